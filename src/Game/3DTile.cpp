@@ -1,16 +1,296 @@
 #include "3DTile.h"
+#include "DungeonGrid.h"
+#include <cstddef>
 //-----------------------------------------------------------------------------
 ShaderProgram shader;
 Uniform uniformWorldMatrix;
-Uniform uniformViewMatrix;
-Uniform uniformProjectionMatrix;
-Uniform uniformLight;
+
+// uniform-   ( std140)
+struct FrameUniforms
+{
+	Matrix4 view;
+	Matrix4 projection;
+	Vector4 lightDirection; // xyz - 
+	Vector4 lightParams;    // x - ambient, y - diffuse
+};
+struct MaterialUniforms
+{
+	Vector4 ambientColor;
+	Vector4 diffuseColor;
+};
+constexpr unsigned FrameBlockBinding = 0;
+constexpr unsigned MaterialBlockBinding = 1;
+UniformBuffer frameUniformBuffer;    //      BeginDraw
+UniformBuffer materialUniformBuffer; //      
+MaterialUniforms currentMaterialUniforms = { Vector4(1.0f), Vector4(1.0f) };
 
 Texture2D defaultTexture;
+//  vbo/ibo      :      VAO
+GeometryArena tileArena;
+constexpr unsigned TileArenaVertexCapacity = 256 * 1024;
+constexpr unsigned TileArenaIndexCapacity = 512 * 1024;
 Model wallModel;
-Model floorModel[7];
+constexpr unsigned FloorVariantCount = 7;
+Model floorModel[FloorVariantCount];
 Model ceilModel;
 
+struct TileInstance
+{
+	Vector3 position;
+};
+
+struct TileInstanceBatch
+{
+	Model* model = nullptr;
+	std::vector<TileInstance> instances;
+	VertexBuffer instanceBuffer;
+	std::vector<VertexArrayBuffer> vao; //     ,    vbo/ibo + instanceBuffer
+};
+TileInstanceBatch wallBatch;
+TileInstanceBatch floorBatch[FloorVariantCount];
+
+struct TileChunk
+{
+	Model model; //    
+	unsigned triangleCount = 0;
+};
+std::vector<TileChunk> chunks;
+AABBArraySoA chunkBounds;
+std::vector<uint32_t> visibleChunks;
+unsigned drawnChunkTriangles = 0;
+unsigned drawnChunkDrawCalls = 0;
+int chunkCountX = 0;
+int chunkCountZ = 0;
+Texture2D* materialTextures[256] = {};
+
+//        -  glMultiDrawElementsBaseVertex
+struct ChunkDrawGroup
+{
+	const Texture2D* texture = nullptr; //      
+	const Material* material = nullptr; // ,  ranges  
+	std::vector<GeometryRange> ranges;
+};
+std::vector<ChunkDrawGroup> chunkDrawGroups;
+
+RenderQueue tileQueue;
+constexpr float TileQueueFarDistance = 100.0f; //      
+
+//           ,    wallModel
+struct CubeFace
+{
+	Vector3 corner[4];
+	Vector2 uv[4];
+	Vector3 normal;
+	int axis;  //   (0 - x, 1 - y, 2 - z)
+	int side;  //     (+1/-1)
+	int axisU; // ,    uv.x
+	int axisV; // ,    uv.y
+};
+const CubeFace cubeFaces[6] =
+{
+	{ { {-0.5f, 0.5f, 0.5f}, { 0.5f, 0.5f, 0.5f}, { 0.5f,-0.5f, 0.5f}, {-0.5f,-0.5f, 0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, { 0.0f, 0.0f,-1.0f}, 2,  1, 0, 1 }, // front
+	{ { { 0.5f, 0.5f,-0.5f}, {-0.5f, 0.5f,-0.5f}, {-0.5f,-0.5f,-0.5f}, { 0.5f,-0.5f,-0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, { 0.0f, 0.0f, 1.0f}, 2, -1, 0, 1 }, // back
+	{ { {-0.5f, 0.5f,-0.5f}, { 0.5f, 0.5f,-0.5f}, { 0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, { 0.0f, 1.0f, 0.0f}, 1,  1, 0, 2 }, // top
+	{ { { 0.5f,-0.5f,-0.5f}, {-0.5f,-0.5f,-0.5f}, {-0.5f,-0.5f, 0.5f}, { 0.5f,-0.5f, 0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, { 0.0f,-1.0f, 0.0f}, 1, -1, 0, 2 }, // bottom
+	{ { {-0.5f, 0.5f,-0.5f}, {-0.5f, 0.5f, 0.5f}, {-0.5f,-0.5f, 0.5f}, {-0.5f,-0.5f,-0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, {-1.0f, 0.0f, 0.0f}, 0, -1, 2, 1 }, // left
+	{ { { 0.5f, 0.5f, 0.5f}, { 0.5f, 0.5f,-0.5f}, { 0.5f,-0.5f,-0.5f}, { 0.5f,-0.5f, 0.5f} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} }, { 1.0f, 0.0f, 0.0f}, 0,  1, 2, 1 }, // right
+};
+
+//-----------------------------------------------------------------------------
+void bindMaterial(const Material& material)
+{
+	const Texture2D* diffuseTexture = material.diffuseTexture;
+	if( diffuseTexture && diffuseTexture->IsValid() )
+		diffuseTexture->Bind(0);
+
+	const MaterialUniforms uniforms = { Vector4(material.ambientColor, 1.0f), Vector4(material.diffuseColor, 1.0f) };
+	if( uniforms.ambientColor != currentMaterialUniforms.ambientColor || uniforms.diffuseColor != currentMaterialUniforms.diffuseColor )
+	{
+		materialUniformBuffer.Update(0, sizeof(MaterialUniforms), &uniforms);
+		currentMaterialUniforms = uniforms;
+	}
+}
+//-----------------------------------------------------------------------------
+void drawModel(Model& model)
+{
+	auto& subMeshes = model.GetSubMesh();
+	for( size_t i = 0; i < subMeshes.size(); i++ )
+	{
+		if( !subMeshes[i].IsDrawable() ) continue;
+		bindMaterial(subMeshes[i].material);
+		subMeshes[i].Draw();
+	}
+}
+//-----------------------------------------------------------------------------
+bool createInstanceBatch(TileInstanceBatch& batch, Model& model)
+{
+	batch.model = &model;
+	if( !batch.instanceBuffer.Create(RenderResourceUsage::Dynamic, 1, sizeof(TileInstance), nullptr) )
+		return false;
+
+	const std::vector<VertexAttribute> formatInstance =
+	{
+		{.location = 4, .size = 3, .normalized = false, .stride = sizeof(TileInstance), .offset = (void*)offsetof(TileInstance, position), .divisor = 1}
+	};
+
+	auto& subMeshes = model.GetSubMesh();
+	batch.vao.resize(subMeshes.size());
+	for( size_t i = 0; i < subMeshes.size(); i++ )
+	{
+		//     - VAO   arena,    arenaRange
+		GeometryArena* arena = subMeshes[i].arena;
+		VertexBuffer* vertexBuffer = arena ? arena->GetVertexBuffer() : &subMeshes[i].vertexBuffer;
+		IndexBuffer* indexBuffer = arena ? arena->GetIndexBuffer() : &subMeshes[i].indexBuffer;
+		if( !batch.vao[i].Create(vertexBuffer, indexBuffer, GetVertexMeshFormat(subMeshes[i].layout), &batch.instanceBuffer, formatInstance) )
+		{
+			LogError("Tile instance VAO create failed!");
+			return false;
+		}
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+void destroyInstanceBatch(TileInstanceBatch& batch)
+{
+	for( size_t i = 0; i < batch.vao.size(); i++ )
+		batch.vao[i].Destroy();
+	batch.vao.clear();
+	batch.instanceBuffer.Destroy();
+	batch.instances.clear();
+	batch.model = nullptr;
+}
+//-----------------------------------------------------------------------------
+void flushInstanceBatch(TileInstanceBatch& batch)
+{
+	if( batch.instances.empty() || !batch.model ) return;
+
+	const unsigned instanceCount = (unsigned)batch.instances.size();
+	batch.instanceBuffer.Update(0, instanceCount, sizeof(TileInstance), batch.instances.data());
+
+	const auto& subMeshes = batch.model->GetSubMesh();
+	for( size_t i = 0; i < batch.vao.size(); i++ )
+	{
+		bindMaterial(subMeshes[i].material);
+		const GeometryRange& range = subMeshes[i].arenaRange;
+		if( subMeshes[i].arena )
+			batch.vao[i].DrawInstancedBaseVertex(instanceCount, PrimitiveDraw::Triangles, range.firstIndex, range.indexCount, (int)range.firstVertex);
+		else
+			batch.vao[i].DrawInstanced(instanceCount);
+	}
+	batch.instances.clear(); // capacity   
+}
+//-----------------------------------------------------------------------------
+//  w x h   face, start -    
+void emitChunkQuad(Mesh& mesh, const CubeFace& face, const int start[3], int w, int h)
+{
+	const uint32_t baseVertex = (uint32_t)mesh.vertices.size();
+	for( int c = 0; c < 4; c++ )
+	{
+		const Vector3& corner = face.corner[c];
+		Vector3 position;
+		position[face.axis] = (float)start[face.axis] + corner[face.axis];
+		position[face.axisU] = corner[face.axisU] < 0.0f ? (float)start[face.axisU] - 0.5f : (float)(start[face.axisU] + w) - 0.5f;
+		position[face.axisV] = corner[face.axisV] < 0.0f ? (float)start[face.axisV] - 0.5f : (float)(start[face.axisV] + h) - 0.5f;
+
+		const Vector2 texCoord = { face.uv[c].x * (float)w, face.uv[c].y * (float)h }; //    (Repeat)
+		mesh.vertices.push_back({ position, face.normal, Vector3(1.0f), texCoord });
+	}
+	const uint32_t quadIndices[6] = { 0, 3, 1, 1, 3, 2 };
+	for( uint32_t index : quadIndices )
+		mesh.indices.push_back(baseVertex + index);
+}
+//-----------------------------------------------------------------------------
+// greedy meshing:         ,       
+void buildChunkMesh(const DungeonGrid& grid, int chunkX, int chunkZ, std::vector<Mesh>& meshes)
+{
+	const int origin[3] = { chunkX * DungeonGrid::ChunkSize, 0, chunkZ * DungeonGrid::ChunkSize };
+	const int size[3] = {
+		Min(DungeonGrid::ChunkSize, grid.GetWidth() - origin[0]),
+		grid.GetLevels(),
+		Min(DungeonGrid::ChunkSize, grid.GetDepth() - origin[2]) };
+
+	int meshIndex[256];
+	for( int& index : meshIndex ) index = -1;
+
+	std::vector<uint8_t> mask;
+	for( const CubeFace& face : cubeFaces )
+	{
+		const int sizeU = size[face.axisU];
+		const int sizeV = size[face.axisV];
+		mask.assign((size_t)sizeU * sizeV, 0);
+
+		for( int slice = 0; slice < size[face.axis]; slice++ )
+		{
+			for( int j = 0; j < sizeV; j++ )
+			{
+				for( int i = 0; i < sizeU; i++ )
+				{
+					int cell[3];
+					cell[face.axis] = origin[face.axis] + slice;
+					cell[face.axisU] = origin[face.axisU] + i;
+					cell[face.axisV] = origin[face.axisV] + j;
+					const uint8_t material = grid.GetCell(cell[0], cell[1], cell[2]);
+					cell[face.axis] += face.side;
+					//     ,       
+					mask[(size_t)j * sizeU + i] = (material != 0 && !grid.IsSolid(cell[0], cell[1], cell[2])) ? material : 0;
+				}
+			}
+
+			for( int j = 0; j < sizeV; j++ )
+			{
+				for( int i = 0; i < sizeU; )
+				{
+					const uint8_t material = mask[(size_t)j * sizeU + i];
+					if( material == 0 )
+					{
+						i++;
+						continue;
+					}
+
+					int w = 1;
+					while( i + w < sizeU && mask[(size_t)j * sizeU + i + w] == material ) w++;
+
+					int h = 1;
+					for( ; j + h < sizeV; h++ )
+					{
+						bool sameRow = true;
+						for( int k = 0; k < w && sameRow; k++ )
+							sameRow = mask[(size_t)(j + h) * sizeU + i + k] == material;
+						if( !sameRow ) break;
+					}
+
+					for( int y = 0; y < h; y++ )
+						memset(&mask[(size_t)(j + y) * sizeU + i], 0, (size_t)w);
+
+					if( meshIndex[material] < 0 )
+					{
+						meshIndex[material] = (int)meshes.size();
+						meshes.emplace_back();
+						Texture2D* texture = materialTextures[material];
+						meshes.back().material = { .diffuseTexture = texture ? texture : &defaultTexture };
+					}
+
+					int start[3];
+					start[face.axis] = origin[face.axis] + slice;
+					start[face.axisU] = origin[face.axisU] + i;
+					start[face.axisV] = origin[face.axisV] + j;
+					emitChunkQuad(meshes[meshIndex[material]], face, start, w, h);
+					i += w;
+				}
+			}
+		}
+	}
+}
+//-----------------------------------------------------------------------------
+void destroyChunks()
+{
+	for( size_t i = 0; i < chunks.size(); i++ )
+		chunks[i].model.Destroy();
+	chunks.clear();
+	chunkBounds.Clear();
+	chunkCountX = chunkCountZ = 0;
+}
+
 //  ,   -   https://zisongbr.itch.io/dungeon-low-poly-tileable
 
 //https://sketchfab.com/3d-models/low-poly-nature-pack-by-rgsdev-4b7e5b2130384655a7ccdd7e7b711836
@@ -25,10 +305,17 @@ layout(location = 0) in vec3 vertexPosition;
 layout(location = 1) in vec3 vertexNormal;
 layout(location = 2) in vec3 vertexColor;
 layout(location = 3) in vec2 vertexTexCoord;
+layout(location = 4) in vec3 instancePosition; //   (   ).        (0,0,0)
 
 uniform mat4 uWorld;
-uniform mat4 uView;
-uniform mat4 uProjection;
+
+layout(std140) uniform FrameBlock
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightDirection;
+	vec4 uLightParams;
+};
 
 out vec3 fragmentColor;
 out vec3 Normal;
@@ -36,7 +323,7 @@ out vec2 TexCoord;
 
 void main()
 {
-	gl_Position   = uProjection * uView * uWorld * vec4(vertexPosition, 1.0);
+	gl_Position   = uProjection * uView * uWorld * vec4(vertexPosition + instancePosition, 1.0);
 	fragmentColor = vertexColor;
 	Normal        = vertexNormal;
 	TexCoord      = vertexTexCoord;
@@ -49,12 +336,19 @@ in vec3 fragmentColor;
 in vec3 Normal;
 in vec2 TexCoord;
 
-struct DirectionalLight
+layout(std140) uniform FrameBlock
 {
-	float Ambient, Diffuse;
-	vec3 Direction;
+	mat4 uView;
+	mat4 uProjection;
+	vec4 uLightDirection; // xyz - 
+	vec4 uLightParams;    // x - ambient, y - diffuse
+};
+
+layout(std140) uniform MaterialBlock
+{
+	vec4 uMaterialAmbient;
+	vec4 uMaterialDiffuse;
 };
-uniform DirectionalLight Light;
 
 uniform sampler2D Texture;
 
@@ -64,8 +358,8 @@ void main()
 {
 	outColor = texture(Texture, TexCoord) * vec4(fragmentColor, 1.0);
 
-	float NdotLD = max(dot(Light.Direction, normalize(Normal)), 0.0); // 
-	outColor.rgb *= Light.Ambient + Light.Diffuse * NdotLD;
+	float NdotLD = max(dot(uLightDirection.xyz, normalize(Normal)), 0.0); // 
+	outColor.rgb *= uMaterialAmbient.rgb * uLightParams.x + uMaterialDiffuse.rgb * uLightParams.y * NdotLD;
 	//float attenuation = saturate(1.0 - DistanceToLight / LightRadius);
 	//frag_Color.rgb *= Light.Ambient + Light.Diffuse * NdotLD * attenuation;
 }
@@ -75,10 +369,19 @@ void main()
 		return false;
 
 	uniformWorldMatrix = shader["uWorld"];
-	uniformViewMatrix = shader["uView"];
-	uniformProjectionMatrix = shader["uProjection"];
-	uniformLight = shader["Light"];
 
+	const ShaderUniformBlockInfo* frameBlock = shader.GetUniformBlockInfo("FrameBlock");
+	const ShaderUniformBlockInfo* materialBlock = shader.GetUniformBlockInfo("MaterialBlock");
+	if( !frameBlock || frameBlock->dataSize != sizeof(FrameUniforms) || !materialBlock || materialBlock->dataSize != sizeof(MaterialUniforms) )
+	{
+		LogError("Tile shader uniform blocks do not match!");
+		return false;
+	}
+	shader.BindUniformBlock("FrameBlock", FrameBlockBinding);
+	shader.BindUniformBlock("MaterialBlock", MaterialBlockBinding);
+	if( !frameUniformBuffer.Create(RenderResourceUsage::Dynamic, sizeof(FrameUniforms)) ||
+		!materialUniformBuffer.Create(RenderResourceUsage::Dynamic, sizeof(MaterialUniforms), &currentMaterialUniforms) )
+		return false;
 
 	Texture2DInfo texInfo;
 	texInfo.mipmap = false;
@@ -87,6 +390,10 @@ void main()
 	if( !defaultTexture.Create("../data/textures/tile.png", texInfo) )
 		return false;
 
+	//      -    (20   ),    65536  - 16- 
+	if( !tileArena.Create(GetVertexMeshFormat(VertexMeshLayout::PackedWhite), GetVertexMeshSize(VertexMeshLayout::PackedWhite), TileArenaVertexCapacity, TileArenaIndexCapacity, sizeof(uint16_t)) )
+		return false;
+
 	// wall
 	{
 		std::vector<Mesh> meshData(1);
@@ -132,57 +439,238 @@ void main()
 		};
 
 		meshData[0].material = { .diffuseTexture = &defaultTexture };
-		wallModel.Create(std::move(meshData));
+		wallModel.Create(std::move(meshData), &tileArena);
 	}
 
 	// floor
 	{
-		for( int i = 1; i < 8; i++ )
+		for( unsigned i = 1; i <= FloorVariantCount; i++ )
 		{
-			floorModel[i - 1].Create(("../data/mesh/tilesFloor/tile" + std::to_string(i) + ".obj").c_str());
+			floorModel[i - 1].Create(("../data/mesh/tilesFloor/tile" + std::to_string(i) + ".obj").c_str(), "./", &tileArena);
 			floorModel[i - 1].SetMaterial({ .diffuseTexture = &defaultTexture });
 		}
 	}
 
+	// instancing
+	{
+		if( !createInstanceBatch(wallBatch, wallModel) )
+			return false;
+		for( unsigned i = 0; i < FloorVariantCount; i++ )
+		{
+			if( !createInstanceBatch(floorBatch[i], floorModel[i]) )
+				return false;
+		}
+	}
+
 
 	return true;
 }
 //-----------------------------------------------------------------------------
 void Tile3DManager::Destroy()
 {
+	tileQueue.Clear();
+	destroyChunks();
+	destroyInstanceBatch(wallBatch);
+	for( unsigned i = 0; i < FloorVariantCount; i++ )
+		destroyInstanceBatch(floorBatch[i]);
+
 	defaultTexture.Destroy();
+	frameUniformBuffer.Destroy();
+	materialUniformBuffer.Destroy();
 	shader.Destroy();
 	wallModel.Destroy();
+	for( unsigned i = 0; i < FloorVariantCount; i++ )
+		floorModel[i].Destroy();
+	chunkDrawGroups.clear();
+	tileArena.Destroy();
 }
 //-----------------------------------------------------------------------------
 void Tile3DManager::BeginDraw(const Matrix4& proj, const Matrix4& view)
 {
 	shader.Bind();
-	uniformViewMatrix = view;
-	uniformProjectionMatrix = proj;
 
-	shader.SetUniform(shader.GetUniformLocation("Light.Ambient"), 0.333333f);
-	shader.SetUniform(shader.GetUniformLocation("Light.Diffuse"), 0.666666f);
-	Vector3 LightDirection = Vector3(0.0f, 0.5f, -1.0f);
-	shader.SetUniform(shader.GetUniformLocation("Light.Direction"), LightDirection);
+	const FrameUniforms frameUniforms = {
+		.view = view,
+		.projection = proj,
+		.lightDirection = Vector4(0.0f, 0.5f, -1.0f, 0.0f),
+		.lightParams = Vector4(0.333333f, 0.666666f, 0.0f, 0.0f)
+	};
+	frameUniformBuffer.Update(0, sizeof(FrameUniforms), &frameUniforms);
+	frameUniformBuffer.Bind(FrameBlockBinding);
+	materialUniformBuffer.Bind(MaterialBlockBinding);
+
+	tileQueue.Begin(view, TileQueueFarDistance);
 }
 //-----------------------------------------------------------------------------
 void Tile3DManager::DrawWall(const Vector3& position)
 {
 	Matrix4 world = Matrix4::Translate(Matrix4::Identity, position);
 	uniformWorldMatrix = world;
-	wallModel.Draw();
+	drawModel(wallModel);
 }
 //-----------------------------------------------------------------------------
 void Tile3DManager::DrawFloor(const Vector3& position)
 {
 	Matrix4 world = Matrix4::Translate(Matrix4::Identity, position);
 	uniformWorldMatrix = world;
-	floorModel[3].Draw();
+	drawModel(floorModel[3]);
 }
 //-----------------------------------------------------------------------------
 void Tile3DManager::DrawCeil(const Vector3& position)
 {
 
 }
-//-----------------------------------------------------------------------------
\ No newline at end of file
+//-----------------------------------------------------------------------------
+void Tile3DManager::PushWall(const Vector3& position)
+{
+	wallBatch.instances.push_back({ position });
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::PushFloor(const Vector3& position, unsigned variant)
+{
+	assert(variant < FloorVariantCount);
+	floorBatch[variant].instances.push_back({ position });
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::FlushInstances()
+{
+	uniformWorldMatrix = Matrix4::Identity; //    instancePosition
+	flushInstanceBatch(wallBatch);
+	for( unsigned i = 0; i < FloorVariantCount; i++ )
+		flushInstanceBatch(floorBatch[i]);
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::SetMaterialTexture(uint8_t material, Texture2D* texture)
+{
+	materialTextures[material] = texture;
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::UpdateChunks(DungeonGrid& grid)
+{
+	if( grid.GetChunkCountX() != chunkCountX || grid.GetChunkCountZ() != chunkCountZ )
+	{
+		destroyChunks();
+		chunkCountX = grid.GetChunkCountX();
+		chunkCountZ = grid.GetChunkCountZ();
+		chunks.resize((size_t)chunkCountX * chunkCountZ);
+
+		for( int z = 0; z < chunkCountZ; z++ )
+		{
+			for( int x = 0; x < chunkCountX; x++ )
+			{
+				const Vector3 boundsMin = Vector3((float)(x * DungeonGrid::ChunkSize), 0.0f, (float)(z * DungeonGrid::ChunkSize)) - 0.5f;
+				const Vector3 boundsMax = Vector3(
+					(float)Min((x + 1) * DungeonGrid::ChunkSize, grid.GetWidth()),
+					(float)grid.GetLevels(),
+					(float)Min((z + 1) * DungeonGrid::ChunkSize, grid.GetDepth())) - 0.5f;
+				chunkBounds.Add({ boundsMin, boundsMax });
+			}
+		}
+	}
+
+	for( int z = 0; z < chunkCountZ; z++ )
+	{
+		for( int x = 0; x < chunkCountX; x++ )
+		{
+			if( !grid.IsChunkDirty(x, z) ) continue;
+
+			std::vector<Mesh> meshes;
+			buildChunkMesh(grid, x, z, meshes);
+
+			TileChunk& chunk = chunks[(size_t)z * chunkCountX + x];
+			chunk.triangleCount = 0;
+			for( size_t i = 0; i < meshes.size(); i++ )
+				chunk.triangleCount += (unsigned)meshes[i].indices.size() / 3;
+
+			chunk.model.Destroy();
+			if( !meshes.empty() && !chunk.model.Create(std::move(meshes), &tileArena) )
+				LogError("Tile chunk mesh create failed!");
+
+			grid.ClearChunkDirty(x, z);
+		}
+	}
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::DrawChunks(const Frustum& frustum)
+{
+	uniformWorldMatrix = Matrix4::Identity; //      
+
+	drawnChunkTriangles = 0;
+	drawnChunkDrawCalls = 0;
+	frustum.CullAABBs(chunkBounds, visibleChunks);
+
+	//       ,   
+	for( ChunkDrawGroup& group : chunkDrawGroups )
+		group.ranges.clear();
+	for( uint32_t index : visibleChunks )
+	{
+		TileChunk& chunk = chunks[index];
+		drawnChunkTriangles += chunk.triangleCount;
+		for( Mesh& mesh : chunk.model.GetSubMesh() )
+		{
+			if( !mesh.IsDrawable() ) continue;
+			if( !mesh.arena )
+			{
+				bindMaterial(mesh.material);
+				mesh.Draw();
+				drawnChunkDrawCalls++;
+				continue;
+			}
+
+			ChunkDrawGroup* group = nullptr;
+			for( ChunkDrawGroup& existing : chunkDrawGroups )
+			{
+				if( existing.texture == mesh.material.diffuseTexture )
+				{
+					group = &existing;
+					break;
+				}
+			}
+			if( !group )
+			{
+				chunkDrawGroups.emplace_back();
+				group = &chunkDrawGroups.back();
+				group->texture = mesh.material.diffuseTexture;
+			}
+			group->material = &mesh.material;
+			group->ranges.push_back(mesh.arenaRange);
+		}
+	}
+
+	for( ChunkDrawGroup& group : chunkDrawGroups )
+	{
+		if( group.ranges.empty() ) continue;
+		bindMaterial(*group.material);
+		tileArena.MultiDraw(group.ranges.data(), group.ranges.size());
+		drawnChunkDrawCalls++;
+	}
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::GetChunkStatistics(unsigned& triangleCount, unsigned& drawCallCount)
+{
+	triangleCount = drawnChunkTriangles;
+	drawCallCount = drawnChunkDrawCalls;
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::QueueWall(const Vector3& position)
+{
+	tileQueue.Submit(wallModel, shader, Matrix4::Translate(Matrix4::Identity, position));
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::QueueFloor(const Vector3& position, unsigned variant)
+{
+	assert(variant < FloorVariantCount);
+	tileQueue.Submit(floorModel[variant], shader, Matrix4::Translate(Matrix4::Identity, position));
+}
+//-----------------------------------------------------------------------------
+void Tile3DManager::FlushQueue()
+{
+	tileQueue.Sort();
+	tileQueue.Draw("uWorld", bindMaterial);
+}
+//-----------------------------------------------------------------------------
+const RenderQueueStatistics& Tile3DManager::GetQueueStatistics()
+{
+	return tileQueue.GetStatistics();
+}
+//-----------------------------------------------------------------------------
@@ -2,6 +2,8 @@
 
 #include "MicroEngine.h"
 
+class DungeonGrid;
+
 namespace Tile3DManager
 {
 	bool Create();
@@ -11,4 +13,23 @@ namespace Tile3DManager
 	void DrawWall(const Vector3& position);
 	void DrawFloor(const Vector3& position);
 	void DrawCeil(const Vector3& position);
+
+	// инстансный режим: тайлы копятся в поинстансный буфер, FlushInstances рисует один glDrawElementsInstanced на модель тайла
+	void PushWall(const Vector3& position);
+	void PushFloor(const Vector3& position, unsigned variant = 3);
+	void FlushInstances();
+
+	// чанковый режим: твердые клетки DungeonGrid собираются в статический меш на чанк
+	// (без граней между соседними клетками, соседние грани одного материала сливаются).
+	// UpdateChunks перестраивает только грязные чанки.
+	void SetMaterialTexture(uint8_t material, Texture2D* texture);
+	void UpdateChunks(DungeonGrid& grid);
+	void DrawChunks(const Frustum& frustum); // рисуются только чанки, попавшие в frustum
+	void GetChunkStatistics(unsigned& triangleCount, unsigned& drawCallCount); // нарисованное последним DrawChunks
+
+	// режим очереди: сабмеши тайлов копятся в RenderQueue (очищается в BeginDraw), FlushQueue сортирует их по ключу и рисует, меняя ресурсы только при смене
+	void QueueWall(const Vector3& position);
+	void QueueFloor(const Vector3& position, unsigned variant = 3);
+	void FlushQueue();
+	const RenderQueueStatistics& GetQueueStatistics(); // последний FlushQueue
 }
\ No newline at end of file
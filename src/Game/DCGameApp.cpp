@@ -1,6 +1,8 @@
 #include "DCGameApp.h"
 #include "3DTile.h"
 #include "PlayerCamera.h"
+#include "DungeonGrid.h"
+#include <chrono>
 
 //   ( ) https://deepnight.itch.io/dungeon-crawler
 //        - https://voxelvoid.itch.io/dark-lords-maze
@@ -27,12 +29,62 @@
 //
 //     - https://forum.zdoom.org/viewtopic.php?t=63994
 
+enum class TileRenderMode
+{
+	PerTile,   // DrawWall/DrawFloor   
+	Instanced, // PushWall/PushFloor + FlushInstances
+	Chunked,   //  -   DungeonGrid,  - 
+	Queued,    // QueueWall/QueueFloor + FlushQueue (   RenderQueue)
+};
+TileRenderMode tileRenderMode = TileRenderMode::Chunked;
+float tileSubmitTimeMs = 0.0f; //  CPU-  
+
+DungeonGrid dungeonGrid;
+AABBArraySoA floorBounds;
+std::vector<uint32_t> visibleFloors;
+
+//    PerTile/Instanced   
+template<class Function>
+void forEachSolidCell(const DungeonGrid& grid, Function&& function)
+{
+	for( int z = 0; z < grid.GetDepth(); z++ )
+	{
+		for( int level = 0; level < grid.GetLevels(); level++ )
+		{
+			for( int x = 0; x < grid.GetWidth(); x++ )
+			{
+				if( grid.IsSolid(x, level, z) )
+					function(GridCell{ x, level, z });
+			}
+		}
+	}
+}
+
 bool GameAppInit()
 {
 	if( !Tile3DManager::Create() )
 		return false;
 
+	if( !dungeonGrid.Create(100, 5, 100) )
+		return false;
+	for( int x = 0; x < 50; x++ )
+	{
+		for( int y = 0; y < 50; y++ )
+		{
+			for( int z = 0; z < 5; z++ )
+				dungeonGrid.SetCell(x * 2, z, y * 2, 1);
+		}
+	}
+
+	floorBounds.Reserve(50 * 50);
+	for( int x = 0; x < 50; x++ )
+	{
+		for( int y = 0; y < 50; y++ )
+			floorBounds.Add(AABB(Vector3((float)x, -0.5f, (float)y), 0.5f));
+	}
+
 	PlayerCamera::SetPosition({ 5.0f, 0.0f, 10.0f }, { 5.0f, 0.0f, -1.0f });
+	PlayerCamera::SetGrid(&dungeonGrid);
 	//SetMouseVisible(false);
 
 	return true;
@@ -40,6 +92,7 @@ bool GameAppInit()
 
 void GameAppClose()
 {
+	dungeonGrid.Destroy();
 	Tile3DManager::Destroy();
 }
 
@@ -51,26 +104,58 @@ void GameAppFrame()
 	Matrix4 perpective = Matrix4::Perspective(45.0f, GetWindowAspectRatio(), 0.01f, 1000.f);
 	Tile3DManager::BeginDraw(perpective, view);
 
-	glEnable(GL_CULL_FACE);
-	glFrontFace(GL_CW); // TODO: 
-	for( size_t x = 0; x < 50; x++ )
+	if( IsKeyPressed('M') )
+		tileRenderMode = (TileRenderMode)(((int)tileRenderMode + 1) % 4);
+
+	Tile3DManager::UpdateChunks(dungeonGrid); //    
+
+	RasterizerState rasterizerState;
+	rasterizerState.cullMode = CullMode::Back;
+	rasterizerState.frontFace = FaceOrientation::Clockwise; // TODO: 
+	SetRasterizerState(rasterizerState);
+	const auto submitBegin = std::chrono::steady_clock::now();
+	if( tileRenderMode == TileRenderMode::PerTile )
 	{
-		for( size_t y = 0; y < 50; y++ )
+		for( size_t x = 0; x < 50; x++ )
 		{
-			Tile3DManager::DrawFloor({(float)x, -0.5f, (float)y});
-
-			for( size_t z = 0; z < 5; z++ )
-			{
-				Vector3 pos;
-				pos.x = x * 2;
-				pos.y = z;
-				pos.z = y * 2;
-				Tile3DManager::DrawWall(pos);
-			}
+			for( size_t y = 0; y < 50; y++ )
+				Tile3DManager::DrawFloor({ (float)x, -0.5f, (float)y });
 		}
+		forEachSolidCell(dungeonGrid, [](const GridCell& cell) { Tile3DManager::DrawWall(DungeonGrid::CellToWorld(cell)); });
 	}
-	glFrontFace(GL_CCW);
-	glDisable(GL_CULL_FACE);
+	else if( tileRenderMode == TileRenderMode::Instanced )
+	{
+		for( size_t x = 0; x < 50; x++ )
+		{
+			for( size_t y = 0; y < 50; y++ )
+				Tile3DManager::PushFloor({ (float)x, -0.5f, (float)y });
+		}
+		forEachSolidCell(dungeonGrid, [](const GridCell& cell) { Tile3DManager::PushWall(DungeonGrid::CellToWorld(cell)); });
+		Tile3DManager::FlushInstances();
+	}
+	else if( tileRenderMode == TileRenderMode::Queued )
+	{
+		//   :    VAO     
+		for( size_t x = 0; x < 50; x++ )
+		{
+			for( size_t y = 0; y < 50; y++ )
+				Tile3DManager::QueueFloor({ (float)x, -0.5f, (float)y }, (unsigned)((x * 3 + y) % 7));
+		}
+		forEachSolidCell(dungeonGrid, [](const GridCell& cell) { Tile3DManager::QueueWall(DungeonGrid::CellToWorld(cell)); });
+		Tile3DManager::FlushQueue();
+	}
+	else
+	{
+		const Frustum frustum(perpective * view);
+		frustum.CullAABBs(floorBounds, visibleFloors);
+		for( uint32_t index : visibleFloors )
+			Tile3DManager::PushFloor(floorBounds.Get(index).GetCenter());
+		Tile3DManager::FlushInstances();
+		Tile3DManager::DrawChunks(frustum);
+	}
+	const float submitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - submitBegin).count();
+	tileSubmitTimeMs = tileSubmitTimeMs * 0.95f + submitMs * 0.05f;
+	SetRasterizerState({});
 
 	//DebugDraw::DrawLine({ 0.0f, 0.0f, 0.0f }, { -10.0f, 2.0f, 0.0f }, RED);
 	//DebugDraw::Flush(perpective * view);
@@ -78,6 +163,35 @@ void GameAppFrame()
 	DebugText::Begin();
 	DebugText::SetForeground({ 255, 255, 0, 255 });
 	DebugText::SetBackground({ 100, 120, 255, 255 });
-	DebugText::Print(1, 1, "Hello");
+	const char* modeNames[] = { "per-tile", "instanced", "chunked", "queued" };
+	char info[128];
+	snprintf(info, sizeof(info), "%s submit: %.3f ms (M - switch)", modeNames[(int)tileRenderMode], tileSubmitTimeMs);
+	DebugText::Print(1, 1, info);
+	unsigned chunkTriangles = 0, chunkDrawCalls = 0;
+	Tile3DManager::GetChunkStatistics(chunkTriangles, chunkDrawCalls);
+	snprintf(info, sizeof(info), "chunks: %u tris, %u draws", chunkTriangles, chunkDrawCalls);
+	DebugText::Print(1, 2, info);
+	const RenderFrameStatistics& renderStatistics = GetRenderFrameStatistics();
+	snprintf(info, sizeof(info), "state: %u issued, %u skipped; uniforms: %u issued, %u skipped", renderStatistics.stateCalls, renderStatistics.stateCallsSkipped, renderStatistics.uniformCalls, renderStatistics.uniformCallsSkipped);
+	DebugText::Print(1, 3, info);
+	//   :        
+	const Point2 cursor = GetCursorPosition();
+	const Vector4 viewport(0.0f, 0.0f, (float)GetWindowWidth(), (float)GetWindowHeight());
+	const Vector3 pickNear = Matrix4::UnProject(Vector3((float)cursor.x, viewport.w - (float)cursor.y, 0.0f), view, perpective, viewport);
+	const Vector3 pickFar = Matrix4::UnProject(Vector3((float)cursor.x, viewport.w - (float)cursor.y, 1.0f), view, perpective, viewport);
+	GridRayHit pickHit;
+	if( dungeonGrid.Raycast(Ray(pickNear, pickFar - pickNear), 1.0f, pickHit) )
+		snprintf(info, sizeof(info), "pick: cell %d %d %d", pickHit.cell[0], pickHit.cell[1], pickHit.cell[2]);
+	else
+		snprintf(info, sizeof(info), "pick: none");
+	DebugText::Print(1, 4, info);
+	if( tileRenderMode == TileRenderMode::Queued )
+	{
+		const RenderQueueStatistics& queueStatistics = Tile3DManager::GetQueueStatistics();
+		snprintf(info, sizeof(info), "queue: %u items; shader/texture/vao changes %u/%u/%u (unsorted %u/%u/%u)", queueStatistics.items,
+			queueStatistics.shaderChanges, queueStatistics.textureChanges, queueStatistics.vaoChanges,
+			queueStatistics.submitShaderChanges, queueStatistics.submitTextureChanges, queueStatistics.submitVaoChanges);
+		DebugText::Print(1, 5, info);
+	}
 	DebugText::Flush();
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "DungeonGrid.h"
+//-----------------------------------------------------------------------------
+bool DungeonGrid::Create(int width, int levels, int depth)
+{
+	Destroy();
+	if( width <= 0 || levels <= 0 || depth <= 0 )
+	{
+		LogError("DungeonGrid: invalid size!");
+		return false;
+	}
+
+	m_width = width;
+	m_levels = levels;
+	m_depth = depth;
+	m_chunkCountX = GetChunkCountX();
+	m_chunkCells = (size_t)ChunkSize * ChunkSize * levels;
+	m_chunkWords = m_chunkCells / 64;
+	const size_t chunkCount = (size_t)GetChunkCountX() * GetChunkCountZ();
+	m_cells.resize(chunkCount * m_chunkCells, 0);
+	m_flags.resize(chunkCount * FlagCount * m_chunkWords, 0);
+	m_dirtyChunks.resize(chunkCount, 1);
+	return true;
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::Destroy()
+{
+	m_cells.clear();
+	m_flags.clear();
+	m_dirtyChunks.clear();
+	m_chunkCells = m_chunkWords = 0;
+	m_chunkCountX = 0;
+	m_width = m_levels = m_depth = 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t DungeonGrid::GetCell(int x, int level, int z) const
+{
+	if( !IsInside(x, level, z) ) return 0;
+	return m_cells[getCellIndex(x, level, z)];
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::SetCell(int x, int level, int z, uint8_t material)
+{
+	if( !IsInside(x, level, z) ) return;
+
+	uint8_t& cell = m_cells[getCellIndex(x, level, z)];
+	if( cell == material ) return;
+	cell = material;
+	setFlag(x, level, z, 0, material != 0);
+
+	// грани клетки на границе чанка принадлежат и соседнему чанку
+	markChunkDirty(x, z);
+	markChunkDirty(x - 1, z);
+	markChunkDirty(x + 1, z);
+	markChunkDirty(x, z - 1);
+	markChunkDirty(x, z + 1);
+}
+//-----------------------------------------------------------------------------
+uint8_t DungeonGrid::GetFlags(int x, int level, int z) const
+{
+	if( !IsInside(x, level, z) ) return CellBlocked;
+
+	const size_t local = getLocalIndex(x, level, z);
+	const size_t word = getFlagWord(getChunkIndex(x, z), local, 0);
+	const unsigned bit = (unsigned)(local & 63);
+	uint8_t flags = 0;
+	for( int flag = 0; flag < FlagCount; flag++ )
+		flags |= (uint8_t)(((m_flags[word + flag * m_chunkWords] >> bit) & 1) << flag);
+	return flags;
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::SetFlags(int x, int level, int z, uint8_t flags, bool enable)
+{
+	if( !IsInside(x, level, z) ) return;
+
+	for( int flag = 1; flag < FlagCount; flag++ )
+	{
+		if( flags & (1 << flag) )
+			setFlag(x, level, z, flag, enable);
+	}
+}
+//-----------------------------------------------------------------------------
+uint8_t DungeonGrid::GetOpenNeighbours(const GridCell& cell) const
+{
+	uint8_t open = 0;
+	for( uint8_t direction = 0; direction < (uint8_t)GridDirection::Count; direction++ )
+	{
+		if( !IsBlocked(GetNeighbour(cell, (GridDirection)direction)) )
+			open |= (uint8_t)(1 << direction);
+	}
+	return open;
+}
+//-----------------------------------------------------------------------------
+bool DungeonGrid::TryStep(const GridCell& from, GridDirection direction, GridCell& outCell) const
+{
+	const GridCell target = GetNeighbour(from, direction);
+	if( IsBlocked(target) ) return false;
+	outCell = target;
+	return true;
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::IsBlocked(const GridCell* cells, size_t count, uint8_t* outBlocked) const
+{
+	for( size_t i = 0; i < count; i++ )
+		outBlocked[i] = IsBlocked(cells[i]) ? 1 : 0;
+}
+//-----------------------------------------------------------------------------
+size_t DungeonGrid::ResolveMoves(GridMove* moves, size_t count)
+{
+	size_t movedCount = 0;
+	for( size_t i = 0; i < count; i++ )
+	{
+		GridMove& move = moves[i];
+		move.result = move.from;
+		move.moved = TryStep(move.from, move.direction, move.result);
+		if( !move.moved ) continue;
+
+		SetFlags(move.from.x, move.from.level, move.from.z, CellOccupied, false);
+		SetFlags(move.result.x, move.result.level, move.result.z, CellOccupied, true);
+		movedCount++;
+	}
+	return movedCount;
+}
+//-----------------------------------------------------------------------------
+bool DungeonGrid::Raycast(const Ray& ray, float maxDistance, GridRayHit& outHit) const
+{
+	// клетки внутри сетки, IsInside не нужен
+	return GridRaycast(ray, maxDistance, GetBounds(), [this](int x, int level, int z) { return testFlag(x, level, z, 0); }, outHit);
+}
+//-----------------------------------------------------------------------------
+bool DungeonGrid::HasLineOfSight(const Vector3& from, const Vector3& to) const
+{
+	return GridLineOfSight(from, to, GetBounds(), [this](int x, int level, int z) { return testFlag(x, level, z, 0); });
+}
+//-----------------------------------------------------------------------------
+size_t DungeonGrid::HasLineOfSight(const Vector3& from, const Vector3* targets, size_t count, uint8_t* outVisible) const
+{
+	return GridLineOfSight(from, targets, count, GetBounds(), [this](int x, int level, int z) { return testFlag(x, level, z, 0); }, outVisible);
+}
+//-----------------------------------------------------------------------------
+GridCell DungeonGrid::GetNeighbour(const GridCell& cell, GridDirection direction)
+{
+	static constexpr int offsetX[] = { 0, 1, 0, -1 };
+	static constexpr int offsetZ[] = { -1, 0, 1, 0 };
+	return { cell.x + offsetX[(int)direction], cell.level, cell.z + offsetZ[(int)direction] };
+}
+//-----------------------------------------------------------------------------
+GridDirection DungeonGrid::GetDirection(const Vector3& direction)
+{
+	if( fabsf(direction.x) > fabsf(direction.z) )
+		return direction.x > 0.0f ? GridDirection::East : GridDirection::West;
+	return direction.z > 0.0f ? GridDirection::South : GridDirection::North;
+}
+//-----------------------------------------------------------------------------
+GridCell DungeonGrid::WorldToCell(const Vector3& position)
+{
+	return { (int)floorf(position.x + 0.5f), (int)floorf(position.y + 0.5f), (int)floorf(position.z + 0.5f) };
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::setFlag(int x, int level, int z, int flag, bool enable)
+{
+	const size_t local = getLocalIndex(x, level, z);
+	const uint64_t bit = 1ull << (local & 63);
+	uint64_t& word = m_flags[getFlagWord(getChunkIndex(x, z), local, flag)];
+	word = enable ? (word | bit) : (word & ~bit);
+}
+//-----------------------------------------------------------------------------
+void DungeonGrid::markChunkDirty(int x, int z)
+{
+	if( x < 0 || x >= m_width || z < 0 || z >= m_depth ) return;
+	m_dirtyChunks[(z / ChunkSize) * GetChunkCountX() + (x / ChunkSize)] = 1;
+}
+//-----------------------------------------------------------------------------
\ No newline at end of file
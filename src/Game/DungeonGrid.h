@@ -0,0 +1,130 @@
+#pragma once
+
+#include "MicroEngine.h"
+
+// Клетка сетки (x, этаж, z)
+struct GridCell
+{
+	int x = 0;
+	int level = 0;
+	int z = 0;
+
+	bool operator==(const GridCell&) const = default;
+};
+
+// Шаг по сетке в пределах этажа
+enum class GridDirection : uint8_t
+{
+	North = 0, // -z
+	East,      // +x
+	South,     // +z
+	West,      // -x
+	Count
+};
+
+// Флаги клетки. Хранятся битовыми плоскостями (бит на клетку)
+enum CellFlags : uint8_t
+{
+	CellSolid    = 1 << 0, // стена, выставляется SetCell по материалу
+	CellBlocked  = 1 << 1, // непроходимая клетка без стены (решетка, предмет)
+	CellOccupied = 1 << 2, // клетку занимает актер
+
+	CellBlockingFlags = CellSolid | CellBlocked | CellOccupied,
+};
+
+// Ход актера для DungeonGrid::ResolveMoves
+struct GridMove
+{
+	GridCell from;
+	GridDirection direction = GridDirection::North;
+	GridCell result;    // клетка после хода (from, если ход заблокирован)
+	bool moved = false;
+};
+
+// Сетка клеток подземелья. Клетка (x, level, z) в мире - куб с центром в (x, level, z) и стороной 1.
+// Материал 0 - пустая клетка, остальные - твердая клетка (стена) с этим материалом.
+// Клетки хранятся по чанкам ChunkSize x ChunkSize x levels (материалы - байт на клетку, флаги - битовые плоскости),
+// при изменении клетки чанк помечается грязным.
+// Движение по сетке не использует треугольные коллизии: клетка проходима, если у нее нет флагов CellBlockingFlags
+class DungeonGrid
+{
+public:
+	static constexpr int ChunkSize = 16;
+	static constexpr int ChunkShift = 4;
+	static constexpr int FlagCount = 3;
+
+	bool Create(int width, int levels, int depth);
+	void Destroy();
+
+	[[nodiscard]] uint8_t GetCell(int x, int level, int z) const; // вне сетки - пустая клетка
+	void SetCell(int x, int level, int z, uint8_t material);
+	[[nodiscard]] bool IsSolid(int x, int level, int z) const { return IsInside(x, level, z) && testFlag(x, level, z, 0); }
+	[[nodiscard]] bool IsInside(int x, int level, int z) const { return x >= 0 && x < m_width && level >= 0 && level < m_levels && z >= 0 && z < m_depth; }
+	[[nodiscard]] bool IsInside(const GridCell& cell) const { return IsInside(cell.x, cell.level, cell.z); }
+
+	// флаги клетки, вне сетки - CellBlocked (за край карты шагнуть нельзя)
+	[[nodiscard]] uint8_t GetFlags(int x, int level, int z) const;
+	[[nodiscard]] bool HasFlags(int x, int level, int z, uint8_t flags) const { return (GetFlags(x, level, z) & flags) != 0; }
+	void SetFlags(int x, int level, int z, uint8_t flags, bool enable); // CellSolid задается только материалом
+	[[nodiscard]] bool IsBlocked(int x, int level, int z) const { return HasFlags(x, level, z, CellBlockingFlags); }
+	[[nodiscard]] bool IsBlocked(const GridCell& cell) const { return IsBlocked(cell.x, cell.level, cell.z); }
+
+	// маска направлений (бит 1 << GridDirection), в которые можно шагнуть из клетки
+	[[nodiscard]] uint8_t GetOpenNeighbours(const GridCell& cell) const;
+	// шаг на соседнюю клетку, false - клетка занята
+	bool TryStep(const GridCell& from, GridDirection direction, GridCell& outCell) const;
+
+	// пакетные запросы на ход игры
+	void IsBlocked(const GridCell* cells, size_t count, uint8_t* outBlocked) const;
+	// ходы выполняются по порядку и сразу переносят CellOccupied, поэтому следующий актер видит предыдущие ходы. Возвращает число сделанных ходов
+	size_t ResolveMoves(GridMove* moves, size_t count);
+
+	// луч по клеткам (GridRaycast): первая стена на [0, maxDistance], hit.cell - (x, level, z)
+	bool Raycast(const Ray& ray, float maxDistance, GridRayHit& outHit) const;
+	// между точками нет стен
+	[[nodiscard]] bool HasLineOfSight(const Vector3& from, const Vector3& to) const;
+	// видимость from -> targets[i] для всех целей одним вызовом, возвращает число видимых
+	size_t HasLineOfSight(const Vector3& from, const Vector3* targets, size_t count, uint8_t* outVisible) const;
+
+	[[nodiscard]] AABB GetBounds() const { return AABB(Vector3(-0.5f), Vector3((float)m_width, (float)m_levels, (float)m_depth) - 0.5f); }
+
+	[[nodiscard]] static GridCell GetNeighbour(const GridCell& cell, GridDirection direction);
+	[[nodiscard]] static GridDirection GetDirection(const Vector3& direction); // ближайшее направление по оси x/z
+	[[nodiscard]] static Vector3 CellToWorld(const GridCell& cell) { return Vector3((float)cell.x, (float)cell.level, (float)cell.z); }
+	[[nodiscard]] static GridCell WorldToCell(const Vector3& position);
+
+	[[nodiscard]] int GetWidth() const { return m_width; }
+	[[nodiscard]] int GetLevels() const { return m_levels; }
+	[[nodiscard]] int GetDepth() const { return m_depth; }
+
+	[[nodiscard]] int GetChunkCountX() const { return (m_width + ChunkSize - 1) / ChunkSize; }
+	[[nodiscard]] int GetChunkCountZ() const { return (m_depth + ChunkSize - 1) / ChunkSize; }
+
+	[[nodiscard]] bool IsChunkDirty(int chunkX, int chunkZ) const { return m_dirtyChunks[chunkZ * GetChunkCountX() + chunkX] != 0; }
+	void ClearChunkDirty(int chunkX, int chunkZ) { m_dirtyChunks[chunkZ * GetChunkCountX() + chunkX] = 0; }
+
+private:
+	// чанки лежат подряд, внутри чанка клетки по [level][z][x]
+	size_t getChunkIndex(int x, int z) const { return (size_t)(z >> ChunkShift) * m_chunkCountX + (size_t)(x >> ChunkShift); }
+	static size_t getLocalIndex(int x, int level, int z) { return ((size_t)level << (2 * ChunkShift)) + ((size_t)(z & (ChunkSize - 1)) << ChunkShift) + (size_t)(x & (ChunkSize - 1)); }
+	size_t getCellIndex(int x, int level, int z) const { return getChunkIndex(x, z) * m_chunkCells + getLocalIndex(x, level, z); }
+	// слово битовой плоскости флага: плоскости чанка лежат подряд
+	size_t getFlagWord(size_t chunk, size_t local, int flag) const { return (chunk * FlagCount + (size_t)flag) * m_chunkWords + (local >> 6); }
+	bool testFlag(int x, int level, int z, int flag) const
+	{
+		const size_t local = getLocalIndex(x, level, z);
+		return (m_flags[getFlagWord(getChunkIndex(x, z), local, flag)] >> (local & 63)) & 1;
+	}
+	void setFlag(int x, int level, int z, int flag, bool enable);
+	void markChunkDirty(int x, int z);
+
+	std::vector<uint8_t> m_cells;
+	std::vector<uint64_t> m_flags;
+	std::vector<uint8_t> m_dirtyChunks;
+	size_t m_chunkCells = 0; // ChunkSize * ChunkSize * levels, кратно 64
+	size_t m_chunkWords = 0; // слов на плоскость флага чанка
+	int m_chunkCountX = 0;
+	int m_width = 0;
+	int m_levels = 0;
+	int m_depth = 0;
+};
@@ -7,7 +7,8 @@
 #	pragma warning(push)
 #endif // _MSC_VER
 
-#include <map>
+#include <algorithm>
+#include <cstddef>
 #include <unordered_map>
 
 #if defined(_MSC_VER)
@@ -103,12 +104,30 @@ void ResourceCacheSystem::Clear()
 //-----------------------------------------------------------------------------
 ShaderProgram shaderProgram;
 int MatrixID;
-int ColorID;
-GLuint vao, vbo;
-std::map<unsigned, std::vector<Vector3>> Points;
-std::map<unsigned, std::vector<Vector3>> Lines;
+constexpr unsigned DebugDrawStreamSize = 1024 * 1024; // начальный размер в байтах на кадр, растет при нехватке
+StreamBuffer debugDrawBuffer;
+VertexArrayBuffer debugDrawVao;
+struct DebugDrawVertex
+{
+	Vector3 position;
+	Vector3 color;
+};
+// массивы только растут - clear() сохраняет память, поэтому в установившемся режиме аллокаций нет
+std::vector<DebugDrawVertex> Points;
+std::vector<DebugDrawVertex> Lines;
 //-----------------------------------------------------------------------------
-// TODO: можно оптимизировать, если хранить цвет в вершине, тогда не нужно использовать мап, можно использовать массив который только растет (а сбрасывается только счетчик). но займет больше памяти. хотя и н сильно
+bool debugDrawCreateBuffer(unsigned frameSize)
+{
+	debugDrawVao.Destroy();
+	if( !debugDrawBuffer.Create(frameSize) )
+		return false;
+	const std::vector<VertexAttribute> format =
+	{
+		{.location = 0, .size = 3, .normalized = false, .stride = sizeof(DebugDrawVertex), .offset = (void*)offsetof(DebugDrawVertex, position)},
+		{.location = 1, .size = 3, .normalized = false, .stride = sizeof(DebugDrawVertex), .offset = (void*)offsetof(DebugDrawVertex, color)}
+	};
+	return debugDrawVao.Create(debugDrawBuffer.GetVertexBuffer(), nullptr, format);
+}
 //-----------------------------------------------------------------------------
 void drawGround(float scale)
 { // 10x10
@@ -198,13 +217,14 @@ inline void  orthoVec(Vector3* left, Vector3* up, Vector3 v)
 //-----------------------------------------------------------------------------
 void DebugDraw::DrawPoint(const Vector3& from, unsigned rgb)
 {
-	Points[rgb].push_back(from);
+	Points.push_back({ from, RGBToVec(rgb) });
 }
 //-----------------------------------------------------------------------------
 void DebugDraw::DrawLine(const Vector3& from, const Vector3& to, unsigned rgb)
 {
-	Lines[rgb].push_back(from);
-	Lines[rgb].push_back(to);
+	const Vector3 color = RGBToVec(rgb);
+	Lines.push_back({ from, color });
+	Lines.push_back({ to, color });
 }
 //-----------------------------------------------------------------------------
 void DebugDraw::DrawLineDashed(Vector3 from, Vector3 to, unsigned rgb)
@@ -679,53 +699,41 @@ void DebugDraw::Flush(const Matrix4& ViewProj)
 	if (Points.empty() && Lines.empty())
 		return;
 
-	shaderProgram.Bind();
-	shaderProgram.SetUniform(MatrixID, ViewProj);
-
-	// TODO: сделать интерфейс
-	VertexArrayBuffer::UnBind();
-	glBindVertexArray(vao);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3), 0);
-
-	//glEnable(GL_DEPTH_TEST);
-	//glDepthFunc(GL_LEQUAL);
-	//glEnable(GL_PROGRAM_POINT_SIZE); // for GL_POINTS
-	//glEnable(GL_LINE_SMOOTH); // for GL_LINES (thin)
-
-	// Draw Points
+	// все вершины кадра одним куском: сначала линии, затем точки - по одному вызову отрисовки на тип примитива
+	const size_t vertexCount = Lines.size() + Points.size();
+	const size_t dataSize = vertexCount * sizeof(DebugDrawVertex);
+	if (dataSize > debugDrawBuffer.GetFrameSize())
 	{
-		//glPointSize(6);
-		for (auto& it : Points)
+		unsigned frameSize = debugDrawBuffer.GetFrameSize() ? debugDrawBuffer.GetFrameSize() : DebugDrawStreamSize;
+		while (frameSize < dataSize) frameSize *= 2;
+		if (!debugDrawCreateBuffer(frameSize))
 		{
-			shaderProgram.SetUniform(ColorID, RGBToVec(it.first));
-			const size_t count = it.second.size();
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vector3), it.second.data(), GL_STATIC_DRAW);
-			glDrawArrays(GL_POINTS, 0, count);
+			Points.clear();
+			Lines.clear();
+			return;
 		}
-		//glPointSize(1);
 	}
 
-	// Draw Lines
+	unsigned offset = 0;
+	DebugDrawVertex* data = (DebugDrawVertex*)debugDrawBuffer.Map((unsigned)dataSize, sizeof(DebugDrawVertex), offset);
+	if (data)
 	{
-		for (auto& it : Lines)
-		{
-			shaderProgram.SetUniform(ColorID, RGBToVec(it.first));
-			const size_t count = it.second.size();
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vector3), it.second.data(), GL_STATIC_DRAW);
-			glDrawArrays(GL_LINES, 0, count);
-		}
+		if (!Lines.empty()) memcpy(data, Lines.data(), Lines.size() * sizeof(DebugDrawVertex));
+		if (!Points.empty()) memcpy(data + Lines.size(), Points.data(), Points.size() * sizeof(DebugDrawVertex));
+		debugDrawBuffer.Unmap();
+
+		shaderProgram.Bind();
+		shaderProgram.SetUniform(MatrixID, ViewProj);
+
+		const unsigned first = offset / sizeof(DebugDrawVertex);
+		if (!Lines.empty())
+			debugDrawVao.Draw(PrimitiveDraw::Lines, first, (unsigned)Lines.size());
+		if (!Points.empty())
+			debugDrawVao.Draw(PrimitiveDraw::Points, first + (unsigned)Lines.size(), (unsigned)Points.size());
 	}
 
-	//glEnable(GL_DEPTH_TEST);
-	//glDepthFunc(GL_LESS);
-	//glDisable(GL_LINE_SMOOTH);
-	//glDisable(GL_PROGRAM_POINT_SIZE);
-	glBindVertexArray(0);
-
-	Points.clear(); // TODO: надо по другому - без реальной очистки памяти
-	Lines.clear(); // TODO: надо по другому - без реальной очистки памяти
+	Points.clear();
+	Lines.clear();
 }
 //-----------------------------------------------------------------------------
 bool DebugDraw::Init()
@@ -733,13 +741,13 @@ bool DebugDraw::Init()
 	const char* vertexSource = R"(
 #version 330 core
 layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexColor;
 uniform mat4 MVP;
-uniform vec3 u_color;
 out vec3 out_color;
 void main()
 {
 	gl_Position =  MVP * vec4(vertexPosition, 1);
-	out_color = u_color;
+	out_color = vertexColor;
 }
 )";
 
@@ -755,19 +763,17 @@ void main()
 	if (!shaderProgram.CreateFromMemories(vertexSource, fragmentSource))
 		return false;
 	MatrixID = shaderProgram.GetUniformLocation("MVP");
-	ColorID = shaderProgram.GetUniformLocation("u_color");
-
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
 
-	return true;
+	return debugDrawCreateBuffer(DebugDrawStreamSize);
 }
 //-----------------------------------------------------------------------------
 void DebugDraw::Close()
 {
 	shaderProgram.Destroy();
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &vbo);
+	debugDrawVao.Destroy();
+	debugDrawBuffer.Destroy();
+	Points = {};
+	Lines = {};
 }
 //-----------------------------------------------------------------------------
 //=============================================================================
@@ -1121,15 +1127,17 @@ void DebugText::Flush()
 	debugTextShader.SetUniform(debugTextUniformTexture, 0);
 	debugTextShader.SetUniform(debugTextUniformProjection, ortho);
 
-	// TODO: вернуть стейты
+	BlendState blendState;
+	blendState.srcBlend = blendState.srcBlendAlpha = BlendMode::SrcAlpha;
+	blendState.dstBlend = blendState.dstBlendAlpha = BlendMode::OneMinusSrcAlpha;
+	DepthState depthState;
+	depthState.depthFunc = CompareFunction::Disabled;
 
-	glDisable(GL_DEPTH_TEST);
-	//glDisable(GL_CULL_FACE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	SetDepthState(depthState);
+	SetBlendState(blendState);
 	debugTextVao.Draw();
-	glDisable(GL_BLEND);
-	glEnable(GL_DEPTH_TEST);
+	SetBlendState({});
+	SetDepthState({});
 }
 //-----------------------------------------------------------------------------
 bool DebugText::Init()
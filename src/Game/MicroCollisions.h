@@ -4,6 +4,7 @@
 // Header
 //=============================================================================
 #include "MicroMath.h"
+#include "MicroGeometry.h"
 
 //=============================================================================
 // Closest
@@ -27,6 +28,176 @@ inline Vector3 ClosestPointOnLineSegment(
 
 inline bool CheckPointInTriangle(const Vector3& tri0, const Vector3& tri1, const Vector3& tri2, const Vector3& point);
 
+//=============================================================================
+// Swept Ellipsoid
+//=============================================================================
+
+// Lowest root of a*t^2 + b*t + c = 0 in (0, maxR)
+inline bool GetLowestRoot(float a, float b, float c, float maxR, float* root);
+
+// Движение единичной сферы в пространстве эллипсоида (мировые координаты, деленные на радиусы эллипсоида)
+struct CollisionPacket
+{
+	Vector3 velocity;
+	Vector3 normalizedVelocity;
+	Vector3 basePoint;
+
+	// ближайшее столкновение
+	bool foundCollision = false;
+	float nearestDistance = 0.0f;
+	float t = 0.0f;
+	Vector3 intersectionPoint;
+	Vector3 triangleNormal; // нормаль треугольника в пространстве эллипсоида
+};
+
+// Треугольник в пространстве эллипсоида с заранее вычисленной плоскостью
+struct CollisionTriangle
+{
+	Vector3 p1, p2, p3;
+	Plane plane;
+};
+
+// Swept sphere vs triangle (Fauerby, "Improved Collision detection and Response"). Only front-facing triangles
+inline void CheckCollisionsTriangle(CollisionPacket& packet, const CollisionTriangle& triangle);
+
+//=============================================================================
+// Time Of Impact
+//=============================================================================
+
+// Первое касание движущегося тела за все перемещение одним запросом (без разбиения на подшаги)
+struct SweepHit
+{
+	float time = 1.0f;              // доля перемещения [0, 1] до касания
+	Vector3 normal;                 // нормаль препятствия в точке касания (к движущемуся телу)
+	Vector3 contact;                // точка касания
+	uint32_t triangle = UINT32_MAX; // индекс треугольника, для AABB - UINT32_MAX
+};
+
+// Эллипсоид center -> center + displacement против треугольников (по 3 вершины на треугольник).
+// Как и у CharacterController, учитываются только треугольники, повернутые лицевой стороной к движению
+inline bool SweepEllipsoidTriangles(const Vector3& center, const Vector3& radius, const Vector3& displacement, const Vector3* triangleVertices, size_t triangleCount, SweepHit& outHit);
+inline bool SweepSphereTriangles(const Sphere& sphere, const Vector3& displacement, const Vector3* triangleVertices, size_t triangleCount, SweepHit& outHit);
+// AABB moving -> moving + displacement против неподвижного target (для двух движущихся - смещение одного относительно другого).
+// Пересекающиеся в начале AABB дают time = 0 и нормаль по оси наименьшего проникновения
+inline bool SweepAABB(const AABB& moving, const Vector3& displacement, const AABB& target, SweepHit& outHit);
+
+//=============================================================================
+// Collision Triangle SoA
+//=============================================================================
+
+// Треугольники в SoA виде с заранее вычисленными плоскостью, направлениями и длинами ребер и плоскостями ребер
+// (перпендикулярны треугольнику, нормаль наружу). Пакетные проверки обрабатывают по 8 (AVX) или 4 (SSE2) треугольника
+// за проход, остаток - скалярно тем же кодом
+class CollisionTriangleSoA
+{
+public:
+	void Reserve(size_t count);
+	void Clear();
+	void Add(const Vector3& p1, const Vector3& p2, const Vector3& p3);
+	void Build(const std::vector<Vector3>& triangleVertices); // по 3 вершины на треугольник
+	CollisionTriangle Get(size_t index) const;
+
+	size_t GetSize() const { return normalX.size(); }
+
+	// проекция точки на плоскость лежит в треугольнике (для треугольников [first, last), результат 0/1)
+	void CheckPointInTriangle(const Vector3& point, size_t first, size_t last, uint8_t* outInside) const;
+	// ближайшая точка треугольника: проекция на плоскость или ClosestPointOnLineSegment ближайшего ребра
+	void ClosestPoint(const Vector3& point, size_t first, size_t last, Vector3* outPoints) const;
+	void DistanceSquared(const Vector3& point, size_t first, size_t last, float* outDistanceSquared) const;
+	// индексы треугольников, пересекающих сферу
+	size_t OverlapSphere(const Vector3& center, float radius, uint32_t* outIndices) const;
+	size_t OverlapSphere(const Vector3& center, float radius, std::vector<uint32_t>& outIndices) const;
+
+	std::vector<float> vertexX[3], vertexY[3], vertexZ[3];
+	std::vector<float> normalX, normalY, normalZ, planeD;
+	std::vector<float> edgeDirX[3], edgeDirY[3], edgeDirZ[3], edgeLength[3]; // ребро i: vertex[i] -> vertex[(i + 1) % 3]
+	std::vector<float> edgeNormalX[3], edgeNormalY[3], edgeNormalZ[3], edgeD[3];
+};
+
+//=============================================================================
+// Collision Mesh
+//=============================================================================
+
+// Статическая геометрия для CharacterController: BVH в мировых координатах для широкой фазы и
+// треугольники в пространстве эллипсоида для каждого используемого радиуса (без деления на радиус при каждом запросе).
+// Кэш заполняется PrepareEllipsoid при создании контроллеров, запросы только читают
+class CollisionMesh
+{
+public:
+	void Create(const std::vector<Vector3>& triangleVertices); // по 3 вершины на треугольник (как Model::GetTriangles())
+	void Destroy();
+
+	// слот кэша для радиуса, повторный вызов с тем же радиусом возвращает тот же слот
+	uint32_t PrepareEllipsoid(const Vector3& radius);
+	// первое касание эллипсоида (SweepEllipsoidTriangles по кандидатам BVH). candidates - буфер вызывающего, поэтому запрос можно делать из нескольких потоков.
+	// Треугольники в пространстве эллипсоида берутся из кэша, если радиус подготовлен PrepareEllipsoid
+	bool SweepEllipsoid(const Vector3& center, const Vector3& radius, const Vector3& displacement, std::vector<uint32_t>& candidates, SweepHit& outHit) const;
+
+	const BVH& GetBVH() const { return m_bvh; }
+	const std::vector<CollisionTriangle>& GetEllipsoidTriangles(uint32_t slot) const { return m_ellipsoids[slot].triangles; }
+	const std::vector<Vector3>& GetTriangles() const { return m_triangles; }
+
+private:
+	struct EllipsoidCache
+	{
+		Vector3 radius;
+		std::vector<CollisionTriangle> triangles;
+	};
+
+	std::vector<Vector3> m_triangles;
+	BVH m_bvh;
+	std::vector<EllipsoidCache> m_ellipsoids;
+};
+
+//=============================================================================
+// Character Controller
+//=============================================================================
+
+// Эллипсоид, скользящий по статической геометрии (collide and slide).
+// Узкая фаза не выделяет память: буфер кандидатов BVH переиспользуется между вызовами
+class CharacterController
+{
+public:
+	static constexpr int MaxIterations = 5;
+	static constexpr float SlopeWalkAngle = 0.8f;         // косинус наибольшего уклона, на котором персонаж стоит
+	static constexpr float VeryCloseDistance = 0.0000005f; // зазор до поверхности в пространстве эллипсоида
+
+	void Create(const Vector3& radius, const std::vector<CollisionMesh*>& colliders);
+	void Destroy();
+
+	// перемещение за шаг: горизонтальная часть со скольжением, затем вертикальная (гравитация) отдельным проходом
+	void Move(const Vector3& displacement);
+	// первое касание при перемещении без скольжения (рывок, проверка пути); hit.triangle - индекс в сетке коллайдера
+	bool Sweep(const Vector3& displacement, SweepHit& outHit);
+
+	const Vector3& GetRadius() const { return m_radius; }
+	bool IsGrounded() const { return m_grounded; }
+
+	Vector3 position;
+
+private:
+	struct Collider
+	{
+		CollisionMesh* mesh;
+		uint32_t slot;
+	};
+
+	Vector3 collideWithWorld(Vector3 basePoint, Vector3 velocity, bool checkGrounded); // в пространстве эллипсоида
+	void checkCollision(CollisionPacket& packet);
+
+	std::vector<Collider> m_colliders;
+	std::vector<uint32_t> m_candidates;
+	Vector3 m_radius = Vector3(1.0f);
+	bool m_grounded = false;
+};
+
+// Персонаж для пакетного шага StepCharacters (MicroEngine.h)
+struct CharacterState
+{
+	CharacterController controller;
+	Vector3 velocity; // м/с, вертикальная составляющая - падение
+};
+
 //=============================================================================
 // Impl
 //=============================================================================
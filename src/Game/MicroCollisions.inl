@@ -77,4 +77,739 @@ inline bool CheckPointInTriangle(const Vector3& tri0, const Vector3& tri1, const
 
 	return u >= 0.0f && v >= 0.0f && w >= 0.0f;
 #endif
-}
\ No newline at end of file
+}
+
+//=============================================================================
+// Swept Ellipsoid
+//=============================================================================
+
+inline bool GetLowestRoot(float a, float b, float c, float maxR, float* root)
+{
+	// Check if a solution exists
+	const float determinant = b * b - 4.0f * a * c;
+	// If determinant is negative it means no solutions.
+	if( determinant < 0.0f ) return false;
+
+	// calculate the two roots: (if determinant == 0 then x1==x2 but let's disregard that slight optimization)
+	const float sqrtD = sqrtf(determinant);
+	float r1 = (-b - sqrtD) / (2.0f * a);
+	float r2 = (-b + sqrtD) / (2.0f * a);
+
+	// Sort so x1 <= x2
+	if( r1 > r2 ) std::swap(r1, r2);
+
+	// Get lowest root:
+	if( r1 > 0.0f && r1 < maxR )
+	{
+		*root = r1;
+		return true;
+	}
+	// It is possible that we want x2 - this can happen if x1 < 0
+	if( r2 > 0.0f && r2 < maxR )
+	{
+		*root = r2;
+		return true;
+	}
+	// No (valid) solutions
+	return false;
+}
+
+inline void CheckCollisionsTriangle(CollisionPacket& packet, const CollisionTriangle& triangle)
+{
+	const Plane& trianglePlane = triangle.plane;
+	const Vector3& p1 = triangle.p1;
+	const Vector3& p2 = triangle.p2;
+	const Vector3& p3 = triangle.p3;
+
+	// only check front-facing triangles
+	if( !trianglePlane.IsFrontFacingTo(packet.normalizedVelocity) )
+		return;
+
+	// Get interval of plane intersection:
+	float t0, t1;
+	bool embeddedInPlane = false;
+
+	// Calculate the signed distance from sphere position to triangle plane
+	const float signedDistToTrianglePlane = trianglePlane.SignedDistanceTo(packet.basePoint);
+
+	// cache this as we're going to use it a few times below:
+	const float normalDotVelocity = DotProduct(trianglePlane.normal, packet.velocity);
+	// if sphere is travelling parrallel to the plane:
+	if( normalDotVelocity == 0.0f )
+	{
+		// Sphere is not embedded in plane. No collision possible
+		if( fabsf(signedDistToTrianglePlane) >= 1.0f )
+			return;
+
+		// sphere is embedded in plane. It intersects in the whole range [0..1]
+		embeddedInPlane = true;
+		t0 = 0.0f;
+		t1 = 1.0f;
+	}
+	else
+	{
+		// N dot D is not 0. Calculate intersection interval:
+		t0 = (-1.0f - signedDistToTrianglePlane) / normalDotVelocity;
+		t1 = (+1.0f - signedDistToTrianglePlane) / normalDotVelocity;
+
+		// Swap so t0 < t1
+		if( t0 > t1 ) std::swap(t0, t1);
+
+		// Both t values are outside values [0,1]. No collision possible
+		if( t0 > 1.0f || t1 < 0.0f )
+			return;
+
+		// Clamp to [0,1]
+		t0 = Clamp(t0, 0.0f, 1.0f);
+		t1 = Clamp(t1, 0.0f, 1.0f);
+	}
+
+	// At this point we have two time values t0 and t1 between which the swept sphere intersects with the triangle plane.
+	// If any collision is to occur it must happen within this interval.
+	Vector3 collisionPoint;
+	bool foundCollison = false;
+	float t = 1.0f;
+
+	// First we check for the easy case - collision inside the triangle. If this happens it must be at time t0 as this is when
+	// the sphere rests on the front side of the triangle plane. Note, this can only happen if the sphere is not embedded in the triangle plane.
+	if( !embeddedInPlane )
+	{
+		const Vector3 planeIntersectionPoint = (packet.basePoint - trianglePlane.normal) + t0 * packet.velocity;
+		if( CheckPointInTriangle(p1, p2, p3, planeIntersectionPoint) )
+		{
+			foundCollison = true;
+			t = t0;
+			collisionPoint = planeIntersectionPoint;
+		}
+	}
+
+	// if we haven't found a collision already we'll have to sweep sphere against points and edges of the triangle.
+	// Note: A collision inside the triangle (the check above) will always happen before a vertex or edge collision!
+	if( !foundCollison )
+	{
+		const Vector3& velocity = packet.velocity;
+		const Vector3& base = packet.basePoint;
+		const float velocitySquaredLength = DotProduct(velocity, velocity);
+		float newT;
+
+		// For each vertex or edge a quadratic equation have to be solved. We parameterize this equation as a*t^2 + b*t + c = 0
+
+		// Check against points:
+		const Vector3* points[3] = { &p1, &p2, &p3 };
+		for( int i = 0; i < 3; i++ )
+		{
+			const Vector3& point = *points[i];
+			const float b = 2.0f * DotProduct(velocity, base - point);
+			const float c = DotProduct(point - base, point - base) - 1.0f;
+			if( GetLowestRoot(velocitySquaredLength, b, c, t, &newT) )
+			{
+				t = newT;
+				foundCollison = true;
+				collisionPoint = point;
+			}
+		}
+
+		// Check agains edges: p1 -> p2, p2 -> p3, p3 -> p1
+		for( int i = 0; i < 3; i++ )
+		{
+			const Vector3& from = *points[i];
+			const Vector3 edge = *points[(i + 1) % 3] - from;
+			const Vector3 baseToVertex = from - base;
+			const float edgeSquaredLength = DotProduct(edge, edge);
+			const float edgeDotVelocity = DotProduct(edge, velocity);
+			const float edgeDotBaseToVertex = DotProduct(edge, baseToVertex);
+
+			// Calculate parameters for equation
+			const float a = edgeSquaredLength * -velocitySquaredLength + edgeDotVelocity * edgeDotVelocity;
+			const float b = edgeSquaredLength * (2.0f * DotProduct(velocity, baseToVertex)) - 2.0f * edgeDotVelocity * edgeDotBaseToVertex;
+			const float c = edgeSquaredLength * (1.0f - DotProduct(baseToVertex, baseToVertex)) + edgeDotBaseToVertex * edgeDotBaseToVertex;
+
+			// Does the swept sphere collide against infinite edge?
+			if( GetLowestRoot(a, b, c, t, &newT) )
+			{
+				// Check if intersection is within line segment:
+				const float f = (edgeDotVelocity * newT - edgeDotBaseToVertex) / edgeSquaredLength;
+				if( f >= 0.0f && f <= 1.0f )
+				{
+					t = newT;
+					foundCollison = true;
+					collisionPoint = from + f * edge;
+				}
+			}
+		}
+	}
+
+	if( !foundCollison )
+		return;
+
+	// distance to collision: 't' is time of collision. Does this triangle qualify for the closest hit?
+	const float distToCollision = t * packet.velocity.GetLength();
+	if( !packet.foundCollision || distToCollision < packet.nearestDistance )
+	{
+		packet.nearestDistance = distToCollision;
+		packet.intersectionPoint = collisionPoint;
+		packet.foundCollision = true;
+		packet.t = t;
+		packet.triangleNormal = trianglePlane.normal;
+	}
+}
+
+//=============================================================================
+// Time Of Impact
+//=============================================================================
+
+namespace sweep
+{
+	inline CollisionPacket CreatePacket(const Vector3& center, const Vector3& radius, const Vector3& displacement)
+	{
+		CollisionPacket packet;
+		packet.basePoint = center / radius;
+		packet.velocity = displacement / radius;
+		packet.normalizedVelocity = packet.velocity.GetNormalize();
+		packet.nearestDistance = std::numeric_limits<float>::max();
+		return packet;
+	}
+
+	// CheckCollisionsTriangle с запоминанием треугольника ближайшего касания
+	inline void CheckTriangle(CollisionPacket& packet, const CollisionTriangle& triangle, uint32_t index, uint32_t& hitTriangle)
+	{
+		const float nearestDistance = packet.nearestDistance;
+		CheckCollisionsTriangle(packet, triangle);
+		if( packet.nearestDistance != nearestDistance )
+			hitTriangle = index;
+	}
+
+	inline CollisionTriangle ToEllipsoidSpace(const Vector3* triangleVertices, const Vector3& radius)
+	{
+		CollisionTriangle triangle;
+		triangle.p1 = triangleVertices[0] / radius;
+		triangle.p2 = triangleVertices[1] / radius;
+		triangle.p3 = triangleVertices[2] / radius;
+		triangle.plane = Plane(triangle.p1, triangle.p2, triangle.p3);
+		return triangle;
+	}
+
+	// касание из пространства эллипсоида в мировые координаты
+	inline void ToWorld(const CollisionPacket& packet, const Vector3& radius, uint32_t hitTriangle, SweepHit& outHit)
+	{
+		const Vector3 center = packet.basePoint + packet.velocity * packet.t;
+		outHit.time = packet.t;
+		outHit.contact = packet.intersectionPoint * radius;
+		// нормаль единичной сферы (центр - точка касания) переводится в мировые координаты делением на радиус
+		outHit.normal = ((center - packet.intersectionPoint) / radius).GetNormalize();
+		outHit.triangle = hitTriangle;
+	}
+}
+
+inline bool SweepEllipsoidTriangles(const Vector3& center, const Vector3& radius, const Vector3& displacement, const Vector3* triangleVertices, size_t triangleCount, SweepHit& outHit)
+{
+	if( displacement == Vector3(0.0f) ) return false;
+
+	CollisionPacket packet = sweep::CreatePacket(center, radius, displacement);
+	uint32_t hitTriangle = UINT32_MAX;
+	for( size_t i = 0; i < triangleCount; i++ )
+		sweep::CheckTriangle(packet, sweep::ToEllipsoidSpace(triangleVertices + i * 3, radius), (uint32_t)i, hitTriangle);
+
+	if( !packet.foundCollision ) return false;
+	sweep::ToWorld(packet, radius, hitTriangle, outHit);
+	return true;
+}
+
+inline bool SweepSphereTriangles(const Sphere& sphere, const Vector3& displacement, const Vector3* triangleVertices, size_t triangleCount, SweepHit& outHit)
+{
+	return SweepEllipsoidTriangles(sphere.position, Vector3(sphere.radius), displacement, triangleVertices, triangleCount, outHit);
+}
+
+inline bool SweepAABB(const AABB& moving, const Vector3& displacement, const AABB& target, SweepHit& outHit)
+{
+	// сумма Минковского: target расширяется на половину размера moving, moving сжимается в точку (центр) - остается отрезок против AABB
+	const Vector3 extent = moving.GetExtent();
+	const Vector3 boxMin = target.min - extent;
+	const Vector3 boxMax = target.max + extent;
+	const Vector3 origin = moving.GetCenter();
+
+	float tMin = 0.0f;
+	float tMax = 1.0f;
+	int entryAxis = -1;
+	for( int axis = 0; axis < 3; axis++ )
+	{
+		if( fabsf(displacement[axis]) < 1e-12f )
+		{
+			if( origin[axis] <= boxMin[axis] || origin[axis] >= boxMax[axis] ) return false;
+			continue;
+		}
+
+		const float invDisplacement = 1.0f / displacement[axis];
+		float t0 = (boxMin[axis] - origin[axis]) * invDisplacement;
+		float t1 = (boxMax[axis] - origin[axis]) * invDisplacement;
+		if( t0 > t1 ) std::swap(t0, t1);
+
+		if( t0 > tMin )
+		{
+			tMin = t0;
+			entryAxis = axis;
+		}
+		tMax = Min(tMax, t1);
+		// пустой интервал - промах, нулевой - касание ребром или уход от касания
+		if( tMin >= tMax ) return false;
+	}
+
+	Vector3 normal(0.0f);
+	if( entryAxis >= 0 )
+	{
+		normal[entryAxis] = displacement[entryAxis] > 0.0f ? -1.0f : 1.0f;
+	}
+	else
+	{
+		// пересекаются в начале - выталкивание по оси наименьшего проникновения
+		float minDepth = std::numeric_limits<float>::max();
+		for( int axis = 0; axis < 3; axis++ )
+		{
+			const float depthToMin = origin[axis] - boxMin[axis];
+			const float depthToMax = boxMax[axis] - origin[axis];
+			if( depthToMin < minDepth )
+			{
+				minDepth = depthToMin;
+				normal = Vector3(0.0f);
+				normal[axis] = -1.0f;
+			}
+			if( depthToMax < minDepth )
+			{
+				minDepth = depthToMax;
+				normal = Vector3(0.0f);
+				normal[axis] = 1.0f;
+			}
+		}
+	}
+
+	outHit.time = tMin;
+	outHit.normal = normal;
+	// точка грани moving, которой он касается target, зажатая в target
+	outHit.contact = Min(Max(origin + displacement * tMin - normal * extent, target.min), target.max);
+	outHit.triangle = UINT32_MAX;
+	return true;
+}
+
+//=============================================================================
+// Collision Triangle SoA
+//=============================================================================
+
+namespace collisionSoA
+{
+	template<class L>
+	struct Point
+	{
+		typename L::Float x, y, z;
+	};
+
+	// все плоскости ребер не дальше 0 - проекция точки внутри треугольника
+	template<class L>
+	inline typename L::Mask CheckPointInTriangle(const CollisionTriangleSoA& soa, size_t i, const Point<L>& p)
+	{
+		typename L::Mask inside = L::LessEqual(L::Set(-1.0f), L::Set(0.0f));
+		for( int e = 0; e < 3; e++ )
+		{
+			typename L::Float distance = L::Mul(L::Load(soa.edgeNormalX[e].data() + i), p.x);
+			distance = L::Add(distance, L::Mul(L::Load(soa.edgeNormalY[e].data() + i), p.y));
+			distance = L::Add(distance, L::Mul(L::Load(soa.edgeNormalZ[e].data() + i), p.z));
+			distance = L::Add(distance, L::Load(soa.edgeD[e].data() + i));
+			inside = L::And(inside, L::LessEqual(distance, L::Set(0.0f)));
+		}
+		return inside;
+	}
+
+	// ClosestPointOnLineSegment по нормализованному направлению и длине ребра
+	template<class L>
+	inline Point<L> ClosestPointOnLineSegment(const CollisionTriangleSoA& soa, size_t i, int e, const Point<L>& p)
+	{
+		const Point<L> a = { L::Load(soa.vertexX[e].data() + i), L::Load(soa.vertexY[e].data() + i), L::Load(soa.vertexZ[e].data() + i) };
+		const Point<L> direction = { L::Load(soa.edgeDirX[e].data() + i), L::Load(soa.edgeDirY[e].data() + i), L::Load(soa.edgeDirZ[e].data() + i) };
+		typename L::Float t = L::Mul(L::Sub(p.x, a.x), direction.x);
+		t = L::Add(t, L::Mul(L::Sub(p.y, a.y), direction.y));
+		t = L::Add(t, L::Mul(L::Sub(p.z, a.z), direction.z));
+		t = L::Min(L::Max(t, L::Set(0.0f)), L::Load(soa.edgeLength[e].data() + i));
+		return { L::Add(a.x, L::Mul(direction.x, t)), L::Add(a.y, L::Mul(direction.y, t)), L::Add(a.z, L::Mul(direction.z, t)) };
+	}
+
+	template<class L>
+	inline typename L::Float DistanceSquared(const Point<L>& a, const Point<L>& b)
+	{
+		const typename L::Float dx = L::Sub(a.x, b.x);
+		const typename L::Float dy = L::Sub(a.y, b.y);
+		const typename L::Float dz = L::Sub(a.z, b.z);
+		return L::Add(L::Add(L::Mul(dx, dx), L::Mul(dy, dy)), L::Mul(dz, dz));
+	}
+
+	template<class L>
+	inline Point<L> ClosestPoint(const CollisionTriangleSoA& soa, size_t i, const Point<L>& p)
+	{
+		// ближайшая из точек трех ребер
+		Point<L> closest = ClosestPointOnLineSegment<L>(soa, i, 0, p);
+		typename L::Float closestDistance = DistanceSquared<L>(closest, p);
+		for( int e = 1; e < 3; e++ )
+		{
+			const Point<L> edgePoint = ClosestPointOnLineSegment<L>(soa, i, e, p);
+			const typename L::Float edgeDistance = DistanceSquared<L>(edgePoint, p);
+			const typename L::Mask isCloser = L::Less(edgeDistance, closestDistance);
+			closest.x = L::Select(isCloser, edgePoint.x, closest.x);
+			closest.y = L::Select(isCloser, edgePoint.y, closest.y);
+			closest.z = L::Select(isCloser, edgePoint.z, closest.z);
+			closestDistance = L::Min(edgeDistance, closestDistance);
+		}
+
+		// проекция на плоскость, если она внутри треугольника
+		const Point<L> normal = { L::Load(soa.normalX.data() + i), L::Load(soa.normalY.data() + i), L::Load(soa.normalZ.data() + i) };
+		typename L::Float planeDistance = L::Mul(normal.x, p.x);
+		planeDistance = L::Add(planeDistance, L::Mul(normal.y, p.y));
+		planeDistance = L::Add(planeDistance, L::Mul(normal.z, p.z));
+		planeDistance = L::Add(planeDistance, L::Load(soa.planeD.data() + i));
+		const typename L::Mask inside = CheckPointInTriangle<L>(soa, i, p);
+		closest.x = L::Select(inside, L::Sub(p.x, L::Mul(normal.x, planeDistance)), closest.x);
+		closest.y = L::Select(inside, L::Sub(p.y, L::Mul(normal.y, planeDistance)), closest.y);
+		closest.z = L::Select(inside, L::Sub(p.z, L::Mul(normal.z, planeDistance)), closest.z);
+		return closest;
+	}
+
+	template<class L>
+	inline Point<L> SetPoint(const Vector3& point)
+	{
+		return { L::Set(point.x), L::Set(point.y), L::Set(point.z) };
+	}
+
+	// проход по [first, last) самым широким доступным Lanes, kernel(lanes, i) вызывается на каждые Width треугольников
+	template<class Kernel>
+	inline void ForEach(size_t first, size_t last, Kernel&& kernel)
+	{
+		size_t i = first;
+#if defined(MICROMATH_AVX)
+		for( ; i + simd::LanesAVX::Width <= last; i += simd::LanesAVX::Width )
+			kernel(simd::LanesAVX(), i);
+#endif // MICROMATH_AVX
+#if defined(MICROMATH_SSE2)
+		for( ; i + simd::LanesSSE::Width <= last; i += simd::LanesSSE::Width )
+			kernel(simd::LanesSSE(), i);
+#endif // MICROMATH_SSE2
+		for( ; i < last; i++ )
+			kernel(simd::LanesScalar(), i);
+	}
+}
+
+inline void CollisionTriangleSoA::Reserve(size_t count)
+{
+	for( int e = 0; e < 3; e++ )
+	{
+		for( std::vector<float>* values : { &vertexX[e], &vertexY[e], &vertexZ[e], &edgeDirX[e], &edgeDirY[e], &edgeDirZ[e], &edgeLength[e], &edgeNormalX[e], &edgeNormalY[e], &edgeNormalZ[e], &edgeD[e] } )
+			values->reserve(count);
+	}
+	for( std::vector<float>* values : { &normalX, &normalY, &normalZ, &planeD } )
+		values->reserve(count);
+}
+
+inline void CollisionTriangleSoA::Clear()
+{
+	for( int e = 0; e < 3; e++ )
+	{
+		for( std::vector<float>* values : { &vertexX[e], &vertexY[e], &vertexZ[e], &edgeDirX[e], &edgeDirY[e], &edgeDirZ[e], &edgeLength[e], &edgeNormalX[e], &edgeNormalY[e], &edgeNormalZ[e], &edgeD[e] } )
+			values->clear();
+	}
+	for( std::vector<float>* values : { &normalX, &normalY, &normalZ, &planeD } )
+		values->clear();
+}
+
+inline void CollisionTriangleSoA::Add(const Vector3& p1, const Vector3& p2, const Vector3& p3)
+{
+	const Vector3 vertices[3] = { p1, p2, p3 };
+	const Vector3 cross = CrossProduct(p2 - p1, p3 - p1);
+	const float crossLength = cross.GetLength();
+	const bool isDegenerate = crossLength <= 0.0f;
+	const Vector3 normal = isDegenerate ? Vector3(0.0f) : cross / crossLength;
+
+	normalX.push_back(normal.x);
+	normalY.push_back(normal.y);
+	normalZ.push_back(normal.z);
+	planeD.push_back(-DotProduct(normal, p1));
+
+	for( int e = 0; e < 3; e++ )
+	{
+		const Vector3 edge = vertices[(e + 1) % 3] - vertices[e];
+		const float length = edge.GetLength();
+		const Vector3 direction = length > 0.0f ? edge / length : Vector3(0.0f);
+		// у вырожденного треугольника нет внутренности: плоскости ребер всегда снаружи, остаются только ребра
+		const Vector3 edgeNormal = isDegenerate ? Vector3(0.0f) : CrossProduct(direction, normal);
+
+		vertexX[e].push_back(vertices[e].x);
+		vertexY[e].push_back(vertices[e].y);
+		vertexZ[e].push_back(vertices[e].z);
+		edgeDirX[e].push_back(direction.x);
+		edgeDirY[e].push_back(direction.y);
+		edgeDirZ[e].push_back(direction.z);
+		edgeLength[e].push_back(length);
+		edgeNormalX[e].push_back(edgeNormal.x);
+		edgeNormalY[e].push_back(edgeNormal.y);
+		edgeNormalZ[e].push_back(edgeNormal.z);
+		edgeD[e].push_back(isDegenerate ? 1.0f : -DotProduct(edgeNormal, vertices[e]));
+	}
+}
+
+inline void CollisionTriangleSoA::Build(const std::vector<Vector3>& triangleVertices)
+{
+	Clear();
+	Reserve(triangleVertices.size() / 3);
+	for( size_t i = 0; i + 2 < triangleVertices.size(); i += 3 )
+		Add(triangleVertices[i + 0], triangleVertices[i + 1], triangleVertices[i + 2]);
+}
+
+inline CollisionTriangle CollisionTriangleSoA::Get(size_t index) const
+{
+	CollisionTriangle triangle;
+	triangle.p1 = { vertexX[0][index], vertexY[0][index], vertexZ[0][index] };
+	triangle.p2 = { vertexX[1][index], vertexY[1][index], vertexZ[1][index] };
+	triangle.p3 = { vertexX[2][index], vertexY[2][index], vertexZ[2][index] };
+	triangle.plane = Plane(triangle.p1, Vector3(normalX[index], normalY[index], normalZ[index]));
+	return triangle;
+}
+
+inline void CollisionTriangleSoA::CheckPointInTriangle(const Vector3& point, size_t first, size_t last, uint8_t* outInside) const
+{
+	collisionSoA::ForEach(first, last, [&](auto lanes, size_t i)
+		{
+			using L = decltype(lanes);
+			const unsigned mask = L::MoveMask(collisionSoA::CheckPointInTriangle<L>(*this, i, collisionSoA::SetPoint<L>(point)));
+			for( size_t j = 0; j < L::Width; j++ )
+				outInside[i - first + j] = (uint8_t)((mask >> j) & 1u);
+		});
+}
+
+inline void CollisionTriangleSoA::ClosestPoint(const Vector3& point, size_t first, size_t last, Vector3* outPoints) const
+{
+	collisionSoA::ForEach(first, last, [&](auto lanes, size_t i)
+		{
+			using L = decltype(lanes);
+			const collisionSoA::Point<L> closest = collisionSoA::ClosestPoint<L>(*this, i, collisionSoA::SetPoint<L>(point));
+			float x[L::Width], y[L::Width], z[L::Width];
+			L::Store(x, closest.x);
+			L::Store(y, closest.y);
+			L::Store(z, closest.z);
+			for( size_t j = 0; j < L::Width; j++ )
+				outPoints[i - first + j] = Vector3(x[j], y[j], z[j]);
+		});
+}
+
+inline void CollisionTriangleSoA::DistanceSquared(const Vector3& point, size_t first, size_t last, float* outDistanceSquared) const
+{
+	collisionSoA::ForEach(first, last, [&](auto lanes, size_t i)
+		{
+			using L = decltype(lanes);
+			const collisionSoA::Point<L> p = collisionSoA::SetPoint<L>(point);
+			L::Store(outDistanceSquared + (i - first), collisionSoA::DistanceSquared<L>(collisionSoA::ClosestPoint<L>(*this, i, p), p));
+		});
+}
+
+inline size_t CollisionTriangleSoA::OverlapSphere(const Vector3& center, float radius, uint32_t* outIndices) const
+{
+	size_t count = 0;
+	collisionSoA::ForEach(0, GetSize(), [&](auto lanes, size_t i)
+		{
+			using L = decltype(lanes);
+			const collisionSoA::Point<L> p = collisionSoA::SetPoint<L>(center);
+			const typename L::Float distanceSquared = collisionSoA::DistanceSquared<L>(collisionSoA::ClosestPoint<L>(*this, i, p), p);
+			const unsigned mask = L::MoveMask(L::LessEqual(distanceSquared, L::Set(radius * radius)));
+			for( size_t j = 0; j < L::Width; j++ )
+			{
+				outIndices[count] = (uint32_t)(i + j);
+				count += (mask >> j) & 1u;
+			}
+		});
+	return count;
+}
+
+inline size_t CollisionTriangleSoA::OverlapSphere(const Vector3& center, float radius, std::vector<uint32_t>& outIndices) const
+{
+	outIndices.resize(GetSize());
+	const size_t count = OverlapSphere(center, radius, outIndices.data());
+	outIndices.resize(count);
+	return count;
+}
+
+//=============================================================================
+// Collision Mesh
+//=============================================================================
+
+inline void CollisionMesh::Create(const std::vector<Vector3>& triangleVertices)
+{
+	Destroy();
+	m_triangles = triangleVertices;
+	m_triangles.resize(m_triangles.size() / 3 * 3);
+	m_bvh.Build(m_triangles);
+}
+
+inline void CollisionMesh::Destroy()
+{
+	m_triangles.clear();
+	m_bvh.Clear();
+	m_ellipsoids.clear();
+}
+
+inline uint32_t CollisionMesh::PrepareEllipsoid(const Vector3& radius)
+{
+	for( size_t i = 0; i < m_ellipsoids.size(); i++ )
+	{
+		if( m_ellipsoids[i].radius == radius )
+			return (uint32_t)i;
+	}
+
+	EllipsoidCache cache;
+	cache.radius = radius;
+	cache.triangles.resize(m_triangles.size() / 3);
+	for( size_t i = 0; i < cache.triangles.size(); i++ )
+	{
+		CollisionTriangle& triangle = cache.triangles[i];
+		triangle.p1 = m_triangles[i * 3 + 0] / radius;
+		triangle.p2 = m_triangles[i * 3 + 1] / radius;
+		triangle.p3 = m_triangles[i * 3 + 2] / radius;
+		triangle.plane = Plane(triangle.p1, triangle.p2, triangle.p3);
+	}
+	m_ellipsoids.push_back(std::move(cache));
+	return (uint32_t)(m_ellipsoids.size() - 1);
+}
+
+inline bool CollisionMesh::SweepEllipsoid(const Vector3& center, const Vector3& radius, const Vector3& displacement, std::vector<uint32_t>& candidates, SweepHit& outHit) const
+{
+	if( displacement == Vector3(0.0f) ) return false;
+
+	m_bvh.QueryEllipsoidSweep(center, radius, displacement, candidates);
+	const EllipsoidCache* cache = nullptr;
+	for( const EllipsoidCache& ellipsoid : m_ellipsoids )
+	{
+		if( ellipsoid.radius == radius ) cache = &ellipsoid;
+	}
+
+	CollisionPacket packet = sweep::CreatePacket(center, radius, displacement);
+	uint32_t hitTriangle = UINT32_MAX;
+	for( const uint32_t index : candidates )
+	{
+		if( cache ) sweep::CheckTriangle(packet, cache->triangles[index], index, hitTriangle);
+		else sweep::CheckTriangle(packet, sweep::ToEllipsoidSpace(m_triangles.data() + (size_t)index * 3, radius), index, hitTriangle);
+	}
+
+	if( !packet.foundCollision ) return false;
+	sweep::ToWorld(packet, radius, hitTriangle, outHit);
+	return true;
+}
+
+//=============================================================================
+// Character Controller
+//=============================================================================
+
+inline void CharacterController::Create(const Vector3& radius, const std::vector<CollisionMesh*>& colliders)
+{
+	Destroy();
+	m_radius = radius;
+	for( size_t i = 0; i < colliders.size(); i++ )
+		m_colliders.push_back({ colliders[i], colliders[i]->PrepareEllipsoid(radius) });
+	m_candidates.reserve(256);
+}
+
+inline void CharacterController::Destroy()
+{
+	m_colliders.clear();
+	m_candidates.clear();
+	m_grounded = false;
+}
+
+inline void CharacterController::Move(const Vector3& displacement)
+{
+	m_grounded = false;
+
+	// горизонтальный проход со скольжением
+	const Vector3 eSpacePosition = position / m_radius;
+	const Vector3 eSpaceVelocity = Vector3(displacement.x, 0.0f, displacement.z) / m_radius;
+	Vector3 finalPosition = collideWithWorld(eSpacePosition, eSpaceVelocity, false);
+
+	// вертикальный проход - по нему определяется опора под ногами
+	const Vector3 eSpaceGravity = Vector3(0.0f, displacement.y, 0.0f) / m_radius;
+	finalPosition = collideWithWorld(finalPosition, eSpaceGravity, true);
+
+	position = finalPosition * m_radius;
+}
+
+inline bool CharacterController::Sweep(const Vector3& displacement, SweepHit& outHit)
+{
+	bool isHit = false;
+	SweepHit hit;
+	for( const Collider& collider : m_colliders )
+	{
+		if( collider.mesh->SweepEllipsoid(position, m_radius, displacement, m_candidates, hit) && (!isHit || hit.time < outHit.time) )
+		{
+			outHit = hit;
+			isHit = true;
+		}
+	}
+	return isHit;
+}
+
+inline Vector3 CharacterController::collideWithWorld(Vector3 basePoint, Vector3 velocity, bool checkGrounded)
+{
+	for( int iteration = 0; iteration <= MaxIterations; iteration++ )
+	{
+		CollisionPacket packet;
+		packet.velocity = velocity;
+		packet.normalizedVelocity = velocity.GetNormalize();
+		packet.basePoint = basePoint;
+		packet.nearestDistance = std::numeric_limits<float>::max();
+		checkCollision(packet);
+
+		// If no collision we just move along the velocity
+		if( !packet.foundCollision )
+			return basePoint + velocity;
+
+		// The original destination point
+		const Vector3 destinationPoint = basePoint + velocity;
+		Vector3 newBasePoint = basePoint;
+		// only update if we are not already very close and if so we only move very close to intersection..not to the exact spot.
+		if( packet.nearestDistance >= VeryCloseDistance )
+		{
+			const Vector3 direction = velocity.GetNormalize();
+			newBasePoint = basePoint + direction * (packet.nearestDistance - VeryCloseDistance);
+			// Adjust polygon intersection point (so sliding plane will be unaffected by the fact that we move slightly less than collision tells us)
+			packet.intersectionPoint -= VeryCloseDistance * direction;
+		}
+
+		// Determine the sliding plane
+		const Vector3 slidePlaneNormal = (newBasePoint - packet.intersectionPoint).GetNormalize();
+		const Plane slidingPlane(packet.intersectionPoint, slidePlaneNormal);
+		const Vector3 newDestinationPoint = destinationPoint - slidingPlane.SignedDistanceTo(destinationPoint) * slidePlaneNormal;
+
+		// опора: касание ниже центра при движении вниз о треугольник с допустимым уклоном (нормаль переводится в мировые координаты)
+		if( checkGrounded && velocity.y <= 0.0f && packet.intersectionPoint.y < newBasePoint.y )
+		{
+			const Vector3 worldNormal = (packet.triangleNormal / m_radius).GetNormalize();
+			if( worldNormal.y >= SlopeWalkAngle )
+				m_grounded = true;
+		}
+
+		// Generate the slide vector, which will become our new velocity vector for the next iteration
+		velocity = newDestinationPoint - packet.intersectionPoint;
+		basePoint = newBasePoint;
+
+		// dont recurse if the new velocity is very small
+		if( velocity.GetLength() < VeryCloseDistance )
+			break;
+	}
+	return basePoint;
+}
+
+inline void CharacterController::checkCollision(CollisionPacket& packet)
+{
+	// широкая фаза в мировых координатах - кандидаты рядом с траекторией, затем точная проверка в пространстве эллипсоида
+	const Vector3 worldPosition = packet.basePoint * m_radius;
+	const Vector3 worldVelocity = packet.velocity * m_radius;
+	for( size_t i = 0; i < m_colliders.size(); i++ )
+	{
+		const Collider& collider = m_colliders[i];
+		collider.mesh->GetBVH().QueryEllipsoidSweep(worldPosition, m_radius, worldVelocity, m_candidates);
+		const std::vector<CollisionTriangle>& triangles = collider.mesh->GetEllipsoidTriangles(collider.slot);
+		for( size_t j = 0; j < m_candidates.size(); j++ )
+			CheckCollisionsTriangle(packet, triangles[m_candidates[j]]);
+	}
+}
@@ -16,6 +16,10 @@
 
 #include "MicroEngine.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #if defined(_WIN32)
 #	define WIN32_LEAN_AND_MEAN
 #	define WIN_32_EXTRA_LEAN
@@ -31,6 +35,10 @@
 #endif // __ANDROID__
 
 #if defined(__linux__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
 #endif // __linux__
 
 #if defined(__EMSCRIPTEN__)
@@ -198,6 +206,331 @@ void Fatal(const std::string& msg)
 }
 //-----------------------------------------------------------------------------
 //=============================================================================
+// File System
+//=============================================================================
+//-----------------------------------------------------------------------------
+bool MappedFile::Open(const char* fileName)
+{
+	Close();
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = (const uint8_t*)data;
+	m_size = (size_t)fileSize.QuadPart;
+	return true;
+#elif defined(__linux__)
+	const int file = open(fileName, O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat fileStat = {};
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); // отображение остается действительным после закрытия дескриптора
+	if (data == MAP_FAILED) return false;
+
+	m_data = (const uint8_t*)data;
+	m_size = (size_t)fileStat.st_size;
+	return true;
+#else
+	(void)fileName;
+	return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_mapping) CloseHandle(m_mapping);
+	if (m_file) CloseHandle(m_file);
+	m_file = m_mapping = nullptr;
+#elif defined(__linux__)
+	if (m_data) munmap((void*)m_data, m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
+// Job System
+//=============================================================================
+//-----------------------------------------------------------------------------
+namespace jobs
+{
+	constexpr int64_t QueueSize = 4096; // степень двойки
+	constexpr unsigned MaxThreads = 64;
+	constexpr int SpinCount = 64;      // попыток найти задачу перед засыпанием потока
+
+	// Ячейка очереди - поля атомарны, так как ворующий поток читает ячейку до подтверждения кражи
+	struct JobSlot
+	{
+		std::atomic<void (*)(void*, uint32_t, uint32_t)> function = nullptr;
+		std::atomic<void*> data = nullptr;
+		std::atomic<uint64_t> range = 0; // begin | end << 32
+		std::atomic<JobCounter*> counter = nullptr;
+	};
+
+	struct QueuedJob
+	{
+		Job job;
+		JobCounter* counter = nullptr;
+	};
+
+	// Очередь Chase-Lev (Le, Pop, Cohen, Nardelli - "Correct and Efficient Work-Stealing for Weak Memory Models").
+	// Push и Pop - только поток-владелец (низ очереди), Steal - любой поток (верх очереди)
+	class WorkStealingQueue
+	{
+	public:
+		bool Push(const QueuedJob& job)
+		{
+			const int64_t b = m_bottom.load(std::memory_order_relaxed);
+			const int64_t t = m_top.load(std::memory_order_acquire);
+			if (b - t >= QueueSize) return false;
+
+			store(m_slots[b & (QueueSize - 1)], job);
+			std::atomic_thread_fence(std::memory_order_release);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		bool Pop(QueuedJob& job)
+		{
+			const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = m_top.load(std::memory_order_relaxed);
+
+			bool isFound = false;
+			if (t <= b)
+			{
+				load(m_slots[b & (QueueSize - 1)], job);
+				isFound = true;
+				if (t == b) // последний элемент - гонка с Steal
+				{
+					if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+						isFound = false;
+					m_bottom.store(b + 1, std::memory_order_relaxed);
+				}
+			}
+			else
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+			return isFound;
+		}
+
+		bool Steal(QueuedJob& job)
+		{
+			int64_t t = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t b = m_bottom.load(std::memory_order_acquire);
+			if (t >= b) return false;
+
+			load(m_slots[t & (QueueSize - 1)], job);
+			return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+	private:
+		static void store(JobSlot& slot, const QueuedJob& job)
+		{
+			slot.function.store(job.job.function, std::memory_order_relaxed);
+			slot.data.store(job.job.data, std::memory_order_relaxed);
+			slot.range.store((uint64_t)job.job.begin | ((uint64_t)job.job.end << 32), std::memory_order_relaxed);
+			slot.counter.store(job.counter, std::memory_order_relaxed);
+		}
+
+		static void load(const JobSlot& slot, QueuedJob& job)
+		{
+			job.job.function = slot.function.load(std::memory_order_relaxed);
+			job.job.data = slot.data.load(std::memory_order_relaxed);
+			const uint64_t range = slot.range.load(std::memory_order_relaxed);
+			job.job.begin = (uint32_t)range;
+			job.job.end = (uint32_t)(range >> 32);
+			job.counter = slot.counter.load(std::memory_order_relaxed);
+		}
+
+		alignas(64) std::atomic<int64_t> m_top = 0;
+		alignas(64) std::atomic<int64_t> m_bottom = 0;
+		JobSlot m_slots[QueueSize];
+	};
+
+	WorkStealingQueue* Queues = nullptr; // [0] - главный поток, [1..] - рабочие потоки
+	std::vector<std::thread> Workers;
+	unsigned ThreadCount = 1;
+	thread_local unsigned ThreadIndex = 0;
+	thread_local bool IsJobThread = false;
+
+	std::atomic<bool> IsExit = false;
+	std::atomic<int> QueuedJobCount = 0;   // задачи в очередях, еще не взятые на выполнение
+	std::atomic<int> SleepingWorkers = 0;
+	std::mutex WakeMutex;
+	std::condition_variable WakeCondition;
+
+	void execute(const QueuedJob& job)
+	{
+		job.job.function(job.job.data, job.job.begin, job.job.end);
+		job.counter->value.fetch_sub(1, std::memory_order_release);
+	}
+
+	// своя очередь, затем кража у остальных начиная с соседа
+	bool tryExecuteOne()
+	{
+		QueuedJob job;
+		bool isFound = Queues[ThreadIndex].Pop(job);
+		for (unsigned i = 1; !isFound && i < ThreadCount; i++)
+			isFound = Queues[(ThreadIndex + i) % ThreadCount].Steal(job);
+		if (!isFound) return false;
+
+		QueuedJobCount.fetch_sub(1);
+		execute(job);
+		return true;
+	}
+
+	void workerThread(unsigned index)
+	{
+		ThreadIndex = index;
+		IsJobThread = true;
+		while (!IsExit.load(std::memory_order_relaxed))
+		{
+			bool isExecuted = false;
+			for (int i = 0; i < SpinCount && !isExecuted; i++)
+			{
+				isExecuted = tryExecuteOne();
+				if (!isExecuted) std::this_thread::yield();
+			}
+			if (isExecuted) continue;
+
+			std::unique_lock<std::mutex> lock(WakeMutex);
+			SleepingWorkers.fetch_add(1);
+			WakeCondition.wait(lock, [] { return QueuedJobCount.load() > 0 || IsExit.load(); });
+			SleepingWorkers.fetch_sub(1);
+		}
+	}
+}
+//-----------------------------------------------------------------------------
+bool JobSystem::Create(unsigned workerCount)
+{
+	Destroy();
+
+	if (workerCount == 0)
+	{
+		const unsigned hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+	if (workerCount >= jobs::MaxThreads) workerCount = jobs::MaxThreads - 1;
+
+	jobs::ThreadCount = workerCount + 1;
+	jobs::Queues = new(std::nothrow) jobs::WorkStealingQueue[jobs::ThreadCount];
+	if (!jobs::Queues)
+	{
+		LogError("JobSystem: out of memory!");
+		jobs::ThreadCount = 1;
+		return false;
+	}
+
+	jobs::ThreadIndex = 0;
+	jobs::IsJobThread = true;
+	jobs::IsExit = false;
+	jobs::QueuedJobCount = 0;
+	jobs::Workers.reserve(workerCount);
+	for (unsigned i = 1; i <= workerCount; i++)
+		jobs::Workers.emplace_back(jobs::workerThread, i);
+	return true;
+}
+//-----------------------------------------------------------------------------
+void JobSystem::Destroy()
+{
+	if (!jobs::Queues) return;
+
+	{
+		std::lock_guard<std::mutex> lock(jobs::WakeMutex);
+		jobs::IsExit = true;
+	}
+	jobs::WakeCondition.notify_all();
+	for (auto& worker : jobs::Workers)
+		worker.join();
+	jobs::Workers.clear();
+
+	delete[] jobs::Queues;
+	jobs::Queues = nullptr;
+	jobs::ThreadCount = 1;
+	jobs::IsJobThread = false;
+}
+//-----------------------------------------------------------------------------
+unsigned JobSystem::GetThreadCount()
+{
+	return jobs::ThreadCount;
+}
+//-----------------------------------------------------------------------------
+void JobSystem::Run(const Job& job, JobCounter& counter)
+{
+	counter.value.fetch_add(1, std::memory_order_relaxed);
+
+	const jobs::QueuedJob queuedJob = { job, &counter };
+	// без системы задач, из чужого потока или при переполнении очереди задача выполняется сразу
+	if (!jobs::Queues || !jobs::IsJobThread || !jobs::Queues[jobs::ThreadIndex].Push(queuedJob))
+	{
+		jobs::execute(queuedJob);
+		return;
+	}
+
+	jobs::QueuedJobCount.fetch_add(1);
+	if (jobs::SleepingWorkers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(jobs::WakeMutex);
+		jobs::WakeCondition.notify_one();
+	}
+}
+//-----------------------------------------------------------------------------
+void JobSystem::Wait(JobCounter& counter)
+{
+	while (counter.value.load(std::memory_order_acquire) > 0)
+	{
+		if (!jobs::Queues || !jobs::IsJobThread || !jobs::tryExecuteOne())
+			std::this_thread::yield();
+	}
+}
+//-----------------------------------------------------------------------------
+void StepCharacters(std::span<CharacterState> characters, float deltaTime)
+{
+	// несколько персонажей на задачу - накладные расходы задачи меньше одного Move
+	constexpr uint32_t GrainSize = 16;
+	JobSystem::ParallelFor((uint32_t)characters.size(), GrainSize, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				characters[i].controller.Move(characters[i].velocity * deltaTime);
+		});
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
 // Input System
 //=============================================================================
 //-----------------------------------------------------------------------------
@@ -626,6 +959,9 @@ bool AppSystemCreate(const AppSystemCreateInfo& createInfo)
 	input::updateMouseVisible();
 	input::updateMousePosition();
 
+	if (!JobSystem::Create())
+		return false;
+
 	RenderSystemInit();
 
 	if (!DebugDraw::Init())
@@ -642,6 +978,7 @@ void AppSystemDestroy()
 	DebugText::Close();
 	DebugDraw::Close();
 	ResourceCacheSystem::Clear();
+	JobSystem::Destroy();
 	WindowSystemDestroy();
 	LogDestroy();
 }
@@ -13,6 +13,8 @@
 #endif // _MSC_VER
 
 #include <assert.h>
+#include <atomic>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -55,6 +57,103 @@ void LogWarning(const std::string& msg);
 void LogError(const std::string& msg);
 void Fatal(const std::string& msg);
 
+//=============================================================================
+// File System
+//=============================================================================
+
+// Файл, отображенный в память только для чтения. Данные доступны до Close() без копирования
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	[[nodiscard]] bool Open(const char* fileName);
+	void Close();
+
+	[[nodiscard]] const uint8_t* GetData() const { return m_data; }
+	[[nodiscard]] size_t GetSize() const { return m_size; }
+	[[nodiscard]] bool IsValid() const { return m_data != nullptr; }
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+#if defined(_WIN32)
+	void* m_file = nullptr;    // HANDLE
+	void* m_mapping = nullptr; // HANDLE
+#endif // _WIN32
+};
+
+//=============================================================================
+// Job System
+//=============================================================================
+
+// Счетчик незавершенных задач. Run увеличивает его, завершение задачи уменьшает.
+// Задача может запускать дочерние задачи на том же счетчике - он обнулится только после завершения всех
+struct JobCounter
+{
+	std::atomic<int> value = 0;
+};
+
+struct Job
+{
+	void (*function)(void* data, uint32_t begin, uint32_t end) = nullptr;
+	void* data = nullptr;
+	uint32_t begin = 0;
+	uint32_t end = 0;
+};
+
+// Пул рабочих потоков по числу ядер, у каждого потока своя очередь Chase-Lev, свободные потоки забирают задачи у других.
+// Run и Wait вызываются из главного потока или из задач
+namespace JobSystem
+{
+	[[nodiscard]] bool Create(unsigned workerCount = 0); // 0 - число ядер минус главный поток
+	void Destroy();
+
+	[[nodiscard]] unsigned GetThreadCount(); // рабочие потоки + главный
+
+	void Run(const Job& job, JobCounter& counter);
+	// ожидание обнуления счетчика - поток в это время выполняет другие задачи
+	void Wait(JobCounter& counter);
+
+	// function(begin, end) по диапазонам [0, count) размером grainSize (0 - автоматически), возврат после завершения всех
+	template<typename Function>
+	void ParallelFor(uint32_t count, uint32_t grainSize, const Function& function)
+	{
+		if (count == 0) return;
+		if (grainSize == 0)
+		{
+			grainSize = count / (GetThreadCount() * 4);
+			if (grainSize == 0) grainSize = 1;
+		}
+		if (grainSize >= count)
+		{
+			function(0u, count);
+			return;
+		}
+
+		Job job;
+		job.function = [](void* data, uint32_t begin, uint32_t end) { (*(const Function*)data)(begin, end); };
+		job.data = (void*)&function;
+
+		JobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			job.begin = begin;
+			job.end = count - begin > grainSize ? begin + grainSize : count;
+			Run(job, counter);
+		}
+		Wait(counter);
+	}
+}
+
+// controller.Move(velocity * deltaTime) для всех персонажей, персонажи распределяются по потокам JobSystem.
+// Каждый контроллер меняет только себя и свой буфер кандидатов, CollisionMesh только читается (ellipsoid кэш готовится в Create),
+// поэтому результат не зависит от числа потоков. Персонажи друг с другом не сталкиваются
+void StepCharacters(std::span<CharacterState> characters, float deltaTime);
+
 //=============================================================================
 // Input System
 //=============================================================================
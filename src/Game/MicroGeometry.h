@@ -1,5 +1,17 @@
 #pragma once
 
+#if defined(_MSC_VER)
+#	pragma warning(push, 0)
+#endif // _MSC_VER
+#include <stdint.h>
+#include <float.h>
+#include <algorithm>
+#include <bit>
+#include <vector>
+#if defined(_MSC_VER)
+#	pragma warning(pop)
+#endif // _MSC_VER
+
 #include "MicroMath.h"
 
 // Intersection test result.
@@ -97,6 +109,21 @@ public:
 	float radius = 0.0f;
 };
 
+//=============================================================================
+// Capsule
+//=============================================================================
+class Capsule
+{
+public:
+	Capsule() = default;
+	Capsule(const Vector3& inStart, const Vector3& inEnd, float inRadius) : start(inStart), end(inEnd), radius(inRadius) {}
+
+	// центры полусфер
+	Vector3 start;
+	Vector3 end;
+	float radius = 0.0f;
+};
+
 //=============================================================================
 // AABB
 //=============================================================================
@@ -144,9 +171,64 @@ inline float GetSqDistanceTo(const AABB& aabb, const Vector3& inPoint); // Get t
 inline bool operator==(const AABB& Left, const AABB& Right) noexcept;
 inline bool operator!=(const AABB& Left, const AABB& Right) noexcept;
 
+//=============================================================================
+// AABB SoA
+//=============================================================================
+
+// Массив AABB в SoA виде (отдельный массив на каждую компоненту) для пакетных SIMD проверок
+class AABBArraySoA
+{
+public:
+	void Reserve(size_t count);
+	void Clear();
+	void Add(const AABB& aabb);
+	void Set(size_t index, const AABB& aabb);
+	AABB Get(size_t index) const;
+
+	size_t GetSize() const { return minX.size(); }
+
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+};
+
 //=============================================================================
 // Frustum
 //=============================================================================
+class Frustum
+{
+public:
+	enum PlaneId
+	{
+		PlaneLeft = 0,
+		PlaneRight,
+		PlaneBottom,
+		PlaneTop,
+		PlaneNear,
+		PlaneFar,
+		PlaneCount
+	};
+
+	Frustum() = default;
+	explicit Frustum(const Matrix4& viewProjection) { Set(viewProjection); }
+
+	// Плоскости извлекаются из матрицы (Gribb/Hartmann), клип по z в [-w, w] как у Matrix4::Perspective
+	void Set(const Matrix4& viewProjection);
+
+	Intersection IsInside(const Vector3& point) const;
+	Intersection IsInside(const Sphere& sphere) const;
+	Intersection IsInside(const AABB& aabb) const;
+
+	// Только проверка на OUTSIDE (быстрее, не различает INSIDE и INTERSECTS)
+	bool IsVisible(const Sphere& sphere) const;
+	bool IsVisible(const AABB& aabb) const;
+
+	// Пакетное отсечение: индексы видимых AABB пишутся в outVisible (размер не меньше boxes.GetSize()).
+	// SSE2/AVX по 4/8 боксов за раз, остаток и сборки без SIMD - скалярно. Возвращает количество видимых.
+	size_t CullAABBs(const AABBArraySoA& boxes, uint32_t* outVisible) const;
+	size_t CullAABBs(const AABBArraySoA& boxes, std::vector<uint32_t>& outVisible) const;
+
+	Vector4 planes[PlaneCount]; // xyz - нормаль внутрь, w - d. Точка внутри, если dot(n, p) + d >= 0
+};
 
 
 //=============================================================================
@@ -168,4 +250,285 @@ public:
 	Vector3 normal;
 };
 
+//=============================================================================
+// Ray
+//=============================================================================
+class Ray
+{
+public:
+	Ray() = default;
+	Ray(const Vector3& inOrigin, const Vector3& inDirection) : origin(inOrigin), direction(inDirection) {}
+
+	Vector3 GetPoint(float distance) const { return origin + direction * distance; }
+
+	Vector3 origin;
+	Vector3 direction; // расстояния вдоль луча измеряются в длинах direction
+};
+
+// Пакет до MaxSize лучей в SoA виде. Ядра обрабатывают simd::LanesWide лучей за инструкцию,
+// BVH обходится пакетом целиком: узел посещается, если в него попадает хотя бы один луч
+class RayPacket
+{
+public:
+	static constexpr size_t MaxSize = 8;
+	static constexpr uint32_t NoHit = UINT32_MAX;
+
+	RayPacket() { Clear(); }
+
+	void Clear();
+	bool Add(const Ray& ray, float maxDistance); // false - пакет заполнен
+	Ray GetRay(size_t index) const { return Ray({ originX[index], originY[index], originZ[index] }, { directionX[index], directionY[index], directionZ[index] }); }
+	size_t GetSize() const { return m_size; }
+	bool IsHit(size_t index) const { return triangle[index] != NoHit; }
+
+	alignas(32) float originX[MaxSize];
+	alignas(32) float originY[MaxSize];
+	alignas(32) float originZ[MaxSize];
+	alignas(32) float directionX[MaxSize];
+	alignas(32) float directionY[MaxSize];
+	alignas(32) float directionZ[MaxSize];
+	alignas(32) float distance[MaxSize]; // до запроса - maxDistance, после - параметр ближайшего пересечения (пустые слоты - отрицательные)
+	uint32_t triangle[MaxSize];          // индекс треугольника пересечения или NoHit
+
+private:
+	size_t m_size = 0;
+};
+
+// Пересечение луча с треугольником (Moller-Trumbore), обе стороны треугольника. distance - параметр луча
+inline bool RayTriangleIntersect(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance);
+// все лучи пакета против одного треугольника: более близкие пересечения записываются в distance/triangle пакета
+inline void RayTriangleIntersect(RayPacket& packet, const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t triangleIndex);
+// Пересечение отрезка origin + t * direction, t в [tMin, tMax] с AABB (метод плит)
+inline bool SegmentAABBIntersect(const Vector3& origin, const Vector3& direction, float tMin, float tMax, const Vector3& boxMin, const Vector3& boxMax);
+// то же, tMin/tMax сужаются до части отрезка внутри AABB
+inline bool SegmentAABBClip(const Vector3& origin, const Vector3& direction, float& tMin, float& tMax, const Vector3& boxMin, const Vector3& boxMax);
+
+//=============================================================================
+// Grid Raycast
+//=============================================================================
+
+// Клетки сетки - единичные кубы с центрами в целых координатах (как у DungeonGrid)
+struct GridRayHit
+{
+	int cell[3] = { 0, 0, 0 };
+	float distance = 0.0f; // параметр луча при входе в клетку
+	Vector3 normal;        // грань входа, ноль - луч начался в этой клетке
+};
+
+// Обход клеток вдоль луча (Amanatides-Woo 3D DDA) на [0, maxDistance] внутри bounds: первая клетка, для которой isSolid(x, y, z) == true.
+// Каждый шаг - одно сравнение и одно сложение, клетки проверяются в порядке пересечения лучом
+template<class IsSolid>
+inline bool GridRaycast(const Ray& ray, float maxDistance, const AABB& bounds, IsSolid&& isSolid, GridRayHit& outHit);
+// видимость from -> to: на отрезке нет твердых клеток (включая клетки концов)
+template<class IsSolid>
+inline bool GridLineOfSight(const Vector3& from, const Vector3& to, const AABB& bounds, IsSolid&& isSolid);
+// видимость from -> targets[i] для многих целей одним вызовом (например, все монстры против игрока). Возвращает число видимых
+template<class IsSolid>
+inline size_t GridLineOfSight(const Vector3& from, const Vector3* targets, size_t count, const AABB& bounds, IsSolid&& isSolid, uint8_t* outVisible);
+
+//=============================================================================
+// BVH
+//=============================================================================
+
+// Иерархия ограничивающих объемов над треугольниками. Построение по SAH (по корзинам центров), узлы в плоском массиве,
+// обход без рекурсии. Запросы возвращают индексы треугольников в исходном массиве
+class BVH
+{
+public:
+	static constexpr uint32_t MaxLeafTriangles = 4;
+	static constexpr uint32_t MaxDepth = 64;
+
+	struct alignas(16) Node
+	{
+		bool IsLeaf() const { return count > 0; }
+
+		Vector3 min;
+		uint32_t leftOrFirst; // внутренний узел - индекс левого потомка (правый следом), лист - первый треугольник
+		Vector3 max;
+		uint32_t count;       // 0 - внутренний узел, иначе число треугольников листа
+	};
+
+	// по 3 вершины на треугольник (как Model::GetTriangles())
+	void Build(const std::vector<Vector3>& triangleVertices);
+	void Build(const Vector3* triangleVertices, size_t triangleCount);
+	void Clear();
+
+	// индексы треугольников, AABB которых пересекает aabb. outTriangles очищается, возвращает число найденных
+	size_t QueryAABB(const AABB& aabb, std::vector<uint32_t>& outTriangles) const;
+	// кандидаты для движущейся сферы/эллипсоида (center -> center + velocity): треугольники, AABB которых пересекает заметаемый объем
+	size_t QuerySphereSweep(const Sphere& sphere, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const;
+	size_t QueryEllipsoidSweep(const Vector3& center, const Vector3& radius, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const;
+	// ближайшее пересечение луча с треугольниками на [0, maxDistance]
+	bool RayCast(const Ray& ray, float maxDistance, float& outDistance, uint32_t& outTriangle) const;
+	// то же для пакета лучей, результат в distance/triangle пакета (индексы в исходном массиве)
+	void RayCast(RayPacket& packet) const;
+
+	const std::vector<Node>& GetNodes() const { return m_nodes; }
+	AABB GetBounds() const { return m_nodes.empty() ? AABB() : AABB(m_nodes[0].min, m_nodes[0].max); }
+	size_t GetTriangleCount() const { return m_triangles.size(); }
+	bool IsValid() const { return !m_nodes.empty(); }
+
+private:
+	size_t querySweep(const Vector3& center, const Vector3& extent, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const;
+	// расстояние входа луча в узел, INFINITY - промах
+	static float rayNodeDistance(const Vector3& origin, const Vector3& inverseDirection, float maxDistance, const Node& node);
+	// обход пакетом лучей [first, first + L::Width)
+	template<class L>
+	void rayCastLanes(RayPacket& packet, size_t first) const;
+
+	std::vector<Node> m_nodes;
+	std::vector<Triangle> m_triangles;       // в порядке листьев
+	std::vector<uint32_t> m_triangleIndices; // индекс в исходном массиве для m_triangles
+};
+
+//=============================================================================
+// Dynamic AABB Tree
+//=============================================================================
+
+// Пара прокси с пересекающимися расширенными AABB, proxyA < proxyB
+struct ProxyPair
+{
+	uint32_t proxyA;
+	uint32_t proxyB;
+};
+
+// Динамическое дерево AABB - широкая фаза для движущихся объектов (монстры, снаряды, триггеры).
+// Листья хранят расширенные (fat) AABB: пока объект движется внутри своего расширенного AABB, дерево не меняется.
+// Вставка по стоимости площади поверхности, повороты по площади и ограничение разницы высот (по мотивам b2DynamicTree из Box2D).
+// Переставленный лист вставляется от ближайшего предка, содержащего новый AABB, а не от корня.
+// Прокси - индекс листа, остается неизменным до DestroyProxy
+class DynamicAABBTree
+{
+public:
+	static constexpr uint32_t NullNode = UINT32_MAX;
+	static constexpr float AABBMargin = 0.1f;            // расширение AABB со всех сторон
+	static constexpr float DisplacementMultiplier = 4.0f; // упреждение по смещению за кадр
+	static constexpr uint32_t MaxStackSize = 256;
+	static constexpr int MaxHeightDifference = 4;        // допустимая разница высот потомков (ограничивает высоту дерева)
+
+	uint32_t CreateProxy(const AABB& aabb, uint32_t userData);
+	void DestroyProxy(uint32_t proxy);
+	// true - лист переставлен в дереве (aabb вышел за расширенный или расширенный стал слишком велик)
+	bool MoveProxy(uint32_t proxy, const AABB& aabb, const Vector3& displacement);
+	void Clear();
+
+	uint32_t GetUserData(uint32_t proxy) const { return m_nodes[proxy].userData; }
+	const AABB& GetFatAABB(uint32_t proxy) const { return m_nodes[proxy].aabb; }
+	size_t GetProxyCount() const { return m_proxyCount; }
+	int GetHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+	// проверка структуры дерева (родители, высоты, охватывающие AABB)
+	bool Validate() const;
+
+	// callback(proxy) для каждого прокси, расширенный AABB которого пересекает aabb; false из callback прекращает запрос
+	template<class Callback>
+	void Query(const AABB& aabb, Callback&& callback) const;
+	size_t Query(const AABB& aabb, std::vector<uint32_t>& outProxies) const;
+	// callback(proxy, maxDistance) для прокси вдоль луча на [0, maxDistance] (по расширенным AABB) возвращает новое maxDistance:
+	// расстояние до точного попадания сужает луч, 0 прекращает запрос, maxDistance - продолжить без изменений
+	template<class Callback>
+	void RayCast(const Ray& ray, float maxDistance, Callback&& callback) const;
+
+	// пары, в которых участвует прокси, созданный или переставленный после прошлого вызова (новые возможные контакты)
+	size_t UpdatePairs(std::vector<ProxyPair>& outPairs);
+	// все пары пересекающихся расширенных AABB
+	size_t QueryAllPairs(std::vector<ProxyPair>& outPairs) const;
+
+private:
+	struct Node
+	{
+		bool IsLeaf() const { return child1 == NullNode; }
+
+		AABB aabb;
+		uint32_t parent = NullNode; // у свободного узла - следующий свободный
+		uint32_t child1 = NullNode;
+		uint32_t child2 = NullNode;
+		int height = -1;            // лист - 0, свободный узел - -1
+		uint32_t userData = 0;
+		bool moved = false;
+	};
+
+	uint32_t allocateNode();
+	void freeNode(uint32_t node);
+	void insertLeaf(uint32_t leaf, uint32_t start);
+	uint32_t removeLeaf(uint32_t leaf);
+	void refitAncestors(uint32_t index, bool rotateNodes);
+	void rotate(uint32_t node);
+	uint32_t balance(uint32_t node);
+	void bufferMove(uint32_t proxy);
+
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_moveBuffer;
+	uint32_t m_root = NullNode;
+	uint32_t m_freeList = NullNode;
+	size_t m_proxyCount = 0;
+};
+
+//=============================================================================
+// Convex Hull
+//=============================================================================
+
+// Выпуклая оболочка точек (quickhull) - дешевый прокси коллизий вместо треугольников модели.
+// Вершины добавляются по одной, каждый раз самая дальняя от текущей оболочки точка, поэтому при бюджете вершин
+// построение просто останавливается раньше: оболочка лежит внутри исходной, GetError - расстояние до самой дальней отброшенной точки
+class ConvexHull
+{
+public:
+	// points - любые точки, например Model::GetTriangles(); maxVertices - бюджет вершин (0 - без ограничения, меньше 4 нельзя)
+	bool Build(const std::vector<Vector3>& points, size_t maxVertices = 0);
+	bool Build(const Vector3* points, size_t count, size_t maxVertices = 0);
+	void Clear();
+
+	[[nodiscard]] Vector3 GetSupport(const Vector3& direction) const; // самая дальняя вершина вдоль direction
+	[[nodiscard]] bool Contains(const Vector3& point, float tolerance = 0.0f) const;
+	[[nodiscard]] std::vector<Vector3> GetTriangles() const; // по 3 вершины на треугольник (CollisionMesh, отрисовка)
+	[[nodiscard]] float GetError() const { return m_error; }
+	[[nodiscard]] bool IsValid() const { return !planes.empty(); }
+
+	std::vector<Vector3> vertices;
+	std::vector<uint32_t> indices; // треугольники граней, обход против часовой стрелки снаружи
+	std::vector<Plane> planes;     // плоскости граней, нормаль наружу; треугольники одной плоскости объединены
+
+private:
+	float m_error = 0.0f;
+};
+
+//=============================================================================
+// GJK / EPA
+//=============================================================================
+
+// Выпуклое тело для GJK: ядро (точка, отрезок или оболочка в мировых координатах) и скругление радиусом.
+// Сфера - точка с радиусом, капсула - отрезок с радиусом. Тело не владеет оболочкой
+class ConvexShape
+{
+public:
+	ConvexShape() = default;
+	ConvexShape(const Sphere& sphere) : m_points{ sphere.position, sphere.position }, m_radius(sphere.radius) {}
+	ConvexShape(const Capsule& capsule) : m_points{ capsule.start, capsule.end }, m_radius(capsule.radius) {}
+	ConvexShape(const ConvexHull& hull, const Transform& transform = Transform()) : m_hull(&hull), m_transform(transform) {}
+
+	// опорная точка ядра без радиуса
+	[[nodiscard]] Vector3 GetSupport(const Vector3& direction) const;
+	[[nodiscard]] float GetRadius() const { return m_radius; }
+
+private:
+	Vector3 m_points[2];
+	const ConvexHull* m_hull = nullptr;
+	Transform m_transform;
+	float m_radius = 0.0f;
+};
+
+// Результат ConvexCollide
+struct ConvexContact
+{
+	float distance = 0.0f; // расстояние между поверхностями, при пересечении - минус глубина проникновения
+	Vector3 normal;        // от A к B: сдвиг B на normal * -distance разделяет тела
+	Vector3 pointA;        // ближайшая (самая глубокая) точка поверхности A
+	Vector3 pointB;
+};
+
+// пересекаются ли тела (только GJK)
+[[nodiscard]] inline bool ConvexOverlap(const ConvexShape& a, const ConvexShape& b);
+// расстояние или глубина проникновения (GJK, при пересечении ядер - EPA), true - тела пересекаются
+inline bool ConvexCollide(const ConvexShape& a, const ConvexShape& b, ConvexContact& outContact);
+
 #include "MicroGeometry.inl"
\ No newline at end of file
@@ -165,13 +165,12 @@ inline bool AABB::Contains(const Vector3& point) const
 
 inline bool AABB::Contains(const AABB& rhs) const
 {
-	// TODO: 
 	if( min.x > rhs.min.x ) return false;
 	if( min.y > rhs.min.y ) return false;
 	if( min.z > rhs.min.z ) return false;
-	if( rhs.min.x > max.x ) return false;
-	if( rhs.min.y > max.y ) return false;
-	if( rhs.min.z > max.z ) return false;
+	if( rhs.max.x > max.x ) return false;
+	if( rhs.max.y > max.y ) return false;
+	if( rhs.max.z > max.z ) return false;
 	return true;
 }
 
@@ -240,6 +239,214 @@ inline float GetSqDistanceTo(const AABB& aabb, const Vector3& inPoint)
 inline bool operator==(const AABB& Left, const AABB& Right) noexcept { return Left.min == Right.min && Left.max == Right.max; }
 inline bool operator!=(const AABB& Left, const AABB& Right) noexcept { return Left.min != Right.min ||Left.max != Right.max; }
 
+//=============================================================================
+// AABB SoA
+//=============================================================================
+
+inline void AABBArraySoA::Reserve(size_t count)
+{
+	minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+	maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+}
+
+inline void AABBArraySoA::Clear()
+{
+	minX.clear(); minY.clear(); minZ.clear();
+	maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+inline void AABBArraySoA::Add(const AABB& aabb)
+{
+	minX.push_back(aabb.min.x); minY.push_back(aabb.min.y); minZ.push_back(aabb.min.z);
+	maxX.push_back(aabb.max.x); maxY.push_back(aabb.max.y); maxZ.push_back(aabb.max.z);
+}
+
+inline void AABBArraySoA::Set(size_t index, const AABB& aabb)
+{
+	minX[index] = aabb.min.x; minY[index] = aabb.min.y; minZ[index] = aabb.min.z;
+	maxX[index] = aabb.max.x; maxY[index] = aabb.max.y; maxZ[index] = aabb.max.z;
+}
+
+inline AABB AABBArraySoA::Get(size_t index) const
+{
+	return { { minX[index], minY[index], minZ[index] }, { maxX[index], maxY[index], maxZ[index] } };
+}
+
+//=============================================================================
+// Frustum
+//=============================================================================
+
+inline void Frustum::Set(const Matrix4& m)
+{
+	//   (   )
+	const Vector4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	const Vector4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	const Vector4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	const Vector4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	planes[PlaneLeft]   = row3 + row0;
+	planes[PlaneRight]  = row3 - row0;
+	planes[PlaneBottom] = row3 + row1;
+	planes[PlaneTop]    = row3 - row1;
+	planes[PlaneNear]   = row3 + row2;
+	planes[PlaneFar]    = row3 - row2;
+
+	for( Vector4& plane : planes )
+	{
+		const float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if( length > EPSILON ) plane = plane / length;
+	}
+}
+
+inline Intersection Frustum::IsInside(const Vector3& point) const
+{
+	for( const Vector4& plane : planes )
+	{
+		if( plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w < 0.0f )
+			return OUTSIDE;
+	}
+	return INSIDE;
+}
+
+inline Intersection Frustum::IsInside(const Sphere& sphere) const
+{
+	bool allInside = true;
+	for( const Vector4& plane : planes )
+	{
+		const float distance = plane.x * sphere.position.x + plane.y * sphere.position.y + plane.z * sphere.position.z + plane.w;
+		if( distance < -sphere.radius ) return OUTSIDE;
+		if( distance < sphere.radius ) allInside = false;
+	}
+	return allInside ? INSIDE : INTERSECTS;
+}
+
+inline Intersection Frustum::IsInside(const AABB& aabb) const
+{
+	const Vector3 center = aabb.GetCenter();
+	const Vector3 extent = aabb.GetExtent();
+
+	bool allInside = true;
+	for( const Vector4& plane : planes )
+	{
+		const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		const float radius = fabsf(plane.x) * extent.x + fabsf(plane.y) * extent.y + fabsf(plane.z) * extent.z;
+		if( distance < -radius ) return OUTSIDE;
+		if( distance < radius ) allInside = false;
+	}
+	return allInside ? INSIDE : INTERSECTS;
+}
+
+inline bool Frustum::IsVisible(const Sphere& sphere) const
+{
+	for( const Vector4& plane : planes )
+	{
+		if( plane.x * sphere.position.x + plane.y * sphere.position.y + plane.z * sphere.position.z + plane.w < -sphere.radius )
+			return false;
+	}
+	return true;
+}
+
+inline bool Frustum::IsVisible(const AABB& aabb) const
+{
+	//   AABB,      
+	for( const Vector4& plane : planes )
+	{
+		const float distance =
+			Max(plane.x * aabb.min.x, plane.x * aabb.max.x) +
+			Max(plane.y * aabb.min.y, plane.y * aabb.max.y) +
+			Max(plane.z * aabb.min.z, plane.z * aabb.max.z) + plane.w;
+		if( distance < 0.0f ) return false;
+	}
+	return true;
+}
+
+inline size_t Frustum::CullAABBs(const AABBArraySoA& boxes, uint32_t* outVisible) const
+{
+	const size_t size = boxes.GetSize();
+	const float* minX = boxes.minX.data();
+	const float* minY = boxes.minY.data();
+	const float* minZ = boxes.minZ.data();
+	const float* maxX = boxes.maxX.data();
+	const float* maxY = boxes.maxY.data();
+	const float* maxZ = boxes.maxZ.data();
+
+	size_t count = 0;
+	size_t i = 0;
+
+#if defined(MICROMATH_AVX)
+	for( ; i + 8 <= size; i += 8 )
+	{
+		const __m256 bminX = _mm256_loadu_ps(minX + i), bmaxX = _mm256_loadu_ps(maxX + i);
+		const __m256 bminY = _mm256_loadu_ps(minY + i), bmaxY = _mm256_loadu_ps(maxY + i);
+		const __m256 bminZ = _mm256_loadu_ps(minZ + i), bmaxZ = _mm256_loadu_ps(maxZ + i);
+
+		__m256 outside = _mm256_setzero_ps();
+		for( const Vector4& plane : planes )
+		{
+			const __m256 nx = _mm256_set1_ps(plane.x);
+			const __m256 ny = _mm256_set1_ps(plane.y);
+			const __m256 nz = _mm256_set1_ps(plane.z);
+			__m256 distance = _mm256_max_ps(_mm256_mul_ps(nx, bminX), _mm256_mul_ps(nx, bmaxX));
+			distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(ny, bminY), _mm256_mul_ps(ny, bmaxY)));
+			distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(nz, bminZ), _mm256_mul_ps(nz, bmaxZ)));
+			distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+		}
+
+		const unsigned visibleMask = ~(unsigned)_mm256_movemask_ps(outside) & 0xFFu;
+		for( unsigned j = 0; j < 8; j++ )
+		{
+			outVisible[count] = (uint32_t)(i + j);
+			count += (visibleMask >> j) & 1u;
+		}
+	}
+#endif // MICROMATH_AVX
+
+#if defined(MICROMATH_SSE2)
+	for( ; i + 4 <= size; i += 4 )
+	{
+		const __m128 bminX = _mm_loadu_ps(minX + i), bmaxX = _mm_loadu_ps(maxX + i);
+		const __m128 bminY = _mm_loadu_ps(minY + i), bmaxY = _mm_loadu_ps(maxY + i);
+		const __m128 bminZ = _mm_loadu_ps(minZ + i), bmaxZ = _mm_loadu_ps(maxZ + i);
+
+		__m128 outside = _mm_setzero_ps();
+		for( const Vector4& plane : planes )
+		{
+			const __m128 nx = _mm_set1_ps(plane.x);
+			const __m128 ny = _mm_set1_ps(plane.y);
+			const __m128 nz = _mm_set1_ps(plane.z);
+			__m128 distance = _mm_max_ps(_mm_mul_ps(nx, bminX), _mm_mul_ps(nx, bmaxX));
+			distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(ny, bminY), _mm_mul_ps(ny, bmaxY)));
+			distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(nz, bminZ), _mm_mul_ps(nz, bmaxZ)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+		}
+
+		const unsigned visibleMask = ~(unsigned)_mm_movemask_ps(outside) & 0xFu;
+		for( unsigned j = 0; j < 4; j++ )
+		{
+			outVisible[count] = (uint32_t)(i + j);
+			count += (visibleMask >> j) & 1u;
+		}
+	}
+#endif // MICROMATH_SSE2
+
+	for( ; i < size; i++ )
+	{
+		if( IsVisible(AABB({ minX[i], minY[i], minZ[i] }, { maxX[i], maxY[i], maxZ[i] })) )
+			outVisible[count++] = (uint32_t)i;
+	}
+	return count;
+}
+
+inline size_t Frustum::CullAABBs(const AABBArraySoA& boxes, std::vector<uint32_t>& outVisible) const
+{
+	outVisible.resize(boxes.GetSize());
+	const size_t count = CullAABBs(boxes, outVisible.data());
+	outVisible.resize(count);
+	return count;
+}
+
 //=============================================================================
 // Plane
 //=============================================================================
@@ -267,4 +474,1827 @@ inline bool Plane::IsFrontFacingTo(const Vector3& direction) const
 {
 	const float dot = DotProduct(normal, direction);
 	return (dot <= 0.0f);
-}
\ No newline at end of file
+}
+
+//=============================================================================
+// Ray
+//=============================================================================
+
+inline bool RayTriangleIntersect(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance)
+{
+	const Vector3 edge1 = v1 - v0;
+	const Vector3 edge2 = v2 - v0;
+	const Vector3 p = CrossProduct(ray.direction, edge2);
+	const float det = DotProduct(edge1, p);
+	if( fabsf(det) < 1e-12f ) return false; //   
+
+	const float invDet = 1.0f / det;
+	const Vector3 s = ray.origin - v0;
+	const float u = DotProduct(s, p) * invDet;
+	if( u < 0.0f || u > 1.0f ) return false;
+
+	const Vector3 q = CrossProduct(s, edge1);
+	const float v = DotProduct(ray.direction, q) * invDet;
+	if( v < 0.0f || u + v > 1.0f ) return false;
+
+	const float t = DotProduct(edge2, q) * invDet;
+	if( t < 0.0f ) return false;
+
+	distance = t;
+	return true;
+}
+
+//=============================================================================
+// Ray Packet
+//=============================================================================
+
+inline void RayPacket::Clear()
+{
+	//          :     
+	for( size_t i = 0; i < MaxSize; i++ )
+	{
+		originX[i] = originY[i] = originZ[i] = 0.0f;
+		directionX[i] = directionY[i] = directionZ[i] = 0.0f;
+		distance[i] = -1.0f;
+		triangle[i] = NoHit;
+	}
+	m_size = 0;
+}
+
+inline bool RayPacket::Add(const Ray& ray, float maxDistance)
+{
+	if( m_size == MaxSize ) return false;
+	originX[m_size] = ray.origin.x;
+	originY[m_size] = ray.origin.y;
+	originZ[m_size] = ray.origin.z;
+	directionX[m_size] = ray.direction.x;
+	directionY[m_size] = ray.direction.y;
+	directionZ[m_size] = ray.direction.z;
+	distance[m_size] = maxDistance;
+	triangle[m_size] = NoHit;
+	m_size++;
+	return true;
+}
+
+namespace rayPacket
+{
+	template<class L>
+	struct Lanes3
+	{
+		typename L::Float x, y, z;
+	};
+
+	template<class L>
+	inline Lanes3<L> Cross(const Lanes3<L>& a, const Lanes3<L>& b)
+	{
+		return {
+			L::Sub(L::Mul(a.y, b.z), L::Mul(a.z, b.y)),
+			L::Sub(L::Mul(a.z, b.x), L::Mul(a.x, b.z)),
+			L::Sub(L::Mul(a.x, b.y), L::Mul(a.y, b.x)) };
+	}
+
+	template<class L>
+	inline typename L::Float Dot(const Lanes3<L>& a, const Lanes3<L>& b)
+	{
+		return L::Add(L::Add(L::Mul(a.x, b.x), L::Mul(a.y, b.y)), L::Mul(a.z, b.z));
+	}
+
+	template<class L>
+	inline Lanes3<L> Set(const Vector3& v)
+	{
+		return { L::Set(v.x), L::Set(v.y), L::Set(v.z) };
+	}
+
+	// Moller-Trumbore  L::Width    ,      closest
+	template<class L>
+	inline typename L::Mask IntersectTriangle(const Lanes3<L>& origin, const Lanes3<L>& direction, const typename L::Float& closest,
+		const Vector3& v0, const Vector3& v1, const Vector3& v2, typename L::Float& outDistance)
+	{
+		const typename L::Float zero = L::Set(0.0f);
+		const typename L::Float one = L::Set(1.0f);
+		const Lanes3<L> edge1 = Set<L>(v1 - v0);
+		const Lanes3<L> edge2 = Set<L>(v2 - v0);
+
+		const Lanes3<L> p = Cross<L>(direction, edge2);
+		const typename L::Float det = Dot<L>(edge1, p);
+		typename L::Mask valid = L::Or(L::Less(det, L::Set(-1e-12f)), L::Less(L::Set(1e-12f), det)); //   
+		const typename L::Float invDet = L::Div(one, det);
+
+		const Lanes3<L> s = { L::Sub(origin.x, L::Set(v0.x)), L::Sub(origin.y, L::Set(v0.y)), L::Sub(origin.z, L::Set(v0.z)) };
+		const typename L::Float u = L::Mul(Dot<L>(s, p), invDet);
+		valid = L::And(valid, L::And(L::LessEqual(zero, u), L::LessEqual(u, one)));
+
+		const Lanes3<L> q = Cross<L>(s, edge1);
+		const typename L::Float v = L::Mul(Dot<L>(direction, q), invDet);
+		valid = L::And(valid, L::And(L::LessEqual(zero, v), L::LessEqual(L::Add(u, v), one)));
+
+		outDistance = L::Mul(Dot<L>(edge2, q), invDet);
+		return L::And(valid, L::And(L::LessEqual(zero, outDistance), L::LessEqual(outDistance, closest)));
+	}
+
+	template<class L>
+	inline void IntersectTriangle(RayPacket& packet, size_t first, const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t triangleIndex)
+	{
+		const Lanes3<L> origin = { L::Load(packet.originX + first), L::Load(packet.originY + first), L::Load(packet.originZ + first) };
+		const Lanes3<L> direction = { L::Load(packet.directionX + first), L::Load(packet.directionY + first), L::Load(packet.directionZ + first) };
+		const typename L::Float closest = L::Load(packet.distance + first);
+
+		typename L::Float distance;
+		const typename L::Mask hit = IntersectTriangle<L>(origin, direction, closest, v0, v1, v2, distance);
+		const unsigned hitMask = L::MoveMask(hit);
+		if( hitMask == 0 ) return;
+
+		L::Store(packet.distance + first, L::Select(hit, distance, closest));
+		for( size_t j = 0; j < L::Width; j++ )
+		{
+			if( hitMask & (1u << j) ) packet.triangle[first + j] = triangleIndex;
+		}
+	}
+}
+
+inline void RayTriangleIntersect(RayPacket& packet, const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t triangleIndex)
+{
+	for( size_t first = 0; first < RayPacket::MaxSize; first += simd::LanesWide::Width )
+		rayPacket::IntersectTriangle<simd::LanesWide>(packet, first, v0, v1, v2, triangleIndex);
+}
+
+inline bool SegmentAABBIntersect(const Vector3& origin, const Vector3& direction, float tMin, float tMax, const Vector3& boxMin, const Vector3& boxMax)
+{
+	return SegmentAABBClip(origin, direction, tMin, tMax, boxMin, boxMax);
+}
+
+inline bool SegmentAABBClip(const Vector3& origin, const Vector3& direction, float& tMin, float& tMax, const Vector3& boxMin, const Vector3& boxMax)
+{
+	for( size_t axis = 0; axis < 3; axis++ )
+	{
+		if( fabsf(direction[axis]) < 1e-12f )
+		{
+			//    -    
+			if( origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis] ) return false;
+			continue;
+		}
+
+		const float invDirection = 1.0f / direction[axis];
+		float t0 = (boxMin[axis] - origin[axis]) * invDirection;
+		float t1 = (boxMax[axis] - origin[axis]) * invDirection;
+		if( t0 > t1 ) std::swap(t0, t1);
+
+		tMin = Max(tMin, t0);
+		tMax = Min(tMax, t1);
+		if( tMin > tMax ) return false;
+	}
+	return true;
+}
+
+//=============================================================================
+// Grid Raycast
+//=============================================================================
+
+template<class IsSolid>
+inline bool GridRaycast(const Ray& ray, float maxDistance, const AABB& bounds, IsSolid&& isSolid, GridRayHit& outHit)
+{
+	//     -      
+	float tEnter = 0.0f;
+	float tExit = maxDistance;
+	if( !SegmentAABBClip(ray.origin, ray.direction, tEnter, tExit, bounds.min, bounds.max) )
+		return false;
+
+	const Vector3 enterPoint = ray.GetPoint(tEnter);
+	int cell[3], cellMin[3], cellMax[3], step[3];
+	float tMax[3], tDelta[3], tEntry[3];
+	for( int axis = 0; axis < 3; axis++ )
+	{
+		cellMin[axis] = (int)floorf(bounds.min[axis] + 0.5f);
+		cellMax[axis] = (int)ceilf(bounds.max[axis] + 0.5f) - 1;
+		cell[axis] = std::clamp((int)floorf(enterPoint[axis] + 0.5f), cellMin[axis], cellMax[axis]);
+
+		const float direction = ray.direction[axis];
+		if( direction > 0.0f )
+		{
+			step[axis] = 1;
+			tDelta[axis] = 1.0f / direction;
+			tMax[axis] = ((float)cell[axis] + 0.5f - ray.origin[axis]) / direction;
+		}
+		else if( direction < 0.0f )
+		{
+			step[axis] = -1;
+			tDelta[axis] = -1.0f / direction;
+			tMax[axis] = ((float)cell[axis] - 0.5f - ray.origin[axis]) / direction;
+		}
+		else
+		{
+			step[axis] = 0;
+			tDelta[axis] = tMax[axis] = std::numeric_limits<float>::infinity();
+		}
+		tEntry[axis] = step[axis] != 0 ? tMax[axis] - tDelta[axis] : -std::numeric_limits<float>::infinity();
+	}
+
+	//      -     
+	int axis = tEntry[0] > tEntry[1] ? (tEntry[0] > tEntry[2] ? 0 : 2) : (tEntry[1] > tEntry[2] ? 1 : 2);
+	if( tEntry[axis] <= 0.0f ) axis = -1;
+	float t = tEnter;
+
+	for( ;; )
+	{
+		if( isSolid(cell[0], cell[1], cell[2]) )
+		{
+			outHit.cell[0] = cell[0];
+			outHit.cell[1] = cell[1];
+			outHit.cell[2] = cell[2];
+			outHit.distance = t;
+			outHit.normal = Vector3(0.0f);
+			if( axis >= 0 ) outHit.normal[axis] = -(float)step[axis];
+			return true;
+		}
+
+		axis = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+		t = tMax[axis];
+		if( t > tExit ) return false;
+		cell[axis] += step[axis];
+		if( cell[axis] < cellMin[axis] || cell[axis] > cellMax[axis] ) return false;
+		tMax[axis] += tDelta[axis];
+	}
+}
+
+template<class IsSolid>
+inline bool GridLineOfSight(const Vector3& from, const Vector3& to, const AABB& bounds, IsSolid&& isSolid)
+{
+	GridRayHit hit;
+	return !GridRaycast(Ray(from, to - from), 1.0f, bounds, isSolid, hit);
+}
+
+template<class IsSolid>
+inline size_t GridLineOfSight(const Vector3& from, const Vector3* targets, size_t count, const AABB& bounds, IsSolid&& isSolid, uint8_t* outVisible)
+{
+	size_t visibleCount = 0;
+	GridRayHit hit;
+	for( size_t i = 0; i < count; i++ )
+	{
+		const bool isVisible = !GridRaycast(Ray(from, targets[i] - from), 1.0f, bounds, isSolid, hit);
+		outVisible[i] = isVisible ? 1 : 0;
+		visibleCount += isVisible ? 1 : 0;
+	}
+	return visibleCount;
+}
+
+//=============================================================================
+// BVH
+//=============================================================================
+
+inline void BVH::Build(const std::vector<Vector3>& triangleVertices)
+{
+	Build(triangleVertices.data(), triangleVertices.size() / 3);
+}
+
+inline void BVH::Build(const Vector3* triangleVertices, size_t triangleCount)
+{
+	constexpr uint32_t BinCount = 12;
+	constexpr uint32_t MaxSAHLeafTriangles = 16; // SAH     MaxLeafTriangles,    
+	const AABB emptyAABB(Vector3(INFINITY), Vector3(-INFINITY));
+
+	Clear();
+	if( triangleCount == 0 ) return;
+
+	std::vector<AABB> triangleBounds(triangleCount, emptyAABB);
+	std::vector<Vector3> centroids(triangleCount);
+	std::vector<uint32_t> indices(triangleCount);
+	for( size_t i = 0; i < triangleCount; i++ )
+	{
+		const Triangle triangle(triangleVertices[i * 3 + 0], triangleVertices[i * 3 + 1], triangleVertices[i * 3 + 2]);
+		triangleBounds[i].AddTriangle(triangle);
+		centroids[i] = triangleBounds[i].GetCenter();
+		indices[i] = (uint32_t)i;
+	}
+
+	//    2n-1 -     
+	m_nodes.reserve(triangleCount * 2);
+	m_nodes.push_back({ .min = {}, .leftOrFirst = 0, .max = {}, .count = (uint32_t)triangleCount });
+
+	struct BuildTask
+	{
+		uint32_t node;
+		uint32_t depth;
+	};
+	std::vector<BuildTask> tasks;
+	tasks.push_back({ 0, 1 });
+
+	while( !tasks.empty() )
+	{
+		const BuildTask task = tasks.back();
+		tasks.pop_back();
+
+		Node& node = m_nodes[task.node];
+		const uint32_t first = node.leftOrFirst;
+		const uint32_t count = node.count;
+
+		AABB bounds = emptyAABB;
+		AABB centroidBounds = emptyAABB;
+		for( uint32_t i = first; i < first + count; i++ )
+		{
+			bounds.AddAABB(triangleBounds[indices[i]]);
+			centroidBounds.AddPoint(centroids[indices[i]]);
+		}
+		node.min = bounds.min;
+		node.max = bounds.max;
+
+		if( count <= MaxLeafTriangles || task.depth >= MaxDepth )
+			continue;
+
+		// SAH  :   = 1 + (S(L) * N(L) + S(R) * N(R)) / S(),   = N
+		struct Bin
+		{
+			AABB bounds;
+			uint32_t count = 0;
+		};
+		float bestCost = INFINITY;
+		size_t bestAxis = 0;
+		uint32_t bestSplit = 0;
+		const float invParentArea = 1.0f / Max(bounds.GetSurfaceArea(), 1e-20f);
+		for( size_t axis = 0; axis < 3; axis++ )
+		{
+			const float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+			if( extent <= 0.0f ) continue;
+
+			Bin bins[BinCount];
+			for( uint32_t b = 0; b < BinCount; b++ )
+				bins[b].bounds = emptyAABB;
+			const float scale = (float)BinCount / extent;
+			for( uint32_t i = first; i < first + count; i++ )
+			{
+				const uint32_t b = std::min((uint32_t)((centroids[indices[i]][axis] - centroidBounds.min[axis]) * scale), BinCount - 1);
+				bins[b].bounds.AddAABB(triangleBounds[indices[i]]);
+				bins[b].count++;
+			}
+
+			//        ,  
+			float leftCost[BinCount - 1];
+			AABB leftBounds = emptyAABB;
+			uint32_t leftCount = 0;
+			for( uint32_t b = 0; b < BinCount - 1; b++ )
+			{
+				leftBounds.AddAABB(bins[b].bounds);
+				leftCount += bins[b].count;
+				leftCost[b] = leftCount ? leftBounds.GetSurfaceArea() * (float)leftCount : 0.0f;
+			}
+			AABB rightBounds = emptyAABB;
+			uint32_t rightCount = 0;
+			for( uint32_t b = BinCount - 1; b > 0; b-- )
+			{
+				rightBounds.AddAABB(bins[b].bounds);
+				rightCount += bins[b].count;
+				if( rightCount == 0 || rightCount == count ) continue;
+				const float cost = 1.0f + (leftCost[b - 1] + rightBounds.GetSurfaceArea() * (float)rightCount) * invParentArea;
+				if( cost < bestCost )
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b; //  [0, b) - 
+				}
+			}
+		}
+
+		if( bestCost == INFINITY ) continue; //   
+		if( bestCost >= (float)count && count <= MaxSAHLeafTriangles ) continue;
+
+		const float splitScale = (float)BinCount / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+		const float splitMin = centroidBounds.min[bestAxis];
+		uint32_t* middle = std::partition(indices.data() + first, indices.data() + first + count, [&](uint32_t index)
+			{
+				return std::min((uint32_t)((centroids[index][bestAxis] - splitMin) * splitScale), BinCount - 1) < bestSplit;
+			});
+		const uint32_t leftCount = (uint32_t)(middle - (indices.data() + first));
+		if( leftCount == 0 || leftCount == count ) continue;
+
+		const uint32_t left = (uint32_t)m_nodes.size();
+		node.leftOrFirst = left;
+		node.count = 0;
+		m_nodes.push_back({ .min = {}, .leftOrFirst = first, .max = {}, .count = leftCount });
+		m_nodes.push_back({ .min = {}, .leftOrFirst = first + leftCount, .max = {}, .count = count - leftCount });
+		tasks.push_back({ left + 1, task.depth + 1 });
+		tasks.push_back({ left, task.depth + 1 });
+	}
+	m_nodes.shrink_to_fit();
+
+	//     -       
+	m_triangles.resize(triangleCount);
+	for( size_t i = 0; i < triangleCount; i++ )
+	{
+		const size_t index = indices[i];
+		m_triangles[i] = Triangle(triangleVertices[index * 3 + 0], triangleVertices[index * 3 + 1], triangleVertices[index * 3 + 2]);
+	}
+	m_triangleIndices = std::move(indices);
+}
+
+inline void BVH::Clear()
+{
+	m_nodes.clear();
+	m_triangles.clear();
+	m_triangleIndices.clear();
+}
+
+inline size_t BVH::QueryAABB(const AABB& aabb, std::vector<uint32_t>& outTriangles) const
+{
+	outTriangles.clear();
+	if( m_nodes.empty() ) return 0;
+
+	uint32_t stack[MaxDepth + 1];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( node.min.x > aabb.max.x || node.max.x < aabb.min.x ||
+			node.min.y > aabb.max.y || node.max.y < aabb.min.y ||
+			node.min.z > aabb.max.z || node.max.z < aabb.min.z )
+			continue;
+
+		if( !node.IsLeaf() )
+		{
+			stack[stackSize++] = node.leftOrFirst + 1;
+			stack[stackSize++] = node.leftOrFirst;
+			continue;
+		}
+
+		for( uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++ )
+		{
+			const Triangle& triangle = m_triangles[i];
+			const Vector3 triangleMin = Min(Min(triangle[0], triangle[1]), triangle[2]);
+			const Vector3 triangleMax = Max(Max(triangle[0], triangle[1]), triangle[2]);
+			if( triangleMin.x <= aabb.max.x && triangleMax.x >= aabb.min.x &&
+				triangleMin.y <= aabb.max.y && triangleMax.y >= aabb.min.y &&
+				triangleMin.z <= aabb.max.z && triangleMax.z >= aabb.min.z )
+				outTriangles.push_back(m_triangleIndices[i]);
+		}
+	}
+	return outTriangles.size();
+}
+
+inline size_t BVH::QuerySphereSweep(const Sphere& sphere, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const
+{
+	return querySweep(sphere.position, Vector3(sphere.radius), velocity, outTriangles);
+}
+
+inline size_t BVH::QueryEllipsoidSweep(const Vector3& center, const Vector3& radius, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const
+{
+	//    AABB   radius
+	return querySweep(center, radius, velocity, outTriangles);
+}
+
+inline size_t BVH::querySweep(const Vector3& center, const Vector3& extent, const Vector3& velocity, std::vector<uint32_t>& outTriangles) const
+{
+	//  :     AABB,     ( )
+	outTriangles.clear();
+	if( m_nodes.empty() ) return 0;
+
+	uint32_t stack[MaxDepth + 1];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( !SegmentAABBIntersect(center, velocity, 0.0f, 1.0f, node.min - extent, node.max + extent) )
+			continue;
+
+		if( !node.IsLeaf() )
+		{
+			stack[stackSize++] = node.leftOrFirst + 1;
+			stack[stackSize++] = node.leftOrFirst;
+			continue;
+		}
+
+		for( uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++ )
+		{
+			const Triangle& triangle = m_triangles[i];
+			const Vector3 triangleMin = Min(Min(triangle[0], triangle[1]), triangle[2]);
+			const Vector3 triangleMax = Max(Max(triangle[0], triangle[1]), triangle[2]);
+			if( SegmentAABBIntersect(center, velocity, 0.0f, 1.0f, triangleMin - extent, triangleMax + extent) )
+				outTriangles.push_back(m_triangleIndices[i]);
+		}
+	}
+	return outTriangles.size();
+}
+
+inline float BVH::rayNodeDistance(const Vector3& origin, const Vector3& inverseDirection, float maxDistance, const Node& node)
+{
+	const float tx0 = (node.min.x - origin.x) * inverseDirection.x;
+	const float tx1 = (node.max.x - origin.x) * inverseDirection.x;
+	const float ty0 = (node.min.y - origin.y) * inverseDirection.y;
+	const float ty1 = (node.max.y - origin.y) * inverseDirection.y;
+	const float tz0 = (node.min.z - origin.z) * inverseDirection.z;
+	const float tz1 = (node.max.z - origin.z) * inverseDirection.z;
+	const float tEnter = Max(Max(Min(tx0, tx1), Min(ty0, ty1)), Max(Min(tz0, tz1), 0.0f));
+	const float tExit = Min(Min(Max(tx0, tx1), Max(ty0, ty1)), Min(Max(tz0, tz1), maxDistance));
+	return tEnter <= tExit ? tEnter : INFINITY;
+}
+
+inline bool BVH::RayCast(const Ray& ray, float maxDistance, float& outDistance, uint32_t& outTriangle) const
+{
+	if( m_nodes.empty() ) return false;
+
+	//      -  NaN   
+	auto safeInverse = [](float v) { return 1.0f / (fabsf(v) > 1e-20f ? v : (v < 0.0f ? -1e-20f : 1e-20f)); };
+	const Vector3 inverseDirection(safeInverse(ray.direction.x), safeInverse(ray.direction.y), safeInverse(ray.direction.z));
+
+	float closest = maxDistance;
+	bool isHit = false;
+
+	uint32_t stack[MaxDepth + 1];
+	uint32_t stackSize = 0;
+	if( rayNodeDistance(ray.origin, inverseDirection, closest, m_nodes[0]) == INFINITY ) return false;
+	stack[stackSize++] = 0;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( node.IsLeaf() )
+		{
+			for( uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++ )
+			{
+				float distance;
+				if( RayTriangleIntersect(ray, m_triangles[i][0], m_triangles[i][1], m_triangles[i][2], distance) && distance <= closest )
+				{
+					closest = distance;
+					outTriangle = m_triangleIndices[i];
+					isHit = true;
+				}
+			}
+			continue;
+		}
+
+		//    -     
+		uint32_t nearChild = node.leftOrFirst;
+		uint32_t farChild = node.leftOrFirst + 1;
+		float nearDistance = rayNodeDistance(ray.origin, inverseDirection, closest, m_nodes[nearChild]);
+		float farDistance = rayNodeDistance(ray.origin, inverseDirection, closest, m_nodes[farChild]);
+		if( farDistance < nearDistance )
+		{
+			std::swap(nearChild, farChild);
+			std::swap(nearDistance, farDistance);
+		}
+		if( farDistance != INFINITY ) stack[stackSize++] = farChild;
+		if( nearDistance != INFINITY ) stack[stackSize++] = nearChild;
+	}
+
+	if( isHit ) outDistance = closest;
+	return isHit;
+}
+
+inline void BVH::RayCast(RayPacket& packet) const
+{
+	for( size_t first = 0; first < RayPacket::MaxSize; first += simd::LanesWide::Width )
+		rayCastLanes<simd::LanesWide>(packet, first);
+}
+
+template<class L>
+inline void BVH::rayCastLanes(RayPacket& packet, size_t first) const
+{
+	if( m_nodes.empty() ) return;
+
+	//      -  NaN   
+	auto safeInverse = [](float v) { return 1.0f / (fabsf(v) > 1e-20f ? v : (v < 0.0f ? -1e-20f : 1e-20f)); };
+	alignas(32) float inverseX[L::Width], inverseY[L::Width], inverseZ[L::Width];
+	for( size_t j = 0; j < L::Width; j++ )
+	{
+		inverseX[j] = safeInverse(packet.directionX[first + j]);
+		inverseY[j] = safeInverse(packet.directionY[first + j]);
+		inverseZ[j] = safeInverse(packet.directionZ[first + j]);
+	}
+
+	const rayPacket::Lanes3<L> origin = { L::Load(packet.originX + first), L::Load(packet.originY + first), L::Load(packet.originZ + first) };
+	const rayPacket::Lanes3<L> direction = { L::Load(packet.directionX + first), L::Load(packet.directionY + first), L::Load(packet.directionZ + first) };
+	const rayPacket::Lanes3<L> inverse = { L::Load(inverseX), L::Load(inverseY), L::Load(inverseZ) };
+	const typename L::Float zero = L::Set(0.0f);
+	typename L::Float closest = L::Load(packet.distance + first);
+	if( L::MoveMask(L::LessEqual(zero, closest)) == 0 ) return;
+
+	//      ,  - ,     closest
+	auto nodeDistance = [&](const Node& node, typename L::Float& outEnter) -> typename L::Mask
+	{
+		const typename L::Float t1x = L::Mul(L::Sub(L::Set(node.min.x), origin.x), inverse.x);
+		const typename L::Float t2x = L::Mul(L::Sub(L::Set(node.max.x), origin.x), inverse.x);
+		const typename L::Float t1y = L::Mul(L::Sub(L::Set(node.min.y), origin.y), inverse.y);
+		const typename L::Float t2y = L::Mul(L::Sub(L::Set(node.max.y), origin.y), inverse.y);
+		const typename L::Float t1z = L::Mul(L::Sub(L::Set(node.min.z), origin.z), inverse.z);
+		const typename L::Float t2z = L::Mul(L::Sub(L::Set(node.max.z), origin.z), inverse.z);
+		const typename L::Float tEnter = L::Max(L::Max(L::Max(L::Min(t1x, t2x), L::Min(t1y, t2y)), L::Min(t1z, t2z)), zero);
+		const typename L::Float tExit = L::Min(L::Min(L::Max(t1x, t2x), L::Max(t1y, t2y)), L::Max(t1z, t2z));
+		outEnter = tEnter;
+		return L::And(L::LessEqual(tEnter, tExit), L::LessEqual(tEnter, closest));
+	};
+
+	uint32_t stack[MaxDepth + 1];
+	uint32_t stackSize = 0;
+	typename L::Float enter;
+	if( L::MoveMask(nodeDistance(m_nodes[0], enter)) == 0 ) return;
+	stack[stackSize++] = 0;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( node.IsLeaf() )
+		{
+			for( uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++ )
+			{
+				typename L::Float distance;
+				const typename L::Mask hit = rayPacket::IntersectTriangle<L>(origin, direction, closest, m_triangles[i][0], m_triangles[i][1], m_triangles[i][2], distance);
+				const unsigned hitMask = L::MoveMask(hit);
+				if( hitMask == 0 ) continue;
+				closest = L::Select(hit, distance, closest);
+				for( size_t j = 0; j < L::Width; j++ )
+				{
+					if( hitMask & (1u << j) ) packet.triangle[first + j] = m_triangleIndices[i];
+				}
+			}
+			continue;
+		}
+
+		// ,     ,  
+		uint32_t nearChild = node.leftOrFirst;
+		uint32_t farChild = node.leftOrFirst + 1;
+		typename L::Float nearEnter, farEnter;
+		const unsigned nearMask = L::MoveMask(nodeDistance(m_nodes[nearChild], nearEnter));
+		const unsigned farMask = L::MoveMask(nodeDistance(m_nodes[farChild], farEnter));
+		const unsigned farFirstMask = L::MoveMask(L::Less(farEnter, nearEnter)) & nearMask & farMask;
+		const unsigned bothMask = nearMask & farMask;
+		if( 2 * std::popcount(farFirstMask) > std::popcount(bothMask) || (nearMask == 0 && farMask != 0) )
+		{
+			if( nearMask ) stack[stackSize++] = nearChild;
+			stack[stackSize++] = farChild;
+		}
+		else
+		{
+			if( farMask ) stack[stackSize++] = farChild;
+			if( nearMask ) stack[stackSize++] = nearChild;
+		}
+	}
+
+	L::Store(packet.distance + first, closest);
+}
+
+//=============================================================================
+// Dynamic AABB Tree
+//=============================================================================
+
+namespace dynamicTree
+{
+	inline AABB Merge(const AABB& a, const AABB& b)
+	{
+		return AABB(Min(a.min, b.min), Max(a.max, b.max));
+	}
+}
+
+inline uint32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData)
+{
+	const uint32_t proxy = allocateNode();
+	Node& node = m_nodes[proxy];
+	node.aabb = AABB(aabb.min - AABBMargin, aabb.max + AABBMargin);
+	node.userData = userData;
+	node.height = 0;
+	node.moved = false;
+	insertLeaf(proxy, m_root);
+	bufferMove(proxy);
+	m_proxyCount++;
+	return proxy;
+}
+
+inline void DynamicAABBTree::DestroyProxy(uint32_t proxy)
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+	if( m_nodes[proxy].moved )
+	{
+		for( uint32_t& moved : m_moveBuffer )
+		{
+			if( moved == proxy ) moved = NullNode;
+		}
+	}
+	removeLeaf(proxy);
+	freeNode(proxy);
+	m_proxyCount--;
+}
+
+inline bool DynamicAABBTree::MoveProxy(uint32_t proxy, const AABB& aabb, const Vector3& displacement)
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+
+	//  AABB     
+	AABB fatAABB(aabb.min - AABBMargin, aabb.max + AABBMargin);
+	const Vector3 prediction = displacement * DisplacementMultiplier;
+	for( size_t axis = 0; axis < 3; axis++ )
+	{
+		if( prediction[axis] < 0.0f ) fatAABB.min[axis] += prediction[axis];
+		else fatAABB.max[axis] += prediction[axis];
+	}
+
+	const AABB& treeAABB = m_nodes[proxy].aabb;
+	if( treeAABB.Contains(aabb) )
+	{
+		//   ,   AABB      
+		const AABB hugeAABB(fatAABB.min - 4.0f * AABBMargin, fatAABB.max + 4.0f * AABBMargin);
+		if( hugeAABB.Contains(treeAABB) )
+			return false;
+	}
+
+	//   AABB     -     ,    ,
+	//        ,     
+	uint32_t start = removeLeaf(proxy);
+	while( start != NullNode && !m_nodes[start].aabb.Contains(fatAABB) )
+		start = m_nodes[start].parent;
+	m_nodes[proxy].aabb = fatAABB;
+	insertLeaf(proxy, start != NullNode ? start : m_root);
+	bufferMove(proxy);
+	return true;
+}
+
+inline void DynamicAABBTree::Clear()
+{
+	m_nodes.clear();
+	m_moveBuffer.clear();
+	m_root = NullNode;
+	m_freeList = NullNode;
+	m_proxyCount = 0;
+}
+
+inline bool DynamicAABBTree::Validate() const
+{
+	if( m_root == NullNode ) return m_proxyCount == 0;
+	if( m_nodes[m_root].parent != NullNode ) return false;
+
+	size_t leafCount = 0;
+	uint32_t stack[MaxStackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = m_root;
+	while( stackSize > 0 )
+	{
+		const uint32_t index = stack[--stackSize];
+		const Node& node = m_nodes[index];
+		if( node.IsLeaf() )
+		{
+			if( node.height != 0 || node.child2 != NullNode ) return false;
+			leafCount++;
+			continue;
+		}
+
+		const Node& child1 = m_nodes[node.child1];
+		const Node& child2 = m_nodes[node.child2];
+		if( child1.parent != index || child2.parent != index ) return false;
+		if( node.height != 1 + std::max(child1.height, child2.height) ) return false;
+		if( node.aabb != dynamicTree::Merge(child1.aabb, child2.aabb) ) return false;
+		stack[stackSize++] = node.child1;
+		stack[stackSize++] = node.child2;
+	}
+	return leafCount == m_proxyCount;
+}
+
+template<class Callback>
+inline void DynamicAABBTree::Query(const AABB& aabb, Callback&& callback) const
+{
+	if( m_root == NullNode ) return;
+
+	uint32_t stack[MaxStackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = m_root;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( !node.aabb.Overlaps(aabb) ) continue;
+
+		if( node.IsLeaf() )
+		{
+			if( !callback((uint32_t)(&node - m_nodes.data())) ) return;
+			continue;
+		}
+		assert(stackSize + 2 <= MaxStackSize);
+		stack[stackSize++] = node.child1;
+		stack[stackSize++] = node.child2;
+	}
+}
+
+inline size_t DynamicAABBTree::Query(const AABB& aabb, std::vector<uint32_t>& outProxies) const
+{
+	outProxies.clear();
+	Query(aabb, [&](uint32_t proxy) { outProxies.push_back(proxy); return true; });
+	return outProxies.size();
+}
+
+template<class Callback>
+inline void DynamicAABBTree::RayCast(const Ray& ray, float maxDistance, Callback&& callback) const
+{
+	if( m_root == NullNode ) return;
+
+	uint32_t stack[MaxStackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = m_root;
+	while( stackSize > 0 )
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if( !SegmentAABBIntersect(ray.origin, ray.direction, 0.0f, maxDistance, node.aabb.min, node.aabb.max) ) continue;
+
+		if( node.IsLeaf() )
+		{
+			const float distance = callback((uint32_t)(&node - m_nodes.data()), maxDistance);
+			if( distance <= 0.0f ) return;
+			maxDistance = Min(maxDistance, distance);
+			continue;
+		}
+		assert(stackSize + 2 <= MaxStackSize);
+		stack[stackSize++] = node.child1;
+		stack[stackSize++] = node.child2;
+	}
+}
+
+inline size_t DynamicAABBTree::UpdatePairs(std::vector<ProxyPair>& outPairs)
+{
+	outPairs.clear();
+	for( const uint32_t proxy : m_moveBuffer )
+	{
+		if( proxy == NullNode ) continue;
+
+		Query(m_nodes[proxy].aabb, [&](uint32_t other)
+			{
+				//    -    ,   
+				if( other == proxy || (m_nodes[other].moved && other > proxy) ) return true;
+				outPairs.push_back({ std::min(proxy, other), std::max(proxy, other) });
+				return true;
+			});
+	}
+
+	for( const uint32_t proxy : m_moveBuffer )
+	{
+		if( proxy != NullNode ) m_nodes[proxy].moved = false;
+	}
+	m_moveBuffer.clear();
+	return outPairs.size();
+}
+
+inline size_t DynamicAABBTree::QueryAllPairs(std::vector<ProxyPair>& outPairs) const
+{
+	outPairs.clear();
+	for( uint32_t proxy = 0; proxy < (uint32_t)m_nodes.size(); proxy++ )
+	{
+		const Node& node = m_nodes[proxy];
+		if( node.height != 0 ) continue; //  
+
+		Query(node.aabb, [&](uint32_t other)
+			{
+				if( other > proxy ) outPairs.push_back({ proxy, other });
+				return true;
+			});
+	}
+	return outPairs.size();
+}
+
+inline uint32_t DynamicAABBTree::allocateNode()
+{
+	if( m_freeList == NullNode )
+	{
+		m_nodes.emplace_back();
+		return (uint32_t)(m_nodes.size() - 1);
+	}
+
+	const uint32_t index = m_freeList;
+	m_freeList = m_nodes[index].parent;
+	m_nodes[index] = Node();
+	return index;
+}
+
+inline void DynamicAABBTree::freeNode(uint32_t node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].child1 = m_nodes[node].child2 = NullNode;
+	m_nodes[node].height = -1;
+	m_nodes[node].moved = false;
+	m_freeList = node;
+}
+
+inline void DynamicAABBTree::bufferMove(uint32_t proxy)
+{
+	if( m_nodes[proxy].moved ) return;
+	m_nodes[proxy].moved = true;
+	m_moveBuffer.push_back(proxy);
+}
+
+// start -  ,     (m_root -    )
+inline void DynamicAABBTree::insertLeaf(uint32_t leaf, uint32_t start)
+{
+	if( m_root == NullNode )
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NullNode;
+		return;
+	}
+
+	//  : ,       ,     
+	const AABB leafAABB = m_nodes[leaf].aabb;
+	uint32_t index = start;
+	while( !m_nodes[index].IsLeaf() )
+	{
+		const Node& node = m_nodes[index];
+		const float area = node.aabb.GetSurfaceArea();
+		const float combinedArea = dynamicTree::Merge(node.aabb, leafAABB).GetSurfaceArea();
+
+		//        
+		const float cost = 2.0f * combinedArea;
+		//     -    
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](uint32_t child)
+		{
+			const Node& childNode = m_nodes[child];
+			const float mergedArea = dynamicTree::Merge(leafAABB, childNode.aabb).GetSurfaceArea();
+			return childNode.IsLeaf() ? mergedArea + inheritanceCost : mergedArea - childNode.aabb.GetSurfaceArea() + inheritanceCost;
+		};
+		const float cost1 = descendCost(node.child1);
+		const float cost2 = descendCost(node.child2);
+
+		if( cost < cost1 && cost < cost2 ) break;
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	const uint32_t sibling = index;
+	const uint32_t oldParent = m_nodes[sibling].parent;
+	const uint32_t newParent = allocateNode(); //   m_nodes -   
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if( oldParent != NullNode )
+	{
+		if( m_nodes[oldParent].child1 == sibling ) m_nodes[oldParent].child1 = newParent;
+		else m_nodes[oldParent].child2 = newParent;
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	// AABB     (height = -1  allocateNode)   
+	refitAncestors(newParent, true);
+}
+
+//  ,     (NullNode -  )
+inline uint32_t DynamicAABBTree::removeLeaf(uint32_t leaf)
+{
+	if( leaf == m_root )
+	{
+		m_root = NullNode;
+		return NullNode;
+	}
+
+	const uint32_t parent = m_nodes[leaf].parent;
+	const uint32_t grandParent = m_nodes[parent].parent;
+	const uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	if( grandParent == NullNode )
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = NullNode;
+		freeNode(parent);
+		return sibling;
+	}
+
+	//  ,    
+	if( m_nodes[grandParent].child1 == parent ) m_nodes[grandParent].child1 = sibling;
+	else m_nodes[grandParent].child2 = sibling;
+	m_nodes[sibling].parent = grandParent;
+	freeNode(parent);
+
+	refitAncestors(grandParent, false);
+	return sibling;
+}
+
+//   : , ,   AABB .  ,        AABB,  ,
+//    -   (      ).
+//      -  MoveProxy    ,        
+inline void DynamicAABBTree::refitAncestors(uint32_t index, bool rotateNodes)
+{
+	while( index != NullNode )
+	{
+		uint32_t subtree = index;
+		if( rotateNodes )
+		{
+			rotate(index);
+			subtree = balance(index);
+		}
+		Node& node = m_nodes[subtree];
+		const int height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+		const AABB aabb = dynamicTree::Merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+		if( subtree == index && height == node.height && aabb == node.aabb )
+			return;
+		node.height = height;
+		node.aabb = aabb;
+		index = node.parent;
+	}
+}
+
+//   :  A       ,      .
+// AABB  A    ,     .       1 (AVL) 
+//      -     
+inline void DynamicAABBTree::rotate(uint32_t iA)
+{
+	float bestGain = 0.0f;
+	uint32_t bestChild = NullNode;
+	uint32_t bestParent = NullNode;
+	uint32_t bestGrandChild = NullNode;
+	auto consider = [&](uint32_t child, uint32_t parent)
+	{
+		const Node& parentNode = m_nodes[parent];
+		if( parentNode.IsLeaf() ) return;
+		const float area = parentNode.aabb.GetSurfaceArea();
+		const float area1 = dynamicTree::Merge(m_nodes[child].aabb, m_nodes[parentNode.child2].aabb).GetSurfaceArea(); // child <-> child1
+		const float area2 = dynamicTree::Merge(m_nodes[child].aabb, m_nodes[parentNode.child1].aabb).GetSurfaceArea(); // child <-> child2
+		if( area - area1 > bestGain ) { bestGain = area - area1; bestChild = child; bestParent = parent; bestGrandChild = parentNode.child1; }
+		if( area - area2 > bestGain ) { bestGain = area - area2; bestChild = child; bestParent = parent; bestGrandChild = parentNode.child2; }
+	};
+	Node& A = m_nodes[iA];
+	consider(A.child1, A.child2);
+	consider(A.child2, A.child1);
+	if( bestChild == NullNode ) return;
+
+	//  A    ,    A
+	Node& parent = m_nodes[bestParent];
+	if( parent.child1 == bestGrandChild ) parent.child1 = bestChild;
+	else parent.child2 = bestChild;
+	if( A.child1 == bestChild ) A.child1 = bestGrandChild;
+	else A.child2 = bestGrandChild;
+	m_nodes[bestChild].parent = bestParent;
+	m_nodes[bestGrandChild].parent = iA;
+	parent.aabb = dynamicTree::Merge(m_nodes[parent.child1].aabb, m_nodes[parent.child2].aabb);
+	parent.height = 1 + std::max(m_nodes[parent.child1].height, m_nodes[parent.child2].height);
+}
+
+//    A     MaxHeightDifference,     .    .
+//       ( AABB   ),    
+inline uint32_t DynamicAABBTree::balance(uint32_t iA)
+{
+	Node& A = m_nodes[iA];
+	if( A.IsLeaf() ) return iA;
+
+	const uint32_t iB = A.child1;
+	const uint32_t iC = A.child2;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+	const int balanceFactor = C.height - B.height;
+
+	//  C 
+	if( balanceFactor > MaxHeightDifference )
+	{
+		const uint32_t iF = C.child1;
+		const uint32_t iG = C.child2;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+		if( C.parent != NullNode )
+		{
+			if( m_nodes[C.parent].child1 == iA ) m_nodes[C.parent].child1 = iC;
+			else m_nodes[C.parent].child2 = iC;
+		}
+		else
+		{
+			m_root = iC;
+		}
+
+		if( F.height > G.height )
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.aabb = dynamicTree::Merge(B.aabb, G.aabb);
+			C.aabb = dynamicTree::Merge(A.aabb, F.aabb);
+			A.height = 1 + std::max(B.height, G.height);
+			C.height = 1 + std::max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.aabb = dynamicTree::Merge(B.aabb, F.aabb);
+			C.aabb = dynamicTree::Merge(A.aabb, G.aabb);
+			A.height = 1 + std::max(B.height, F.height);
+			C.height = 1 + std::max(A.height, G.height);
+		}
+		return iC;
+	}
+
+	//  B 
+	if( balanceFactor < -MaxHeightDifference )
+	{
+		const uint32_t iD = B.child1;
+		const uint32_t iE = B.child2;
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+		if( B.parent != NullNode )
+		{
+			if( m_nodes[B.parent].child1 == iA ) m_nodes[B.parent].child1 = iB;
+			else m_nodes[B.parent].child2 = iB;
+		}
+		else
+		{
+			m_root = iB;
+		}
+
+		if( D.height > E.height )
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.aabb = dynamicTree::Merge(C.aabb, E.aabb);
+			B.aabb = dynamicTree::Merge(A.aabb, D.aabb);
+			A.height = 1 + std::max(C.height, E.height);
+			B.height = 1 + std::max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.aabb = dynamicTree::Merge(C.aabb, D.aabb);
+			B.aabb = dynamicTree::Merge(A.aabb, E.aabb);
+			A.height = 1 + std::max(C.height, D.height);
+			B.height = 1 + std::max(A.height, E.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+//=============================================================================
+// Convex Hull
+//=============================================================================
+
+namespace convexHull
+{
+	//    (quickhull  EPA),  v[0] v[1] v[2]    
+	struct Face
+	{
+		uint32_t v[3];
+		Vector3 normal;
+		float distance; // DotProduct(normal,  )
+		bool isRemoved;
+	};
+
+	inline bool CreateFace(const Vector3& p0, const Vector3& p1, const Vector3& p2, uint32_t i0, uint32_t i1, uint32_t i2, Face& outFace)
+	{
+		const Vector3 normal = CrossProduct(p1 - p0, p2 - p0);
+		const float length = normal.GetLength();
+		if( length < 1e-20f ) return false;
+		outFace.v[0] = i0;
+		outFace.v[1] = i1;
+		outFace.v[2] = i2;
+		outFace.normal = normal / length;
+		outFace.distance = DotProduct(outFace.normal, p0);
+		outFace.isRemoved = false;
+		return true;
+	}
+
+	//   4 ,     
+	template<class GetPoint>
+	inline bool CreateTetrahedron(const uint32_t index[4], GetPoint&& getPoint, std::vector<Face>& outFaces)
+	{
+		static constexpr uint32_t faceVertices[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } }; // 3    
+		outFaces.clear();
+		for( const auto& f : faceVertices )
+		{
+			Face face;
+			if( !CreateFace(getPoint(index[f[0]]), getPoint(index[f[1]]), getPoint(index[f[2]]), index[f[0]], index[f[1]], index[f[2]], face) )
+				return false;
+			if( DotProduct(face.normal, getPoint(index[f[3]])) > face.distance )
+			{
+				std::swap(face.v[1], face.v[2]);
+				face.normal = -face.normal;
+				face.distance = -face.distance;
+			}
+			outFaces.push_back(face);
+		}
+		return true;
+	}
+
+	//   :   ,        ( )
+	inline void FindHorizon(const std::vector<Face>& faces, const std::vector<uint32_t>& visible, std::vector<std::pair<uint32_t, uint32_t>>& outHorizon)
+	{
+		outHorizon.clear();
+		for( const uint32_t f : visible )
+		{
+			for( int e = 0; e < 3; e++ )
+			{
+				const uint32_t from = faces[f].v[e];
+				const uint32_t to = faces[f].v[(e + 1) % 3];
+				bool isShared = false;
+				for( const uint32_t other : visible )
+				{
+					const Face& face = faces[other];
+					for( int k = 0; k < 3 && !isShared; k++ )
+						isShared = face.v[k] == to && face.v[(k + 1) % 3] == from;
+				}
+				if( !isShared ) outHorizon.push_back({ from, to });
+			}
+		}
+	}
+}
+
+inline bool ConvexHull::Build(const std::vector<Vector3>& points, size_t maxVertices)
+{
+	return Build(points.data(), points.size(), maxVertices);
+}
+
+inline bool ConvexHull::Build(const Vector3* points, size_t count, size_t maxVertices)
+{
+	using convexHull::Face;
+	Clear();
+	if( count < 4 ) return false;
+	if( maxVertices != 0 && maxVertices < 4 ) maxVertices = 4;
+
+	//    
+	Vector3 maxAbs(0.0f);
+	uint32_t extremes[6] = {}; // min x, max x, min y, ...
+	for( uint32_t i = 0; i < (uint32_t)count; i++ )
+	{
+		for( int axis = 0; axis < 3; axis++ )
+		{
+			maxAbs[axis] = Max(maxAbs[axis], fabsf(points[i][axis]));
+			if( points[i][axis] < points[extremes[axis * 2]][axis] ) extremes[axis * 2] = i;
+			if( points[i][axis] > points[extremes[axis * 2 + 1]][axis] ) extremes[axis * 2 + 1] = i;
+		}
+	}
+	const float epsilon = 3.0f * FLT_EPSILON * (maxAbs.x + maxAbs.y + maxAbs.z);
+
+	//  :     ,    ,    
+	uint32_t initial[4] = {};
+	float best = 0.0f;
+	for( int i = 0; i < 6; i++ )
+	{
+		for( int j = i + 1; j < 6; j++ )
+		{
+			const Vector3 d = points[extremes[j]] - points[extremes[i]];
+			if( DotProduct(d, d) > best )
+			{
+				best = DotProduct(d, d);
+				initial[0] = extremes[i];
+				initial[1] = extremes[j];
+			}
+		}
+	}
+	if( best <= epsilon * epsilon ) return false;
+
+	const Vector3 lineDirection = (points[initial[1]] - points[initial[0]]).GetNormalize();
+	best = 0.0f;
+	for( uint32_t i = 0; i < (uint32_t)count; i++ )
+	{
+		const Vector3 offset = CrossProduct(points[i] - points[initial[0]], lineDirection);
+		if( DotProduct(offset, offset) > best )
+		{
+			best = DotProduct(offset, offset);
+			initial[2] = i;
+		}
+	}
+	if( best <= epsilon * epsilon ) return false;
+
+	const Plane base(points[initial[0]], points[initial[1]], points[initial[2]]);
+	best = 0.0f;
+	for( uint32_t i = 0; i < (uint32_t)count; i++ )
+	{
+		const float distance = fabsf(base.SignedDistanceTo(points[i]));
+		if( distance > best )
+		{
+			best = distance;
+			initial[3] = i;
+		}
+	}
+	if( best <= epsilon ) return false;
+
+	std::vector<Face> faces;
+	if( !convexHull::CreateTetrahedron(initial, [&](uint32_t i) { return points[i]; }, faces) )
+		return false;
+
+	//   :    (   ,  )
+	std::vector<std::vector<uint32_t>> outside(faces.size());
+	auto assignPoint = [&](uint32_t point, size_t firstFace)
+	{
+		float bestDistance = epsilon;
+		size_t bestFace = SIZE_MAX;
+		for( size_t f = firstFace; f < faces.size(); f++ )
+		{
+			if( faces[f].isRemoved ) continue;
+			const float distance = DotProduct(faces[f].normal, points[point]) - faces[f].distance;
+			if( distance > bestDistance )
+			{
+				bestDistance = distance;
+				bestFace = f;
+			}
+		}
+		if( bestFace != SIZE_MAX ) outside[bestFace].push_back(point);
+	};
+	for( uint32_t i = 0; i < (uint32_t)count; i++ )
+	{
+		if( i != initial[0] && i != initial[1] && i != initial[2] && i != initial[3] )
+			assignPoint(i, 0);
+	}
+	auto farthestPoint = [&](size_t f, float& outDistance)
+	{
+		uint32_t farthest = UINT32_MAX;
+		outDistance = 0.0f;
+		for( const uint32_t point : outside[f] )
+		{
+			const float distance = DotProduct(faces[f].normal, points[point]) - faces[f].distance;
+			if( distance > outDistance )
+			{
+				outDistance = distance;
+				farthest = point;
+			}
+		}
+		return farthest;
+	};
+
+	std::vector<uint32_t> visible;
+	std::vector<std::pair<uint32_t, uint32_t>> horizon;
+	std::vector<uint32_t> orphans;
+	size_t vertexCount = 4;
+	while( true )
+	{
+		//        
+		float farthestDistance = 0.0f;
+		uint32_t eye = UINT32_MAX;
+		for( size_t f = 0; f < faces.size(); f++ )
+		{
+			if( faces[f].isRemoved || outside[f].empty() ) continue;
+			float distance = 0.0f;
+			const uint32_t point = farthestPoint(f, distance);
+			if( distance > farthestDistance )
+			{
+				farthestDistance = distance;
+				eye = point;
+			}
+		}
+		m_error = farthestDistance;
+		if( eye == UINT32_MAX || (maxVertices != 0 && vertexCount >= maxVertices) )
+			break;
+
+		// ,    ,      
+		visible.clear();
+		orphans.clear();
+		for( uint32_t f = 0; f < (uint32_t)faces.size(); f++ )
+		{
+			if( faces[f].isRemoved || DotProduct(faces[f].normal, points[eye]) - faces[f].distance <= epsilon ) continue;
+			visible.push_back(f);
+		}
+		convexHull::FindHorizon(faces, visible, horizon);
+		for( const uint32_t f : visible )
+		{
+			faces[f].isRemoved = true;
+			for( const uint32_t point : outside[f] )
+			{
+				if( point != eye ) orphans.push_back(point);
+			}
+			outside[f].clear();
+			outside[f].shrink_to_fit();
+		}
+
+		const size_t firstNewFace = faces.size();
+		for( const auto& edge : horizon )
+		{
+			Face face;
+			if( convexHull::CreateFace(points[edge.first], points[edge.second], points[eye], edge.first, edge.second, eye, face) )
+				faces.push_back(face);
+		}
+		outside.resize(faces.size());
+		for( const uint32_t point : orphans )
+			assignPoint(point, firstNewFace);
+		vertexCount++;
+	}
+
+	//         
+	std::vector<uint32_t> remap(count, UINT32_MAX);
+	for( const Face& face : faces )
+	{
+		if( face.isRemoved ) continue;
+		for( const uint32_t v : face.v )
+		{
+			if( remap[v] == UINT32_MAX )
+			{
+				remap[v] = (uint32_t)vertices.size();
+				vertices.push_back(points[v]);
+			}
+			indices.push_back(remap[v]);
+		}
+
+		bool isMerged = false;
+		for( const Plane& plane : planes )
+			isMerged = isMerged || (DotProduct(plane.normal, face.normal) > 1.0f - 1e-5f && fabsf(plane.SignedDistanceTo(points[face.v[0]])) <= epsilon * 4.0f);
+		if( !isMerged ) planes.push_back(Plane(points[face.v[0]], face.normal));
+	}
+	return true;
+}
+
+inline void ConvexHull::Clear()
+{
+	vertices.clear();
+	indices.clear();
+	planes.clear();
+	m_error = 0.0f;
+}
+
+inline Vector3 ConvexHull::GetSupport(const Vector3& direction) const
+{
+	size_t best = 0;
+	float bestDot = -std::numeric_limits<float>::max();
+	for( size_t i = 0; i < vertices.size(); i++ )
+	{
+		const float d = DotProduct(vertices[i], direction);
+		if( d > bestDot )
+		{
+			bestDot = d;
+			best = i;
+		}
+	}
+	return vertices[best];
+}
+
+inline bool ConvexHull::Contains(const Vector3& point, float tolerance) const
+{
+	for( const Plane& plane : planes )
+	{
+		if( plane.SignedDistanceTo(point) > tolerance ) return false;
+	}
+	return !planes.empty();
+}
+
+inline std::vector<Vector3> ConvexHull::GetTriangles() const
+{
+	std::vector<Vector3> triangles(indices.size());
+	for( size_t i = 0; i < indices.size(); i++ )
+		triangles[i] = vertices[indices[i]];
+	return triangles;
+}
+
+//=============================================================================
+// GJK / EPA
+//=============================================================================
+
+inline Vector3 ConvexShape::GetSupport(const Vector3& direction) const
+{
+	if( m_hull )
+	{
+		//     ,       
+		const Vector3 localDirection = m_transform.rotate.Conjugate() * direction;
+		return m_transform.ToTransform(m_hull->GetSupport(localDirection));
+	}
+	return DotProduct(m_points[0], direction) >= DotProduct(m_points[1], direction) ? m_points[0] : m_points[1];
+}
+
+namespace gjk
+{
+	constexpr int MaxIterations = 64;
+
+	//    A - B     
+	struct Vertex
+	{
+		Vector3 a, b, w;
+	};
+
+	struct Simplex
+	{
+		Vertex v[4];
+		float barycentric[4];
+		int count = 0;
+	};
+
+	inline Vertex Support(const ConvexShape& a, const ConvexShape& b, const Vector3& direction)
+	{
+		Vertex vertex;
+		vertex.a = a.GetSupport(direction);
+		vertex.b = b.GetSupport(-direction);
+		vertex.w = vertex.a - vertex.b;
+		return vertex;
+	}
+
+	inline void Reduce(Simplex& simplex, std::initializer_list<std::pair<int, float>> keep)
+	{
+		Vertex vertices[4];
+		float barycentric[4];
+		int count = 0;
+		for( const auto& [index, weight] : keep )
+		{
+			vertices[count] = simplex.v[index];
+			barycentric[count++] = weight;
+		}
+		for( int i = 0; i < count; i++ )
+		{
+			simplex.v[i] = vertices[i];
+			simplex.barycentric[i] = barycentric[i];
+		}
+		simplex.count = count;
+	}
+
+	inline void SolveSegment(Simplex& simplex)
+	{
+		const Vector3& a = simplex.v[0].w;
+		const Vector3 ab = simplex.v[1].w - a;
+		const float lengthSquared = DotProduct(ab, ab);
+		const float t = lengthSquared > 0.0f ? -DotProduct(a, ab) / lengthSquared : 0.0f;
+		if( t <= 0.0f ) Reduce(simplex, { { 0, 1.0f } });
+		else if( t >= 1.0f ) Reduce(simplex, { { 1, 1.0f } });
+		else Reduce(simplex, { { 0, 1.0f - t }, { 1, t } });
+	}
+
+	//          (Ericson, Real-Time Collision Detection 5.1.5)
+	inline void SolveTriangle(Simplex& simplex)
+	{
+		const Vector3& a = simplex.v[0].w;
+		const Vector3& b = simplex.v[1].w;
+		const Vector3& c = simplex.v[2].w;
+		const Vector3 ab = b - a;
+		const Vector3 ac = c - a;
+
+		const float d1 = -DotProduct(ab, a);
+		const float d2 = -DotProduct(ac, a);
+		if( d1 <= 0.0f && d2 <= 0.0f ) return Reduce(simplex, { { 0, 1.0f } });
+
+		const float d3 = -DotProduct(ab, b);
+		const float d4 = -DotProduct(ac, b);
+		if( d3 >= 0.0f && d4 <= d3 ) return Reduce(simplex, { { 1, 1.0f } });
+
+		const float vc = d1 * d4 - d3 * d2;
+		if( vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f )
+		{
+			const float v = d1 / (d1 - d3);
+			return Reduce(simplex, { { 0, 1.0f - v }, { 1, v } });
+		}
+
+		const float d5 = -DotProduct(ab, c);
+		const float d6 = -DotProduct(ac, c);
+		if( d6 >= 0.0f && d5 <= d6 ) return Reduce(simplex, { { 2, 1.0f } });
+
+		const float vb = d5 * d2 - d1 * d6;
+		if( vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f )
+		{
+			const float w = d2 / (d2 - d6);
+			return Reduce(simplex, { { 0, 1.0f - w }, { 2, w } });
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+		if( va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f )
+		{
+			const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return Reduce(simplex, { { 1, 1.0f - w }, { 2, w } });
+		}
+
+		const float sum = va + vb + vc;
+		if( sum <= 0.0f )
+		{
+			//   -   
+			Simplex best = simplex;
+			float bestDistance = std::numeric_limits<float>::max();
+			for( const auto& edge : { std::pair<int, int>{ 0, 1 }, std::pair<int, int>{ 0, 2 }, std::pair<int, int>{ 1, 2 } } )
+			{
+				Simplex candidate = simplex;
+				Reduce(candidate, { { edge.first, 0.0f }, { edge.second, 0.0f } });
+				SolveSegment(candidate);
+				Vector3 point(0.0f);
+				for( int i = 0; i < candidate.count; i++ )
+					point += candidate.v[i].w * candidate.barycentric[i];
+				if( DotProduct(point, point) < bestDistance )
+				{
+					bestDistance = DotProduct(point, point);
+					best = candidate;
+				}
+			}
+			simplex = best;
+			return;
+		}
+		const float v = vb / sum;
+		const float w = vc / sum;
+		simplex.barycentric[0] = 1.0f - v - w;
+		simplex.barycentric[1] = v;
+		simplex.barycentric[2] = w;
+	}
+
+	// false -    
+	inline bool SolveTetrahedron(Simplex& simplex)
+	{
+		static constexpr int faceVertices[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+		Simplex best;
+		float bestDistance = std::numeric_limits<float>::max();
+		for( const auto& f : faceVertices )
+		{
+			const Vector3& p0 = simplex.v[f[0]].w;
+			const Vector3 normal = CrossProduct(simplex.v[f[1]].w - p0, simplex.v[f[2]].w - p0);
+			const float originSide = -DotProduct(normal, p0);
+			const float oppositeSide = DotProduct(normal, simplex.v[f[3]].w - p0);
+			//       ,    
+			if( originSide * oppositeSide > 0.0f ) continue;
+
+			Simplex candidate = simplex;
+			Reduce(candidate, { { f[0], 0.0f }, { f[1], 0.0f }, { f[2], 0.0f } });
+			SolveTriangle(candidate);
+			Vector3 point(0.0f);
+			for( int i = 0; i < candidate.count; i++ )
+				point += candidate.v[i].w * candidate.barycentric[i];
+			if( DotProduct(point, point) < bestDistance )
+			{
+				bestDistance = DotProduct(point, point);
+				best = candidate;
+			}
+		}
+		if( bestDistance == std::numeric_limits<float>::max() ) return false;
+		simplex = best;
+		return true;
+	}
+
+	//    A  B, false -   (simplex -    EPA)
+	inline bool Distance(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Vector3& outPointA, Vector3& outPointB)
+	{
+		simplex.count = 1;
+		simplex.v[0] = Support(a, b, Vector3(1.0f, 0.0f, 0.0f));
+		simplex.barycentric[0] = 1.0f;
+
+		for( int iteration = 0; iteration < MaxIterations; iteration++ )
+		{
+			if( simplex.count == 2 ) SolveSegment(simplex);
+			else if( simplex.count == 3 ) SolveTriangle(simplex);
+			else if( simplex.count == 4 && !SolveTetrahedron(simplex) ) return false;
+
+			Vector3 closest(0.0f);
+			for( int i = 0; i < simplex.count; i++ )
+				closest += simplex.v[i].w * simplex.barycentric[i];
+			const float distanceSquared = DotProduct(closest, closest);
+			if( distanceSquared < 1e-12f ) return false;
+
+			//         -  
+			const Vertex vertex = Support(a, b, -closest);
+			bool isDuplicate = false;
+			for( int i = 0; i < simplex.count; i++ )
+				isDuplicate = isDuplicate || simplex.v[i].w == vertex.w;
+			if( isDuplicate || distanceSquared - DotProduct(closest, vertex.w) <= 1e-6f * distanceSquared )
+				break;
+			simplex.v[simplex.count] = vertex;
+			simplex.barycentric[simplex.count++] = 0.0f;
+		}
+
+		outPointA = Vector3(0.0f);
+		outPointB = Vector3(0.0f);
+		for( int i = 0; i < simplex.count; i++ )
+		{
+			outPointA += simplex.v[i].a * simplex.barycentric[i];
+			outPointB += simplex.v[i].b * simplex.barycentric[i];
+		}
+		return true;
+	}
+
+	// EPA:   ,   ,    . false -   ()
+	inline bool Penetration(const ConvexShape& a, const ConvexShape& b, Simplex& simplex, Vector3& outNormal, float& outDepth, Vector3& outPointA, Vector3& outPointB)
+	{
+		using convexHull::Face;
+
+		// ,   GJK  ,   
+		static const Vector3 axes[6] = { { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+		constexpr float Tolerance = 1e-5f;
+		auto addVertex = [&](const Vector3& direction)
+		{
+			const Vertex vertex = Support(a, b, direction);
+			if( simplex.count == 1 && Distance(vertex.w, simplex.v[0].w) < Tolerance ) return false;
+			if( simplex.count == 2 && CrossProduct(simplex.v[1].w - simplex.v[0].w, vertex.w - simplex.v[0].w).GetLength() < Tolerance ) return false;
+			if( simplex.count == 3 && fabsf(DotProduct(CrossProduct(simplex.v[1].w - simplex.v[0].w, simplex.v[2].w - simplex.v[0].w), vertex.w - simplex.v[0].w)) < Tolerance ) return false;
+			simplex.v[simplex.count++] = vertex;
+			return true;
+		};
+		if( simplex.count == 1 )
+		{
+			for( int i = 0; i < 6 && simplex.count == 1; i++ )
+				addVertex(axes[i]);
+		}
+		if( simplex.count == 2 )
+		{
+			const Vector3 edge = simplex.v[1].w - simplex.v[0].w;
+			for( int i = 0; i < 6 && simplex.count == 2; i++ )
+			{
+				const Vector3 perpendicular = CrossProduct(edge, axes[i]);
+				if( DotProduct(perpendicular, perpendicular) > 1e-12f ) addVertex(perpendicular);
+			}
+		}
+		if( simplex.count == 3 )
+		{
+			const Vector3 normal = CrossProduct(simplex.v[1].w - simplex.v[0].w, simplex.v[2].w - simplex.v[0].w);
+			if( !addVertex(normal) ) addVertex(-normal);
+		}
+		if( simplex.count < 4 ) return false;
+
+		std::vector<Vertex> vertices(simplex.v, simplex.v + 4);
+		std::vector<Face> faces;
+		const uint32_t initial[4] = { 0, 1, 2, 3 };
+		if( !convexHull::CreateTetrahedron(initial, [&](uint32_t i) { return vertices[i].w; }, faces) )
+			return false;
+
+		std::vector<uint32_t> visible;
+		std::vector<std::pair<uint32_t, uint32_t>> horizon;
+		size_t closest = 0;
+		for( int iteration = 0; iteration < MaxIterations; iteration++ )
+		{
+			float closestDistance = std::numeric_limits<float>::max();
+			for( size_t f = 0; f < faces.size(); f++ )
+			{
+				if( !faces[f].isRemoved && faces[f].distance < closestDistance )
+				{
+					closestDistance = faces[f].distance;
+					closest = f;
+				}
+			}
+
+			const Vertex vertex = Support(a, b, faces[closest].normal);
+			if( DotProduct(faces[closest].normal, vertex.w) - closestDistance <= Tolerance * Max(1.0f, closestDistance) )
+				break;
+
+			visible.clear();
+			for( uint32_t f = 0; f < (uint32_t)faces.size(); f++ )
+			{
+				if( !faces[f].isRemoved && DotProduct(faces[f].normal, vertex.w) - faces[f].distance > Tolerance )
+					visible.push_back(f);
+			}
+			if( visible.empty() ) break;
+			convexHull::FindHorizon(faces, visible, horizon);
+			for( const uint32_t f : visible )
+				faces[f].isRemoved = true;
+
+			const uint32_t index = (uint32_t)vertices.size();
+			vertices.push_back(vertex);
+			for( const auto& edge : horizon )
+			{
+				Face face;
+				if( convexHull::CreateFace(vertices[edge.first].w, vertices[edge.second].w, vertex.w, edge.first, edge.second, index, face) )
+					faces.push_back(face);
+			}
+		}
+
+		//         
+		const Face& face = faces[closest];
+		const Vertex& v0 = vertices[face.v[0]];
+		const Vertex& v1 = vertices[face.v[1]];
+		const Vertex& v2 = vertices[face.v[2]];
+		const Vector3 point = face.normal * face.distance;
+		const Vector3 e0 = v1.w - v0.w;
+		const Vector3 e1 = v2.w - v0.w;
+		const Vector3 e2 = point - v0.w;
+		const float d00 = DotProduct(e0, e0);
+		const float d01 = DotProduct(e0, e1);
+		const float d11 = DotProduct(e1, e1);
+		const float d20 = DotProduct(e2, e0);
+		const float d21 = DotProduct(e2, e1);
+		const float denominator = d00 * d11 - d01 * d01;
+		const float v = denominator != 0.0f ? (d11 * d20 - d01 * d21) / denominator : 0.0f;
+		const float w = denominator != 0.0f ? (d00 * d21 - d01 * d20) / denominator : 0.0f;
+		const float u = 1.0f - v - w;
+
+		outNormal = face.normal;
+		outDepth = face.distance;
+		outPointA = v0.a * u + v1.a * v + v2.a * w;
+		outPointB = v0.b * u + v1.b * v + v2.b * w;
+		return true;
+	}
+}
+
+inline bool ConvexOverlap(const ConvexShape& a, const ConvexShape& b)
+{
+	gjk::Simplex simplex;
+	Vector3 pointA, pointB;
+	if( !gjk::Distance(a, b, simplex, pointA, pointB) ) return true;
+	const float radius = a.GetRadius() + b.GetRadius();
+	return DotProduct(pointB - pointA, pointB - pointA) <= radius * radius;
+}
+
+inline bool ConvexCollide(const ConvexShape& a, const ConvexShape& b, ConvexContact& outContact)
+{
+	gjk::Simplex simplex;
+	Vector3 pointA, pointB;
+	Vector3 normal(0.0f, 1.0f, 0.0f);
+	float coreDistance = 0.0f;
+	if( gjk::Distance(a, b, simplex, pointA, pointB) )
+	{
+		coreDistance = Distance(pointA, pointB);
+		if( coreDistance > 0.0f ) normal = (pointB - pointA) / coreDistance;
+	}
+	else
+	{
+		//  ;   (,     ) -   
+		float depth = 0.0f;
+		if( gjk::Penetration(a, b, simplex, normal, depth, pointA, pointB) )
+			coreDistance = -depth;
+		else
+		{
+			pointA = simplex.v[0].a;
+			pointB = simplex.v[0].b;
+		}
+	}
+
+	outContact.distance = coreDistance - a.GetRadius() - b.GetRadius();
+	outContact.normal = normal;
+	outContact.pointA = pointA + normal * a.GetRadius();
+	outContact.pointB = pointB - normal * b.GetRadius();
+	return outContact.distance < 0.0f;
+}
@@ -9,7 +9,10 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
+#include <filesystem>
+#include <fstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
@@ -18,63 +21,285 @@
 #endif // _MSC_VER
 //-----------------------------------------------------------------------------
 // MicroEngine
-extern void LogError(const std::string& msg);
-extern void LogWarning(const std::string& msg);
+#include "MicroEngine.h"
 // MicroAdvance
 namespace ResourceCacheSystem
 {
 	extern Texture2D* LoadTexture2D(const char* fileName, const Texture2DInfo& textureInfo);
 }
 //-----------------------------------------------------------------------------
-namespace std
+//=============================================================================
+// Model
+//=============================================================================
+//-----------------------------------------------------------------------------
+// Бинарный формат меша: [Header][SubMesh x subMeshCount][MaterialFile x materialFileCount][имена][вершины и индексы сабмешей]
+// Смещения от начала файла, блоки вершин и индексов выровнены по 16 байт. Вершины хранятся как VertexMesh,
+// индексы как uint32_t - при загрузке блоки передаются в буферы без разбора
+namespace cookedMesh
 {
-	// магия хеширования из glm, по хорошему изменить
-	void hash_combine(size_t& seed, size_t hash)
+	constexpr uint32_t Magic = 0x4853454D; // "MESH"
+	constexpr uint32_t Version = 4; // 2 - сабмеши после OptimizeMesh, 3 - статистика OptimizeMesh в Header, 4 - штампы .mtl файлов
+	constexpr size_t Alignment = 16;
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexSize; // sizeof(VertexMesh) - при изменении формата вершины кэш пересоздается
+		uint32_t subMeshCount;
+		uint32_t materialFileCount;
+		uint64_t sourceSize; // размер и время изменения исходного файла - при несовпадении кэш устарел
+		int64_t sourceTime;
+		Vector3 boundsMin;
+		Vector3 boundsMax;
+		// статистика кэша вершин всех сабмешей до и после OptimizeMesh (VertexCacheStatistics)
+		uint64_t cacheTriangles;
+		uint64_t cacheVerticesBefore;
+		uint64_t cacheMissesBefore;
+		uint64_t cacheVerticesAfter;
+		uint64_t cacheMissesAfter;
+	};
+
+	struct SubMesh
+	{
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t textureNameOffset; // имя диффузной текстуры относительно pathMaterialFiles
+		uint32_t textureNameLength; // 0 - нет текстуры
+		Vector3 ambientColor;
+		Vector3 diffuseColor;
+		Vector3 specularColor;
+		float shininess;
+		Vector3 boundsMin;
+		Vector3 boundsMax;
+	};
+
+	// .mtl файл, из которого взяты материалы и имена текстур - при его изменении кэш устарел
+	struct MaterialFile
+	{
+		uint64_t size;
+		int64_t time;
+		uint32_t nameOffset; // имя относительно pathMaterialFiles
+		uint32_t nameLength;
+	};
+
+	static_assert(std::is_trivially_copyable_v<VertexMesh>);
+	static_assert(alignof(VertexMesh) <= Alignment && alignof(uint32_t) <= Alignment);
+
+	bool GetSourceStamp(const char* fileName, uint64_t& size, int64_t& time)
+	{
+		std::error_code error;
+		size = (uint64_t)std::filesystem::file_size(fileName, error);
+		if (error) return false;
+		time = (int64_t)std::filesystem::last_write_time(fileName, error).time_since_epoch().count();
+		return !error;
+	}
+
+	size_t Align(size_t offset)
+	{
+		return (offset + Alignment - 1) & ~(Alignment - 1);
+	}
+
+	// блок из count элементов размера stride по смещению offset лежит внутри файла и выровнен (без переполнения в offset + count * stride)
+	bool IsValidBlock(uint64_t offset, uint64_t count, size_t stride, size_t alignment, size_t fileSize)
 	{
-		hash += 0x9e3779b9 + (seed << 6) + (seed >> 2);
-		seed ^= hash;
+		return offset % alignment == 0 && offset <= fileSize && count <= (fileSize - offset) / stride;
 	}
 
-	template<>
-	struct hash<Vector2>
+	// MaterialFileReader, запоминающий имена прочитанных .mtl файлов
+	class MaterialFileRecorder final : public tinyobj::MaterialFileReader
 	{
-		size_t operator()(const Vector2& v) const
+	public:
+		MaterialFileRecorder(const std::string& baseDir, std::vector<std::string>& fileNames) : MaterialFileReader(baseDir), m_fileNames(fileNames) {}
+
+		bool operator()(const std::string& matId, std::vector<tinyobj::material_t>* materials, std::map<std::string, int>* matMap, std::string* warn, std::string* err) final
 		{
-			size_t seed = 0;
-			hash<float> hasher;
-			hash_combine(seed, hasher(v.x));
-			hash_combine(seed, hasher(v.y));
-			return seed;
+			if (!MaterialFileReader::operator()(matId, materials, matMap, warn, err))
+				return false;
+			m_fileNames.push_back(matId);
+			return true;
 		}
+
+	private:
+		std::vector<std::string>& m_fileNames;
 	};
+}
+//-----------------------------------------------------------------------------
+VertexMeshLayout getArenaLayout(const GeometryArena& arena)
+{
+	const unsigned vertexSize = arena.GetVertexSize();
+	if (vertexSize == GetVertexMeshSize(VertexMeshLayout::Packed)) return VertexMeshLayout::Packed;
+	if (vertexSize == GetVertexMeshSize(VertexMeshLayout::PackedWhite)) return VertexMeshLayout::PackedWhite;
+	assert(vertexSize == sizeof(VertexMesh));
+	return VertexMeshLayout::Float;
+}
+//-----------------------------------------------------------------------------
+bool createMeshBuffer(Mesh& mesh, GeometryArena* arena, const VertexMesh* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, VertexMeshQuantizationError& ioError)
+{
+	const VertexMeshLayout meshLayout = SelectVertexMeshLayout(vertices, vertexCount);
+	VertexMeshLayout layout = meshLayout;
+	if (arena)
+	{
+		layout = getArenaLayout(*arena);
+		if (layout == VertexMeshLayout::PackedWhite && meshLayout != VertexMeshLayout::PackedWhite)
+		{
+			LogWarning("GeometryArena has no vertex color, mesh uses own buffers");
+			layout = meshLayout;
+			arena = nullptr;
+		}
+		else if (arena->GetIndexSize() < GetIndexSize(vertexCount))
+		{
+			LogWarning("GeometryArena has 16-bit indices, mesh uses own buffers");
+			layout = meshLayout;
+			arena = nullptr;
+		}
+	}
+
+	// на CPU остаются исходные вершины, в буфер идут квантованные
+	std::vector<uint8_t> packedVertices;
+	const void* vertexData = vertices;
+	if (layout != VertexMeshLayout::Float)
+	{
+		packedVertices.resize(vertexCount * GetVertexMeshSize(layout));
+		PackVertexMesh(vertices, vertexCount, layout, packedVertices.data(), ioError);
+		vertexData = packedVertices.data();
+	}
+	mesh.layout = layout;
 
-	template<>
-	struct hash<Vector3>
+	if (arena)
 	{
-		size_t operator()(const Vector3& v) const
+		if (arena->Allocate(vertexData, (unsigned)vertexCount, indices, (unsigned)indexCount, mesh.arenaRange))
 		{
-			size_t seed = 0;
-			hash<float> hasher;
-			hash_combine(seed, hasher(v.x));
-			hash_combine(seed, hasher(v.y));
-			hash_combine(seed, hasher(v.z));
-			return seed;
+			mesh.arena = arena;
+			return true;
 		}
+		LogWarning("GeometryArena is full, mesh uses own buffers");
+		if (layout != meshLayout) // раскладка arena шире нужной
+			return createMeshBuffer(mesh, nullptr, vertices, vertexCount, indices, indexCount, ioError);
+	}
+	mesh.arena = nullptr;
+
+	if (!mesh.vertexBuffer.Create(RenderResourceUsage::Static, vertexCount, GetVertexMeshSize(layout), vertexData))
+	{
+		LogError("VertexBuffer create failed!");
+		return false;
+	}
+	const unsigned indexSize = GetIndexSize(vertexCount);
+	std::vector<uint16_t> shortIndices;
+	const void* indexData = indices;
+	if (indexSize == sizeof(uint16_t))
+	{
+		shortIndices.resize(indexCount);
+		for (size_t i = 0; i < indexCount; i++)
+			shortIndices[i] = (uint16_t)indices[i];
+		indexData = shortIndices.data();
+	}
+	if (!mesh.indexBuffer.Create(RenderResourceUsage::Static, indexCount, indexSize, indexData))
+	{
+		LogError("IndexBuffer create failed!");
+		return false;
+	}
+	if (!mesh.vao.Create(&mesh.vertexBuffer, &mesh.indexBuffer, GetVertexMeshFormat(layout)))
+	{
+		LogError("VAO create failed!");
+		return false;
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+const std::vector<VertexAttribute>& GetVertexMeshFormat(VertexMeshLayout layout)
+{
+	static const std::vector<VertexAttribute> formatVertex =
+	{
+		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, position)},
+		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, normal)},
+		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, color)},
+		{.size = 2, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, texCoord)}
+	};
+	static const std::vector<VertexAttribute> formatPacked =
+	{
+		{.size = 3, .type = VertexAttributeType::Float, .normalized = false, .stride = sizeof(VertexMeshPacked), .offset = (void*)offsetof(VertexMeshPacked, position)},
+		{.size = 4, .type = VertexAttributeType::Int2_10_10_10, .normalized = true, .stride = sizeof(VertexMeshPacked), .offset = (void*)offsetof(VertexMeshPacked, normal)},
+		{.size = 4, .type = VertexAttributeType::UnsignedByte, .normalized = true, .stride = sizeof(VertexMeshPacked), .offset = (void*)offsetof(VertexMeshPacked, color)},
+		{.size = 2, .type = VertexAttributeType::HalfFloat, .normalized = false, .stride = sizeof(VertexMeshPacked), .offset = (void*)offsetof(VertexMeshPacked, texCoord)}
+	};
+	static const Vector4 white(1.0f);
+	static const std::vector<VertexAttribute> formatPackedWhite =
+	{
+		{.size = 3, .type = VertexAttributeType::Float, .normalized = false, .stride = (int)offsetof(VertexMeshPacked, color), .offset = (void*)offsetof(VertexMeshPacked, position)},
+		{.size = 4, .type = VertexAttributeType::Int2_10_10_10, .normalized = true, .stride = (int)offsetof(VertexMeshPacked, color), .offset = (void*)offsetof(VertexMeshPacked, normal)},
+		{.size = 4, .normalized = false, .stride = 0, .offset = nullptr, .constantValue = &white},
+		{.size = 2, .type = VertexAttributeType::HalfFloat, .normalized = false, .stride = (int)offsetof(VertexMeshPacked, color), .offset = (void*)offsetof(VertexMeshPacked, texCoord)}
 	};
 
-	template <>
-	struct hash<VertexMesh>
+	switch (layout)
+	{
+	case VertexMeshLayout::Packed:      return formatPacked;
+	case VertexMeshLayout::PackedWhite: return formatPackedWhite;
+	default:                            return formatVertex;
+	}
+}
+//-----------------------------------------------------------------------------
+unsigned GetVertexMeshSize(VertexMeshLayout layout)
+{
+	switch (layout)
 	{
-		size_t operator()(const VertexMesh& vertex) const
+	case VertexMeshLayout::Packed:      return sizeof(VertexMeshPacked);
+	case VertexMeshLayout::PackedWhite: return offsetof(VertexMeshPacked, color);
+	default:                            return sizeof(VertexMesh);
+	}
+}
+//-----------------------------------------------------------------------------
+VertexMeshLayout SelectVertexMeshLayout(const VertexMesh* vertices, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (vertices[i].color != Vector3(1.0f))
+			return VertexMeshLayout::Packed;
+	}
+	return VertexMeshLayout::PackedWhite;
+}
+//-----------------------------------------------------------------------------
+void PackVertexMesh(const VertexMesh* vertices, size_t count, VertexMeshLayout layout, uint8_t* outData, VertexMeshQuantizationError& ioError)
+{
+	if (layout == VertexMeshLayout::Float)
+	{
+		memcpy(outData, vertices, count * sizeof(VertexMesh));
+		return;
+	}
+
+	const unsigned stride = GetVertexMeshSize(layout);
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexMesh& vertex = vertices[i];
+		VertexMeshPacked packed;
+		packed.position = vertex.position;
+		packed.normal = PackSnorm10x3(vertex.normal);
+		packed.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+		packed.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+		packed.color = PackUnorm8x4(Vector4(vertex.color, 1.0f));
+		memcpy(outData + i * stride, &packed, stride); // у PackedWhite color отрезается
+
+		const Vector3 normal = UnpackSnorm10x3(packed.normal);
+		ioError.normal = Max(ioError.normal, Max(fabsf(normal.x - vertex.normal.x), Max(fabsf(normal.y - vertex.normal.y), fabsf(normal.z - vertex.normal.z))));
+		ioError.texCoord = Max(ioError.texCoord, Max(fabsf(HalfToFloat(packed.texCoord[0]) - vertex.texCoord.x), fabsf(HalfToFloat(packed.texCoord[1]) - vertex.texCoord.y)));
+		if (layout == VertexMeshLayout::Packed)
 		{
-			return ((hash<Vector3>()(vertex.position) ^ (hash<Vector2>()(vertex.texCoord) << 1)) >> 1);
+			const Vector4 color = UnpackUnorm8x4(packed.color);
+			ioError.color = Max(ioError.color, Max(fabsf(color.x - vertex.color.x), Max(fabsf(color.y - vertex.color.y), fabsf(color.z - vertex.color.z))));
 		}
-	};
-} // namespace std
+	}
+}
 //-----------------------------------------------------------------------------
-//=============================================================================
-// Model
-//=============================================================================
+void Mesh::Draw()
+{
+	if (arena)
+		arena->Draw(arenaRange);
+	else
+		vao.Draw(PrimitiveDraw::Triangles);
+}
 //-----------------------------------------------------------------------------
 std::vector<Vector3> Mesh::GetTriangles() const
 {
@@ -85,21 +310,36 @@ std::vector<Vector3> Mesh::GetTriangles() const
 	return v;
 }
 //-----------------------------------------------------------------------------
-bool Model::Create(const char* fileName, const char* pathMaterialFiles)
+bool Model::Create(const char* fileName, const char* pathMaterialFiles, GeometryArena* arena)
 {
 	Destroy();
+	m_arena = arena;
+	m_quantizationError = {};
+	m_optimizationStatistics = {};
 	bool success = false;
 	if( std::string(fileName).find(".obj") != std::string::npos )
 	{
-		success = loadObjFile(fileName, pathMaterialFiles);
+		const std::string cacheFileName = std::string(fileName) + ".mesh";
+		success = loadCookedFile(cacheFileName.c_str(), fileName, pathMaterialFiles);
+		if( !success )
+		{
+			std::vector<std::string> textureNames;
+			std::vector<std::string> materialFileNames;
+			success = loadObjFile(fileName, pathMaterialFiles, textureNames, materialFileNames);
+			if( success && !saveCookedFile(cacheFileName.c_str(), fileName, pathMaterialFiles, textureNames, materialFileNames) )
+				LogWarning("Model: failed to write mesh cache " + cacheFileName);
+		}
 	}
 
 	return success;
 }
 //-----------------------------------------------------------------------------
-bool Model::Create(std::vector<Mesh>&& meshes)
+bool Model::Create(std::vector<Mesh>&& meshes, GeometryArena* arena)
 {
 	Destroy();
+	m_arena = arena;
+	m_quantizationError = {};
+	m_optimizationStatistics = {};
 	m_subMeshes = std::move(meshes);
 	return createBuffer();
 }
@@ -114,6 +354,9 @@ void Model::Destroy()
 		m_subMeshes[i].vertexBuffer.Destroy();
 		m_subMeshes[i].indexBuffer.Destroy();
 		m_subMeshes[i].vao.Destroy();
+		if (m_subMeshes[i].arena)
+			m_subMeshes[i].arena->Free(m_subMeshes[i].arenaRange);
+		m_subMeshes[i].arena = nullptr;
 	}
 	m_subMeshes.clear();
 }
@@ -130,12 +373,12 @@ void Model::Draw()
 {
 	for (int i = 0; i < m_subMeshes.size(); i++)
 	{
-		if (m_subMeshes[i].vao.IsValid())
+		if (m_subMeshes[i].IsDrawable())
 		{
 			const Texture2D* diffuseTexture = m_subMeshes[i].material.diffuseTexture;
 			if (diffuseTexture && diffuseTexture->IsValid())
 				diffuseTexture->Bind(0);
-			m_subMeshes[i].vao.Draw(PrimitiveDraw::Triangles);
+			m_subMeshes[i].Draw();
 		}
 	}
 }
@@ -152,34 +395,53 @@ std::vector<Vector3> Model::GetTriangles() const
 	return v;
 }
 //-----------------------------------------------------------------------------
-bool Model::loadObjFile(const char* fileName, const char* pathMaterialFiles)
+AABB Model::GetBounds() const
 {
-	tinyobj::ObjReaderConfig readerConfig;
-	readerConfig.mtl_search_path = pathMaterialFiles; // Path to material files
-
-	tinyobj::ObjReader reader;
-	if (!reader.ParseFromFile(fileName, readerConfig))
+	AABB bounds;
+	bool isFirst = true;
+	for( size_t i = 0; i < m_subMeshes.size(); i++ )
 	{
-		if (!reader.Error().empty())
-			LogError("TinyObjReader: " + reader.Error());
+		if( m_subMeshes[i].vertices.empty() ) continue;
+		if( isFirst ) bounds = m_subMeshes[i].bounds;
+		else bounds.AddAABB(m_subMeshes[i].bounds);
+		isFirst = false;
+	}
+	return bounds;
+}
+//-----------------------------------------------------------------------------
+bool Model::loadObjFile(const char* fileName, const char* pathMaterialFiles, std::vector<std::string>& textureNames, std::vector<std::string>& materialFileNames)
+{
+	std::ifstream stream(fileName);
+	if (!stream)
+	{
+		LogError("TinyObjReader: Cannot open file " + std::string(fileName));
 		return false;
 	}
-	if (!reader.Warning().empty())
-		LogWarning("TinyObjReader: " + reader.Warning());
 
-	auto& attributes = reader.GetAttrib();
-	auto& shapes = reader.GetShapes();
-	auto& materials = reader.GetMaterials();
+	// имена прочитанных .mtl файлов сохраняются в кэш вместе с их штампами
+	cookedMesh::MaterialFileRecorder materialReader(pathMaterialFiles, materialFileNames);
+	tinyobj::attrib_t attributes;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
+	std::string warning, error;
+	if (!tinyobj::LoadObj(&attributes, &shapes, &materials, &warning, &error, &stream, &materialReader))
+	{
+		if (!error.empty())
+			LogError("TinyObjReader: " + error);
+		return false;
+	}
+	if (!warning.empty())
+		LogWarning("TinyObjReader: " + warning);
 
 	const bool isFindMaterials = !materials.empty();
 
 	std::vector<Mesh> tempMesh(materials.size());
-	std::vector<std::unordered_map<VertexMesh, uint32_t>> uniqueVertices(materials.size());
 	if (tempMesh.empty())
-	{
 		tempMesh.resize(1);
-		uniqueVertices.resize(1);
-	}
+
+	// уникальных вершин обычно столько же, сколько позиций, при необходимости таблица растет
+	VertexMeshIndexMap uniqueVertices;
+	uniqueVertices.Reserve(attributes.vertices.size() / 3);
 
 	// Loop over shapes
 	for (size_t shapeId = 0; shapeId < shapes.size(); shapeId++)
@@ -236,19 +498,14 @@ bool Model::loadObjFile(const char* fileName, const char* pathMaterialFiles)
 				vertex.color = { r, g, b };
 				vertex.texCoord = { tx,ty };
 
-				if (uniqueVertices[materialId].count(vertex) == 0)
-				{
-					uniqueVertices[materialId][vertex] = static_cast<uint32_t>(tempMesh[materialId].vertices.size());
-					tempMesh[materialId].vertices.emplace_back(vertex);
-				}
-
-				tempMesh[materialId].indices.emplace_back(uniqueVertices[materialId][vertex]);
+				tempMesh[materialId].indices.emplace_back(uniqueVertices.GetOrAdd((uint32_t)materialId, vertex, tempMesh[materialId].vertices));
 			}
 			index_offset += fv;
 		}
 	}
 
 	// load materials
+	std::vector<std::string> tempTextureNames(tempMesh.size());
 	bool isFindToTransparent = false;
 	if (isFindMaterials)
 	{
@@ -256,6 +513,7 @@ bool Model::loadObjFile(const char* fileName, const char* pathMaterialFiles)
 		{
 			if (materials[i].diffuse_texname.empty()) continue;
 
+			tempTextureNames[i] = materials[i].diffuse_texname;
 			std::string diffuseMap = pathMaterialFiles + materials[i].diffuse_texname;
 			tempMesh[i].material.diffuseTexture = ResourceCacheSystem::LoadTexture2D(diffuseMap.c_str(), {});
 			if (!isFindToTransparent && tempMesh[i].material.diffuseTexture)
@@ -263,72 +521,607 @@ bool Model::loadObjFile(const char* fileName, const char* pathMaterialFiles)
 		}
 	}
 
-	// сортировка по прозрачности
-	if (isFindToTransparent)
+	// сортировка по прозрачности: сначала непрозрачное, затем прозрачное (порядок сохраняется и в кэше)
+	m_subMeshes.clear();
+	m_subMeshes.reserve(tempMesh.size());
+	textureNames.clear();
+	textureNames.reserve(tempMesh.size());
+	for (int pass = 0; pass < (isFindToTransparent ? 2 : 1); pass++)
 	{
-		std::vector<Mesh> tempMesh2;
-
-		// TODO: медленно, оптимизировать
-
-		// сначала непрозрачное
-		for (int i = 0; i < tempMesh.size(); i++)
-		{
-			if (!tempMesh[i].material.diffuseTexture)
-				tempMesh2.push_back(tempMesh[i]);
-			else if (!tempMesh[i].material.diffuseTexture->isTransparent)
-				tempMesh2.push_back(tempMesh[i]);
-		}
-		// теперь прозрачное
-		for (int i = 0; i < tempMesh.size(); i++)
+		for (size_t i = 0; i < tempMesh.size(); i++)
 		{
-			if (tempMesh[i].material.diffuseTexture->isTransparent)
-				tempMesh2.push_back(tempMesh[i]);
+			const bool isTransparent = tempMesh[i].material.diffuseTexture && tempMesh[i].material.diffuseTexture->isTransparent;
+			if (isFindToTransparent && isTransparent != (pass == 1)) continue;
+			m_subMeshes.push_back(std::move(tempMesh[i]));
+			textureNames.push_back(std::move(tempTextureNames[i]));
 		}
+	}
 
-		m_subMeshes = std::move(tempMesh2);
+	// порядок треугольников и вершин оптимизируется один раз и сохраняется в кэше .mesh
+	for (size_t i = 0; i < m_subMeshes.size(); i++)
+	{
+		const MeshOptimizationStatistics statistics = OptimizeMesh(m_subMeshes[i].vertices, m_subMeshes[i].indices);
+		m_optimizationStatistics.before += statistics.before;
+		m_optimizationStatistics.after += statistics.after;
 	}
-	else
-		m_subMeshes = std::move(tempMesh);
+	LogPrint("Model " + std::string(fileName) + ": ACMR " + std::to_string(m_optimizationStatistics.before.GetACMR()) + " -> " + std::to_string(m_optimizationStatistics.after.GetACMR()) +
+		", ATVR " + std::to_string(m_optimizationStatistics.before.GetATVR()) + " -> " + std::to_string(m_optimizationStatistics.after.GetATVR()));
 
 	return createBuffer();
 }
 //-----------------------------------------------------------------------------
 bool Model::createBuffer()
 {
-	// формат вершин
-	const std::vector<VertexAttribute> formatVertex =
+	for (size_t i = 0; i < m_subMeshes.size(); i++)
 	{
-		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, position)},
-		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, normal)},
-		{.size = 3, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, color)},
-		{.size = 2, .normalized = false, .stride = sizeof(VertexMesh), .offset = (void*)offsetof(VertexMesh, texCoord)}
-	};
+		Mesh& mesh = m_subMeshes[i];
+		if (!createMeshBuffer(mesh, m_arena, mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size(), m_quantizationError))
+		{
+			Destroy();
+			return false;
+		}
 
-	for (int i = 0; i < m_subMeshes.size(); i++)
+		mesh.bounds = {};
+		if (!mesh.vertices.empty())
+		{
+			mesh.bounds = AABB(mesh.vertices[0].position, mesh.vertices[0].position);
+			for (size_t j = 1; j < mesh.vertices.size(); j++)
+				mesh.bounds.AddPoint(mesh.vertices[j].position);
+		}
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+bool Model::loadCookedFile(const char* cacheFileName, const char* sourceFileName, const char* pathMaterialFiles)
+{
+	using namespace cookedMesh;
+
+	MappedFile file;
+	if (!file.Open(cacheFileName))
+		return false;
+
+	const uint8_t* data = file.GetData();
+	const size_t size = file.GetSize();
+
+	Header header;
+	if (size < sizeof(Header)) return false;
+	memcpy(&header, data, sizeof(Header));
+	if (header.magic != Magic || header.version != Version || header.vertexSize != sizeof(VertexMesh))
+		return false;
+
+	// без исходного файла кэш используется как есть
+	uint64_t sourceSize = 0;
+	int64_t sourceTime = 0;
+	if (GetSourceStamp(sourceFileName, sourceSize, sourceTime) && (sourceSize != header.sourceSize || sourceTime != header.sourceTime))
+		return false;
+
+	const uint64_t tableSize = sizeof(Header) + (uint64_t)header.subMeshCount * sizeof(SubMesh) + (uint64_t)header.materialFileCount * sizeof(MaterialFile);
+	if (size < tableSize)
 	{
-		if (!m_subMeshes[i].vertexBuffer.Create(RenderResourceUsage::Static, m_subMeshes[i].vertices.size(), sizeof(m_subMeshes[i].vertices[0]), m_subMeshes[i].vertices.data()))
+		LogWarning("Model: invalid mesh cache " + std::string(cacheFileName));
+		return false;
+	}
+
+	// материалы и имена текстур взяты из .mtl - его изменение также делает кэш устаревшим
+	for (uint32_t i = 0; i < header.materialFileCount; i++)
+	{
+		MaterialFile materialFile;
+		memcpy(&materialFile, data + sizeof(Header) + header.subMeshCount * sizeof(SubMesh) + i * sizeof(MaterialFile), sizeof(MaterialFile));
+		if (!IsValidBlock(materialFile.nameOffset, materialFile.nameLength, 1, 1, size))
 		{
-			LogError("VertexBuffer create failed!");
-			Destroy();
+			LogWarning("Model: invalid mesh cache " + std::string(cacheFileName));
 			return false;
 		}
-		if (!m_subMeshes[i].indexBuffer.Create(RenderResourceUsage::Static, m_subMeshes[i].indices.size(), sizeof(uint32_t), m_subMeshes[i].indices.data()))
+		const std::string materialFileName = pathMaterialFiles + std::string((const char*)data + materialFile.nameOffset, materialFile.nameLength);
+		if (GetSourceStamp(materialFileName.c_str(), sourceSize, sourceTime) && (sourceSize != materialFile.size || sourceTime != materialFile.time))
+			return false;
+	}
+
+	m_optimizationStatistics.before = { (size_t)header.cacheTriangles, (size_t)header.cacheVerticesBefore, (size_t)header.cacheMissesBefore };
+	m_optimizationStatistics.after = { (size_t)header.cacheTriangles, (size_t)header.cacheVerticesAfter, (size_t)header.cacheMissesAfter };
+
+	m_subMeshes.resize(header.subMeshCount);
+	for (uint32_t i = 0; i < header.subMeshCount; i++)
+	{
+		SubMesh subMesh;
+		memcpy(&subMesh, data + sizeof(Header) + i * sizeof(SubMesh), sizeof(SubMesh));
+		// блоки передаются в буферы по указателю - смещения проверяются на выравнивание и выход за файл
+		if (!IsValidBlock(subMesh.vertexOffset, subMesh.vertexCount, sizeof(VertexMesh), Alignment, size) ||
+			!IsValidBlock(subMesh.indexOffset, subMesh.indexCount, sizeof(uint32_t), Alignment, size) ||
+			!IsValidBlock(subMesh.textureNameOffset, subMesh.textureNameLength, 1, 1, size))
 		{
-			LogError("IndexBuffer create failed!");
+			LogWarning("Model: invalid mesh cache " + std::string(cacheFileName));
 			Destroy();
 			return false;
 		}
 
-		if (!m_subMeshes[i].vao.Create(&m_subMeshes[i].vertexBuffer, &m_subMeshes[i].indexBuffer, formatVertex))
+		Mesh& mesh = m_subMeshes[i];
+		mesh.material.ambientColor = subMesh.ambientColor;
+		mesh.material.diffuseColor = subMesh.diffuseColor;
+		mesh.material.specularColor = subMesh.specularColor;
+		mesh.material.shininess = subMesh.shininess;
+		mesh.bounds = AABB(subMesh.boundsMin, subMesh.boundsMax);
+		if (subMesh.textureNameLength > 0)
+		{
+			const std::string diffuseMap = pathMaterialFiles + std::string((const char*)data + subMesh.textureNameOffset, subMesh.textureNameLength);
+			mesh.material.diffuseTexture = ResourceCacheSystem::LoadTexture2D(diffuseMap.c_str(), {});
+		}
+
+		const VertexMesh* vertices = (const VertexMesh*)(data + subMesh.vertexOffset);
+		const uint32_t* indices = (const uint32_t*)(data + subMesh.indexOffset);
+		if (!createMeshBuffer(mesh, m_arena, vertices, subMesh.vertexCount, indices, subMesh.indexCount, m_quantizationError))
 		{
-			LogError("VAO create failed!");
 			Destroy();
 			return false;
 		}
+
+		// копия на CPU для GetTriangles() и коллизий - копирование блока целиком
+		mesh.vertices.assign(vertices, vertices + subMesh.vertexCount);
+		mesh.indices.assign(indices, indices + subMesh.indexCount);
+	}
+
+	return true;
+}
+//-----------------------------------------------------------------------------
+bool Model::saveCookedFile(const char* cacheFileName, const char* sourceFileName, const char* pathMaterialFiles, const std::vector<std::string>& textureNames, const std::vector<std::string>& materialFileNames) const
+{
+	using namespace cookedMesh;
+
+	Header header = {};
+	header.magic = Magic;
+	header.version = Version;
+	header.vertexSize = sizeof(VertexMesh);
+	header.subMeshCount = (uint32_t)m_subMeshes.size();
+	header.materialFileCount = (uint32_t)materialFileNames.size();
+	if (!GetSourceStamp(sourceFileName, header.sourceSize, header.sourceTime))
+		return false;
+	const AABB bounds = GetBounds();
+	header.boundsMin = bounds.min;
+	header.boundsMax = bounds.max;
+	header.cacheTriangles = m_optimizationStatistics.before.triangles;
+	header.cacheVerticesBefore = m_optimizationStatistics.before.vertices;
+	header.cacheMissesBefore = m_optimizationStatistics.before.misses;
+	header.cacheVerticesAfter = m_optimizationStatistics.after.vertices;
+	header.cacheMissesAfter = m_optimizationStatistics.after.misses;
+
+	// раскладка файла
+	std::vector<SubMesh> subMeshes(m_subMeshes.size());
+	std::vector<MaterialFile> materialFiles(materialFileNames.size());
+	size_t offset = sizeof(Header) + subMeshes.size() * sizeof(SubMesh) + materialFiles.size() * sizeof(MaterialFile);
+	for (size_t i = 0; i < materialFileNames.size(); i++)
+	{
+		MaterialFile& materialFile = materialFiles[i];
+		materialFile = {};
+		if (!GetSourceStamp((pathMaterialFiles + materialFileNames[i]).c_str(), materialFile.size, materialFile.time))
+			return false;
+		materialFile.nameOffset = (uint32_t)offset;
+		materialFile.nameLength = (uint32_t)materialFileNames[i].size();
+		offset += materialFileNames[i].size();
+	}
+	for (size_t i = 0; i < m_subMeshes.size(); i++)
+	{
+		const Mesh& mesh = m_subMeshes[i];
+		SubMesh& subMesh = subMeshes[i];
+		subMesh = {};
+		subMesh.textureNameOffset = (uint32_t)offset;
+		subMesh.textureNameLength = (uint32_t)textureNames[i].size();
+		subMesh.ambientColor = mesh.material.ambientColor;
+		subMesh.diffuseColor = mesh.material.diffuseColor;
+		subMesh.specularColor = mesh.material.specularColor;
+		subMesh.shininess = mesh.material.shininess;
+		subMesh.boundsMin = mesh.bounds.min;
+		subMesh.boundsMax = mesh.bounds.max;
+		offset += textureNames[i].size();
+	}
+	for (size_t i = 0; i < m_subMeshes.size(); i++)
+	{
+		SubMesh& subMesh = subMeshes[i];
+		subMesh.vertexCount = (uint32_t)m_subMeshes[i].vertices.size();
+		subMesh.indexCount = (uint32_t)m_subMeshes[i].indices.size();
+		offset = Align(offset);
+		subMesh.vertexOffset = offset;
+		offset = Align(offset + subMesh.vertexCount * sizeof(VertexMesh));
+		subMesh.indexOffset = offset;
+		offset += subMesh.indexCount * sizeof(uint32_t);
+	}
+
+	std::vector<uint8_t> data(offset, 0);
+	memcpy(data.data(), &header, sizeof(Header));
+	memcpy(data.data() + sizeof(Header), subMeshes.data(), subMeshes.size() * sizeof(SubMesh));
+	memcpy(data.data() + sizeof(Header) + subMeshes.size() * sizeof(SubMesh), materialFiles.data(), materialFiles.size() * sizeof(MaterialFile));
+	for (size_t i = 0; i < materialFiles.size(); i++)
+		memcpy(data.data() + materialFiles[i].nameOffset, materialFileNames[i].data(), materialFiles[i].nameLength);
+	for (size_t i = 0; i < m_subMeshes.size(); i++)
+	{
+		const SubMesh& subMesh = subMeshes[i];
+		memcpy(data.data() + subMesh.textureNameOffset, textureNames[i].data(), subMesh.textureNameLength);
+		memcpy(data.data() + subMesh.vertexOffset, m_subMeshes[i].vertices.data(), subMesh.vertexCount * sizeof(VertexMesh));
+		memcpy(data.data() + subMesh.indexOffset, m_subMeshes[i].indices.data(), subMesh.indexCount * sizeof(uint32_t));
+	}
+
+	// запись во временный файл и переименование - недописанный кэш не будет прочитан
+	const std::string tempFileName = std::string(cacheFileName) + ".tmp";
+	FILE* file = nullptr;
+	if (fopen_s(&file, tempFileName.c_str(), "wb") != 0 || !file)
+		return false;
+	const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+	fclose(file);
+
+	std::error_code error;
+	if (written)
+		std::filesystem::rename(tempFileName, cacheFileName, error);
+	if (!written || error)
+	{
+		std::filesystem::remove(tempFileName, error);
+		return false;
 	}
 	return true;
 }
+//=============================================================================
+// Mesh Optimization
+//=============================================================================
 //-----------------------------------------------------------------------------
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize)
+{
+	VertexCacheStatistics statistics;
+	statistics.triangles = indexCount / 3;
+
+	// вершина в кэше, пока после ее загрузки было не больше cacheSize промахов (0 - вершина еще не встречалась)
+	std::vector<size_t> timestamps(vertexCount, 0);
+	size_t time = (size_t)cacheSize + 1;
+	for (size_t i = 0; i < statistics.triangles * 3; i++)
+	{
+		const uint32_t index = indices[i];
+		if (timestamps[index] == 0) statistics.vertices++;
+		if (time - timestamps[index] > cacheSize)
+		{
+			timestamps[index] = time++;
+			statistics.misses++;
+		}
+	}
+	return statistics;
+}
+//-----------------------------------------------------------------------------
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize, std::vector<uint32_t>* outClusters)
+{
+	if (outClusters) outClusters->clear();
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) return;
+
+	// треугольники вершины v: adjacency[offsets[v], offsets[v + 1])
+	std::vector<uint32_t> liveTriangles(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		liveTriangles[indices[i]]++;
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + liveTriangles[v];
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+	}
+
+	std::vector<size_t> timestamps(vertexCount, 0);
+	std::vector<uint8_t> emitted(triangleCount, 0);
+	std::vector<uint32_t> deadEnd; // вершины выведенных треугольников, последние сверху
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+	deadEnd.reserve(triangleCount * 3);
+
+	size_t time = (size_t)cacheSize + 1;
+	size_t cursor = 0; // следующая по порядку вершина, когда стек пуст
+	uint32_t fanning = indices[0];
+	bool newCluster = true;
+	for (;;)
+	{
+		// веер из всех оставшихся треугольников вершины
+		candidates.clear();
+		for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++)
+		{
+			const uint32_t triangle = adjacency[a];
+			if (emitted[triangle]) continue;
+			emitted[triangle] = 1;
+			if (newCluster && outClusters) outClusters->push_back((uint32_t)(result.size() / 3));
+			newCluster = false;
+
+			for (int k = 0; k < 3; k++)
+			{
+				const uint32_t v = indices[triangle * 3 + k];
+				result.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+				if (time - timestamps[v] > cacheSize) timestamps[v] = time++;
+			}
+		}
+
+		// следующая - самая старая из вершин веера, которая не вытеснится из кэша, пока выводится ее веер
+		// (2 новые вершины на треугольник), иначе любая вершина веера с оставшимися треугольниками
+		uint32_t next = UINT32_MAX;
+		int64_t bestPriority = -1;
+		for (const uint32_t v : candidates)
+		{
+			if (liveTriangles[v] == 0) continue;
+			const size_t age = time - timestamps[v];
+			const int64_t priority = age + 2 * (size_t)liveTriangles[v] <= cacheSize ? (int64_t)age : 0;
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+		// тупик: недавно использованные вершины, затем по порядку
+		while (next == UINT32_MAX && !deadEnd.empty())
+		{
+			const uint32_t v = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveTriangles[v] > 0) next = v;
+		}
+		while (next == UINT32_MAX && cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0) next = (uint32_t)cursor;
+			cursor++;
+		}
+		if (next == UINT32_MAX) break;
+
+		newCluster = time - timestamps[next] > cacheSize;
+		fanning = next;
+	}
+
+	assert(result.size() == triangleCount * 3);
+	std::copy(result.begin(), result.end(), indices);
+}
+//-----------------------------------------------------------------------------
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexMesh* vertices, size_t vertexCount, const std::vector<uint32_t>& clusters)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (clusters.size() < 2) return;
+
+	struct Cluster
+	{
+		uint32_t firstTriangle;
+		uint32_t triangleCount;
+		float sortKey;
+	};
+	std::vector<Cluster> sortClusters(clusters.size());
+	std::vector<Vector3> clusterCenters(clusters.size());
+	std::vector<Vector3> clusterNormals(clusters.size());
+
+	// центры кластеров и меша взвешены по площади треугольников, нормаль кластера - сумма нормалей с весом площади
+	Vector3 meshCenter;
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		const uint32_t first = clusters[c];
+		const uint32_t last = c + 1 < clusters.size() ? clusters[c + 1] : (uint32_t)triangleCount;
+		sortClusters[c] = { first, last - first, 0.0f };
+
+		Vector3 center;
+		Vector3 normal;
+		float area = 0.0f;
+		for (uint32_t t = first; t < last; t++)
+		{
+			assert(indices[t * 3] < vertexCount && indices[t * 3 + 1] < vertexCount && indices[t * 3 + 2] < vertexCount);
+			const Vector3& p0 = vertices[indices[t * 3 + 0]].position;
+			const Vector3& p1 = vertices[indices[t * 3 + 1]].position;
+			const Vector3& p2 = vertices[indices[t * 3 + 2]].position;
+			const Vector3 cross = CrossProduct(p1 - p0, p2 - p0);
+			const float triangleArea = cross.GetLength();
+			center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters[c] = area > 0.0f ? center / area : vertices[indices[first * 3]].position;
+		clusterNormals[c] = normal;
+	}
+	if (meshArea > 0.0f) meshCenter = meshCenter / meshArea;
+
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		const float normalLength = clusterNormals[c].GetLength();
+		if (normalLength > 0.0f)
+			sortClusters[c].sortKey = DotProduct(clusterCenters[c] - meshCenter, clusterNormals[c] / normalLength);
+	}
+	std::stable_sort(sortClusters.begin(), sortClusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+	for (const Cluster& cluster : sortClusters)
+		result.insert(result.end(), indices + (size_t)cluster.firstTriangle * 3, indices + (size_t)(cluster.firstTriangle + cluster.triangleCount) * 3);
+	std::copy(result.begin(), result.end(), indices);
+}
+//-----------------------------------------------------------------------------
+void OptimizeVertexFetch(std::vector<VertexMesh>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+	std::vector<VertexMesh> result;
+	result.reserve(vertices.size());
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == UINT32_MAX)
+		{
+			remap[index] = (uint32_t)result.size();
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices = std::move(result);
+}
+//-----------------------------------------------------------------------------
+MeshOptimizationStatistics OptimizeMesh(std::vector<VertexMesh>& vertices, std::vector<uint32_t>& indices)
+{
+	MeshOptimizationStatistics statistics;
+	statistics.before = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	std::vector<uint32_t> clusters;
+	OptimizeVertexCache(indices.data(), indices.size(), vertices.size(), VertexCacheSize, &clusters);
+	OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size(), clusters);
+	OptimizeVertexFetch(vertices, indices);
+
+	statistics.after = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	return statistics;
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
+// Render Queue
+//=============================================================================
+//-----------------------------------------------------------------------------
+void RenderQueue::Begin(const Matrix4& view, float farDistance)
+{
+	m_items.clear();
+	m_sorted = false;
+	m_depthAxis = Vector3(view[0][2], view[1][2], view[2][2]);
+	m_depthOffset = view[3][2];
+	m_invFarDistance = farDistance > 0.0f ? 1.0f / farDistance : 0.0f;
+
+	// id больше не помещаются в ключ - раздаются заново
+	if (m_shaderIds.size() > (1u << ShaderBits) || m_textureIds.size() > (1u << TextureBits) || m_vaoIds.size() > (1u << VaoBits))
+	{
+		m_shaderIds.clear();
+		m_textureIds.clear();
+		m_vaoIds.clear();
+	}
+}
+//-----------------------------------------------------------------------------
+void RenderQueue::Submit(Mesh& mesh, ShaderProgram& shader, const Matrix4& world, uint8_t layer)
+{
+	if (!mesh.IsDrawable()) return;
+
+	const Texture2D* texture = mesh.material.diffuseTexture;
+	const bool transparent = texture && texture->isTransparent;
+	const uint64_t state =
+		((uint64_t)getId(m_shaderIds, &shader, ShaderBits) << (TextureBits + VaoBits)) |
+		((uint64_t)getId(m_textureIds, texture, TextureBits) << VaoBits) |
+		(uint64_t)getId(m_vaoIds, mesh.GetVAO(), VaoBits);
+
+	const float depth = DotProduct(m_depthAxis, world.TransformPoint(mesh.bounds.GetCenter())) + m_depthOffset;
+	const float normalizedDepth = Clamp(depth * m_invFarDistance, 0.0f, 1.0f);
+
+	uint64_t key = ((uint64_t)layer << 56) | ((uint64_t)transparent << 55);
+	if (transparent)
+	{
+		constexpr uint32_t maxDepth = (1u << TransparentDepthBits) - 1;
+		const uint32_t quantizedDepth = maxDepth - (uint32_t)(normalizedDepth * (float)maxDepth);
+		key |= ((uint64_t)quantizedDepth << (55 - TransparentDepthBits)) | (state >> (ShaderBits + TextureBits + VaoBits - (55 - TransparentDepthBits)));
+	}
+	else
+	{
+		constexpr uint32_t maxDepth = (1u << OpaqueDepthBits) - 1;
+		key |= (state << OpaqueDepthBits) | (uint64_t)(normalizedDepth * (float)maxDepth);
+	}
+
+	m_items.push_back({ key, &mesh, &shader, world });
+	m_sorted = false;
+}
+//-----------------------------------------------------------------------------
+void RenderQueue::Submit(Model& model, ShaderProgram& shader, const Matrix4& world, uint8_t layer)
+{
+	for (Mesh& mesh : model.GetSubMesh())
+		Submit(mesh, shader, world, layer);
+}
+//-----------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	const size_t count = m_items.size();
+	m_order.resize(count);
+	m_sortBuffer.resize(count);
+	for (size_t i = 0; i < count; i++)
+		m_order[i] = { m_items[i].key, (uint32_t)i };
+
+	// порядок отправки сохраняется при равных ключах
+	if (RadixSort(m_order.data(), m_sortBuffer.data(), count) != m_order.data())
+		m_order.swap(m_sortBuffer);
+	m_sorted = true;
+}
+//-----------------------------------------------------------------------------
+void RenderQueue::Draw(const char* worldUniformName, void (*bindMaterial)(const Material&))
+{
+	m_statistics = {};
+	m_statistics.items = (unsigned)m_items.size();
+
+	// смены ресурсов в порядке отправки - для сравнения с отсортированным порядком
+	const ShaderProgram* lastShader = nullptr;
+	const Texture2D* lastTexture = nullptr;
+	const VertexArrayBuffer* lastVao = nullptr;
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		const RenderItem& item = m_items[i];
+		const Texture2D* texture = item.mesh->material.diffuseTexture;
+		if (texture && texture->isTransparent) m_statistics.transparentItems++;
+		if (i == 0 || item.shader != lastShader) m_statistics.submitShaderChanges++;
+		if (i == 0 || texture != lastTexture) m_statistics.submitTextureChanges++;
+		if (i == 0 || item.mesh->GetVAO() != lastVao) m_statistics.submitVaoChanges++;
+		lastShader = item.shader;
+		lastTexture = texture;
+		lastVao = item.mesh->GetVAO();
+	}
+
+	if (!m_sorted) Sort();
+
+	lastShader = nullptr;
+	lastTexture = nullptr;
+	lastVao = nullptr;
+	const Material* lastMaterial = nullptr;
+	int worldLocation = -1;
+	for (size_t i = 0; i < m_order.size(); i++)
+	{
+		RenderItem& item = m_items[m_order[i].item];
+		if (i == 0 || item.shader != lastShader)
+		{
+			item.shader->Bind();
+			worldLocation = item.shader->GetUniformLocation(worldUniformName);
+			lastShader = item.shader;
+			lastMaterial = nullptr;
+			m_statistics.shaderChanges++;
+		}
+
+		const Material& material = item.mesh->material;
+		if (&material != lastMaterial)
+		{
+			if (bindMaterial)
+				bindMaterial(material);
+			else if (material.diffuseTexture && material.diffuseTexture->IsValid() && (i == 0 || material.diffuseTexture != lastTexture))
+				material.diffuseTexture->Bind(0);
+			lastMaterial = &material;
+		}
+		if (i == 0 || material.diffuseTexture != lastTexture)
+		{
+			lastTexture = material.diffuseTexture;
+			m_statistics.textureChanges++;
+		}
+		if (i == 0 || item.mesh->GetVAO() != lastVao)
+		{
+			lastVao = item.mesh->GetVAO();
+			m_statistics.vaoChanges++;
+		}
+
+		if (worldLocation >= 0)
+			item.shader->SetUniform(worldLocation, item.world);
+		item.mesh->Draw();
+	}
+}
+//-----------------------------------------------------------------------------
+void RenderQueue::Clear()
+{
+	m_items.clear();
+	m_order.clear();
+	m_sortBuffer.clear();
+	m_sorted = false;
+	m_shaderIds.clear();
+	m_textureIds.clear();
+	m_vaoIds.clear();
+	m_statistics = {};
+}
+//-----------------------------------------------------------------------------
+uint32_t RenderQueue::getId(std::unordered_map<const void*, uint32_t>& ids, const void* resource, unsigned bits)
+{
+	const auto it = ids.try_emplace(resource, (uint32_t)ids.size()).first;
+	return it->second & ((1u << bits) - 1); // при переполнении id совпадают, страдает только группировка
+}
 //=============================================================================
 // Camera
 //=============================================================================
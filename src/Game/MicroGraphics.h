@@ -4,9 +4,13 @@
 // Header
 //=============================================================================
 
+#include <cstring>
+#include <string>
 #include <vector>
+#include <unordered_map>
 
 #include "MicroMath.h"
+#include "MicroGeometry.h"
 #include "MicroRender.h"
 
 class Texture2D;
@@ -38,28 +42,240 @@ struct VertexMesh
 	Vector2 texCoord;
 };
 
+//   VertexMesh   GPU. Model     ,  CPU  VertexMesh
+enum class VertexMeshLayout : uint8_t
+{
+	Float,       // VertexMesh   - 44 
+	Packed,      // VertexMeshPacked - 24 
+	PackedWhite, // VertexMeshPacked  color (    ,   - ) - 20 
+};
+
+struct VertexMeshPacked
+{
+	Vector3 position;
+	uint32_t normal;      // PackSnorm10x3
+	uint16_t texCoord[2]; // FloatToHalf
+	uint32_t color;       // PackUnorm8x4 (a = 1),  - PackedWhite  
+};
+
+//      
+struct VertexMeshQuantizationError
+{
+	float normal = 0.0f;
+	float color = 0.0f;
+	float texCoord = 0.0f;
+};
+
+//    ( 0-3: position, normal, color, texCoord)
+[[nodiscard]] const std::vector<VertexAttribute>& GetVertexMeshFormat(VertexMeshLayout layout = VertexMeshLayout::Float);
+[[nodiscard]] unsigned GetVertexMeshSize(VertexMeshLayout layout);
+// PackedWhite,     ,  Packed
+[[nodiscard]] VertexMeshLayout SelectVertexMeshLayout(const VertexMesh* vertices, size_t count);
+// outData - count * GetVertexMeshSize(layout) ,     ioError ()
+void PackVertexMesh(const VertexMesh* vertices, size_t count, VertexMeshLayout layout, uint8_t* outData, VertexMeshQuantizationError& ioError);
+
+//       ( OBJ):     ,      .
+//  -  ()     (-0   0),  64-.      ,
+//     groupVertices. Reserve   ,  Clear  
+class VertexMeshIndexMap
+{
+public:
+	void Reserve(size_t vertexCount);
+	void Clear();
+
+	//    groupVertices,      groupVertices.
+	//         ,     
+	uint32_t GetOrAdd(uint32_t group, const VertexMesh& vertex, std::vector<VertexMesh>& groupVertices);
+
+	[[nodiscard]] size_t GetSize() const { return m_count; }
+	[[nodiscard]] size_t GetCapacity() const { return m_slots.size(); }
+
+	[[nodiscard]] static uint64_t Hash(uint32_t group, const VertexMesh& vertex);
+
+private:
+	struct Slot
+	{
+		uint64_t hash;
+		uint32_t group;
+		uint32_t index; // UINT32_MAX -  
+	};
+
+	static uint64_t hashKey(uint32_t group, const VertexMesh& vertex, VertexMesh& outKey);
+	void rehash(size_t capacity);
+
+	std::vector<Slot> m_slots; //  -  ,    
+	size_t m_count = 0;
+};
+
+//      vertexBuffer/indexBuffer/vao,    arenaRange   arena
+// (            VAO)
 class Mesh
 {
 public:
 	std::vector<Vector3> GetTriangles() const;
 
+	void Draw();
+	[[nodiscard]] bool IsDrawable() const { return arena ? arenaRange.indexCount > 0 : vao.IsValid(); }
+	[[nodiscard]] VertexArrayBuffer* GetVAO() { return arena ? arena->GetVAO() : &vao; }
+
 	std::vector<VertexMesh> vertices;
 	std::vector<uint32_t> indices;
 	Material material;
+	AABB bounds;
 
 	VertexBuffer vertexBuffer;
 	IndexBuffer indexBuffer;
 	VertexArrayBuffer vao;
+
+	GeometryArena* arena = nullptr;
+	GeometryRange arenaRange;
+	VertexMeshLayout layout = VertexMeshLayout::Float; //     (  arena)
+};
+
+//-----------------------------------------------------------------------------
+inline void VertexMeshIndexMap::Reserve(size_t vertexCount)
+{
+	const size_t capacity = std::bit_ceil(std::max<size_t>(vertexCount * 2, 16));
+	if (capacity > m_slots.size()) rehash(capacity);
+}
+//-----------------------------------------------------------------------------
+inline void VertexMeshIndexMap::Clear()
+{
+	for (Slot& slot : m_slots)
+		slot.index = UINT32_MAX;
+	m_count = 0;
+}
+//-----------------------------------------------------------------------------
+inline uint32_t VertexMeshIndexMap::GetOrAdd(uint32_t group, const VertexMesh& vertex, std::vector<VertexMesh>& groupVertices)
+{
+	if ((m_count + 1) * 2 > m_slots.size()) rehash(std::max<size_t>(m_slots.size() * 2, 16));
+
+	VertexMesh key;
+	const uint64_t hash = hashKey(group, vertex, key);
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+	{
+		Slot& slot = m_slots[i];
+		if (slot.index == UINT32_MAX)
+		{
+			slot = { hash, group, (uint32_t)groupVertices.size() };
+			groupVertices.push_back(key);
+			m_count++;
+			return slot.index;
+		}
+		if (slot.hash == hash && slot.group == group && memcmp(&groupVertices[slot.index], &key, sizeof(VertexMesh)) == 0)
+			return slot.index;
+	}
+}
+//-----------------------------------------------------------------------------
+inline uint64_t VertexMeshIndexMap::Hash(uint32_t group, const VertexMesh& vertex)
+{
+	VertexMesh key;
+	return hashKey(group, vertex, key);
+}
+//-----------------------------------------------------------------------------
+inline uint64_t VertexMeshIndexMap::hashKey(uint32_t group, const VertexMesh& vertex, VertexMesh& outKey)
+{
+	static_assert(sizeof(VertexMesh) % sizeof(uint32_t) == 0 && std::is_trivially_copyable_v<VertexMesh>);
+	constexpr size_t WordCount = sizeof(VertexMesh) / sizeof(uint32_t);
+	uint32_t words[WordCount];
+	memcpy(words, &vertex, sizeof(VertexMesh));
+
+	//   8       MurmurHash3
+	uint64_t hash = 0x9E3779B97F4A7C15ull ^ group;
+	for (size_t i = 0; i < WordCount; i += 2)
+	{
+		if ((words[i] & 0x7FFFFFFFu) == 0) words[i] = 0; // -0 == 0
+		uint64_t block = words[i];
+		if (i + 1 < WordCount)
+		{
+			if ((words[i + 1] & 0x7FFFFFFFu) == 0) words[i + 1] = 0;
+			block |= (uint64_t)words[i + 1] << 32;
+		}
+		block *= 0x87C37B91114253D5ull;
+		block = std::rotl(block, 31);
+		block *= 0x4CF5AD432745937Full;
+		hash ^= block;
+		hash = std::rotl(hash, 27) * 5 + 0x52DCE729;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+
+	memcpy(&outKey, words, sizeof(VertexMesh));
+	return hash;
+}
+//-----------------------------------------------------------------------------
+inline void VertexMeshIndexMap::rehash(size_t capacity)
+{
+	std::vector<Slot> slots(capacity, Slot{ 0, 0, UINT32_MAX });
+	const size_t mask = capacity - 1;
+	for (const Slot& slot : m_slots)
+	{
+		if (slot.index == UINT32_MAX) continue;
+		size_t i = (size_t)slot.hash & mask;
+		while (slots[i].index != UINT32_MAX)
+			i = (i + 1) & mask;
+		slots[i] = slot;
+	}
+	m_slots = std::move(slots);
+}
+
+//=============================================================================
+// Mesh Optimization
+//=============================================================================
+
+//  post-transform   (FIFO  cacheSize )
+struct VertexCacheStatistics
+{
+	VertexCacheStatistics& operator+=(const VertexCacheStatistics& s) { triangles += s.triangles; vertices += s.vertices; misses += s.misses; return *this; }
+
+	// ACMR -    (0.5 -    , 3 -   )
+	[[nodiscard]] float GetACMR() const { return triangles > 0 ? (float)misses / (float)triangles : 0.0f; }
+	// ATVR -     (1 -     )
+	[[nodiscard]] float GetATVR() const { return vertices > 0 ? (float)misses / (float)vertices : 0.0f; }
+
+	size_t triangles = 0;
+	size_t vertices = 0;
+	size_t misses = 0;
 };
 
+struct MeshOptimizationStatistics
+{
+	VertexCacheStatistics before;
+	VertexCacheStatistics after;
+};
+
+constexpr unsigned VertexCacheSize = 16;
+
+[[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize = VertexCacheSize);
+// Tipsify (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"):    ,
+//          ,     .
+// outClusters -   :   ,       
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize = VertexCacheSize, std::vector<uint32_t>* outClusters = nullptr);
+//    dot(  -  ,  ):   ,  ,
+//        .      
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexMesh* vertices, size_t vertexCount, const std::vector<uint32_t>& clusters);
+//       ( ),  
+void OptimizeVertexFetch(std::vector<VertexMesh>& vertices, std::vector<uint32_t>& indices);
+//   ,     
+MeshOptimizationStatistics OptimizeMesh(std::vector<VertexMesh>& vertices, std::vector<uint32_t>& indices);
+
+// 16- ,      
+[[nodiscard]] inline unsigned GetIndexSize(size_t vertexCount) { return vertexCount < 65536 ? (unsigned)sizeof(uint16_t) : (unsigned)sizeof(uint32_t); }
+
 //=============================================================================
 // Model
 //=============================================================================
 class Model
 {
 public:
-	bool Create(const char* fileName, const char* pathMaterialFiles = "./");
-	bool Create(std::vector<Mesh>&& meshes);
+	//  OBJ  OptimizeMesh     .mesh.    PackedWhite/Packed,  16-,  . arena -     (    ),
+	// nullptr,         arena -    
+	bool Create(const char* fileName, const char* pathMaterialFiles = "./", GeometryArena* arena = nullptr);
+	bool Create(std::vector<Mesh>&& meshes, GeometryArena* arena = nullptr);
 	void Destroy();
 
 	void SetMaterial(const Material& material);
@@ -69,7 +285,7 @@ public:
 	bool IsValid() const
 	{
 		if (m_subMeshes.size() > 0)
-			return m_subMeshes[0].vertexBuffer.IsValid() && m_subMeshes[0].indexBuffer.IsValid() && m_subMeshes[0].vao.IsValid();
+			return m_subMeshes[0].IsDrawable();
 		return false;
 	}
 
@@ -79,12 +295,137 @@ public:
 	//     
 	std::vector<Vector3> GetTriangles() const;
 
+	AABB GetBounds() const;
+
+	//     
+	const VertexMeshQuantizationError& GetQuantizationError() const { return m_quantizationError; }
+	//        OptimizeMesh (  .mesh -    )
+	const MeshOptimizationStatistics& GetOptimizationStatistics() const { return m_optimizationStatistics; }
+
 private:
-	bool loadObjFile(const char* fileName, const char* pathMaterialFiles = "./");
+	bool loadObjFile(const char* fileName, const char* pathMaterialFiles, std::vector<std::string>& textureNames, std::vector<std::string>& materialFileNames);
+	//  OBJ    (fileName.obj.mesh) -   ,       
+	bool loadCookedFile(const char* cacheFileName, const char* sourceFileName, const char* pathMaterialFiles);
+	bool saveCookedFile(const char* cacheFileName, const char* sourceFileName, const char* pathMaterialFiles, const std::vector<std::string>& textureNames, const std::vector<std::string>& materialFileNames) const;
 	bool createBuffer();
 	std::vector<Mesh> m_subMeshes;
+	GeometryArena* m_arena = nullptr;
+	VertexMeshQuantizationError m_quantizationError;
+	MeshOptimizationStatistics m_optimizationStatistics;
+};
+
+//=============================================================================
+// Render Queue
+//=============================================================================
+
+//   :      ,   
+struct RenderItem
+{
+	uint64_t key = 0;
+	Mesh* mesh = nullptr;
+	ShaderProgram* shader = nullptr;
+	Matrix4 world;
+};
+
+//     :        ( )
+struct RenderQueueStatistics
+{
+	unsigned items = 0;
+	unsigned transparentItems = 0;
+	unsigned shaderChanges = 0;
+	unsigned textureChanges = 0;
+	unsigned vaoChanges = 0;
+	unsigned submitShaderChanges = 0;
+	unsigned submitTextureChanges = 0;
+	unsigned submitVaoChanges = 0;
+};
+
+//   :     
+struct RadixSortEntry
+{
+	uint64_t key;
+	uint32_t item;
+};
+
+//  LSD    , ,    , .
+// entries  scratch -  count ,    ,    
+RadixSortEntry* RadixSort(RadixSortEntry* entries, RadixSortEntry* scratch, size_t count);
+
+//    64-  .
+// : [ 8][0][][][VAO][] -   ,      .
+//  (diffuseTexture->isTransparent): [ 8][1][  24][] -        .
+//    id   , id   . Sort -     
+class RenderQueue
+{
+public:
+	static constexpr unsigned ShaderBits = 10;
+	static constexpr unsigned TextureBits = 14;
+	static constexpr unsigned VaoBits = 16;
+	static constexpr unsigned OpaqueDepthBits = 64 - 9 - ShaderBits - TextureBits - VaoBits;
+	static constexpr unsigned TransparentDepthBits = 24;
+
+	//  - z    view, farDistance - ,    
+	void Begin(const Matrix4& view, float farDistance);
+	void Submit(Mesh& mesh, ShaderProgram& shader, const Matrix4& world, uint8_t layer = 0);
+	void Submit(Model& model, ShaderProgram& shader, const Matrix4& world, uint8_t layer = 0); //   
+	void Sort();
+	// worldUniformName - uniform  . bindMaterial    , nullptr -   diffuseTexture   0
+	void Draw(const char* worldUniformName, void (*bindMaterial)(const Material&) = nullptr);
+	void Clear(); //   id  (  ,   )
+
+	[[nodiscard]] const std::vector<RenderItem>& GetItems() const { return m_items; } //   
+	[[nodiscard]] const RenderQueueStatistics& GetStatistics() const { return m_statistics; } //  Draw
+
+private:
+	static uint32_t getId(std::unordered_map<const void*, uint32_t>& ids, const void* resource, unsigned bits);
+
+	std::vector<RenderItem> m_items;
+	std::vector<RadixSortEntry> m_order;
+	std::vector<RadixSortEntry> m_sortBuffer;
+	std::unordered_map<const void*, uint32_t> m_shaderIds;
+	std::unordered_map<const void*, uint32_t> m_textureIds;
+	std::unordered_map<const void*, uint32_t> m_vaoIds;
+	Vector3 m_depthAxis = Vector3(0.0f, 0.0f, 1.0f);
+	float m_depthOffset = 0.0f;
+	float m_invFarDistance = 1.0f;
+	bool m_sorted = false;
+	RenderQueueStatistics m_statistics;
 };
 
+//-----------------------------------------------------------------------------
+inline RadixSortEntry* RadixSort(RadixSortEntry* entries, RadixSortEntry* scratch, size_t count)
+{
+	//   8     
+	uint32_t histogram[8][256] = {};
+	for (size_t i = 0; i < count; i++)
+	{
+		for (unsigned byte = 0; byte < 8; byte++)
+			histogram[byte][(entries[i].key >> (byte * 8)) & 0xFF]++;
+	}
+
+	//    ,       
+	RadixSortEntry* source = entries;
+	RadixSortEntry* target = scratch;
+	for (unsigned byte = 0; byte < 8 && count > 1; byte++)
+	{
+		const unsigned shift = byte * 8;
+		uint32_t* counts = histogram[byte];
+		if (counts[(source[0].key >> shift) & 0xFF] == count) continue; //     
+
+		uint32_t offset = 0;
+		for (unsigned bucket = 0; bucket < 256; bucket++)
+		{
+			const uint32_t bucketCount = counts[bucket];
+			counts[bucket] = offset;
+			offset += bucketCount;
+		}
+		for (size_t i = 0; i < count; i++)
+			target[counts[(source[i].key >> shift) & 0xFF]++] = source[i];
+		std::swap(source, target);
+	}
+	return source;
+}
+
 //=============================================================================
 // Camera
 //=============================================================================
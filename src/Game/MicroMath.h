@@ -24,9 +24,127 @@ Left handed
 #	pragma warning(disable : 5264)
 #endif // _MSC_VER
 #include <math.h>
+#include <stdint.h>
+#include <bit>
 #include <limits>
 #include <assert.h>
 
+//=============================================================================
+// SIMD config
+//=============================================================================
+// MICROMATH_NO_SIMD - отключить все SIMD-пути (останется только скалярный код)
+#if !defined(MICROMATH_NO_SIMD)
+#	if defined(__AVX__)
+#		define MICROMATH_AVX 1
+#	endif
+#	if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define MICROMATH_SSE2 1
+#	endif
+#endif // MICROMATH_NO_SIMD
+
+// MICROMATH_SIMD_MATRIX - включить SIMD-версии Matrix4 * Vector4, Matrix4::Inverse и Matrix4::TransformPoint
+// (по умолчанию выключено, выбор на этапе компиляции; скалярные версии остаются доступны через MathScalar).
+// Matrix4 * Matrix4, Matrix3 * Matrix3 и Quaternion * Quaternion всегда скалярные - компилятор векторизует их не хуже MathSimd
+#if !defined(MICROMATH_SIMD_MATRIX)
+#	define MICROMATH_SIMD_MATRIX 0
+#endif
+
+#if defined(MICROMATH_AVX)
+#	include <immintrin.h>
+#elif defined(MICROMATH_SSE2)
+#	include <emmintrin.h>
+#endif
+
+//=============================================================================
+// SIMD lanes
+//=============================================================================
+// Ширина и операции одного прохода для пакетных ядер (SoA данные). Ядро пишется один раз шаблоном по Lanes
+// и вызывается с самым широким доступным вариантом, скалярный вариант обрабатывает остаток
+namespace simd
+{
+	struct LanesScalar
+	{
+		static constexpr size_t Width = 1;
+		using Float = float;
+		using Mask = bool;
+
+		static Float Load(const float* p) { return *p; }
+		static void Store(float* p, Float a) { *p = a; }
+		static Float Set(float a) { return a; }
+		static Float Add(Float a, Float b) { return a + b; }
+		static Float Sub(Float a, Float b) { return a - b; }
+		static Float Mul(Float a, Float b) { return a * b; }
+		static Float Div(Float a, Float b) { return a / b; }
+		static Float Min(Float a, Float b) { return a < b ? a : b; }
+		static Float Max(Float a, Float b) { return a > b ? a : b; }
+		static Mask LessEqual(Float a, Float b) { return a <= b; }
+		static Mask Less(Float a, Float b) { return a < b; }
+		static Mask And(Mask a, Mask b) { return a && b; }
+		static Mask Or(Mask a, Mask b) { return a || b; }
+		static Float Select(Mask mask, Float a, Float b) { return mask ? a : b; }
+		static unsigned MoveMask(Mask mask) { return mask ? 1u : 0u; }
+	};
+
+#if defined(MICROMATH_SSE2)
+	struct LanesSSE
+	{
+		static constexpr size_t Width = 4;
+		using Float = __m128;
+		using Mask = __m128;
+
+		static Float Load(const float* p) { return _mm_loadu_ps(p); }
+		static void Store(float* p, Float a) { _mm_storeu_ps(p, a); }
+		static Float Set(float a) { return _mm_set1_ps(a); }
+		static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+		static Mask LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+		static Mask Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+		static Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+		static Mask Or(Mask a, Mask b) { return _mm_or_ps(a, b); }
+		static Float Select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+		static unsigned MoveMask(Mask mask) { return (unsigned)_mm_movemask_ps(mask); }
+	};
+#endif // MICROMATH_SSE2
+
+#if defined(MICROMATH_AVX)
+	struct LanesAVX
+	{
+		static constexpr size_t Width = 8;
+		using Float = __m256;
+		using Mask = __m256;
+
+		static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, Float a) { _mm256_storeu_ps(p, a); }
+		static Float Set(float a) { return _mm256_set1_ps(a); }
+		static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+		static Mask LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static Mask Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+		static Mask Or(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+		static Float Select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+		static unsigned MoveMask(Mask mask) { return (unsigned)_mm256_movemask_ps(mask); }
+	};
+#endif // MICROMATH_AVX
+
+	// самый широкий доступный вариант
+#if defined(MICROMATH_AVX)
+	using LanesWide = LanesAVX;
+#elif defined(MICROMATH_SSE2)
+	using LanesWide = LanesSSE;
+#else
+	using LanesWide = LanesScalar;
+#endif
+}
+
 //=============================================================================
 // Constant definitions
 //=============================================================================
@@ -725,6 +843,43 @@ public:
 
 inline Transform operator*(const Transform& Left, const Transform& Right) noexcept;
 
+//=============================================================================
+// Packing
+//=============================================================================
+// Сжатие вершинных данных. Наибольшая ошибка: half - 2^-11 от значения, snorm10 - 1/1022, unorm8 - 1/510
+
+inline uint16_t FloatToHalf(float value) noexcept; // округление к ближайшему четному, за пределами диапазона half - inf
+inline float    HalfToFloat(uint16_t value) noexcept;
+inline uint32_t PackSnorm10x3(const Vector3& v) noexcept; // раскладка GL_INT_2_10_10_10_REV (x в младших битах, w = 0), компоненты обрезаются до [-1, 1]
+inline Vector3  UnpackSnorm10x3(uint32_t packed) noexcept;
+inline uint32_t PackUnorm8x4(const Vector4& v) noexcept; // RGBA8 (r в младшем байте), компоненты обрезаются до [0, 1]
+inline Vector4  UnpackUnorm8x4(uint32_t packed) noexcept;
+
+//=============================================================================
+// SIMD
+//=============================================================================
+// Реализации горячих операций. Оба варианта доступны всегда, операторы выбирают по MICROMATH_SIMD_MATRIX.
+// MathSimd: SSE2 (под AVX используется тот же код), на остальных платформах (в том числе NEON) - скалярный код.
+namespace MathScalar
+{
+	inline Matrix4 Multiply(const Matrix4& Left, const Matrix4& Right) noexcept;
+	inline Vector4 Multiply(const Matrix4& Left, const Vector4& Right) noexcept;
+	inline Matrix4 Inverse(const Matrix4& m) noexcept;
+	inline Vector3 TransformPoint(const Matrix4& m, const Vector3& pos) noexcept;
+	inline Matrix3 Multiply(const Matrix3& Left, const Matrix3& Right) noexcept;
+	inline Quaternion Multiply(const Quaternion& Left, const Quaternion& Right) noexcept;
+}
+
+namespace MathSimd
+{
+	inline Matrix4 Multiply(const Matrix4& Left, const Matrix4& Right) noexcept;
+	inline Vector4 Multiply(const Matrix4& Left, const Vector4& Right) noexcept;
+	inline Matrix4 Inverse(const Matrix4& m) noexcept;
+	inline Vector3 TransformPoint(const Matrix4& m, const Vector3& pos) noexcept;
+	inline Matrix3 Multiply(const Matrix3& Left, const Matrix3& Right) noexcept;
+	inline Quaternion Multiply(const Quaternion& Left, const Quaternion& Right) noexcept;
+}
+
 //=============================================================================
 // Impl
 //=============================================================================
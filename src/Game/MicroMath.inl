@@ -543,11 +543,11 @@ inline Vector4 operator*(const Vector4& Left, const Quaternion& Right) noexcept
 
 inline Vector4 operator*(const Matrix4& Left, const Vector4& Right) noexcept
 {
-	return {
-		Left[0][0] * Right[0] + Left[1][0] * Right[1] + Left[2][0] * Right[2] + Left[3][0] * Right[3],
-		Left[0][1] * Right[0] + Left[1][1] * Right[1] + Left[2][1] * Right[2] + Left[3][1] * Right[3],
-		Left[0][2] * Right[0] + Left[1][2] * Right[1] + Left[2][2] * Right[2] + Left[3][2] * Right[3],
-		Left[0][3] * Right[0] + Left[1][3] * Right[1] + Left[2][3] * Right[2] + Left[3][3] * Right[3] };
+#if MICROMATH_SIMD_MATRIX
+	return MathSimd::Multiply(Left, Right);
+#else
+	return MathScalar::Multiply(Left, Right);
+#endif
 }
 inline Vector4 operator*(const Vector4& Left, const Matrix4& Right) noexcept
 {
@@ -949,12 +949,7 @@ inline Quaternion operator*(float Left, const Quaternion& Right) noexcept { retu
 inline Quaternion operator*(const Quaternion& Left, float Right) noexcept { return { Left.w * Right, Left.x * Right, Left.y * Right, Left.z * Right }; }
 inline Quaternion operator*(const Quaternion& Left, const Quaternion& Right) noexcept
 {
-	return {
-		Left.w * Right.w - Left.x * Right.x - Left.y * Right.y - Left.z * Right.z,
-		Left.w * Right.x + Left.x * Right.w + Left.y * Right.z - Left.z * Right.y,
-		Left.w * Right.y + Left.y * Right.w + Left.z * Right.x - Left.x * Right.z,
-		Left.w * Right.z + Left.z * Right.w + Left.x * Right.y - Left.y * Right.x
-	};
+	return MathScalar::Multiply(Left, Right);
 }
 inline Quaternion operator/(const Quaternion& Left, float Right) noexcept { return { Left.w / Right, Left.x / Right, Left.y / Right, Left.z / Right }; }
 
@@ -1114,38 +1109,7 @@ inline Matrix3 operator*(const Matrix3& Left, float Right) noexcept
 
 inline Matrix3 operator*(const Matrix3& Left, const Matrix3& Right) noexcept
 {
-	// TODO: убрать лишние операции
-	const float SrcA00 = Left[0][0];
-	const float SrcA01 = Left[0][1];
-	const float SrcA02 = Left[0][2];
-	const float SrcA10 = Left[1][0];
-	const float SrcA11 = Left[1][1];
-	const float SrcA12 = Left[1][2];
-	const float SrcA20 = Left[2][0];
-	const float SrcA21 = Left[2][1];
-	const float SrcA22 = Left[2][2];
-
-	const float SrcB00 = Right[0][0];
-	const float SrcB01 = Right[0][1];
-	const float SrcB02 = Right[0][2];
-	const float SrcB10 = Right[1][0];
-	const float SrcB11 = Right[1][1];
-	const float SrcB12 = Right[1][2];
-	const float SrcB20 = Right[2][0];
-	const float SrcB21 = Right[2][1];
-	const float SrcB22 = Right[2][2];
-
-	Matrix3 Result;
-	Result[0][0] = SrcA00 * SrcB00 + SrcA10 * SrcB01 + SrcA20 * SrcB02;
-	Result[0][1] = SrcA01 * SrcB00 + SrcA11 * SrcB01 + SrcA21 * SrcB02;
-	Result[0][2] = SrcA02 * SrcB00 + SrcA12 * SrcB01 + SrcA22 * SrcB02;
-	Result[1][0] = SrcA00 * SrcB10 + SrcA10 * SrcB11 + SrcA20 * SrcB12;
-	Result[1][1] = SrcA01 * SrcB10 + SrcA11 * SrcB11 + SrcA21 * SrcB12;
-	Result[1][2] = SrcA02 * SrcB10 + SrcA12 * SrcB11 + SrcA22 * SrcB12;
-	Result[2][0] = SrcA00 * SrcB20 + SrcA10 * SrcB21 + SrcA20 * SrcB22;
-	Result[2][1] = SrcA01 * SrcB20 + SrcA11 * SrcB21 + SrcA21 * SrcB22;
-	Result[2][2] = SrcA02 * SrcB20 + SrcA12 * SrcB21 + SrcA22 * SrcB22;
-	return Result;
+	return MathScalar::Multiply(Left, Right);
 }
 
 inline Matrix3 operator/(float Left, const Matrix3& Right) noexcept
@@ -1227,60 +1191,11 @@ inline float Matrix4::GetDeterminant() const
 
 inline Matrix4 Matrix4::Inverse() const
 {
-	const float Coef00 = value[2][2] * value[3][3] - value[3][2] * value[2][3];
-	const float Coef02 = value[1][2] * value[3][3] - value[3][2] * value[1][3];
-	const float Coef03 = value[1][2] * value[2][3] - value[2][2] * value[1][3];
-
-	const float Coef04 = value[2][1] * value[3][3] - value[3][1] * value[2][3];
-	const float Coef06 = value[1][1] * value[3][3] - value[3][1] * value[1][3];
-	const float Coef07 = value[1][1] * value[2][3] - value[2][1] * value[1][3];
-
-	const float Coef08 = value[2][1] * value[3][2] - value[3][1] * value[2][2];
-	const float Coef10 = value[1][1] * value[3][2] - value[3][1] * value[1][2];
-	const float Coef11 = value[1][1] * value[2][2] - value[2][1] * value[1][2];
-
-	const float Coef12 = value[2][0] * value[3][3] - value[3][0] * value[2][3];
-	const float Coef14 = value[1][0] * value[3][3] - value[3][0] * value[1][3];
-	const float Coef15 = value[1][0] * value[2][3] - value[2][0] * value[1][3];
-
-	const float Coef16 = value[2][0] * value[3][2] - value[3][0] * value[2][2];
-	const float Coef18 = value[1][0] * value[3][2] - value[3][0] * value[1][2];
-	const float Coef19 = value[1][0] * value[2][2] - value[2][0] * value[1][2];
-
-	const float Coef20 = value[2][0] * value[3][1] - value[3][0] * value[2][1];
-	const float Coef22 = value[1][0] * value[3][1] - value[3][0] * value[1][1];
-	const float Coef23 = value[1][0] * value[2][1] - value[2][0] * value[1][1];
-
-	const Vector4 Fac0(Coef00, Coef00, Coef02, Coef03);
-	const Vector4 Fac1(Coef04, Coef04, Coef06, Coef07);
-	const Vector4 Fac2(Coef08, Coef08, Coef10, Coef11);
-	const Vector4 Fac3(Coef12, Coef12, Coef14, Coef15);
-	const Vector4 Fac4(Coef16, Coef16, Coef18, Coef19);
-	const Vector4 Fac5(Coef20, Coef20, Coef22, Coef23);
-
-	const Vector4 Vec0(value[1][0], value[0][0], value[0][0], value[0][0]);
-	const Vector4 Vec1(value[1][1], value[0][1], value[0][1], value[0][1]);
-	const Vector4 Vec2(value[1][2], value[0][2], value[0][2], value[0][2]);
-	const Vector4 Vec3(value[1][3], value[0][3], value[0][3], value[0][3]);
-
-	const Vector4 Inv0(Vec1 * Fac0 - Vec2 * Fac1 + Vec3 * Fac2);
-	const Vector4 Inv1(Vec0 * Fac0 - Vec2 * Fac3 + Vec3 * Fac4);
-	const Vector4 Inv2(Vec0 * Fac1 - Vec1 * Fac3 + Vec3 * Fac5);
-	const Vector4 Inv3(Vec0 * Fac2 - Vec1 * Fac4 + Vec2 * Fac5);
-
-	const Vector4 SignA(+1.0f, -1.0f, +1.0f, -1.0f);
-	const Vector4 SignB(-1.0f, +1.0f, -1.0f, +1.0f);
-
-	const Matrix4 inverse(Inv0 * SignA, Inv1 * SignB, Inv2 * SignA, Inv3 * SignB);
-
-	const Vector4 Row0(inverse[0][0], inverse[1][0], inverse[2][0], inverse[3][0]);
-
-	const Vector4 Dot0(value[0] * Row0);
-	const float Dot1 = (Dot0.x + Dot0.y) + (Dot0.z + Dot0.w);
-
-	const float OneOverDeterminant = 1.0f / Dot1;
-
-	return inverse * OneOverDeterminant;
+#if MICROMATH_SIMD_MATRIX
+	return MathSimd::Inverse(*this);
+#else
+	return MathScalar::Inverse(*this);
+#endif
 }
 
 inline Matrix4 Matrix4::Transpose() const
@@ -1310,10 +1225,11 @@ inline Matrix4 Matrix4::Transpose() const
 
 inline Vector3 Matrix4::TransformPoint(const Vector3& pos) const
 {
-	return Vector3(
-		value[0].x * pos.x + value[1].x * pos.y + value[2].x * pos.z + value[3].x,
-		value[0].y * pos.x + value[1].y * pos.y + value[2].y * pos.z + value[3].y,
-		value[0].z * pos.x + value[1].z * pos.y + value[2].z * pos.z + value[3].z);
+#if MICROMATH_SIMD_MATRIX
+	return MathSimd::TransformPoint(*this, pos);
+#else
+	return MathScalar::TransformPoint(*this, pos);
+#endif
 }
 
 inline bool Matrix4::Decompose(Vector3& scale, Quaternion& orientation, Vector3& translation, Vector3& skew, Vector4& perspective)
@@ -1795,22 +1711,7 @@ inline Matrix4 operator*(const Matrix4& Left, float Right) noexcept
 
 inline Matrix4 operator*(const Matrix4& Left, const Matrix4& Right) noexcept
 {
-	// TODO: убрать лишние операции
-	const Vector4& SrcA0 = Left[0];
-	const Vector4& SrcA1 = Left[1];
-	const Vector4& SrcA2 = Left[2];
-	const Vector4& SrcA3 = Left[3];
-	const Vector4& SrcB0 = Right[0];
-	const Vector4& SrcB1 = Right[1];
-	const Vector4& SrcB2 = Right[2];
-	const Vector4& SrcB3 = Right[3];
-
-	Matrix4 Result;
-	Result[0] = SrcA0 * SrcB0[0] + SrcA1 * SrcB0[1] + SrcA2 * SrcB0[2] + SrcA3 * SrcB0[3];
-	Result[1] = SrcA0 * SrcB1[0] + SrcA1 * SrcB1[1] + SrcA2 * SrcB1[2] + SrcA3 * SrcB1[3];
-	Result[2] = SrcA0 * SrcB2[0] + SrcA1 * SrcB2[1] + SrcA2 * SrcB2[2] + SrcA3 * SrcB2[3];
-	Result[3] = SrcA0 * SrcB3[0] + SrcA1 * SrcB3[1] + SrcA2 * SrcB3[2] + SrcA3 * SrcB3[3];
-	return Result;
+	return MathScalar::Multiply(Left, Right);
 }
 
 inline Matrix4 operator/(float Left, const Matrix4& Right) noexcept
@@ -1862,4 +1763,396 @@ inline Transform operator*(const Transform& Left, const Transform& Right) noexce
 		Left.rotate * (Right.position * Left.scale) + Left.position,
 		Left.rotate * Right.rotate,
 		Left.scale * Right.scale };
-}
\ No newline at end of file
+}
+
+//=============================================================================
+// Packing
+//=============================================================================
+
+inline uint16_t FloatToHalf(float value) noexcept
+{
+	uint32_t bits = std::bit_cast<uint32_t>(value);
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	bits &= 0x7FFFFFFF;
+
+	if( bits >= 0x7F800000 ) // inf, nan
+		return (uint16_t)(sign | 0x7C00 | (bits > 0x7F800000 ? 0x200 : 0));
+	if( bits >= 0x477FF000 ) // от 65520 округляется в inf
+		return (uint16_t)(sign | 0x7C00);
+	if( bits < 0x38800000 ) // меньше 2^-14 - денормализованный half
+	{
+		if( bits < 0x33000000 ) return (uint16_t)sign; // меньше 2^-25 - ноль
+		const uint32_t mantissa = (bits & 0x7FFFFF) | 0x800000;
+		const uint32_t shift = 126 - (bits >> 23);
+		uint32_t half = mantissa >> shift;
+		const uint32_t rest = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if( rest > halfway || (rest == halfway && (half & 1)) ) half++;
+		return (uint16_t)(sign | half);
+	}
+
+	uint32_t half = (bits - 0x38000000) >> 13; // смещение экспоненты 127 -> 15
+	const uint32_t rest = bits & 0x1FFF;
+	if( rest > 0x1000 || (rest == 0x1000 && (half & 1)) ) half++; // перенос в экспоненту дает верный результат
+	return (uint16_t)(sign | half);
+}
+
+inline float HalfToFloat(uint16_t value) noexcept
+{
+	const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	const uint32_t mantissa = value & 0x3FF;
+
+	if( exponent == 0 ) // ноль и денормализованные: mantissa * 2^-24
+	{
+		const float result = (float)mantissa * (1.0f / 16777216.0f);
+		return sign ? -result : result;
+	}
+	if( exponent == 31 )
+		return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+	return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+inline uint32_t PackSnorm10x3(const Vector3& v) noexcept
+{
+	const auto pack = [](float value) { return (uint32_t)(int32_t)roundf(Clamp(value, -1.0f, 1.0f) * 511.0f) & 0x3FF; };
+	return pack(v.x) | (pack(v.y) << 10) | (pack(v.z) << 20);
+}
+
+inline Vector3 UnpackSnorm10x3(uint32_t packed) noexcept
+{
+	// знаковое расширение 10 бит, -512 как и в GL дает -1
+	const auto unpack = [](uint32_t bits) { return Max((float)((int32_t)(bits << 22) >> 22) / 511.0f, -1.0f); };
+	return { unpack(packed & 0x3FF), unpack((packed >> 10) & 0x3FF), unpack((packed >> 20) & 0x3FF) };
+}
+
+inline uint32_t PackUnorm8x4(const Vector4& v) noexcept
+{
+	const auto pack = [](float value) { return (uint32_t)roundf(Clamp(value, 0.0f, 1.0f) * 255.0f); };
+	return pack(v.x) | (pack(v.y) << 8) | (pack(v.z) << 16) | (pack(v.w) << 24);
+}
+
+inline Vector4 UnpackUnorm8x4(uint32_t packed) noexcept
+{
+	constexpr float Scale = 1.0f / 255.0f;
+	return { (float)(packed & 0xFF) * Scale, (float)((packed >> 8) & 0xFF) * Scale, (float)((packed >> 16) & 0xFF) * Scale, (float)(packed >> 24) * Scale };
+}
+
+//=============================================================================
+// SIMD Impl
+//=============================================================================
+
+namespace MathScalar
+{
+	inline Matrix4 Multiply(const Matrix4& Left, const Matrix4& Right) noexcept
+	{
+		// TODO: убрать лишние операции
+		const Vector4& SrcA0 = Left[0];
+		const Vector4& SrcA1 = Left[1];
+		const Vector4& SrcA2 = Left[2];
+		const Vector4& SrcA3 = Left[3];
+		const Vector4& SrcB0 = Right[0];
+		const Vector4& SrcB1 = Right[1];
+		const Vector4& SrcB2 = Right[2];
+		const Vector4& SrcB3 = Right[3];
+
+		Matrix4 Result;
+		Result[0] = SrcA0 * SrcB0[0] + SrcA1 * SrcB0[1] + SrcA2 * SrcB0[2] + SrcA3 * SrcB0[3];
+		Result[1] = SrcA0 * SrcB1[0] + SrcA1 * SrcB1[1] + SrcA2 * SrcB1[2] + SrcA3 * SrcB1[3];
+		Result[2] = SrcA0 * SrcB2[0] + SrcA1 * SrcB2[1] + SrcA2 * SrcB2[2] + SrcA3 * SrcB2[3];
+		Result[3] = SrcA0 * SrcB3[0] + SrcA1 * SrcB3[1] + SrcA2 * SrcB3[2] + SrcA3 * SrcB3[3];
+		return Result;
+	}
+
+	inline Vector4 Multiply(const Matrix4& Left, const Vector4& Right) noexcept
+	{
+		return {
+			Left[0][0] * Right[0] + Left[1][0] * Right[1] + Left[2][0] * Right[2] + Left[3][0] * Right[3],
+			Left[0][1] * Right[0] + Left[1][1] * Right[1] + Left[2][1] * Right[2] + Left[3][1] * Right[3],
+			Left[0][2] * Right[0] + Left[1][2] * Right[1] + Left[2][2] * Right[2] + Left[3][2] * Right[3],
+			Left[0][3] * Right[0] + Left[1][3] * Right[1] + Left[2][3] * Right[2] + Left[3][3] * Right[3] };
+	}
+
+	inline Matrix4 Inverse(const Matrix4& m) noexcept
+	{
+		const float Coef00 = m.value[2][2] * m.value[3][3] - m.value[3][2] * m.value[2][3];
+		const float Coef02 = m.value[1][2] * m.value[3][3] - m.value[3][2] * m.value[1][3];
+		const float Coef03 = m.value[1][2] * m.value[2][3] - m.value[2][2] * m.value[1][3];
+
+		const float Coef04 = m.value[2][1] * m.value[3][3] - m.value[3][1] * m.value[2][3];
+		const float Coef06 = m.value[1][1] * m.value[3][3] - m.value[3][1] * m.value[1][3];
+		const float Coef07 = m.value[1][1] * m.value[2][3] - m.value[2][1] * m.value[1][3];
+
+		const float Coef08 = m.value[2][1] * m.value[3][2] - m.value[3][1] * m.value[2][2];
+		const float Coef10 = m.value[1][1] * m.value[3][2] - m.value[3][1] * m.value[1][2];
+		const float Coef11 = m.value[1][1] * m.value[2][2] - m.value[2][1] * m.value[1][2];
+
+		const float Coef12 = m.value[2][0] * m.value[3][3] - m.value[3][0] * m.value[2][3];
+		const float Coef14 = m.value[1][0] * m.value[3][3] - m.value[3][0] * m.value[1][3];
+		const float Coef15 = m.value[1][0] * m.value[2][3] - m.value[2][0] * m.value[1][3];
+
+		const float Coef16 = m.value[2][0] * m.value[3][2] - m.value[3][0] * m.value[2][2];
+		const float Coef18 = m.value[1][0] * m.value[3][2] - m.value[3][0] * m.value[1][2];
+		const float Coef19 = m.value[1][0] * m.value[2][2] - m.value[2][0] * m.value[1][2];
+
+		const float Coef20 = m.value[2][0] * m.value[3][1] - m.value[3][0] * m.value[2][1];
+		const float Coef22 = m.value[1][0] * m.value[3][1] - m.value[3][0] * m.value[1][1];
+		const float Coef23 = m.value[1][0] * m.value[2][1] - m.value[2][0] * m.value[1][1];
+
+		const Vector4 Fac0(Coef00, Coef00, Coef02, Coef03);
+		const Vector4 Fac1(Coef04, Coef04, Coef06, Coef07);
+		const Vector4 Fac2(Coef08, Coef08, Coef10, Coef11);
+		const Vector4 Fac3(Coef12, Coef12, Coef14, Coef15);
+		const Vector4 Fac4(Coef16, Coef16, Coef18, Coef19);
+		const Vector4 Fac5(Coef20, Coef20, Coef22, Coef23);
+
+		const Vector4 Vec0(m.value[1][0], m.value[0][0], m.value[0][0], m.value[0][0]);
+		const Vector4 Vec1(m.value[1][1], m.value[0][1], m.value[0][1], m.value[0][1]);
+		const Vector4 Vec2(m.value[1][2], m.value[0][2], m.value[0][2], m.value[0][2]);
+		const Vector4 Vec3(m.value[1][3], m.value[0][3], m.value[0][3], m.value[0][3]);
+
+		const Vector4 Inv0(Vec1 * Fac0 - Vec2 * Fac1 + Vec3 * Fac2);
+		const Vector4 Inv1(Vec0 * Fac0 - Vec2 * Fac3 + Vec3 * Fac4);
+		const Vector4 Inv2(Vec0 * Fac1 - Vec1 * Fac3 + Vec3 * Fac5);
+		const Vector4 Inv3(Vec0 * Fac2 - Vec1 * Fac4 + Vec2 * Fac5);
+
+		const Vector4 SignA(+1.0f, -1.0f, +1.0f, -1.0f);
+		const Vector4 SignB(-1.0f, +1.0f, -1.0f, +1.0f);
+
+		const Matrix4 inverse(Inv0 * SignA, Inv1 * SignB, Inv2 * SignA, Inv3 * SignB);
+
+		const Vector4 Row0(inverse[0][0], inverse[1][0], inverse[2][0], inverse[3][0]);
+
+		const Vector4 Dot0(m.value[0] * Row0);
+		const float Dot1 = (Dot0.x + Dot0.y) + (Dot0.z + Dot0.w);
+
+		const float OneOverDeterminant = 1.0f / Dot1;
+
+		return inverse * OneOverDeterminant;
+	}
+
+	inline Vector3 TransformPoint(const Matrix4& m, const Vector3& pos) noexcept
+	{
+		return Vector3(
+			m.value[0].x * pos.x + m.value[1].x * pos.y + m.value[2].x * pos.z + m.value[3].x,
+			m.value[0].y * pos.x + m.value[1].y * pos.y + m.value[2].y * pos.z + m.value[3].y,
+			m.value[0].z * pos.x + m.value[1].z * pos.y + m.value[2].z * pos.z + m.value[3].z);
+	}
+
+	inline Matrix3 Multiply(const Matrix3& Left, const Matrix3& Right) noexcept
+	{
+		// TODO: убрать лишние операции
+		const float SrcA00 = Left[0][0];
+		const float SrcA01 = Left[0][1];
+		const float SrcA02 = Left[0][2];
+		const float SrcA10 = Left[1][0];
+		const float SrcA11 = Left[1][1];
+		const float SrcA12 = Left[1][2];
+		const float SrcA20 = Left[2][0];
+		const float SrcA21 = Left[2][1];
+		const float SrcA22 = Left[2][2];
+
+		const float SrcB00 = Right[0][0];
+		const float SrcB01 = Right[0][1];
+		const float SrcB02 = Right[0][2];
+		const float SrcB10 = Right[1][0];
+		const float SrcB11 = Right[1][1];
+		const float SrcB12 = Right[1][2];
+		const float SrcB20 = Right[2][0];
+		const float SrcB21 = Right[2][1];
+		const float SrcB22 = Right[2][2];
+
+		Matrix3 Result;
+		Result[0][0] = SrcA00 * SrcB00 + SrcA10 * SrcB01 + SrcA20 * SrcB02;
+		Result[0][1] = SrcA01 * SrcB00 + SrcA11 * SrcB01 + SrcA21 * SrcB02;
+		Result[0][2] = SrcA02 * SrcB00 + SrcA12 * SrcB01 + SrcA22 * SrcB02;
+		Result[1][0] = SrcA00 * SrcB10 + SrcA10 * SrcB11 + SrcA20 * SrcB12;
+		Result[1][1] = SrcA01 * SrcB10 + SrcA11 * SrcB11 + SrcA21 * SrcB12;
+		Result[1][2] = SrcA02 * SrcB10 + SrcA12 * SrcB11 + SrcA22 * SrcB12;
+		Result[2][0] = SrcA00 * SrcB20 + SrcA10 * SrcB21 + SrcA20 * SrcB22;
+		Result[2][1] = SrcA01 * SrcB20 + SrcA11 * SrcB21 + SrcA21 * SrcB22;
+		Result[2][2] = SrcA02 * SrcB20 + SrcA12 * SrcB21 + SrcA22 * SrcB22;
+		return Result;
+	}
+
+	inline Quaternion Multiply(const Quaternion& Left, const Quaternion& Right) noexcept
+	{
+		return {
+			Left.w * Right.w - Left.x * Right.x - Left.y * Right.y - Left.z * Right.z,
+			Left.w * Right.x + Left.x * Right.w + Left.y * Right.z - Left.z * Right.y,
+			Left.w * Right.y + Left.y * Right.w + Left.z * Right.x - Left.x * Right.z,
+			Left.w * Right.z + Left.z * Right.w + Left.x * Right.y - Left.y * Right.x
+		};
+	}
+} // namespace MathScalar
+
+namespace MathSimd
+{
+#if defined(MICROMATH_SSE2)
+	// Fac = (m2a*m3b - m3a*m2b, m2a*m3b - m3a*m2b, m1a*m3b - m3a*m1b, m1a*m2b - m2a*m1b) - как Coef в MathScalar::Inverse
+	template<int a, int b>
+	inline __m128 inverseFactor(__m128 m1, __m128 m2, __m128 m3) noexcept
+	{
+		const __m128 swp0a = _mm_shuffle_ps(m3, m2, _MM_SHUFFLE(b, b, b, b));
+		const __m128 swp0b = _mm_shuffle_ps(m3, m2, _MM_SHUFFLE(a, a, a, a));
+		const __m128 swp00 = _mm_shuffle_ps(m2, m1, _MM_SHUFFLE(a, a, a, a));
+		const __m128 swp01 = _mm_shuffle_ps(swp0a, swp0a, _MM_SHUFFLE(2, 0, 0, 0));
+		const __m128 swp02 = _mm_shuffle_ps(swp0b, swp0b, _MM_SHUFFLE(2, 0, 0, 0));
+		const __m128 swp03 = _mm_shuffle_ps(m2, m1, _MM_SHUFFLE(b, b, b, b));
+		return _mm_sub_ps(_mm_mul_ps(swp00, swp01), _mm_mul_ps(swp02, swp03));
+	}
+
+	// (m1[i], m0[i], m0[i], m0[i])
+	template<int i>
+	inline __m128 inverseVec(__m128 m0, __m128 m1) noexcept
+	{
+		const __m128 temp = _mm_shuffle_ps(m1, m0, _MM_SHUFFLE(i, i, i, i));
+		return _mm_shuffle_ps(temp, temp, _MM_SHUFFLE(2, 2, 2, 0));
+	}
+#endif // MICROMATH_SSE2
+
+	inline Matrix4 Multiply(const Matrix4& Left, const Matrix4& Right) noexcept
+	{
+		Matrix4 Result;
+#if defined(MICROMATH_SSE2)
+		const __m128 a0 = _mm_loadu_ps(&Left[0].x);
+		const __m128 a1 = _mm_loadu_ps(&Left[1].x);
+		const __m128 a2 = _mm_loadu_ps(&Left[2].x);
+		const __m128 a3 = _mm_loadu_ps(&Left[3].x);
+		for( int i = 0; i < 4; i++ )
+		{
+			const __m128 b = _mm_loadu_ps(&Right[i].x);
+			__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm_storeu_ps(&Result[i].x, r);
+		}
+#else
+		Result = MathScalar::Multiply(Left, Right);
+#endif
+		return Result;
+	}
+
+	inline Vector4 Multiply(const Matrix4& Left, const Vector4& Right) noexcept
+	{
+		Vector4 Result;
+#if defined(MICROMATH_SSE2)
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(&Left[0].x), _mm_set1_ps(Right.x));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&Left[1].x), _mm_set1_ps(Right.y)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&Left[2].x), _mm_set1_ps(Right.z)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&Left[3].x), _mm_set1_ps(Right.w)));
+		_mm_storeu_ps(&Result.x, r);
+#else
+		Result = MathScalar::Multiply(Left, Right);
+#endif
+		return Result;
+	}
+
+	inline Matrix4 Inverse(const Matrix4& m) noexcept
+	{
+#if defined(MICROMATH_SSE2)
+		const __m128 m0 = _mm_loadu_ps(&m[0].x);
+		const __m128 m1 = _mm_loadu_ps(&m[1].x);
+		const __m128 m2 = _mm_loadu_ps(&m[2].x);
+		const __m128 m3 = _mm_loadu_ps(&m[3].x);
+
+		const __m128 Fac0 = inverseFactor<2, 3>(m1, m2, m3);
+		const __m128 Fac1 = inverseFactor<1, 3>(m1, m2, m3);
+		const __m128 Fac2 = inverseFactor<1, 2>(m1, m2, m3);
+		const __m128 Fac3 = inverseFactor<0, 3>(m1, m2, m3);
+		const __m128 Fac4 = inverseFactor<0, 2>(m1, m2, m3);
+		const __m128 Fac5 = inverseFactor<0, 1>(m1, m2, m3);
+
+		const __m128 Vec0 = inverseVec<0>(m0, m1);
+		const __m128 Vec1 = inverseVec<1>(m0, m1);
+		const __m128 Vec2 = inverseVec<2>(m0, m1);
+		const __m128 Vec3 = inverseVec<3>(m0, m1);
+
+		const __m128 SignA = _mm_setr_ps(+1.0f, -1.0f, +1.0f, -1.0f);
+		const __m128 SignB = _mm_setr_ps(-1.0f, +1.0f, -1.0f, +1.0f);
+
+		const __m128 Inv0 = _mm_mul_ps(SignA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(Vec1, Fac0), _mm_mul_ps(Vec2, Fac1)), _mm_mul_ps(Vec3, Fac2)));
+		const __m128 Inv1 = _mm_mul_ps(SignB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(Vec0, Fac0), _mm_mul_ps(Vec2, Fac3)), _mm_mul_ps(Vec3, Fac4)));
+		const __m128 Inv2 = _mm_mul_ps(SignA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(Vec0, Fac1), _mm_mul_ps(Vec1, Fac3)), _mm_mul_ps(Vec3, Fac5)));
+		const __m128 Inv3 = _mm_mul_ps(SignB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(Vec0, Fac2), _mm_mul_ps(Vec1, Fac4)), _mm_mul_ps(Vec2, Fac5)));
+
+		// первая строка обратной матрицы, скалярное произведение с первым столбцом - определитель
+		const __m128 Row0 = _mm_shuffle_ps(Inv0, Inv1, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 Row1 = _mm_shuffle_ps(Inv2, Inv3, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 Row2 = _mm_shuffle_ps(Row0, Row1, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 Dot0 = _mm_mul_ps(m0, Row2);
+		const __m128 Dot1 = _mm_add_ps(Dot0, _mm_shuffle_ps(Dot0, Dot0, _MM_SHUFFLE(2, 3, 0, 1))); // (x+y, x+y, z+w, z+w)
+		const __m128 Det = _mm_add_ps(Dot1, _mm_shuffle_ps(Dot1, Dot1, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 OneOverDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), Det);
+
+		Matrix4 Result;
+		_mm_storeu_ps(&Result[0].x, _mm_mul_ps(Inv0, OneOverDeterminant));
+		_mm_storeu_ps(&Result[1].x, _mm_mul_ps(Inv1, OneOverDeterminant));
+		_mm_storeu_ps(&Result[2].x, _mm_mul_ps(Inv2, OneOverDeterminant));
+		_mm_storeu_ps(&Result[3].x, _mm_mul_ps(Inv3, OneOverDeterminant));
+		return Result;
+#else
+		return MathScalar::Inverse(m);
+#endif
+	}
+
+	inline Vector3 TransformPoint(const Matrix4& m, const Vector3& pos) noexcept
+	{
+#if defined(MICROMATH_SSE2)
+		const Vector4 r = Multiply(m, Vector4(pos.x, pos.y, pos.z, 1.0f));
+		return { r.x, r.y, r.z };
+#else
+		return MathScalar::TransformPoint(m, pos);
+#endif
+	}
+
+	inline Matrix3 Multiply(const Matrix3& Left, const Matrix3& Right) noexcept
+	{
+#if defined(MICROMATH_SSE2)
+		// столбцы по 3 float: первые два грузятся 4 float (лишний элемент - начало следующего столбца), последний со сдвигом на 1
+		const __m128 a0 = _mm_loadu_ps(&Left[0].x);
+		const __m128 a1 = _mm_loadu_ps(&Left[1].x);
+		const __m128 a2t = _mm_loadu_ps(&Left[1].z); // (m1z, m2x, m2y, m2z)
+		const __m128 a2 = _mm_shuffle_ps(a2t, a2t, _MM_SHUFFLE(3, 3, 2, 1));
+
+		float r[4];
+		Matrix3 Result;
+		for( int i = 0; i < 3; i++ )
+		{
+			__m128 c = _mm_mul_ps(a0, _mm_set1_ps(Right[i].x));
+			c = _mm_add_ps(c, _mm_mul_ps(a1, _mm_set1_ps(Right[i].y)));
+			c = _mm_add_ps(c, _mm_mul_ps(a2, _mm_set1_ps(Right[i].z)));
+			_mm_storeu_ps(r, c);
+			Result[i] = { r[0], r[1], r[2] };
+		}
+		return Result;
+#else
+		return MathScalar::Multiply(Left, Right);
+#endif
+	}
+
+	inline Quaternion Multiply(const Quaternion& Left, const Quaternion& Right) noexcept
+	{
+#if defined(MICROMATH_SSE2)
+		// память: (w, x, y, z)
+		const __m128 l = _mm_loadu_ps(&Left.w);
+		const __m128 r = _mm_loadu_ps(&Right.w);
+		const __m128 signFirst = _mm_setr_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 0, 0, 0)), r);
+		const __m128 t1 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 2, 1, 1)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 1)));
+		const __m128 t2 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 3, 2, 2)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 1, 3, 2)));
+		const __m128 t3 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 1, 3, 3)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 3, 2, 3)));
+		result = _mm_add_ps(result, _mm_xor_ps(t1, signFirst));
+		result = _mm_add_ps(result, _mm_xor_ps(t2, signFirst));
+		result = _mm_sub_ps(result, t3);
+
+		Quaternion Result;
+		_mm_storeu_ps(&Result.w, result);
+		return Result;
+#else
+		return MathScalar::Multiply(Left, Right);
+#endif
+	}
+} // namespace MathSimd
\ No newline at end of file
@@ -19,13 +19,17 @@ extern "C"
 //-----------------------------------------------------------------------------
 PFNGLACTIVETEXTUREPROC glActiveTexture = nullptr;
 PFNGLATTACHSHADERPROC glAttachShader = nullptr;
+PFNGLBINDBUFFERBASEPROC glBindBufferBase = nullptr;
 PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = nullptr;
 PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer = nullptr;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = nullptr;
+PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate = nullptr;
+PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate = nullptr;
 PFNGLBUFFERDATAPROC glBufferData = nullptr;
 PFNGLBUFFERSUBDATAPROC glBufferSubData = nullptr;
 PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus = nullptr;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = nullptr;
 PFNGLCOMPILESHADERPROC glCompileShader = nullptr;
 PFNGLCREATEPROGRAMPROC glCreateProgram = nullptr;
 PFNGLCREATESHADERPROC glCreateShader = nullptr;
@@ -34,10 +38,15 @@ PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers = nullptr;
 PFNGLDELETEPROGRAMPROC glDeleteProgram = nullptr;
 PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers = nullptr;
 PFNGLDELETESHADERPROC glDeleteShader = nullptr;
+PFNGLDELETESYNCPROC glDeleteSync = nullptr;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = nullptr;
 PFNGLDETACHSHADERPROC glDetachShader = nullptr;
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced = nullptr;
+PFNGLDRAWELEMENTSBASEVERTEXPROC glDrawElementsBaseVertex = nullptr;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC glDrawElementsInstancedBaseVertex = nullptr;
 PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced = nullptr;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = nullptr;
+PFNGLFENCESYNCPROC glFenceSync = nullptr;
 PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer = nullptr;
 PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D = nullptr;
 PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture = nullptr;
@@ -47,6 +56,9 @@ PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = nullptr;
 PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers = nullptr;
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = nullptr;
 PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib = nullptr;
+PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv = nullptr;
+PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC glGetActiveUniformBlockName = nullptr;
+PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform = nullptr;
 PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation = nullptr;
 PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = nullptr;
 PFNGLGETPROGRAMIVPROC glGetProgramiv = nullptr;
@@ -55,16 +67,20 @@ PFNGLGETSHADERIVPROC glGetShaderiv = nullptr;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = nullptr;
 PFNGLLINKPROGRAMPROC glLinkProgram = nullptr;
 PFNGLMAPBUFFERPROC glMapBuffer = nullptr;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange = nullptr;
+PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC glMultiDrawElementsBaseVertex = nullptr;
 PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage = nullptr;
 PFNGLSHADERSOURCEPROC glShaderSource = nullptr;
 PFNGLUNIFORM1FPROC glUniform1f = nullptr;
 PFNGLUNIFORM1IPROC glUniform1i = nullptr;
 PFNGLUNIFORM2FVPROC glUniform2fv = nullptr;
 PFNGLUNIFORM3FVPROC glUniform3fv = nullptr;
+PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding = nullptr;
 PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv = nullptr;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = nullptr;
 PFNGLUNMAPBUFFERPROC glUnmapBuffer = nullptr;
 PFNGLUSEPROGRAMPROC glUseProgram = nullptr;
+PFNGLVERTEXATTRIB4FPROC glVertexAttrib4f = nullptr;
 PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = nullptr;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = nullptr;
 
@@ -73,13 +89,17 @@ void OpenGLInit(OpenGLGetProcAddressFunc func)
 {
 	glActiveTexture = (PFNGLACTIVETEXTUREPROC)func("glActiveTexture");
 	glAttachShader = (PFNGLATTACHSHADERPROC)func("glAttachShader");
+	glBindBufferBase = (PFNGLBINDBUFFERBASEPROC)func("glBindBufferBase");
 	glBindBuffer = (PFNGLBINDBUFFERPROC)func("glBindBuffer");
 	glBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)func("glBindFramebuffer");
 	glBindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)func("glBindRenderbuffer");
 	glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)func("glBindVertexArray");
+	glBlendEquationSeparate = (PFNGLBLENDEQUATIONSEPARATEPROC)func("glBlendEquationSeparate");
+	glBlendFuncSeparate = (PFNGLBLENDFUNCSEPARATEPROC)func("glBlendFuncSeparate");
 	glBufferData = (PFNGLBUFFERDATAPROC)func("glBufferData");
 	glBufferSubData = (PFNGLBUFFERSUBDATAPROC)func("glBufferSubData");
 	glCheckFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)func("glCheckFramebufferStatus");
+	glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)func("glClientWaitSync");
 	glCompileShader = (PFNGLCOMPILESHADERPROC)func("glCompileShader");
 	glCreateProgram = (PFNGLCREATEPROGRAMPROC)func("glCreateProgram");
 	glCreateShader = (PFNGLCREATESHADERPROC)func("glCreateShader");
@@ -88,10 +108,15 @@ void OpenGLInit(OpenGLGetProcAddressFunc func)
 	glDeleteProgram = (PFNGLDELETEPROGRAMPROC)func("glDeleteProgram");
 	glDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)func("glDeleteRenderbuffers");
 	glDeleteShader = (PFNGLDELETESHADERPROC)func("glDeleteShader");
+	glDeleteSync = (PFNGLDELETESYNCPROC)func("glDeleteSync");
 	glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC)func("glDeleteVertexArrays");
 	glDetachShader = (PFNGLDETACHSHADERPROC)func("glDetachShader");
+	glDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC)func("glDrawArraysInstanced");
+	glDrawElementsBaseVertex = (PFNGLDRAWELEMENTSBASEVERTEXPROC)func("glDrawElementsBaseVertex");
+	glDrawElementsInstancedBaseVertex = (PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC)func("glDrawElementsInstancedBaseVertex");
 	glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)func("glDrawElementsInstanced");
 	glEnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)func("glEnableVertexAttribArray");
+	glFenceSync = (PFNGLFENCESYNCPROC)func("glFenceSync");
 	glFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)func("glFramebufferRenderbuffer");
 	glFramebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DPROC)func("glFramebufferTexture2D");
 	glFramebufferTexture = (PFNGLFRAMEBUFFERTEXTUREPROC)func("glFramebufferTexture");
@@ -101,6 +126,9 @@ void OpenGLInit(OpenGLGetProcAddressFunc func)
 	glGenRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)func("glGenRenderbuffers");
 	glGenVertexArrays = (PFNGLGENVERTEXARRAYSPROC)func("glGenVertexArrays");
 	glGetActiveAttrib = (PFNGLGETACTIVEATTRIBPROC)func("glGetActiveAttrib");
+	glGetActiveUniformBlockiv = (PFNGLGETACTIVEUNIFORMBLOCKIVPROC)func("glGetActiveUniformBlockiv");
+	glGetActiveUniformBlockName = (PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC)func("glGetActiveUniformBlockName");
+	glGetActiveUniform = (PFNGLGETACTIVEUNIFORMPROC)func("glGetActiveUniform");
 	glGetAttribLocation = (PFNGLGETATTRIBLOCATIONPROC)func("glGetAttribLocation");
 	glGetProgramInfoLog = (PFNGLGETPROGRAMINFOLOGPROC)func("glGetProgramInfoLog");
 	glGetProgramiv = (PFNGLGETPROGRAMIVPROC)func("glGetProgramiv");
@@ -109,16 +137,20 @@ void OpenGLInit(OpenGLGetProcAddressFunc func)
 	glGetUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)func("glGetUniformLocation");
 	glLinkProgram = (PFNGLLINKPROGRAMPROC)func("glLinkProgram");
 	glMapBuffer = (PFNGLMAPBUFFERPROC)func("glMapBuffer");
+	glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)func("glMapBufferRange");
+	glMultiDrawElementsBaseVertex = (PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC)func("glMultiDrawElementsBaseVertex");
 	glRenderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC)func("glRenderbufferStorage");
 	glShaderSource = (PFNGLSHADERSOURCEPROC)func("glShaderSource");
 	glUniform1f = (PFNGLUNIFORM1FPROC)func("glUniform1f");
 	glUniform1i = (PFNGLUNIFORM1IPROC)func("glUniform1i");
 	glUniform2fv = (PFNGLUNIFORM2FVPROC)func("glUniform2fv");
 	glUniform3fv = (PFNGLUNIFORM3FVPROC)func("glUniform3fv");
+	glUniformBlockBinding = (PFNGLUNIFORMBLOCKBINDINGPROC)func("glUniformBlockBinding");
 	glUniformMatrix3fv = (PFNGLUNIFORMMATRIX3FVPROC)func("glUniformMatrix3fv");
 	glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)func("glUniformMatrix4fv");
 	glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)func("glUnmapBuffer");
 	glUseProgram = (PFNGLUSEPROGRAMPROC)func("glUseProgram");
+	glVertexAttrib4f = (PFNGLVERTEXATTRIB4FPROC)func("glVertexAttrib4f");
 	glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)func("glVertexAttribDivisor");
 	glVertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)func("glVertexAttribPointer");
 }
@@ -52,21 +52,37 @@ typedef __int64 GLintptr;
 typedef int GLsizeiptr;
 typedef int GLintptr;
 #endif
+typedef struct __GLsync* GLsync;
 
 #define GL_ACTIVE_ATTRIBUTES 0x8B89
 #define GL_ACTIVE_ATTRIBUTE_MAX_LENGTH 0x8B8A
+#define GL_ACTIVE_UNIFORMS 0x8B86
+#define GL_ACTIVE_UNIFORM_BLOCKS 0x8A36
+#define GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH 0x8A35
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH 0x8B87
+#define GL_ALWAYS 0x0207
+#define GL_AND 0x1501
+#define GL_AND_INVERTED 0x1504
+#define GL_AND_REVERSE 0x1502
 #define GL_ARRAY_BUFFER 0x8892
 #define GL_BACK 0x0405
 #define GL_BLEND 0x0BE2
+#define GL_BYTE 0x1400
 #define GL_CCW 0x0901
 #define GL_CLAMP 0x2900
 #define GL_CLAMP_TO_BORDER 0x812D
 #define GL_CLAMP_TO_EDGE 0x812F
+#define GL_CLEAR 0x1500
 #define GL_COLOR_ATTACHMENT0 0x8CE0
 #define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_COLOR_LOGIC_OP 0x0BF2
 #define GL_COMPILE_STATUS 0x8B81
+#define GL_COPY 0x1503
+#define GL_COPY_INVERTED 0x150C
 #define GL_CULL_FACE 0x0B44
 #define GL_CW 0x0900
+#define GL_DECR 0x1E03
+#define GL_DECR_WRAP 0x8508
 #define GL_DEPTH24_STENCIL8 0x88F0
 #define GL_DEPTH_ATTACHMENT 0x8D00
 #define GL_DEPTH_BUFFER_BIT 0x00000100
@@ -76,8 +92,12 @@ typedef int GLintptr;
 #define GL_DEPTH_STENCIL 0x84F9
 #define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
 #define GL_DEPTH_TEST 0x0B71
+#define GL_DST_ALPHA 0x0304
+#define GL_DST_COLOR 0x0306
 #define GL_DYNAMIC_DRAW 0x88E8
 #define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_EQUAL 0x0202
+#define GL_EQUIV 0x1509
 #define GL_FALSE 0
 #define GL_FILL 0x1B02
 #define GL_FLOAT 0x1406
@@ -96,30 +116,60 @@ typedef int GLintptr;
 #define GL_FRAMEBUFFER_SRGB 0x8DB9
 #define GL_FRAMEBUFFER_UNDEFINED 0x8219
 #define GL_FRAMEBUFFER_UNSUPPORTED 0x8CDD
+#define GL_FRONT 0x0404
 #define GL_FRONT_AND_BACK 0x0408
+#define GL_FUNC_ADD 0x8006
+#define GL_FUNC_REVERSE_SUBTRACT 0x800B
+#define GL_FUNC_SUBTRACT 0x800A
 #define GL_GEOMETRY_SHADER 0x8DD9
+#define GL_GEQUAL 0x0206
+#define GL_GREATER 0x0204
 #define GL_GREEN 0x1904
+#define GL_HALF_FLOAT 0x140B
+#define GL_INCR 0x1E02
+#define GL_INCR_WRAP 0x8507
 #define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_INT_2_10_10_10_REV 0x8D9F
+#define GL_INVERT 0x150A
+#define GL_KEEP 0x1E00
 #define GL_LEQUAL 0x0203
+#define GL_LESS 0x0201
 #define GL_LINE 0x1B01
 #define GL_LINEAR 0x2601
 #define GL_LINEAR_MIPMAP_LINEAR 0x2703
 #define GL_LINEAR_MIPMAP_NEAREST 0x2701
 #define GL_LINES 0x0001
 #define GL_LINK_STATUS 0x8B82
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAX 0x8008
+#define GL_MIN 0x8007
 #define GL_MIRRORED_REPEAT 0x8370
+#define GL_NAND 0x150E
 #define GL_NEAREST 0x2600
 #define GL_NEAREST_MIPMAP_LINEAR 0x2702
 #define GL_NEAREST_MIPMAP_NEAREST 0x2700
+#define GL_NEVER 0x0200
 #define GL_NONE 0
+#define GL_NOOP 0x1505
+#define GL_NOR 0x1508
+#define GL_NOTEQUAL 0x0205
 #define GL_ONE 1
+#define GL_ONE_MINUS_DST_ALPHA 0x0305
+#define GL_ONE_MINUS_DST_COLOR 0x0307
 #define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_ONE_MINUS_SRC_COLOR 0x0301
+#define GL_OR 0x1507
+#define GL_OR_INVERTED 0x150D
+#define GL_OR_REVERSE 0x150B
 #define GL_PACK_ALIGNMENT 0x0D05
 #define GL_POINTS 0x0000
 #define GL_R8 0x8229
 #define GL_RED 0x1903
 #define GL_RENDERBUFFER 0x8D41
 #define GL_REPEAT 0x2901
+#define GL_REPLACE 0x1E01
 #define GL_RG 0x8227
 #define GL_RG8 0x822B
 #define GL_RGB 0x1907
@@ -128,10 +178,19 @@ typedef int GLintptr;
 #define GL_RGB8 0x8051
 #define GL_RGBA 0x1908
 #define GL_RGBA8 0x8058
+#define GL_SAMPLE_ALPHA_TO_COVERAGE 0x809E
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_SET 0x150F
+#define GL_SHORT 0x1402
 #define GL_SRC_ALPHA 0x0302
+#define GL_SRC_ALPHA_SATURATE 0x0308
+#define GL_SRC_COLOR 0x0300
 #define GL_STATIC_DRAW 0x88E4
 #define GL_STENCIL_BUFFER_BIT 0x00000400
+#define GL_STENCIL_TEST 0x0B90
 #define GL_STREAM_DRAW 0x88E0
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #define GL_TEXTURE0 0x84C0
 #define GL_TEXTURE1 0x84C1
 #define GL_TEXTURE2 0x84C2
@@ -151,16 +210,23 @@ typedef int GLintptr;
 #define GL_TEXTURE_WRAP_R 0x8072
 #define GL_TEXTURE_WRAP_S 0x2802
 #define GL_TEXTURE_WRAP_T 0x2803
+#define GL_TIMEOUT_EXPIRED 0x911B
 #define GL_TRIANGLES 0x0004
 #define GL_TRUE 1
+#define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
+#define GL_UNIFORM_BUFFER 0x8A11
 #define GL_UNPACK_ALIGNMENT 0x0CF5
 #define GL_UNSIGNED_BYTE 0x1401
 #define GL_UNSIGNED_INT 0x1405
+#define GL_UNSIGNED_INT_2_10_10_10_REV 0x8368
 #define GL_UNSIGNED_INT_8_8_8_8_REV 0x8367
 #define GL_UNSIGNED_SHORT 0x1403
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_VIEWPORT 0x0BA2
+#define GL_WAIT_FAILED 0x911D
 #define GL_WRITE_ONLY 0x88B9
+#define GL_XOR 0x1506
+#define GL_ZERO 0
 
 // OpenGL32.lib
 #ifdef __cplusplus
@@ -171,9 +237,11 @@ extern "C" {
 	GLAPI void GLAPIENTRY glClear(GLbitfield mask);
 	GLAPI void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
 	GLAPI void GLAPIENTRY glClearDepth(GLclampd depth);
+	GLAPI void GLAPIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
 	GLAPI void GLAPIENTRY glCullFace(GLenum mode);
 	GLAPI void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures);
 	GLAPI void GLAPIENTRY glDepthFunc(GLenum func);
+	GLAPI void GLAPIENTRY glDepthMask(GLboolean flag);
 	GLAPI void GLAPIENTRY glDepthRange(GLclampd zNear, GLclampd zFar);
 	GLAPI void GLAPIENTRY glDisable(GLenum cap);
 	GLAPI void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count);
@@ -183,10 +251,14 @@ extern "C" {
 	GLAPI void GLAPIENTRY glFrontFace(GLenum mode);
 	GLAPI void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures);
 	GLAPI void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params);
+	GLAPI void GLAPIENTRY glLogicOp(GLenum opcode);
 	GLAPI void GLAPIENTRY glPixelStorei(GLenum pname, GLint param);
 	GLAPI void GLAPIENTRY glPolygonMode(GLenum face, GLenum mode);
 	GLAPI void GLAPIENTRY glReadBuffer(GLenum mode);
 	GLAPI void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+	GLAPI void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask);
+	GLAPI void GLAPIENTRY glStencilMask(GLuint mask);
+	GLAPI void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass);
 	GLAPI void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
 	GLAPI void GLAPIENTRY glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params);
 	GLAPI void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param);
@@ -200,13 +272,17 @@ extern "C" {
 // не сортировать тут, сортировать в объявлении типа и затем тут ставить в нужном месте
 typedef void (GLAPIENTRY* PFNGLACTIVETEXTUREPROC)(GLenum texture);
 typedef void (GLAPIENTRY* PFNGLATTACHSHADERPROC)(GLuint program, GLuint shader);
+typedef void (GLAPIENTRY* PFNGLBINDBUFFERBASEPROC)(GLenum target, GLuint index, GLuint buffer);
 typedef void (GLAPIENTRY* PFNGLBINDBUFFERPROC)(GLenum target, GLuint buffer);
 typedef void (GLAPIENTRY* PFNGLBINDFRAMEBUFFERPROC)(GLenum target, GLuint framebuffer);
 typedef void (GLAPIENTRY* PFNGLBINDRENDERBUFFERPROC)(GLenum target, GLuint renderbuffer);
 typedef void (GLAPIENTRY* PFNGLBINDVERTEXARRAYPROC)(GLuint array);
+typedef void (GLAPIENTRY* PFNGLBLENDEQUATIONSEPARATEPROC)(GLenum modeRGB, GLenum modeAlpha);
+typedef void (GLAPIENTRY* PFNGLBLENDFUNCSEPARATEPROC)(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
 typedef void (GLAPIENTRY* PFNGLBUFFERDATAPROC)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
 typedef void (GLAPIENTRY* PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
 typedef GLenum(GLAPIENTRY* PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum target);
+typedef GLenum(GLAPIENTRY* PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 typedef void (GLAPIENTRY* PFNGLCOMPILESHADERPROC)(GLuint shader);
 typedef GLuint(GLAPIENTRY* PFNGLCREATEPROGRAMPROC)();
 typedef GLuint(GLAPIENTRY* PFNGLCREATESHADERPROC)(GLenum type);
@@ -215,10 +291,15 @@ typedef void (GLAPIENTRY* PFNGLDELETEFRAMEBUFFERSPROC)(GLsizei n, const GLuint*
 typedef void (GLAPIENTRY* PFNGLDELETEPROGRAMPROC)(GLuint program);
 typedef void (GLAPIENTRY* PFNGLDELETERENDERBUFFERSPROC)(GLsizei n, const GLuint* renderbuffers);
 typedef void (GLAPIENTRY* PFNGLDELETESHADERPROC)(GLuint shader);
+typedef void (GLAPIENTRY* PFNGLDELETESYNCPROC)(GLsync sync);
 typedef void (GLAPIENTRY* PFNGLDELETEVERTEXARRAYSPROC)(GLsizei n, const GLuint* arrays);
 typedef void (GLAPIENTRY* PFNGLDETACHSHADERPROC)(GLuint program, GLuint shader);
+typedef void (GLAPIENTRY* PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+typedef void (GLAPIENTRY* PFNGLDRAWELEMENTSBASEVERTEXPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex);
+typedef void (GLAPIENTRY* PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex);
 typedef void (GLAPIENTRY* PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
 typedef void (GLAPIENTRY* PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint index);
+typedef GLsync(GLAPIENTRY* PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
 typedef void (GLAPIENTRY* PFNGLFRAMEBUFFERRENDERBUFFERPROC)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
 typedef void (GLAPIENTRY* PFNGLFRAMEBUFFERTEXTURE2DPROC)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
 typedef void (GLAPIENTRY* PFNGLFRAMEBUFFERTEXTUREPROC)(GLenum target, GLenum attachment, GLuint texture, GLint level);
@@ -228,6 +309,9 @@ typedef void (GLAPIENTRY* PFNGLGENFRAMEBUFFERSPROC)(GLsizei n, GLuint* framebuff
 typedef void (GLAPIENTRY* PFNGLGENRENDERBUFFERSPROC)(GLsizei n, GLuint* renderbuffers);
 typedef void (GLAPIENTRY* PFNGLGENVERTEXARRAYSPROC)(GLsizei n, GLuint* arrays);
 typedef void (GLAPIENTRY* PFNGLGETACTIVEATTRIBPROC)(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, char* name);
+typedef void (GLAPIENTRY* PFNGLGETACTIVEUNIFORMBLOCKIVPROC)(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params);
+typedef void (GLAPIENTRY* PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC)(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei* length, char* uniformBlockName);
+typedef void (GLAPIENTRY* PFNGLGETACTIVEUNIFORMPROC)(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, char* name);
 typedef GLint(GLAPIENTRY* PFNGLGETATTRIBLOCATIONPROC)(GLuint program, const char* name);
 typedef void (GLAPIENTRY* PFNGLGETPROGRAMINFOLOGPROC)(GLuint program, GLsizei bufSize, GLsizei* length, char* infoLog);
 typedef void (GLAPIENTRY* PFNGLGETPROGRAMIVPROC)(GLuint program, GLenum pname, GLint* params);
@@ -236,28 +320,36 @@ typedef void (GLAPIENTRY* PFNGLGETSHADERIVPROC)(GLuint shader, GLenum pname, GLi
 typedef GLint(GLAPIENTRY* PFNGLGETUNIFORMLOCATIONPROC)(GLuint program, const char* name);
 typedef void (GLAPIENTRY* PFNGLLINKPROGRAMPROC)(GLuint program);
 typedef void*(GLAPIENTRY* PFNGLMAPBUFFERPROC)(GLenum target, GLenum access);
+typedef void*(GLAPIENTRY* PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef void (GLAPIENTRY* PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC)(GLenum mode, const GLsizei* count, GLenum type, const void* const* indices, GLsizei drawcount, const GLint* basevertex);
 typedef void (GLAPIENTRY* PFNGLRENDERBUFFERSTORAGEPROC)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
 typedef void (GLAPIENTRY* PFNGLSHADERSOURCEPROC)(GLuint shader, GLsizei count, const char* const* string, const GLint* length);
 typedef void (GLAPIENTRY* PFNGLUNIFORM1FPROC)(GLint location, GLfloat v0);
 typedef void (GLAPIENTRY* PFNGLUNIFORM1IPROC)(GLint location, GLint v0);
 typedef void (GLAPIENTRY* PFNGLUNIFORM2FVPROC)(GLint location, GLsizei count, const GLfloat* value);
 typedef void (GLAPIENTRY* PFNGLUNIFORM3FVPROC)(GLint location, GLsizei count, const GLfloat* value);
+typedef void (GLAPIENTRY* PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
 typedef void (GLAPIENTRY* PFNGLUNIFORMMATRIX3FVPROC)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
 typedef void (GLAPIENTRY* PFNGLUNIFORMMATRIX4FVPROC)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
 typedef GLboolean(GLAPIENTRY* PFNGLUNMAPBUFFERPROC)(GLenum target);
 typedef void (GLAPIENTRY* PFNGLUSEPROGRAMPROC)(GLuint program);
+typedef void (GLAPIENTRY* PFNGLVERTEXATTRIB4FPROC)(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
 typedef void (GLAPIENTRY* PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
 typedef void (GLAPIENTRY* PFNGLVERTEXATTRIBPOINTERPROC)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset);
 
 extern PFNGLACTIVETEXTUREPROC glActiveTexture;
 extern PFNGLATTACHSHADERPROC glAttachShader;
+extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
 extern PFNGLBINDBUFFERPROC glBindBuffer;
 extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
 extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
+extern PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate;
+extern PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
 extern PFNGLBUFFERDATAPROC glBufferData;
 extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
 extern PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
 extern PFNGLCOMPILESHADERPROC glCompileShader;
 extern PFNGLCREATEPROGRAMPROC glCreateProgram;
 extern PFNGLCREATESHADERPROC glCreateShader;
@@ -266,10 +358,15 @@ extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
 extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
 extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers;
 extern PFNGLDELETESHADERPROC glDeleteShader;
+extern PFNGLDELETESYNCPROC glDeleteSync;
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLDETACHSHADERPROC glDetachShader;
+extern PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced;
+extern PFNGLDRAWELEMENTSBASEVERTEXPROC glDrawElementsBaseVertex;
+extern PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC glDrawElementsInstancedBaseVertex;
 extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
+extern PFNGLFENCESYNCPROC glFenceSync;
 extern PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
 extern PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
 extern PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture;
@@ -279,6 +376,9 @@ extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
 extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 extern PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib;
+extern PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv;
+extern PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC glGetActiveUniformBlockName;
+extern PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
 extern PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
 extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
 extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
@@ -287,16 +387,20 @@ extern PFNGLGETSHADERIVPROC glGetShaderiv;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 extern PFNGLLINKPROGRAMPROC glLinkProgram;
 extern PFNGLMAPBUFFERPROC glMapBuffer;
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+extern PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC glMultiDrawElementsBaseVertex;
 extern PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
 extern PFNGLSHADERSOURCEPROC glShaderSource;
 extern PFNGLUNIFORM1FPROC glUniform1f;
 extern PFNGLUNIFORM1IPROC glUniform1i;
 extern PFNGLUNIFORM2FVPROC glUniform2fv;
 extern PFNGLUNIFORM3FVPROC glUniform3fv;
+extern PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
 extern PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
 extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
 extern PFNGLUSEPROGRAMPROC glUseProgram;
+extern PFNGLVERTEXATTRIB4FPROC glVertexAttrib4f;
 extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
 
@@ -9,7 +9,9 @@
 #endif // _MSC_VER
 
 #include <assert.h>
+#include <string.h>
 #include <algorithm>
+#include <unordered_map>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
@@ -43,14 +45,80 @@ namespace state
 	unsigned CurrentVAO = 0;
 	unsigned CurrentTexture2D[MaxBindingTextures] = { 0 };
 	unsigned CurrentTextureCube = 0;
+	unsigned CurrentUniformBuffer[MaxBindingUniformBuffers] = { 0 };
 
 	FrameBuffer* CurrentFrameBuffer = nullptr;
+
+	// теневая копия состояния GL, начальные значения - значения по умолчанию контекста GL
+	struct BlendFunc
+	{
+		GLenum srcRGB, dstRGB, srcAlpha, dstAlpha;
+		bool operator==(const BlendFunc&) const = default;
+	};
+	struct BlendEquation
+	{
+		GLenum modeRGB, modeAlpha;
+		bool operator==(const BlendEquation&) const = default;
+	};
+	struct StencilFunc
+	{
+		GLenum func; GLint ref; GLuint mask;
+		bool operator==(const StencilFunc&) const = default;
+	};
+	struct StencilOps
+	{
+		GLenum fail, depthFail, depthPass;
+		bool operator==(const StencilOps&) const = default;
+	};
+	struct Rect
+	{
+		int x, y, width, height;
+		bool operator==(const Rect&) const = default;
+	};
+
+	bool Blend = false;
+	bool ColorLogicOp = false;
+	bool AlphaToCoverage = false;
+	BlendFunc CurrentBlendFunc = { GL_ONE, GL_ZERO, GL_ONE, GL_ZERO };
+	BlendEquation CurrentBlendEquation = { GL_FUNC_ADD, GL_FUNC_ADD };
+	GLenum LogicOp = GL_COPY;
+	uint32_t ColorMask = ColorWriteAll;
+
+	bool DepthTest = false;
+	GLenum DepthFunc = GL_LESS;
+	bool DepthMask = true;
+
+	bool StencilTest = false;
+	StencilFunc CurrentStencilFunc = { GL_ALWAYS, 0, 0xFFFFFFFF };
+	StencilOps CurrentStencilOps = { GL_KEEP, GL_KEEP, GL_KEEP };
+	GLuint StencilWriteMask = 0xFFFFFFFF;
+
+	bool CullFace = false;
+	GLenum CullFaceMode = GL_BACK;
+	GLenum FrontFace = GL_CCW;
+	bool ScissorTest = false;
+	Rect Viewport = { 0, 0, 0, 0 };
+	Rect Scissor = { 0, 0, 0, 0 };
+
+	// кеш значений uniform по программам, индекс - location. Значения сравниваются побитово
+	constexpr int MaxCachedUniformLocations = 256;
+	struct UniformValue
+	{
+		uint32_t size = 0; // 0 - значение не задавалось
+		float data[16];
+	};
+	std::unordered_map<unsigned, std::vector<UniformValue>> UniformCache;
+	std::vector<UniformValue>* CurrentUniformCache = nullptr;
+
+	RenderFrameStatistics FrameStatistics;
+	RenderFrameStatistics LastFrameStatistics;
 }
 //-----------------------------------------------------------------------------
 namespace render
 {
 	int FramebufferWidth = 0;
 	int FramebufferHeight = 0;
+	uint64_t FrameIndex = 0;
 
 	Color ClearColor;
 	float PerspectiveFOV = 45.0f;
@@ -85,6 +153,22 @@ inline GLenum translateToGL(PrimitiveDraw p)
 	return 0;
 }
 //-----------------------------------------------------------------------------
+inline GLenum translateToGL(VertexAttributeType type)
+{
+	switch (type)
+	{
+	case VertexAttributeType::Float:                 return GL_FLOAT;
+	case VertexAttributeType::HalfFloat:             return GL_HALF_FLOAT;
+	case VertexAttributeType::Byte:                  return GL_BYTE;
+	case VertexAttributeType::UnsignedByte:          return GL_UNSIGNED_BYTE;
+	case VertexAttributeType::Short:                 return GL_SHORT;
+	case VertexAttributeType::UnsignedShort:         return GL_UNSIGNED_SHORT;
+	case VertexAttributeType::Int2_10_10_10:         return GL_INT_2_10_10_10_REV;
+	case VertexAttributeType::UnsignedInt2_10_10_10: return GL_UNSIGNED_INT_2_10_10_10_REV;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
 inline GLint translateToGL(TextureWrapping wrap)
 {
 	switch (wrap)
@@ -122,18 +206,236 @@ inline constexpr GLint translateToGL(TextureMagFilter filter)
 	return 0;
 }
 //-----------------------------------------------------------------------------
+inline constexpr GLenum translateToGL(BlendMode mode)
+{
+	switch (mode)
+	{
+	case BlendMode::Zero:             return GL_ZERO;
+	case BlendMode::One:              return GL_ONE;
+	case BlendMode::DstColor:         return GL_DST_COLOR;
+	case BlendMode::SrcColor:         return GL_SRC_COLOR;
+	case BlendMode::OneMinusDstColor: return GL_ONE_MINUS_DST_COLOR;
+	case BlendMode::SrcAlpha:         return GL_SRC_ALPHA;
+	case BlendMode::OneMinusSrcColor: return GL_ONE_MINUS_SRC_COLOR;
+	case BlendMode::DstAlpha:         return GL_DST_ALPHA;
+	case BlendMode::OneMinusDstAlpha: return GL_ONE_MINUS_DST_ALPHA;
+	case BlendMode::SrcAlphaSaturate: return GL_SRC_ALPHA_SATURATE;
+	case BlendMode::OneMinusSrcAlpha: return GL_ONE_MINUS_SRC_ALPHA;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+inline constexpr GLenum translateToGL(BlendOp op)
+{
+	switch (op)
+	{
+	case BlendOp::Add:                 return GL_FUNC_ADD;
+	case BlendOp::Sub:                 return GL_FUNC_SUBTRACT;
+	case BlendOp::RevSub:              return GL_FUNC_REVERSE_SUBTRACT;
+	case BlendOp::Min:                 return GL_MIN;
+	case BlendOp::Max:                 return GL_MAX;
+	case BlendOp::LogicalClear:        return GL_CLEAR;
+	case BlendOp::LogicalSet:          return GL_SET;
+	case BlendOp::LogicalCopy:         return GL_COPY;
+	case BlendOp::LogicalCopyInverted: return GL_COPY_INVERTED;
+	case BlendOp::LogicalNoop:         return GL_NOOP;
+	case BlendOp::LogicalInvert:       return GL_INVERT;
+	case BlendOp::LogicalAnd:          return GL_AND;
+	case BlendOp::LogicalNand:         return GL_NAND;
+	case BlendOp::LogicalOr:           return GL_OR;
+	case BlendOp::LogicalNor:          return GL_NOR;
+	case BlendOp::LogicalXor:          return GL_XOR;
+	case BlendOp::LogicalEquiv:        return GL_EQUIV;
+	case BlendOp::LogicalAndReverse:   return GL_AND_REVERSE;
+	case BlendOp::LogicalAndInverted:  return GL_AND_INVERTED;
+	case BlendOp::LogicalOrReverse:    return GL_OR_REVERSE;
+	case BlendOp::LogicalOrInverted:   return GL_OR_INVERTED;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+inline constexpr GLenum translateToGL(CompareFunction func)
+{
+	switch (func)
+	{
+	case CompareFunction::Never:    return GL_NEVER;
+	case CompareFunction::Less:     return GL_LESS;
+	case CompareFunction::Equal:    return GL_EQUAL;
+	case CompareFunction::LEqual:   return GL_LEQUAL;
+	case CompareFunction::Greater:  return GL_GREATER;
+	case CompareFunction::NotEqual: return GL_NOTEQUAL;
+	case CompareFunction::GEqual:   return GL_GEQUAL;
+	case CompareFunction::Disabled:
+	case CompareFunction::Always:   return GL_ALWAYS;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+inline constexpr GLenum translateToGL(StencilOp op)
+{
+	switch (op)
+	{
+	case StencilOp::Keep:     return GL_KEEP;
+	case StencilOp::Zero:     return GL_ZERO;
+	case StencilOp::Replace:  return GL_REPLACE;
+	case StencilOp::IncrSat:  return GL_INCR;
+	case StencilOp::DecrSat:  return GL_DECR;
+	case StencilOp::Invert:   return GL_INVERT;
+	case StencilOp::IncrWrap: return GL_INCR_WRAP;
+	case StencilOp::DecrWrap: return GL_DECR_WRAP;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+inline constexpr GLenum translateToGL(CullMode mode)
+{
+	switch (mode)
+	{
+	case CullMode::None:
+	case CullMode::Back:  return GL_BACK;
+	case CullMode::Front: return GL_FRONT;
+	case CullMode::Full:  return GL_FRONT_AND_BACK;
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
 //=============================================================================
 // Render States
 //=============================================================================
 //-----------------------------------------------------------------------------
-void SetBlendState(const BlendState& state, float alphaRef)
+template<typename T>
+inline bool changeState(T& current, const T& value)
+{
+	if( current == value )
+	{
+		state::FrameStatistics.stateCallsSkipped++;
+		return false;
+	}
+	current = value;
+	state::FrameStatistics.stateCalls++;
+	return true;
+}
+//-----------------------------------------------------------------------------
+inline void setCapability(GLenum capability, bool& current, bool enable)
+{
+	if( !changeState(current, enable) ) return;
+	if( enable ) glEnable(capability);
+	else glDisable(capability);
+}
+//-----------------------------------------------------------------------------
+void SetBlendState(const BlendState& blendState, float /*alphaRef*/)
 {
-	//if (state == state::CurrentBlendState) return;
-	//state::CurrentBlendState = state;
+	const bool logicOp = blendState.blendOp >= BlendOp::LogicalClear;
+	setCapability(GL_COLOR_LOGIC_OP, state::ColorLogicOp, logicOp);
+	if( logicOp )
+	{
+		setCapability(GL_BLEND, state::Blend, false);
+		if( changeState(state::LogicOp, translateToGL(blendState.blendOp)) )
+			glLogicOp(state::LogicOp);
+	}
+	else
+	{
+		const state::BlendFunc blendFunc = {
+			translateToGL(blendState.srcBlend), translateToGL(blendState.dstBlend),
+			translateToGL(blendState.srcBlendAlpha), translateToGL(blendState.dstBlendAlpha)
+		};
+		const state::BlendEquation blendEquation = { translateToGL(blendState.blendOp), translateToGL(blendState.blendOpAlpha) };
 
+		// src * 1 + dst * 0 - смешивание ничего не делает
+		const bool blend = !(blendFunc == state::BlendFunc{ GL_ONE, GL_ZERO, GL_ONE, GL_ZERO } && blendEquation == state::BlendEquation{ GL_FUNC_ADD, GL_FUNC_ADD });
+		setCapability(GL_BLEND, state::Blend, blend);
+		if( blend )
+		{
+			if( changeState(state::CurrentBlendFunc, blendFunc) )
+				glBlendFuncSeparate(blendFunc.srcRGB, blendFunc.dstRGB, blendFunc.srcAlpha, blendFunc.dstAlpha);
+			if( changeState(state::CurrentBlendEquation, blendEquation) )
+				glBlendEquationSeparate(blendEquation.modeRGB, blendEquation.modeAlpha);
+		}
+	}
+
+	if( changeState(state::ColorMask, blendState.renderTargetWriteMask) )
+	{
+		const uint32_t mask = state::ColorMask;
+		glColorMask((mask & ColorWriteR) ? GL_TRUE : GL_FALSE, (mask & ColorWriteG) ? GL_TRUE : GL_FALSE, (mask & ColorWriteB) ? GL_TRUE : GL_FALSE, (mask & ColorWriteA) ? GL_TRUE : GL_FALSE);
+	}
+	setCapability(GL_SAMPLE_ALPHA_TO_COVERAGE, state::AlphaToCoverage, blendState.alphaToMask);
 }
 //-----------------------------------------------------------------------------
+void SetDepthState(const DepthState& depthState)
+{
+	const bool depthTest = depthState.depthFunc != CompareFunction::Disabled;
+	setCapability(GL_DEPTH_TEST, state::DepthTest, depthTest);
+	if( depthTest && changeState(state::DepthFunc, translateToGL(depthState.depthFunc)) )
+		glDepthFunc(state::DepthFunc);
+	if( changeState(state::DepthMask, depthState.depthWrite) )
+		glDepthMask(depthState.depthWrite ? GL_TRUE : GL_FALSE);
+}
+//-----------------------------------------------------------------------------
+void SetStencilState(const StencilState& stencilState)
+{
+	const bool stencilTest = stencilState.stencilFunc != CompareFunction::Disabled;
+	setCapability(GL_STENCIL_TEST, state::StencilTest, stencilTest);
+	if( stencilTest )
+	{
+		const state::StencilFunc stencilFunc = { translateToGL(stencilState.stencilFunc), stencilState.stencilRef, stencilState.readMask };
+		if( changeState(state::CurrentStencilFunc, stencilFunc) )
+			glStencilFunc(stencilFunc.func, stencilFunc.ref, stencilFunc.mask);
 
+		const state::StencilOps stencilOps = { translateToGL(stencilState.stencilFail), translateToGL(stencilState.depthFail), translateToGL(stencilState.depthPass) };
+		if( changeState(state::CurrentStencilOps, stencilOps) )
+			glStencilOp(stencilOps.fail, stencilOps.depthFail, stencilOps.depthPass);
+	}
+	if( changeState(state::StencilWriteMask, (GLuint)stencilState.writeMask) )
+		glStencilMask(state::StencilWriteMask);
+}
+//-----------------------------------------------------------------------------
+void SetRasterizerState(const RasterizerState& rasterizerState)
+{
+	const bool cullFace = rasterizerState.cullMode != CullMode::None;
+	setCapability(GL_CULL_FACE, state::CullFace, cullFace);
+	if( cullFace && changeState(state::CullFaceMode, translateToGL(rasterizerState.cullMode)) )
+		glCullFace(state::CullFaceMode);
+	if( changeState(state::FrontFace, (GLenum)(rasterizerState.frontFace == FaceOrientation::Clockwise ? GL_CW : GL_CCW)) )
+		glFrontFace(state::FrontFace);
+	setCapability(GL_SCISSOR_TEST, state::ScissorTest, rasterizerState.scissorTest);
+}
+//-----------------------------------------------------------------------------
+void SetViewport(int x, int y, int width, int height)
+{
+	if( changeState(state::Viewport, state::Rect{ x, y, width, height }) )
+		glViewport(x, y, width, height);
+}
+//-----------------------------------------------------------------------------
+void SetScissor(int x, int y, int width, int height)
+{
+	if( changeState(state::Scissor, state::Rect{ x, y, width, height }) )
+		glScissor(x, y, width, height);
+}
+//-----------------------------------------------------------------------------
+// true - значение uniform текущей программы изменилось и его нужно отправить в GL
+inline bool changeUniform(int location, const void* data, uint32_t size)
+{
+	if( location < 0 ) return false;
+
+	std::vector<state::UniformValue>* cache = state::CurrentUniformCache;
+	if( !cache || location >= state::MaxCachedUniformLocations )
+	{
+		state::FrameStatistics.uniformCalls++;
+		return true;
+	}
+	if( (size_t)location >= cache->size() ) cache->resize((size_t)location + 1);
+
+	state::UniformValue& value = (*cache)[(size_t)location];
+	if( value.size == size && memcmp(value.data, data, size) == 0 )
+	{
+		state::FrameStatistics.uniformCallsSkipped++;
+		return false;
+	}
+	value.size = size;
+	memcpy(value.data, data, size);
+	state::FrameStatistics.uniformCalls++;
+	return true;
+}
 //-----------------------------------------------------------------------------
 //=============================================================================
 // Shader Program
@@ -178,37 +480,43 @@ bool Uniform::IsReady() const
 void Uniform::operator=(int value) const
 {
 	assert(IsReady());
-	glUniform1i(m_location, value);
+	if( changeUniform(m_location, &value, sizeof(value)) )
+		glUniform1i(m_location, value);
 }
 //-----------------------------------------------------------------------------
 void Uniform::operator=(float value) const
 {
 	assert(IsReady());
-	glUniform1f(m_location, value);
+	if( changeUniform(m_location, &value, sizeof(value)) )
+		glUniform1f(m_location, value);
 }
 //-----------------------------------------------------------------------------
 void Uniform::operator=(const Vector2& v) const
 {
 	assert(IsReady());
-	glUniform2fv(m_location, 1, &(v.x));
+	if( changeUniform(m_location, &(v.x), sizeof(v)) )
+		glUniform2fv(m_location, 1, &(v.x));
 }
 //-----------------------------------------------------------------------------
 void Uniform::operator=(const Vector3& v) const
 {
 	assert(IsReady());
-	glUniform3fv(m_location, 1, &(v.x));
+	if( changeUniform(m_location, &(v.x), sizeof(v)) )
+		glUniform3fv(m_location, 1, &(v.x));
 }
 //-----------------------------------------------------------------------------
 void Uniform::operator=(const Matrix3& m) const
 {
 	assert(IsReady());
-	glUniformMatrix3fv(m_location, 1, GL_FALSE, m.DataPtr());
+	if( changeUniform(m_location, m.DataPtr(), sizeof(m)) )
+		glUniformMatrix3fv(m_location, 1, GL_FALSE, m.DataPtr());
 }
 //-----------------------------------------------------------------------------
 void Uniform::operator=(const Matrix4& m) const
 {
 	assert(IsReady());
-	glUniformMatrix4fv(m_location, 1, GL_FALSE, m.DataPtr());
+	if( changeUniform(m_location, m.DataPtr(), sizeof(m)) )
+		glUniformMatrix4fv(m_location, 1, GL_FALSE, m.DataPtr());
 }
 //-----------------------------------------------------------------------------
 bool ShaderProgram::CreateFromMemories(const std::string& vertexShaderMemory, const std::string& fragmentShaderMemory)
@@ -243,6 +551,7 @@ bool ShaderProgram::CreateFromMemories(const std::string& vertexShaderMemory, co
 	glDeleteShader(glShaderVertex);
 	glDeleteShader(glShaderFragment);
 
+	if (IsValid()) reflect();
 	return IsValid();
 }
 //-----------------------------------------------------------------------------
@@ -251,9 +560,12 @@ void ShaderProgram::Destroy()
 	if (m_id > 0)
 	{
 		if (state::CurrentShaderProgram == m_id) UnBind();
+		state::UniformCache.erase(m_id);
 		if (!ResourceCacheSystem::IsLoad(*this))
 			glDeleteProgram(m_id);
 		m_id = 0;
+		m_uniforms.clear();
+		m_uniformBlocks.clear();
 	}
 }
 //-----------------------------------------------------------------------------
@@ -261,65 +573,96 @@ void ShaderProgram::Bind() const
 {
 	if (state::CurrentShaderProgram == m_id) return;
 	state::CurrentShaderProgram = m_id;
+	state::CurrentUniformCache = &state::UniformCache[m_id];
 	glUseProgram(m_id);
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::UnBind()
 {
 	state::CurrentShaderProgram = 0;
+	state::CurrentUniformCache = nullptr;
 	glUseProgram(0);
 }
 //-----------------------------------------------------------------------------
 Uniform ShaderProgram::operator[](const char* uniformName) const
 {
-	return Uniform(glGetUniformLocation(m_id, uniformName), m_id);
+	return Uniform(GetUniformLocation(uniformName), m_id);
+}
+//-----------------------------------------------------------------------------
+const ShaderUniformInfo* ShaderProgram::GetUniformInfo(const char* uniformName) const
+{
+	auto it = m_uniforms.find(uniformName);
+	return it != m_uniforms.end() ? &it->second : nullptr;
+}
+//-----------------------------------------------------------------------------
+const ShaderUniformBlockInfo* ShaderProgram::GetUniformBlockInfo(const char* blockName) const
+{
+	auto it = m_uniformBlocks.find(blockName);
+	return it != m_uniformBlocks.end() ? &it->second : nullptr;
+}
+//-----------------------------------------------------------------------------
+bool ShaderProgram::BindUniformBlock(const char* blockName, unsigned bindingPoint) const
+{
+	assert(bindingPoint < MaxBindingUniformBuffers);
+	const ShaderUniformBlockInfo* block = GetUniformBlockInfo(blockName);
+	if (!block) return false;
+	glUniformBlockBinding(m_id, block->index, bindingPoint);
+	return true;
 }
 //-----------------------------------------------------------------------------
 int ShaderProgram::GetUniformLocation(const char* uniformName) const
 {
-	return glGetUniformLocation(m_id, uniformName);
+	const ShaderUniformInfo* uniform = GetUniformInfo(uniformName);
+	return uniform ? uniform->location : -1;
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetSampler(int uniformId, int value) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniform1i(uniformId, value);
+	if( changeUniform(uniformId, &value, sizeof(value)) )
+		glUniform1i(uniformId, value);
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, int value) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniform1i(uniformId, value);
+	if( changeUniform(uniformId, &value, sizeof(value)) )
+		glUniform1i(uniformId, value);
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, float value) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniform1f(uniformId, value);
+	if( changeUniform(uniformId, &value, sizeof(value)) )
+		glUniform1f(uniformId, value);
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, const Vector2& v) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniform2fv(uniformId, 1, &(v.x));
+	if( changeUniform(uniformId, &(v.x), sizeof(v)) )
+		glUniform2fv(uniformId, 1, &(v.x));
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, const Vector3& v) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniform3fv(uniformId, 1, &(v.x));
+	if( changeUniform(uniformId, &(v.x), sizeof(v)) )
+		glUniform3fv(uniformId, 1, &(v.x));
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, const Matrix3& m) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniformMatrix3fv(uniformId, 1, GL_FALSE, m.DataPtr());
+	if( changeUniform(uniformId, m.DataPtr(), sizeof(m)) )
+		glUniformMatrix3fv(uniformId, 1, GL_FALSE, m.DataPtr());
 }
 //-----------------------------------------------------------------------------
 void ShaderProgram::SetUniform(int uniformId, const Matrix4& m) const
 {
 	assert(state::CurrentShaderProgram == m_id);
-	glUniformMatrix4fv(uniformId, 1, GL_FALSE, m.DataPtr());
+	if( changeUniform(uniformId, m.DataPtr(), sizeof(m)) )
+		glUniformMatrix4fv(uniformId, 1, GL_FALSE, m.DataPtr());
 }
 //-----------------------------------------------------------------------------
 std::vector<ShaderAttribInfo> ShaderProgram::GetAttribInfo() const
@@ -355,6 +698,51 @@ std::vector<ShaderAttribInfo> ShaderProgram::GetAttribInfo() const
 	return attribs;
 }
 //-----------------------------------------------------------------------------
+void ShaderProgram::reflect()
+{
+	m_uniforms.clear();
+	m_uniformBlocks.clear();
+
+	int activeUniforms = 0;
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &activeUniforms);
+	int maxLength = 0;
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::vector<char> name(static_cast<size_t>(maxLength) + 1);
+	for (int i = 0; i < activeUniforms; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_id, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+		std::string uniformName(name.data(), (size_t)length);
+		const ShaderUniformInfo uniform = {
+			.typeId = type,
+			.size = size,
+			.location = glGetUniformLocation(m_id, uniformName.c_str())
+		};
+		// массив "name[0]" доступен и как "name"
+		if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+			m_uniforms.emplace(uniformName.substr(0, uniformName.size() - 3), uniform);
+		m_uniforms.emplace(std::move(uniformName), uniform);
+	}
+
+	int activeBlocks = 0;
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &activeBlocks);
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+	name.resize(static_cast<size_t>(maxLength) + 1);
+	for (int i = 0; i < activeBlocks; i++)
+	{
+		GLsizei length = 0;
+		glGetActiveUniformBlockName(m_id, (GLuint)i, (GLsizei)name.size(), &length, name.data());
+		GLint dataSize = 0;
+		glGetActiveUniformBlockiv(m_id, (GLuint)i, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+
+		m_uniformBlocks.emplace(std::string(name.data(), (size_t)length), ShaderUniformBlockInfo{ .index = (unsigned)i, .dataSize = dataSize });
+	}
+}
+//-----------------------------------------------------------------------------
 //=============================================================================
 // Vertex Buffer
 //=============================================================================
@@ -404,6 +792,14 @@ void VertexBuffer::Update(unsigned offset, unsigned vertexCount, unsigned vertex
 	glBindBuffer(GL_ARRAY_BUFFER, state::CurrentVBO); // restore current vb
 }
 //-----------------------------------------------------------------------------
+void VertexBuffer::UpdateRange(unsigned firstVertex, unsigned vertexCount, const void* data)
+{
+	assert(firstVertex + vertexCount <= m_vertexCount);
+	glBindBuffer(GL_ARRAY_BUFFER, m_id);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)firstVertex * m_vertexSize, (GLsizeiptr)vertexCount * m_vertexSize, data);
+	glBindBuffer(GL_ARRAY_BUFFER, state::CurrentVBO); // restore current vb
+}
+//-----------------------------------------------------------------------------
 void VertexBuffer::Bind() const
 {
 	if (state::CurrentVBO == m_id) return;
@@ -458,6 +854,14 @@ void IndexBuffer::Update(unsigned offset, unsigned indexCount, unsigned indexSiz
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, state::CurrentIBO); // restore current ib
 }
 //-----------------------------------------------------------------------------
+void IndexBuffer::UpdateRange(unsigned firstIndex, unsigned indexCount, const void* data)
+{
+	assert(firstIndex + indexCount <= m_indexCount);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)firstIndex * m_indexSize, (GLsizeiptr)indexCount * m_indexSize, data);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, state::CurrentIBO); // restore current ib
+}
+//-----------------------------------------------------------------------------
 void IndexBuffer::Bind() const
 {
 	if (state::CurrentIBO == m_id) return;
@@ -466,6 +870,173 @@ void IndexBuffer::Bind() const
 }
 //-----------------------------------------------------------------------------
 //=============================================================================
+// Uniform Buffer
+//=============================================================================
+//-----------------------------------------------------------------------------
+bool UniformBuffer::Create(RenderResourceUsage usage, unsigned size, const void* data)
+{
+	Destroy();
+
+	m_size = size;
+	m_usage = usage;
+
+	glGenBuffers(1, &m_id);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+	glBufferData(GL_UNIFORM_BUFFER, size, data, translateToGL(m_usage));
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	return true;
+}
+//-----------------------------------------------------------------------------
+void UniformBuffer::Destroy()
+{
+	if (m_id > 0)
+	{
+		for (int i = 0; i < MaxBindingUniformBuffers; i++)
+		{
+			if (state::CurrentUniformBuffer[i] == m_id) state::CurrentUniformBuffer[i] = 0;
+		}
+		glDeleteBuffers(1, &m_id);
+		m_id = 0;
+		m_size = 0;
+	}
+}
+//-----------------------------------------------------------------------------
+void UniformBuffer::Update(unsigned offset, unsigned size, const void* data)
+{
+	assert(offset + size <= m_size);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+void UniformBuffer::Bind(unsigned bindingPoint) const
+{
+	assert(bindingPoint < MaxBindingUniformBuffers);
+	if (changeState(state::CurrentUniformBuffer[bindingPoint], m_id))
+		glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_id);
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
+// Stream Buffer
+//=============================================================================
+//-----------------------------------------------------------------------------
+constexpr GLuint64 StreamBufferWaitTimeout = 100000000; // 100 мс в наносекундах
+//-----------------------------------------------------------------------------
+bool StreamBuffer::Create(unsigned frameSize, unsigned framesInFlight)
+{
+	Destroy();
+
+	if (frameSize == 0 || framesInFlight == 0 || framesInFlight > MaxFramesInFlight)
+	{
+		LogError("StreamBuffer: invalid size!");
+		return false;
+	}
+
+	m_frameSize = frameSize;
+	m_framesInFlight = framesInFlight;
+	m_frame = 0;
+	m_offset = 0;
+	m_frameIndex = render::FrameIndex;
+	return m_buffer.Create(RenderResourceUsage::Stream, frameSize * framesInFlight, 1, nullptr);
+}
+//-----------------------------------------------------------------------------
+void StreamBuffer::Destroy()
+{
+	if (m_mapped) Unmap();
+	for (unsigned i = 0; i < MaxFramesInFlight; i++)
+	{
+		if (m_fences[i]) glDeleteSync(m_fences[i]);
+		m_fences[i] = nullptr;
+	}
+	m_buffer.Destroy();
+	m_frameSize = m_framesInFlight = 0;
+}
+//-----------------------------------------------------------------------------
+void* StreamBuffer::Map(unsigned size, unsigned alignment, unsigned& offset)
+{
+	assert(IsValid() && !m_mapped && alignment > 0);
+	if (size > m_frameSize)
+	{
+		LogError("StreamBuffer: data size exceeds frame size!");
+		return nullptr;
+	}
+	if (m_frameIndex != render::FrameIndex) beginFrame();
+
+	const unsigned frameBegin = m_frame * m_frameSize;
+	unsigned alignedOffset = (frameBegin + m_offset + alignment - 1) / alignment * alignment;
+	if (alignedOffset + size > frameBegin + m_frameSize)
+	{
+		// в части кадра нет места - уже отправленные команды продолжат читать старую память
+		orphan();
+		alignedOffset = (frameBegin + alignment - 1) / alignment * alignment;
+		if (alignedOffset + size > frameBegin + m_frameSize)
+		{
+			LogError("StreamBuffer: data size exceeds frame size!");
+			return nullptr;
+		}
+	}
+	m_offset = alignedOffset + size - frameBegin;
+	offset = alignedOffset;
+
+	m_buffer.Bind();
+	void* data = glMapBufferRange(GL_ARRAY_BUFFER, alignedOffset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (!data)
+	{
+		LogError("StreamBuffer: map failed!");
+		return nullptr;
+	}
+	m_mapped = true;
+	return data;
+}
+//-----------------------------------------------------------------------------
+void StreamBuffer::Unmap()
+{
+	assert(m_mapped);
+	m_buffer.Bind();
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	m_mapped = false;
+}
+//-----------------------------------------------------------------------------
+void StreamBuffer::beginFrame()
+{
+	// fence прошлой части ставится при первой записи нового кадра - все команды, читающие ее, уже отправлены
+	if (m_fences[m_frame]) glDeleteSync(m_fences[m_frame]);
+	m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_frame = (m_frame + 1) % m_framesInFlight;
+	m_offset = 0;
+	m_frameIndex = render::FrameIndex;
+
+	GLsync fence = m_fences[m_frame];
+	if (!fence) return;
+	m_fences[m_frame] = nullptr;
+
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		state::FrameStatistics.streamBufferWaits++;
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, StreamBufferWaitTimeout);
+	}
+	glDeleteSync(fence);
+	if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+		orphan();
+}
+//-----------------------------------------------------------------------------
+void StreamBuffer::orphan()
+{
+	state::FrameStatistics.streamBufferOrphans++;
+	m_buffer.Bind();
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_frameSize * m_framesInFlight, nullptr, GL_STREAM_DRAW);
+	for (unsigned i = 0; i < MaxFramesInFlight; i++)
+	{
+		if (m_fences[i]) glDeleteSync(m_fences[i]);
+		m_fences[i] = nullptr;
+	}
+	m_offset = 0;
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
 // Vertex Array Buffer
 //=============================================================================
 //-----------------------------------------------------------------------------
@@ -473,7 +1044,8 @@ void VertexAttribute::Bind(unsigned loc) const
 {
 	const GLuint oglLocation = static_cast<GLuint>(location > -1 ? location : loc);
 	glEnableVertexAttribArray(oglLocation);
-	glVertexAttribPointer(oglLocation, size, GL_FLOAT, (GLboolean)(normalized ? GL_TRUE : GL_FALSE), stride, offset);
+	glVertexAttribPointer(oglLocation, size, translateToGL(type), (GLboolean)(normalized ? GL_TRUE : GL_FALSE), stride, offset);
+	if (divisor > 0) glVertexAttribDivisor(oglLocation, divisor);
 }
 //-----------------------------------------------------------------------------
 bool VertexArrayBuffer::Create(VertexBuffer* vbo, IndexBuffer* ibo, const std::vector<VertexAttribute>& attribs)
@@ -489,8 +1061,7 @@ bool VertexArrayBuffer::Create(VertexBuffer* vbo, IndexBuffer* ibo, const std::v
 	glBindVertexArray(m_id);
 
 	vbo->Bind();
-	for (size_t i = 0; i < attribs.size(); i++)
-		attribs[i].Bind(i);
+	bindAttribs(attribs, 0);
 
 	m_attribsCount = (unsigned)attribs.size();
 
@@ -551,6 +1122,22 @@ bool VertexArrayBuffer::Create(VertexBuffer* vbo, IndexBuffer* ibo, ShaderProgra
 	return Create(vbo, ibo, attribs);
 }
 //-----------------------------------------------------------------------------
+bool VertexArrayBuffer::Create(VertexBuffer* vbo, IndexBuffer* ibo, const std::vector<VertexAttribute>& attribs, VertexBuffer* instanceVbo, const std::vector<VertexAttribute>& instanceAttribs)
+{
+	if (!instanceVbo || instanceAttribs.empty()) return false;
+	if (!Create(vbo, ibo, attribs)) return false;
+
+	glBindVertexArray(m_id);
+	instanceVbo->Bind();
+	for (size_t i = 0; i < instanceAttribs.size(); i++)
+		assert(instanceAttribs[i].location > -1 && instanceAttribs[i].divisor > 0);
+	bindAttribs(instanceAttribs, m_attribsCount);
+	m_attribsCount += (unsigned)instanceAttribs.size();
+
+	glBindVertexArray(state::CurrentVAO); // restore VAO
+	return true;
+}
+//-----------------------------------------------------------------------------
 void VertexArrayBuffer::Destroy()
 {
 	if (m_id > 0)
@@ -561,6 +1148,7 @@ void VertexArrayBuffer::Destroy()
 		glDeleteVertexArrays(1, &m_id);
 		m_id = 0;
 	}
+	m_constantAttribs.clear();
 }
 //-----------------------------------------------------------------------------
 void VertexArrayBuffer::UnBind()
@@ -575,13 +1163,7 @@ void VertexArrayBuffer::UnBind()
 //-----------------------------------------------------------------------------
 void VertexArrayBuffer::Draw(PrimitiveDraw primitive)
 {
-	if (state::CurrentVAO != m_id)
-	{
-		state::CurrentVAO = m_id;
-		glBindVertexArray(m_id);
-		m_vbo->Bind();
-		if (m_ibo) m_ibo->Bind();
-	}
+	bind();
 
 	if (m_ibo)
 	{
@@ -595,6 +1177,38 @@ void VertexArrayBuffer::Draw(PrimitiveDraw primitive)
 	}
 }
 //-----------------------------------------------------------------------------
+void VertexArrayBuffer::Draw(PrimitiveDraw primitive, unsigned first, unsigned count)
+{
+	if (count == 0) return;
+	bind();
+
+	if (m_ibo)
+	{
+		const GLenum indexSizeType = (GLenum)(m_ibo->GetIndexSize() == sizeof(uint32_t) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT);
+		glDrawElements(translateToGL(primitive), (GLsizei)count, indexSizeType, (const void*)((size_t)first * m_ibo->GetIndexSize()));
+	}
+	else
+	{
+		glDrawArrays(translateToGL(primitive), (GLint)first, (GLsizei)count);
+	}
+}
+//-----------------------------------------------------------------------------
+void VertexArrayBuffer::DrawInstanced(unsigned instanceCount, PrimitiveDraw primitive)
+{
+	if (instanceCount == 0) return;
+	bind();
+
+	if (m_ibo)
+	{
+		const GLenum indexSizeType = (GLenum)(m_ibo->GetIndexSize() == sizeof(uint32_t) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT);
+		glDrawElementsInstanced(translateToGL(primitive), (GLsizei)m_ibo->GetIndexCount(), indexSizeType, nullptr, (GLsizei)instanceCount);
+	}
+	else
+	{
+		glDrawArraysInstanced(translateToGL(primitive), 0, (GLsizei)m_vbo->GetVertexCount(), (GLsizei)instanceCount);
+	}
+}
+//-----------------------------------------------------------------------------
 void VertexArrayBuffer::DrawNoCache(PrimitiveDraw primitive)
 {
 	state::CurrentVAO = 0;
@@ -606,6 +1220,210 @@ void VertexArrayBuffer::DrawNoCache(PrimitiveDraw primitive)
 	state::CurrentIBO = 0;
 }
 //-----------------------------------------------------------------------------
+void VertexArrayBuffer::DrawBaseVertex(PrimitiveDraw primitive, unsigned firstIndex, unsigned indexCount, int baseVertex)
+{
+	assert(m_ibo);
+	if (indexCount == 0) return;
+	bind();
+
+	const GLenum indexSizeType = (GLenum)(m_ibo->GetIndexSize() == sizeof(uint32_t) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT);
+	glDrawElementsBaseVertex(translateToGL(primitive), (GLsizei)indexCount, indexSizeType, (const void*)((size_t)firstIndex * m_ibo->GetIndexSize()), (GLint)baseVertex);
+}
+//-----------------------------------------------------------------------------
+void VertexArrayBuffer::DrawInstancedBaseVertex(unsigned instanceCount, PrimitiveDraw primitive, unsigned firstIndex, unsigned indexCount, int baseVertex)
+{
+	assert(m_ibo);
+	if (instanceCount == 0 || indexCount == 0) return;
+	bind();
+
+	const GLenum indexSizeType = (GLenum)(m_ibo->GetIndexSize() == sizeof(uint32_t) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT);
+	glDrawElementsInstancedBaseVertex(translateToGL(primitive), (GLsizei)indexCount, indexSizeType, (const void*)((size_t)firstIndex * m_ibo->GetIndexSize()), (GLsizei)instanceCount, (GLint)baseVertex);
+}
+//-----------------------------------------------------------------------------
+void VertexArrayBuffer::MultiDrawBaseVertex(PrimitiveDraw primitive, const int* indexCounts, const void* const* indexOffsets, const int* baseVertices, unsigned drawCount)
+{
+	assert(m_ibo);
+	if (drawCount == 0) return;
+	bind();
+
+	const GLenum indexSizeType = (GLenum)(m_ibo->GetIndexSize() == sizeof(uint32_t) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT);
+	glMultiDrawElementsBaseVertex(translateToGL(primitive), (const GLsizei*)indexCounts, indexSizeType, indexOffsets, (GLsizei)drawCount, (const GLint*)baseVertices);
+}
+//-----------------------------------------------------------------------------
+void VertexArrayBuffer::bind()
+{
+	if (state::CurrentVAO != m_id)
+	{
+		state::CurrentVAO = m_id;
+		glBindVertexArray(m_id);
+		m_vbo->Bind();
+		if (m_ibo) m_ibo->Bind();
+		for (const ConstantAttribute& attrib : m_constantAttribs)
+			glVertexAttrib4f(attrib.location, attrib.value[0], attrib.value[1], attrib.value[2], attrib.value[3]);
+	}
+}
+//-----------------------------------------------------------------------------
+void VertexArrayBuffer::bindAttribs(const std::vector<VertexAttribute>& attribs, unsigned firstIndex)
+{
+	for (size_t i = 0; i < attribs.size(); i++)
+	{
+		const unsigned index = firstIndex + (unsigned)i;
+		if (attribs[i].constantValue)
+		{
+			const Vector4& value = *attribs[i].constantValue;
+			m_constantAttribs.push_back({ attribs[i].location > -1 ? (unsigned)attribs[i].location : index, { value.x, value.y, value.z, value.w } });
+		}
+		else
+			attribs[i].Bind(index);
+	}
+}
+//-----------------------------------------------------------------------------
+//=============================================================================
+// Geometry Arena
+//=============================================================================
+//-----------------------------------------------------------------------------
+bool GeometryArena::Create(const std::vector<VertexAttribute>& attribs, unsigned vertexSize, unsigned vertexCapacity, unsigned indexCapacity, unsigned indexSize)
+{
+	Destroy();
+	if (vertexCapacity == 0 || indexCapacity == 0 || (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t)))
+	{
+		LogError("GeometryArena: invalid capacity!");
+		return false;
+	}
+
+	if (!m_vertexBuffer.Create(RenderResourceUsage::Static, vertexCapacity, vertexSize, nullptr) ||
+		!m_indexBuffer.Create(RenderResourceUsage::Static, indexCapacity, indexSize, nullptr) ||
+		!m_vao.Create(&m_vertexBuffer, &m_indexBuffer, attribs))
+	{
+		LogError("GeometryArena create failed!");
+		Destroy();
+		return false;
+	}
+
+	m_freeVertices.Reset(vertexCapacity);
+	m_freeIndices.Reset(indexCapacity);
+	return true;
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::Destroy()
+{
+	m_vao.Destroy();
+	m_vertexBuffer.Destroy();
+	m_indexBuffer.Destroy();
+	m_freeVertices.Reset(0);
+	m_freeIndices.Reset(0);
+}
+//-----------------------------------------------------------------------------
+bool GeometryArena::Allocate(const void* vertices, unsigned vertexCount, const uint32_t* indices, unsigned indexCount, GeometryRange& outRange)
+{
+	if (!IsValid() || vertexCount == 0 || indexCount == 0) return false;
+	if (m_indexBuffer.GetIndexSize() == sizeof(uint16_t) && vertexCount > 65536) return false;
+
+	unsigned firstVertex = 0;
+	unsigned firstIndex = 0;
+	if (!m_freeVertices.Allocate(vertexCount, firstVertex)) return false;
+	if (!m_freeIndices.Allocate(indexCount, firstIndex))
+	{
+		m_freeVertices.Free(firstVertex, vertexCount);
+		return false;
+	}
+
+	m_vertexBuffer.UpdateRange(firstVertex, vertexCount, vertices);
+	if (m_indexBuffer.GetIndexSize() == sizeof(uint16_t))
+	{
+		m_shortIndices.resize(indexCount);
+		for (unsigned i = 0; i < indexCount; i++)
+			m_shortIndices[i] = (uint16_t)indices[i];
+		m_indexBuffer.UpdateRange(firstIndex, indexCount, m_shortIndices.data());
+	}
+	else
+		m_indexBuffer.UpdateRange(firstIndex, indexCount, indices);
+	outRange = { firstVertex, vertexCount, firstIndex, indexCount };
+	return true;
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::Free(GeometryRange& range)
+{
+	if (range.vertexCount > 0) m_freeVertices.Free(range.firstVertex, range.vertexCount);
+	if (range.indexCount > 0) m_freeIndices.Free(range.firstIndex, range.indexCount);
+	range = {};
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::Draw(const GeometryRange& range, PrimitiveDraw primitive)
+{
+	m_vao.DrawBaseVertex(primitive, range.firstIndex, range.indexCount, (int)range.firstVertex);
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::MultiDraw(const GeometryRange* ranges, size_t count, PrimitiveDraw primitive)
+{
+	m_drawIndexCounts.clear();
+	m_drawIndexOffsets.clear();
+	m_drawBaseVertices.clear();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (ranges[i].indexCount == 0) continue;
+		m_drawIndexCounts.push_back((int)ranges[i].indexCount);
+		m_drawIndexOffsets.push_back((const void*)((size_t)ranges[i].firstIndex * m_indexBuffer.GetIndexSize()));
+		m_drawBaseVertices.push_back((int)ranges[i].firstVertex);
+	}
+	m_vao.MultiDrawBaseVertex(primitive, m_drawIndexCounts.data(), m_drawIndexOffsets.data(), m_drawBaseVertices.data(), (unsigned)m_drawIndexCounts.size());
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::FreeList::Reset(unsigned capacity)
+{
+	m_blocks.clear();
+	if (capacity > 0) m_blocks.push_back({ 0, capacity });
+}
+//-----------------------------------------------------------------------------
+bool GeometryArena::FreeList::Allocate(unsigned count, unsigned& outOffset)
+{
+	for (size_t i = 0; i < m_blocks.size(); i++)
+	{
+		Block& block = m_blocks[i];
+		if (block.count < count) continue;
+
+		outOffset = block.offset;
+		block.offset += count;
+		block.count -= count;
+		if (block.count == 0)
+			m_blocks.erase(m_blocks.begin() + (ptrdiff_t)i);
+		return true;
+	}
+	return false;
+}
+//-----------------------------------------------------------------------------
+void GeometryArena::FreeList::Free(unsigned offset, unsigned count)
+{
+	auto next = std::lower_bound(m_blocks.begin(), m_blocks.end(), offset, [](const Block& block, unsigned value) { return block.offset < value; });
+	assert(next == m_blocks.end() || offset + count <= next->offset);
+
+	// слияние с соседними свободными блоками
+	const bool mergePrev = next != m_blocks.begin() && (next - 1)->offset + (next - 1)->count == offset;
+	const bool mergeNext = next != m_blocks.end() && offset + count == next->offset;
+	if (mergePrev && mergeNext)
+	{
+		(next - 1)->count += count + next->count;
+		m_blocks.erase(next);
+	}
+	else if (mergePrev)
+		(next - 1)->count += count;
+	else if (mergeNext)
+	{
+		next->offset = offset;
+		next->count += count;
+	}
+	else
+		m_blocks.insert(next, { offset, count });
+}
+//-----------------------------------------------------------------------------
+unsigned GeometryArena::FreeList::GetFreeCount() const
+{
+	unsigned count = 0;
+	for (const Block& block : m_blocks)
+		count += block.count;
+	return count;
+}
+//-----------------------------------------------------------------------------
 //=============================================================================
 // Texture 2D
 //=============================================================================
@@ -986,7 +1804,7 @@ void FrameBuffer::Bind(const Vector3& color)
 	if( state::CurrentFrameBuffer != this )
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, m_id);
-		glViewport(0, 0, m_width, m_height);
+		SetViewport(0, 0, m_width, m_height);
 		state::CurrentFrameBuffer = this;
 	}
 	glClearColor(color.x, color.y, color.z, 1.0f);
@@ -996,7 +1814,7 @@ void FrameBuffer::Bind(const Vector3& color)
 void FrameBuffer::MainFrameBufferBind()
 {
 	if( state::CurrentFrameBuffer ) glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	//glViewport(0, 0, GetRenderWidth(), GetRenderHeight()); // TODO:
+	SetViewport(0, 0, render::FramebufferWidth, render::FramebufferHeight);
 	//glClearColor(RendererState::ClearColor.x, RendererState::ClearColor.y, RendererState::ClearColor.z, 1.0f); // TODO:
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	state::CurrentFrameBuffer = nullptr;
@@ -1099,7 +1917,7 @@ void RenderSystemInit()
 {
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glEnable(GL_DEPTH_TEST);
+	SetDepthState({});
 	glClearDepth(1.0f);
 	glDepthRange(0.0f, 1.0f);
 	glClearColor(0.2f, 0.4f, 0.9f, 1.0f);
@@ -1113,10 +1931,19 @@ void RenderSystemBeginFrame(int WindowClientWidth, int WindowClientHeight)
 		render::FramebufferWidth = WindowClientWidth;
 		render::FramebufferHeight = WindowClientHeight;
 
-		glViewport(0, 0, render::FramebufferWidth, render::FramebufferHeight);
-		glScissor(0, 0, render::FramebufferWidth, render::FramebufferHeight);
+		SetViewport(0, 0, render::FramebufferWidth, render::FramebufferHeight);
+		SetScissor(0, 0, render::FramebufferWidth, render::FramebufferHeight);
 	}
 
+	state::LastFrameStatistics = state::FrameStatistics;
+	state::FrameStatistics = {};
+	render::FrameIndex++;
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
+//-----------------------------------------------------------------------------
+const RenderFrameStatistics& GetRenderFrameStatistics()
+{
+	return state::LastFrameStatistics;
+}
 //-----------------------------------------------------------------------------
\ No newline at end of file
@@ -9,6 +9,8 @@
 #endif // _MSC_VER
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #if defined(_MSC_VER)
@@ -19,6 +21,7 @@
 
 class Vector2;
 class Vector3;
+class Vector4;
 class Matrix3;
 class Matrix4;
 
@@ -26,6 +29,7 @@ class Matrix4;
 // Render Config
 //=============================================================================
 constexpr int MaxBindingTextures = 16;
+constexpr int MaxBindingUniformBuffers = 16;
 
 //=============================================================================
 // Core
@@ -38,6 +42,15 @@ enum class RenderResourceUsage
 	Stream,
 };
 
+// хеш для unordered_map<std::string, ...> с поиском по const char*/string_view без создания std::string
+struct StringViewHash
+{
+	using is_transparent = void;
+	size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+};
+template<typename T>
+using StringViewMap = std::unordered_map<std::string, T, StringViewHash, std::equal_to<>>;
+
 //=============================================================================
 // Render States
 //=============================================================================
@@ -118,11 +131,18 @@ enum class CompareFunction
 
 enum class CullMode
 {
+	None,
 	Full,
 	Front,
 	Back,
 };
 
+enum class FaceOrientation
+{
+	CounterClockwise,
+	Clockwise,
+};
+
 struct BlendState
 {
 	BlendMode       srcBlend = BlendMode::One;
@@ -136,7 +156,38 @@ struct BlendState
 	bool            alphaToMask = false;
 };
 
-void SetBlendState(const BlendState& state, float alphaRef);
+struct DepthState
+{
+	CompareFunction depthFunc = CompareFunction::Less; // Disabled - тест глубины выключен
+	bool            depthWrite = true;
+};
+
+struct StencilState
+{
+	CompareFunction stencilFunc = CompareFunction::Disabled; // Disabled - тест трафарета выключен
+	int             stencilRef = 0;
+	uint8_t         readMask = 0xFF;
+	uint8_t         writeMask = 0xFF;
+	StencilOp       stencilFail = StencilOp::Keep;
+	StencilOp       depthFail = StencilOp::Keep;
+	StencilOp       depthPass = StencilOp::Keep;
+};
+
+struct RasterizerState
+{
+	CullMode        cullMode = CullMode::None;
+	FaceOrientation frontFace = FaceOrientation::CounterClockwise;
+	bool            scissorTest = false;
+};
+
+// Состояние GL хранится в теневой копии, вызовы GL, не меняющие состояние, отбрасываются.
+// alphaTest/alphaRef в core profile нет - делается в шейдере через discard.
+void SetBlendState(const BlendState& blendState, float alphaRef = 0.0f);
+void SetDepthState(const DepthState& depthState);
+void SetStencilState(const StencilState& stencilState);
+void SetRasterizerState(const RasterizerState& rasterizerState);
+void SetViewport(int x, int y, int width, int height);
+void SetScissor(int x, int y, int width, int height);
 
 //=============================================================================
 // Shader Program
@@ -171,6 +222,19 @@ struct ShaderAttribInfo
 	int location;
 };
 
+struct ShaderUniformInfo
+{
+	unsigned typeId;
+	int size;     // число элементов массива
+	int location; // -1 у uniform внутри блока
+};
+
+struct ShaderUniformBlockInfo
+{
+	unsigned index;
+	int dataSize;
+};
+
 class ShaderProgram
 {
 public:
@@ -180,7 +244,11 @@ public:
 	void Bind() const;
 	static void UnBind();
 
+	// uniform и uniform-блоки читаются из программы один раз после линковки, поиск идет по кешу без обращения к GL
 	[[nodiscard]] Uniform operator[](const char* uniformName) const;
+	[[nodiscard]] const ShaderUniformInfo* GetUniformInfo(const char* uniformName) const;
+	[[nodiscard]] const ShaderUniformBlockInfo* GetUniformBlockInfo(const char* blockName) const;
+	bool BindUniformBlock(const char* blockName, unsigned bindingPoint) const; // false - блока нет в программе
 
 	// TODO: удалить
 	[[nodiscard]] int GetUniformLocation(const char* uniformName) const;
@@ -197,7 +265,11 @@ public:
 	[[nodiscard]] std::vector<ShaderAttribInfo> GetAttribInfo() const;
 
 private:
+	void reflect();
+
 	unsigned m_id = 0;
+	StringViewMap<ShaderUniformInfo> m_uniforms;
+	StringViewMap<ShaderUniformBlockInfo> m_uniformBlocks;
 };
 
 //=============================================================================
@@ -211,10 +283,13 @@ public:
 	void Destroy();
 
 	void Update(unsigned offset, unsigned vertexCount, unsigned vertexSize, const void* data);
+	// запись вершин [firstVertex, firstVertex + vertexCount) без переразмещения буфера
+	void UpdateRange(unsigned firstVertex, unsigned vertexCount, const void* data);
 
 	void Bind() const;
 
 	[[nodiscard]] unsigned GetVertexCount() const { return m_vertexCount; }
+	[[nodiscard]] unsigned GetVertexSize() const { return m_vertexSize; }
 
 	[[nodiscard]] bool IsValid() const { return m_id > 0; }
 
@@ -238,6 +313,8 @@ public:
 	void Bind() const;
 
 	void Update(unsigned offset, unsigned indexCount, unsigned indexSize, const void* data);
+	// запись индексов [firstIndex, firstIndex + indexCount) без переразмещения буфера
+	void UpdateRange(unsigned firstIndex, unsigned indexCount, const void* data);
 
 	[[nodiscard]] unsigned GetIndexCount() const { return m_indexCount; }
 	[[nodiscard]] unsigned GetIndexSize() const { return m_indexSize; }
@@ -251,6 +328,71 @@ private:
 	unsigned m_indexSize = 0;
 };
 
+//=============================================================================
+// Uniform Buffer
+//=============================================================================
+
+// Данные блока должны повторять раскладку std140 (vec3 выравнивается как vec4, mat4 - 4 столбца vec4)
+class UniformBuffer
+{
+public:
+	[[nodiscard]] bool Create(RenderResourceUsage usage, unsigned size, const void* data = nullptr);
+	void Destroy();
+
+	void Update(unsigned offset, unsigned size, const void* data);
+
+	void Bind(unsigned bindingPoint) const;
+
+	[[nodiscard]] unsigned GetSize() const { return m_size; }
+
+	[[nodiscard]] bool IsValid() const { return m_id > 0; }
+
+private:
+	RenderResourceUsage m_usage = RenderResourceUsage::Static;
+	unsigned m_id = 0;
+	unsigned m_size = 0;
+};
+
+//=============================================================================
+// Stream Buffer
+//=============================================================================
+
+// Кольцевой буфер вершин для данных, которые пишутся каждый кадр (debug draw, спрайты, частицы).
+// Буфер разбит на framesInFlight частей, кадр пишет только в свою часть (glMapBufferRange без синхронизации).
+// Перед повторным использованием части ждется fence кадра, который ее заполнял.
+// Если fence не дождались или кадру не хватило места - буфер переразмещается (orphaning через glBufferData(nullptr)).
+class StreamBuffer
+{
+public:
+	static constexpr unsigned MaxFramesInFlight = 4;
+
+	[[nodiscard]] bool Create(unsigned frameSize, unsigned framesInFlight = 3);
+	void Destroy();
+
+	// место под size байт в части текущего кадра. offset - смещение от начала буфера, кратное alignment
+	// (для вершин alignment = stride, тогда первая вершина для Draw - offset / stride)
+	[[nodiscard]] void* Map(unsigned size, unsigned alignment, unsigned& offset);
+	void Unmap();
+
+	[[nodiscard]] VertexBuffer* GetVertexBuffer() { return &m_buffer; } // для VertexArrayBuffer::Create
+	[[nodiscard]] unsigned GetFrameSize() const { return m_frameSize; }
+
+	[[nodiscard]] bool IsValid() const { return m_buffer.IsValid(); }
+
+private:
+	void beginFrame();
+	void orphan();
+
+	VertexBuffer m_buffer;
+	GLsync m_fences[MaxFramesInFlight] = { nullptr };
+	unsigned m_frameSize = 0;
+	unsigned m_framesInFlight = 0;
+	unsigned m_frame = 0;
+	unsigned m_offset = 0; // от начала части кадра
+	uint64_t m_frameIndex = 0;
+	bool m_mapped = false;
+};
+
 //=============================================================================
 // Vertex Array Buffer
 //=============================================================================
@@ -262,16 +404,32 @@ enum class PrimitiveDraw
 	Points,
 };
 
+// Тип компонент атрибута. Целые с normalized = true приводятся к [0, 1] (беззнаковые) или [-1, 1] (знаковые):
+// Short - snorm16, UnsignedByte - unorm8, Int2_10_10_10 - snorm10 x3 + 2 бита w
+enum class VertexAttributeType : uint8_t
+{
+	Float,
+	HalfFloat,
+	Byte,
+	UnsignedByte,
+	Short,
+	UnsignedShort,
+	Int2_10_10_10,         // GL_INT_2_10_10_10_REV, size = 4
+	UnsignedInt2_10_10_10, // GL_UNSIGNED_INT_2_10_10_10_REV, size = 4
+};
+
 struct VertexAttribute
 {
 	void Bind(unsigned loc) const;
 
 	int location = -1;  // если -1, то берется индекс массива атрибутов
 	int size;
-	//unsigned type;
+	VertexAttributeType type = VertexAttributeType::Float;
 	bool normalized;
 	int stride;         // sizeof Vertex
 	const void* offset; // (void*)offsetof(Vertex, TexCoord)}
+	unsigned divisor = 0; // 0 - повершинный атрибут, 1 - поинстансный (glVertexAttribDivisor)
+	const Vector4* constantValue = nullptr; // атрибут без данных в буфере: значение задается при привязке VAO (glVertexAttrib4f)
 };
 
 class VertexArrayBuffer
@@ -279,22 +437,113 @@ class VertexArrayBuffer
 public:
 	[[nodiscard]] bool Create(VertexBuffer* vbo, IndexBuffer* ibo, const std::vector<VertexAttribute>& attribs);
 	[[nodiscard]] bool Create(VertexBuffer* vbo, IndexBuffer* ibo, ShaderProgram* shaders);
+	// VAO с дополнительным поинстансным буфером (у атрибутов instanceAttribs должны быть заданы location и divisor)
+	[[nodiscard]] bool Create(VertexBuffer* vbo, IndexBuffer* ibo, const std::vector<VertexAttribute>& attribs, VertexBuffer* instanceVbo, const std::vector<VertexAttribute>& instanceAttribs);
 	void Destroy();
 
 	static void UnBind();
 
 	void Draw(PrimitiveDraw primitive = PrimitiveDraw::Triangles);
+	void Draw(PrimitiveDraw primitive, unsigned first, unsigned count); // диапазон вершин (без ibo) или индексов
+	void DrawInstanced(unsigned instanceCount, PrimitiveDraw primitive = PrimitiveDraw::Triangles);
 	void DrawNoCache(PrimitiveDraw primitive = PrimitiveDraw::Triangles);
+	// диапазон индексов, к каждому индексу прибавляется baseVertex (glDrawElementsBaseVertex), нужен ibo
+	void DrawBaseVertex(PrimitiveDraw primitive, unsigned firstIndex, unsigned indexCount, int baseVertex);
+	void DrawInstancedBaseVertex(unsigned instanceCount, PrimitiveDraw primitive, unsigned firstIndex, unsigned indexCount, int baseVertex);
+	// drawCount диапазонов одним вызовом (glMultiDrawElementsBaseVertex), indexOffsets - смещения в байтах от начала ibo
+	void MultiDrawBaseVertex(PrimitiveDraw primitive, const int* indexCounts, const void* const* indexOffsets, const int* baseVertices, unsigned drawCount);
 
 	[[nodiscard]] bool IsValid() const { return m_id > 0; }
 
 	[[nodiscard]] VertexBuffer* GetVertexBuffer() { return m_vbo; }
 	[[nodiscard]] IndexBuffer* GetIndexBuffer() { return m_ibo; }
 private:
+	struct ConstantAttribute
+	{
+		unsigned location;
+		float value[4];
+	};
+
+	void bind();
+	void bindAttribs(const std::vector<VertexAttribute>& attribs, unsigned firstIndex);
+
 	unsigned m_id = 0;
 	VertexBuffer* m_vbo = nullptr;
 	IndexBuffer* m_ibo = nullptr;
 	unsigned m_attribsCount = 0;
+	std::vector<ConstantAttribute> m_constantAttribs; // текущее значение атрибута - состояние контекста, а не VAO
+};
+
+//=============================================================================
+// Geometry Arena
+//=============================================================================
+
+// Место сабмеша в GeometryArena. Индексы хранятся локальными (от 0), при отрисовке к ним прибавляется firstVertex
+struct GeometryRange
+{
+	unsigned firstVertex = 0;
+	unsigned vertexCount = 0;
+	unsigned firstIndex = 0;
+	unsigned indexCount = 0;
+};
+
+// Общие VBO/IBO для статических мешей одного формата вершин и один VAO на них. Индексы uint32 или uint16 (indexSize в Create),
+// с 16-битными индексами Allocate принимает только меши до 65536 вершин (индексы локальные, поэтому емкость arena не ограничена).
+// Диапазоны выделяются first-fit из списков свободных блоков, освобожденные соседние блоки сливаются.
+// Емкость задается в Create: если места нет, Allocate возвращает false и меш создает собственные буферы
+class GeometryArena
+{
+public:
+	[[nodiscard]] bool Create(const std::vector<VertexAttribute>& attribs, unsigned vertexSize, unsigned vertexCapacity, unsigned indexCapacity, unsigned indexSize = sizeof(uint32_t));
+	void Destroy();
+
+	// индексы всегда uint32, в 16-битный буфер они сужаются при загрузке
+	[[nodiscard]] bool Allocate(const void* vertices, unsigned vertexCount, const uint32_t* indices, unsigned indexCount, GeometryRange& outRange);
+	void Free(GeometryRange& range);
+
+	void Draw(const GeometryRange& range, PrimitiveDraw primitive = PrimitiveDraw::Triangles);
+	// несколько диапазонов одним glMultiDrawElementsBaseVertex (без смены VAO между ними)
+	void MultiDraw(const GeometryRange* ranges, size_t count, PrimitiveDraw primitive = PrimitiveDraw::Triangles);
+
+	[[nodiscard]] VertexArrayBuffer* GetVAO() { return &m_vao; }
+	[[nodiscard]] VertexBuffer* GetVertexBuffer() { return &m_vertexBuffer; } // для VAO с поинстансными атрибутами
+	[[nodiscard]] IndexBuffer* GetIndexBuffer() { return &m_indexBuffer; }
+	[[nodiscard]] unsigned GetVertexSize() const { return m_vertexBuffer.GetVertexSize(); }
+	[[nodiscard]] unsigned GetIndexSize() const { return m_indexBuffer.GetIndexSize(); }
+	[[nodiscard]] unsigned GetFreeVertexCount() const { return m_freeVertices.GetFreeCount(); }
+	[[nodiscard]] unsigned GetFreeIndexCount() const { return m_freeIndices.GetFreeCount(); }
+
+	[[nodiscard]] bool IsValid() const { return m_vao.IsValid(); }
+
+private:
+	// свободные блоки по возрастанию offset
+	class FreeList
+	{
+	public:
+		void Reset(unsigned capacity);
+		[[nodiscard]] bool Allocate(unsigned count, unsigned& outOffset);
+		void Free(unsigned offset, unsigned count);
+		[[nodiscard]] unsigned GetFreeCount() const;
+
+	private:
+		struct Block
+		{
+			unsigned offset;
+			unsigned count;
+		};
+		std::vector<Block> m_blocks;
+	};
+
+	VertexBuffer m_vertexBuffer;
+	IndexBuffer m_indexBuffer;
+	VertexArrayBuffer m_vao;
+	FreeList m_freeVertices;
+	FreeList m_freeIndices;
+	// буферы параметров MultiDraw, переиспользуются между вызовами
+	std::vector<int> m_drawIndexCounts;
+	std::vector<const void*> m_drawIndexOffsets;
+	std::vector<int> m_drawBaseVertices;
+	std::vector<uint16_t> m_shortIndices; // для Allocate в 16-битный буфер
 };
 
 //=============================================================================
@@ -472,5 +721,18 @@ private:
 // Render System
 //=============================================================================
 
+// Счетчики вызовов GL за кадр: ушедшие в драйвер и отброшенные кешем состояний
+struct RenderFrameStatistics
+{
+	unsigned stateCalls = 0;
+	unsigned stateCallsSkipped = 0;
+	unsigned uniformCalls = 0;
+	unsigned uniformCallsSkipped = 0;
+	unsigned streamBufferWaits = 0;    // StreamBuffer ждал GPU на fence
+	unsigned streamBufferOrphans = 0;  // StreamBuffer переразмещал память
+};
+
 void RenderSystemInit();
-void RenderSystemBeginFrame(int WindowClientWidth, int WindowClientHeight);
\ No newline at end of file
+void RenderSystemBeginFrame(int WindowClientWidth, int WindowClientHeight);
+
+[[nodiscard]] const RenderFrameStatistics& GetRenderFrameStatistics(); // статистика прошлого кадра
\ No newline at end of file
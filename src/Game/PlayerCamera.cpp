@@ -1,4 +1,5 @@
 #include "PlayerCamera.h"
+#include "DungeonGrid.h"
 
 FlyingCamera camera;
 bool IsFreeCameraRotate = false;
@@ -6,6 +7,7 @@ bool IsFreeCameraMov = false;
 
 Vector3 playerPos;
 Vector3 playerEyeTarget;
+const DungeonGrid* playerGrid = nullptr;
 
 // turn camera
 bool m_isMoving = false;
@@ -67,8 +69,8 @@ void move(moveDir dir)
 	if( dir == moveDir::Left ) m_direction = -Right;
 	if( dir == moveDir::Right ) m_direction = Right;
 
-	//const Vector3 targetPos = Vector3Add(m_cameraPosition, m_direction);
-	//if( !isBlocked(targetPos, map) && dir != moveDir::No )
+	const Vector3 targetPos = camera.position + m_direction;
+	if( dir != moveDir::No && (!playerGrid || !playerGrid->IsBlocked(DungeonGrid::WorldToCell(targetPos))) )
 	{
 		m_isMoving = true;
 		m_targetPosition = camera.position + m_direction;
@@ -114,6 +116,11 @@ void PlayerCamera::SetPosition(const Vector3& pos, const Vector3& eyeTarget)
 	camera.Look(pos, eyeTarget);
 }
 
+void PlayerCamera::SetGrid(const DungeonGrid* grid)
+{
+	playerGrid = grid;
+}
+
 void PlayerCamera::Update(bool FreeCameraRotate, bool FreeCameraMove)
 {
 	if( FreeCameraRotate )
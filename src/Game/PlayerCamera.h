@@ -2,9 +2,13 @@
 
 #include "MicroEngine.h"
 
+class DungeonGrid;
+
 namespace PlayerCamera
 {
 	void SetPosition(const Vector3& pos, const Vector3& eyeTarget);
+	// сетка для пошагового движения: шаг в занятую клетку не выполняется (nullptr - без проверки)
+	void SetGrid(const DungeonGrid* grid);
 
 	void Update(bool FreeCameraRotate, bool FreeCameraMove);
 
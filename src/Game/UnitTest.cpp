@@ -1,5 +1,10 @@
 #include <string>
 #include "UnitTestMath.h"
+#include "UnitTestGeometry.h"
+#include "UnitTestCollisions.h"
+#include "UnitTestJobSystem.h"
+#include "UnitTestDungeonGrid.h"
+#include "UnitTestGraphics.h"
 
 void consoleOkLog(const std::string& msg)
 {
@@ -13,8 +18,19 @@ void consoleErrorLog(const std::string& msg)
 	puts(message.c_str());
 }
 
+bool consoleCheck(bool condition, const std::string& msg)
+{
+	if( !condition ) consoleErrorLog("FAILED: " + msg);
+	return condition;
+}
+
 void RunTest()
 {
 	consoleOkLog("UNIT TEST Enable");
 	RunUnitTestMath();
+	RunUnitTestGeometry();
+	RunUnitTestCollisions();
+	RunUnitTestJobSystem();
+	RunUnitTestDungeonGrid();
+	RunUnitTestGraphics();
 }
@@ -0,0 +1,486 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <random>
+#include <cmath>
+void consoleOkLog(const std::string& msg);
+void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
+
+#include "MicroCollisions.h"
+#include "UnitTestGeometry.h" // loadObjTriangles, benchmarkElapsedMs
+
+// ближайшая точка треугольника скалярными функциями (плоскость строится при каждой проверке, как до CollisionTriangleSoA)
+inline Vector3 referenceClosestPointOnTriangle(const Vector3& p1, const Vector3& p2, const Vector3& p3, const Vector3& point)
+{
+	const Plane plane(p1, p2, p3);
+	const Vector3 projected = point - plane.normal * plane.SignedDistanceTo(point);
+	if( CheckPointInTriangle(p1, p2, p3, projected) )
+		return projected;
+
+	const Vector3 edgePoints[3] = { ClosestPointOnLineSegment(p1, p2, point), ClosestPointOnLineSegment(p2, p3, point), ClosestPointOnLineSegment(p3, p1, point) };
+	Vector3 closest = edgePoints[0];
+	for( int e = 1; e < 3; e++ )
+	{
+		if( DotProduct(edgePoints[e] - point, edgePoints[e] - point) < DotProduct(closest - point, closest - point) )
+			closest = edgePoints[e];
+	}
+	return closest;
+}
+
+void RunUnitTestCollisions()
+{
+	consoleOkLog("==> COLLISIONS TEST Enable");
+
+	//-------------------------------------------------------------------------
+	// CharacterController на простой сцене: пол y = 0 и стена x = 5 (нормаль к -x)
+	//-------------------------------------------------------------------------
+	{
+		const std::vector<Vector3> scene =
+		{
+			{ -50.0f, 0.0f, -50.0f }, { -50.0f, 0.0f, 50.0f }, { 50.0f, 0.0f, 50.0f },
+			{ -50.0f, 0.0f, -50.0f }, { 50.0f, 0.0f, 50.0f }, { 50.0f, 0.0f, -50.0f },
+			{ 5.0f, -1.0f, -50.0f }, { 5.0f, 10.0f, 50.0f }, { 5.0f, 10.0f, -50.0f },
+			{ 5.0f, -1.0f, -50.0f }, { 5.0f, -1.0f, 50.0f }, { 5.0f, 10.0f, 50.0f },
+		};
+		CollisionMesh mesh;
+		mesh.Create(scene);
+
+		const Vector3 radius(0.5f, 1.0f, 0.5f);
+		CharacterController controller;
+		controller.Create(radius, { &mesh });
+		consoleCheck(mesh.PrepareEllipsoid(radius) == 0, "CollisionMesh ellipsoid cache reuse");
+
+		controller.position = Vector3(0.0f, 3.0f, 0.0f);
+		for( int i = 0; i < 60; i++ )
+			controller.Move(Vector3(0.0f, -0.2f, 0.0f));
+		consoleCheck(fabsf(controller.position.y - radius.y) < 0.01f, "CharacterController lands on floor");
+		consoleCheck(controller.IsGrounded(), "CharacterController grounded");
+
+		for( int i = 0; i < 60; i++ )
+			controller.Move(Vector3(0.2f, -0.2f, 0.1f));
+		consoleCheck(controller.position.x <= 5.0f - radius.x + 0.01f && controller.position.x > 4.0f, "CharacterController stops at wall");
+		consoleCheck(controller.position.z > 5.0f, "CharacterController slides along wall");
+		consoleCheck(fabsf(controller.position.y - radius.y) < 0.01f, "CharacterController stays on floor");
+
+		// рывок к стене одним запросом
+		SweepHit hit;
+		controller.position = Vector3(0.0f, radius.y + 0.01f, 0.0f);
+		consoleCheck(controller.Sweep(Vector3(20.0f, 0.0f, 0.0f), hit) && fabsf(controller.position.x + 20.0f * hit.time - (5.0f - radius.x)) < 1e-4f && hit.triangle >= 2
+			&& Distance(hit.normal, Vector3(-1.0f, 0.0f, 0.0f)) < 1e-4f, "CharacterController Sweep");
+	}
+
+	//-------------------------------------------------------------------------
+	// CollisionTriangleSoA == скалярные CheckPointInTriangle/ClosestPointOnLineSegment
+	//-------------------------------------------------------------------------
+	{
+		constexpr size_t TriangleCount = 4099; // не кратно 8 - проверяется и скалярный остаток
+		constexpr int QueryCount = 2000;
+		std::mt19937 random(31);
+		std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+		std::vector<Vector3> triangles(TriangleCount * 3);
+		for( size_t i = 0; i < TriangleCount; i++ )
+		{
+			const Vector3 center(position(random), position(random), position(random));
+			for( int v = 0; v < 3; v++ )
+				triangles[i * 3 + v] = center + Vector3(offset(random), offset(random), offset(random));
+		}
+		std::vector<Vector3> queries(QueryCount);
+		for( Vector3& query : queries )
+			query = Vector3(position(random), position(random), position(random));
+
+		CollisionTriangleSoA soa;
+		soa.Build(triangles);
+		consoleCheck(soa.GetSize() == TriangleCount, "CollisionTriangleSoA size");
+		const CollisionTriangle first = soa.Get(0);
+		consoleCheck(first.p2 == triangles[1] && fabsf(first.plane.SignedDistanceTo(triangles[2])) < 0.001f, "CollisionTriangleSoA Get");
+
+		std::vector<Vector3> closestPoints(TriangleCount);
+		std::vector<uint8_t> inside(TriangleCount);
+		bool isClosestEqual = true;
+		bool isInsideEqual = true;
+		for( int q = 0; q < 50; q++ )
+		{
+			const Vector3& point = queries[q];
+			soa.ClosestPoint(point, 0, TriangleCount, closestPoints.data());
+			for( size_t i = 0; i < TriangleCount; i++ )
+			{
+				const Vector3 reference = referenceClosestPointOnTriangle(triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2], point);
+				isClosestEqual = isClosestEqual && fabsf(Distance(reference, point) - Distance(closestPoints[i], point)) < 0.001f;
+			}
+
+			// точка в плоскости треугольника: центр тяжести внутри, отраженная за вершину - снаружи
+			const size_t t = (size_t)q * 80;
+			const Vector3 centroid = (triangles[t * 3 + 0] + triangles[t * 3 + 1] + triangles[t * 3 + 2]) / 3.0f;
+			const Vector3 outside = triangles[t * 3 + 0] * 2.0f - centroid;
+			soa.CheckPointInTriangle(centroid, t, t + 1, inside.data());
+			isInsideEqual = isInsideEqual && inside[0] == 1;
+			soa.CheckPointInTriangle(outside, t, t + 1, inside.data());
+			isInsideEqual = isInsideEqual && inside[0] == (CheckPointInTriangle(triangles[t * 3 + 0], triangles[t * 3 + 1], triangles[t * 3 + 2], outside) ? 1 : 0);
+		}
+		consoleCheck(isClosestEqual, "CollisionTriangleSoA ClosestPoint == scalar");
+		consoleCheck(isInsideEqual, "CollisionTriangleSoA CheckPointInTriangle == scalar");
+
+		// сфера: пакетный проход против скалярного с плоскостью на каждую проверку
+		constexpr float Radius = 4.0f;
+		std::vector<uint32_t> soaOverlaps;
+		size_t soaTotal = 0;
+		auto begin = std::chrono::steady_clock::now();
+		for( const Vector3& query : queries )
+			soaTotal += soa.OverlapSphere(query, Radius, soaOverlaps);
+		const double soaMs = benchmarkElapsedMs(begin);
+
+		size_t scalarTotal = 0;
+		begin = std::chrono::steady_clock::now();
+		for( const Vector3& query : queries )
+		{
+			for( size_t i = 0; i < TriangleCount; i++ )
+			{
+				const Vector3 closest = referenceClosestPointOnTriangle(triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2], query);
+				scalarTotal += DotProduct(closest - query, closest - query) <= Radius * Radius ? 1 : 0;
+			}
+		}
+		const double scalarMs = benchmarkElapsedMs(begin);
+
+		consoleCheck(soaTotal == scalarTotal, "CollisionTriangleSoA OverlapSphere == scalar");
+		const double tests = (double)TriangleCount * QueryCount;
+		consoleOkLog("Sphere vs triangle " + std::to_string((int)tests) + " tests: scalar " + std::to_string(scalarMs) + " ms, SoA " + std::to_string(soaMs) + " ms, speedup "
+			+ std::to_string(scalarMs / soaMs) + ", " + std::to_string(tests / soaMs / 1000.0) + " Mtests/s");
+	}
+
+	//-------------------------------------------------------------------------
+	// Time Of Impact
+	//-------------------------------------------------------------------------
+	{
+		const std::vector<Vector3> floor =
+		{
+			{ -10.0f, 0.0f, -10.0f }, { -10.0f, 0.0f, 10.0f }, { 10.0f, 0.0f, 10.0f },
+			{ -10.0f, 0.0f, -10.0f }, { 10.0f, 0.0f, 10.0f }, { 10.0f, 0.0f, -10.0f },
+		};
+		SweepHit hit;
+		// быстрое падение за один шаг: касание на высоте радиуса
+		consoleCheck(SweepSphereTriangles(Sphere(Vector3(1.0f, 10.0f, 2.0f), 0.5f), Vector3(0.0f, -100.0f, 0.0f), floor.data(), 2, hit) && fabsf(hit.time - 0.095f) < 1e-5f
+			&& Distance(hit.normal, Vector3(0.0f, 1.0f, 0.0f)) < 1e-5f && Distance(hit.contact, Vector3(1.0f, 0.0f, 2.0f)) < 1e-4f, "SweepSphereTriangles face hit");
+		consoleCheck(!SweepSphereTriangles(Sphere(Vector3(1.0f, 10.0f, 2.0f), 0.5f), Vector3(0.0f, 100.0f, 0.0f), floor.data(), 2, hit), "SweepSphereTriangles moving away");
+		// касание ребра пола сбоку: нормаль от ребра к центру
+		consoleCheck(SweepSphereTriangles(Sphere(Vector3(-20.0f, -0.3f, 0.0f), 0.5f), Vector3(20.0f, 0.0f, 0.0f), floor.data(), 2, hit) && fabsf(hit.time - 0.48f) < 1e-5f
+			&& Distance(hit.normal, Vector3(-0.8f, -0.6f, 0.0f)) < 1e-4f && Distance(hit.contact, Vector3(-10.0f, 0.0f, 0.0f)) < 1e-4f, "SweepSphereTriangles edge hit");
+		consoleCheck(!SweepSphereTriangles(Sphere(Vector3(1.0f, 10.0f, 2.0f), 0.5f), Vector3(0.0f), floor.data(), 2, hit), "SweepSphereTriangles zero displacement");
+		consoleCheck(SweepEllipsoidTriangles(Vector3(1.0f, 5.0f, 0.0f), Vector3(0.5f, 2.0f, 0.5f), Vector3(0.0f, -10.0f, 0.0f), floor.data(), 2, hit) && fabsf(hit.time - 0.3f) < 1e-5f,
+			"SweepEllipsoidTriangles face hit");
+
+		// случайные перемещения == перебор по времени (касание - расстояние до треугольника в пространстве эллипсоида <= 1)
+		std::mt19937 random(41);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		constexpr int Steps = 2000;
+		bool isEqual = true;
+		int hitCount = 0;
+		for( int i = 0; i < 300; i++ )
+		{
+			const Vector3 radius(0.3f + 0.2f * fabsf(unit(random)), 0.5f + 0.5f * fabsf(unit(random)), 0.3f + 0.2f * fabsf(unit(random)));
+			Vector3 triangle[3] = { Vector3(unit(random), unit(random), unit(random)) * 2.0f, Vector3(unit(random), unit(random), unit(random)) * 2.0f, Vector3(unit(random), unit(random), unit(random)) * 2.0f };
+			const Vector3 center = Vector3(unit(random), unit(random), unit(random)) * 4.0f;
+			const Vector3 displacement = -center * 2.0f + Vector3(unit(random), unit(random), unit(random));
+			const Vector3 e[3] = { triangle[0] / radius, triangle[1] / radius, triangle[2] / radius };
+			// лицевая сторона к началу движения, начало без касания
+			if( DotProduct(Plane(e[0], e[1], e[2]).normal, displacement / radius) > 0.0f ) std::swap(triangle[1], triangle[2]);
+			const Vector3 eSpace[3] = { triangle[0] / radius, triangle[1] / radius, triangle[2] / radius };
+			auto touches = [&](float t)
+			{
+				const Vector3 point = (center + displacement * t) / radius;
+				const Vector3 closest = referenceClosestPointOnTriangle(eSpace[0], eSpace[1], eSpace[2], point);
+				return DotProduct(closest - point, closest - point) <= 1.0f;
+			};
+			if( touches(0.0f) ) continue;
+
+			float referenceTime = -1.0f;
+			for( int step = 1; step <= Steps && referenceTime < 0.0f; step++ )
+			{
+				if( touches((float)step / Steps) ) referenceTime = (float)step / Steps;
+			}
+			const bool isHit = SweepEllipsoidTriangles(center, radius, displacement, triangle, 1, hit);
+			if( isHit != (referenceTime >= 0.0f) )
+			{
+				// касание вскользь между отсчетами перебора допустимо только у самого края
+				isEqual = isEqual && isHit && touches(Min(hit.time + 2.0f / Steps, 1.0f));
+				continue;
+			}
+			if( !isHit ) continue;
+			hitCount++;
+			const Vector3 eContact = hit.contact / radius;
+			const Vector3 eCenter = (center + displacement * hit.time) / radius;
+			isEqual = isEqual && hit.time <= referenceTime + 1e-4f && hit.time >= referenceTime - 1.0f / Steps - 1e-4f && hit.triangle == 0
+				&& fabsf(Distance(eContact, eCenter) - 1.0f) < 1e-3f && DotProduct(hit.normal, displacement) < 0.0f;
+		}
+		consoleCheck(isEqual && hitCount > 50, "SweepEllipsoidTriangles == brute force (" + std::to_string(hitCount) + " hits)");
+
+		// AABB
+		const AABB box(Vector3(0.0f), Vector3(1.0f));
+		const AABB mover(Vector3(-3.0f, 0.25f, 0.25f), Vector3(-2.0f, 0.75f, 0.75f));
+		consoleCheck(SweepAABB(mover, Vector3(10.0f, 0.0f, 0.0f), box, hit) && fabsf(hit.time - 0.2f) < 1e-6f && hit.normal == Vector3(-1.0f, 0.0f, 0.0f)
+			&& Distance(hit.contact, Vector3(0.0f, 0.5f, 0.5f)) < 1e-6f, "SweepAABB face hit");
+		consoleCheck(!SweepAABB(mover, Vector3(1.0f, 0.0f, 0.0f), box, hit), "SweepAABB too short");
+		consoleCheck(!SweepAABB(mover, Vector3(10.0f, 5.0f, 0.0f), box, hit), "SweepAABB miss");
+		consoleCheck(!SweepAABB(AABB(Vector3(1.0f, 0.0f, 0.0f), Vector3(2.0f, 1.0f, 1.0f)), Vector3(1.0f, 0.0f, 0.0f), box, hit), "SweepAABB touching and separating");
+		consoleCheck(SweepAABB(AABB(Vector3(0.8f, 0.2f, 0.2f), Vector3(1.7f, 0.8f, 0.8f)), Vector3(1.0f, 0.0f, 0.0f), box, hit) && hit.time == 0.0f && hit.normal == Vector3(1.0f, 0.0f, 0.0f),
+			"SweepAABB initial overlap");
+
+		bool isAABBEqual = true;
+		for( int i = 0; i < 1000; i++ )
+		{
+			const Vector3 center = Vector3(unit(random), unit(random), unit(random)) * 5.0f;
+			const Vector3 extent(0.1f + fabsf(unit(random)), 0.1f + fabsf(unit(random)), 0.1f + fabsf(unit(random)));
+			const AABB moving(center - extent, center + extent);
+			const Vector3 displacement = Vector3(unit(random), unit(random), unit(random)) * 10.0f;
+			float referenceTime = -1.0f;
+			for( int step = 0; step <= Steps && referenceTime < 0.0f; step++ )
+			{
+				const Vector3 offset = displacement * ((float)step / Steps);
+				if( AABB(moving.min + offset, moving.max + offset).Overlaps(box) ) referenceTime = (float)step / Steps;
+			}
+			if( SweepAABB(moving, displacement, box, hit) )
+				isAABBEqual = isAABBEqual && (referenceTime < 0.0f ? true : hit.time <= referenceTime + 1e-5f && hit.time >= referenceTime - 1.0f / Steps - 1e-5f);
+			else
+				isAABBEqual = isAABBEqual && referenceTime < 0.0f;
+		}
+		consoleCheck(isAABBEqual, "SweepAABB == brute force");
+	}
+
+	//-------------------------------------------------------------------------
+	// GJK / EPA
+	//-------------------------------------------------------------------------
+	{
+		std::vector<Vector3> cubePoints;
+		for( int i = 0; i < 8; i++ )
+			cubePoints.push_back(Vector3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+		ConvexHull cube;
+		cube.Build(cubePoints);
+
+		ConvexContact contact;
+		consoleCheck(!ConvexCollide(Sphere(Vector3(0.0f), 1.0f), Sphere(Vector3(3.0f, 0.0f, 0.0f), 1.5f), contact) && fabsf(contact.distance - 0.5f) < 1e-5f
+			&& Distance(contact.normal, Vector3(1.0f, 0.0f, 0.0f)) < 1e-5f && Distance(contact.pointB, Vector3(1.5f, 0.0f, 0.0f)) < 1e-5f, "ConvexCollide sphere vs sphere");
+		consoleCheck(!ConvexCollide(cube, Sphere(Vector3(3.0f, 3.0f, 0.0f), 1.0f), contact) && fabsf(contact.distance - (sqrtf(8.0f) - 1.0f)) < 1e-4f
+			&& Distance(contact.pointA, Vector3(1.0f, 1.0f, 0.0f)) < 1e-4f, "ConvexCollide hull vs sphere (edge)");
+		consoleCheck(ConvexCollide(cube, Sphere(Vector3(0.5f, 0.2f, 0.0f), 0.25f), contact) && fabsf(contact.distance + 0.75f) < 1e-4f
+			&& Distance(contact.normal, Vector3(1.0f, 0.0f, 0.0f)) < 1e-4f, "ConvexCollide sphere center inside hull (EPA)");
+		consoleCheck(ConvexCollide(Capsule(Vector3(1.2f, -3.0f, 0.0f), Vector3(1.2f, 3.0f, 0.0f), 0.5f), cube, contact) && fabsf(contact.distance + 0.3f) < 1e-4f
+			&& Distance(contact.normal, Vector3(-1.0f, 0.0f, 0.0f)) < 1e-4f, "ConvexCollide capsule vs hull");
+		consoleCheck(!ConvexOverlap(cube, ConvexShape(cube, Transform(Vector3(3.0f, 0.0f, 0.0f), Quaternion(Vector3(0.0f, PI * 0.25f, 0.0f)), 1.0f)))
+			&& ConvexCollide(cube, ConvexShape(cube, Transform(Vector3(3.0f, 0.0f, 0.0f), Quaternion(Vector3(0.0f, PI * 0.25f, 0.0f)), 1.0f)), contact) == false
+			&& fabsf(contact.distance - (2.0f - sqrtf(2.0f))) < 1e-4f, "ConvexCollide hull vs rotated hull");
+		consoleCheck(ConvexCollide(cube, ConvexShape(cube, Transform(Vector3(1.5f, 0.3f, 0.1f), Quaternion(), 1.0f)), contact) && fabsf(contact.distance + 0.5f) < 1e-4f
+			&& Distance(contact.normal, Vector3(1.0f, 0.0f, 0.0f)) < 1e-4f, "ConvexCollide hull vs hull penetration (EPA)");
+
+		// случайные оболочки: сфера - перебор треугольников/плоскостей, оболочка - SAT по нормалям граней и произведениям ребер
+		std::mt19937 random(77);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		auto randomHull = [&](ConvexHull& hull)
+		{
+			std::vector<Vector3> points(40);
+			const Vector3 scale(0.5f + fabsf(unit(random)), 0.5f + fabsf(unit(random)), 0.5f + fabsf(unit(random)));
+			for( Vector3& point : points )
+				point = Vector3(unit(random), unit(random), unit(random)) * scale;
+			hull.Build(points);
+		};
+		auto worldVertices = [](const ConvexHull& hull, const Transform& transform)
+		{
+			std::vector<Vector3> vertices;
+			for( const Vector3& vertex : hull.vertices )
+				vertices.push_back(transform.ToTransform(vertex));
+			return vertices;
+		};
+
+		bool isSphereEqual = true;
+		bool isHullEqual = true;
+		int overlapCount = 0;
+		for( int i = 0; i < 300; i++ )
+		{
+			ConvexHull hullA, hullB;
+			randomHull(hullA);
+			randomHull(hullB);
+
+			const Sphere sphere(Vector3(unit(random), unit(random), unit(random)) * 2.0f, 0.3f);
+			float reference = std::numeric_limits<float>::max();
+			if( hullA.Contains(sphere.position) )
+			{
+				for( const Plane& plane : hullA.planes )
+					reference = Min(reference, -plane.SignedDistanceTo(sphere.position));
+				reference = -reference;
+			}
+			else
+			{
+				for( size_t t = 0; t < hullA.indices.size(); t += 3 )
+				{
+					const Vector3 closest = referenceClosestPointOnTriangle(hullA.vertices[hullA.indices[t]], hullA.vertices[hullA.indices[t + 1]], hullA.vertices[hullA.indices[t + 2]], sphere.position);
+					reference = Min(reference, Distance(closest, sphere.position));
+				}
+			}
+			ConvexCollide(hullA, sphere, contact);
+			isSphereEqual = isSphereEqual && fabsf(contact.distance - (reference - sphere.radius)) < 1e-3f;
+
+			const Transform transformB(Vector3(unit(random), unit(random), unit(random)) * 2.5f, Quaternion(Vector3(unit(random), unit(random), unit(random)) * PI), 1.0f);
+			const std::vector<Vector3> verticesA = worldVertices(hullA, Transform());
+			const std::vector<Vector3> verticesB = worldVertices(hullB, transformB);
+			std::vector<Vector3> axes;
+			for( const Plane& plane : hullA.planes )
+				axes.push_back(plane.normal);
+			for( const Plane& plane : hullB.planes )
+				axes.push_back(transformB.rotate * plane.normal);
+			for( size_t ta = 0; ta < hullA.indices.size(); ta += 3 )
+			{
+				for( size_t tb = 0; tb < hullB.indices.size(); tb += 3 )
+				{
+					for( int ea = 0; ea < 3; ea++ )
+					{
+						for( int eb = 0; eb < 3; eb++ )
+						{
+							const Vector3 edgeA = verticesA[hullA.indices[ta + (ea + 1) % 3]] - verticesA[hullA.indices[ta + ea]];
+							const Vector3 edgeB = verticesB[hullB.indices[tb + (eb + 1) % 3]] - verticesB[hullB.indices[tb + eb]];
+							const Vector3 axis = CrossProduct(edgeA, edgeB);
+							if( axis.GetLength() > 1e-4f ) axes.push_back(axis.GetNormalize());
+						}
+					}
+				}
+			}
+			float minOverlap = std::numeric_limits<float>::max();
+			for( const Vector3& axis : axes )
+			{
+				float minA = std::numeric_limits<float>::max(), maxA = -minA, minB = minA, maxB = -minA;
+				for( const Vector3& v : verticesA ) { minA = Min(minA, DotProduct(v, axis)); maxA = Max(maxA, DotProduct(v, axis)); }
+				for( const Vector3& v : verticesB ) { minB = Min(minB, DotProduct(v, axis)); maxB = Max(maxB, DotProduct(v, axis)); }
+				minOverlap = Min(minOverlap, Min(maxA - minB, maxB - minA));
+			}
+			if( fabsf(minOverlap) < 1e-3f ) continue; // касание - результат зависит от округления
+
+			const ConvexShape shapeB(hullB, transformB);
+			const bool isOverlap = ConvexCollide(hullA, shapeB, contact);
+			isHullEqual = isHullEqual && isOverlap == (minOverlap > 0.0f) && ConvexOverlap(hullA, shapeB) == isOverlap;
+			// глубина проникновения многогранников - наименьшее перекрытие по осям SAT
+			if( isOverlap )
+			{
+				overlapCount++;
+				isHullEqual = isHullEqual && fabsf(contact.distance + minOverlap) < 1e-3f;
+			}
+		}
+		consoleCheck(isSphereEqual, "ConvexCollide sphere vs random hull == brute force");
+		consoleCheck(isHullEqual && overlapCount > 30, "ConvexCollide hull vs hull == SAT (" + std::to_string(overlapCount) + " penetrations)");
+
+		// проп rock.obj: сфера против оболочки из 24 вершин и против треугольников модели
+		const std::vector<Vector3> rock = loadObjTriangles("../data/mesh/rock.obj");
+		ConvexHull rockHull;
+		if( !rock.empty() && rockHull.Build(rock, 24) )
+		{
+			CollisionTriangleSoA rockTriangles;
+			rockTriangles.Build(rock);
+			AABB rockBounds(rock[0], rock[0]);
+			for( const Vector3& vertex : rock )
+				rockBounds.AddPoint(vertex);
+			constexpr int QueryCount = 100000;
+			std::vector<Sphere> spheres(QueryCount);
+			for( Sphere& query : spheres )
+				query = Sphere(rockBounds.GetCenter() + rockBounds.GetExtent() * 1.5f * Vector3(unit(random), unit(random), unit(random)), 0.2f);
+
+			int hullHits = 0;
+			auto begin = std::chrono::steady_clock::now();
+			for( const Sphere& query : spheres )
+				hullHits += ConvexOverlap(rockHull, query) ? 1 : 0;
+			const double hullMs = benchmarkElapsedMs(begin);
+
+			int triangleHits = 0;
+			std::vector<uint32_t> overlaps;
+			begin = std::chrono::steady_clock::now();
+			for( const Sphere& query : spheres )
+				triangleHits += rockTriangles.OverlapSphere(query.position, query.radius, overlaps) > 0 ? 1 : 0;
+			const double triangleMs = benchmarkElapsedMs(begin);
+			consoleOkLog("rock.obj " + std::to_string(QueryCount) + " spheres: hull " + std::to_string(rockHull.planes.size()) + " planes " + std::to_string(hullMs) + " ms (" + std::to_string(hullHits)
+				+ " hits), " + std::to_string(rock.size() / 3) + " triangles SoA " + std::to_string(triangleMs) + " ms (" + std::to_string(triangleHits) + " hits, surface only)");
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// 1000 контроллеров на уровне map.obj
+	//-------------------------------------------------------------------------
+	{
+		const std::vector<Vector3> level = loadObjTriangles("../data/mesh/map.obj");
+		if( level.empty() )
+		{
+			consoleErrorLog("map.obj not found, CharacterController benchmark skipped");
+			return;
+		}
+
+		CollisionMesh mesh;
+		mesh.Create(level);
+
+		// снаряды: отрезок 10 м за кадр одним запросом на каждый
+		{
+			constexpr int ProjectileCount = 100000;
+			std::mt19937 random(5);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			const AABB bounds = mesh.GetBVH().GetBounds();
+			std::vector<Vector3> origins(ProjectileCount), displacements(ProjectileCount);
+			for( int i = 0; i < ProjectileCount; i++ )
+			{
+				origins[i] = bounds.min + (bounds.max - bounds.min) * Vector3(unit(random), unit(random), unit(random));
+				const float angle = unit(random) * PI * 2.0f;
+				displacements[i] = Vector3(cosf(angle), unit(random) - 0.5f, sinf(angle)) * 10.0f;
+			}
+			const Vector3 projectileRadius(0.05f);
+			std::vector<uint32_t> candidates;
+			SweepHit hit;
+			int hitCount = 0;
+			const auto begin = std::chrono::steady_clock::now();
+			for( int i = 0; i < ProjectileCount; i++ )
+				hitCount += mesh.SweepEllipsoid(origins[i], projectileRadius, displacements[i], candidates, hit) ? 1 : 0;
+			const double totalMs = benchmarkElapsedMs(begin);
+			consoleOkLog("CollisionMesh map.obj SweepEllipsoid " + std::to_string(ProjectileCount) + " projectiles: " + std::to_string(totalMs) + " ms, "
+				+ std::to_string(totalMs * 1000.0 / ProjectileCount) + " us per query, hits " + std::to_string(hitCount));
+		}
+
+		constexpr int ControllerCount = 1000;
+		constexpr int StepCount = 100;
+		const Vector3 radius(0.2f, 0.4f, 0.2f);
+		const AABB bounds = mesh.GetBVH().GetBounds();
+
+		std::mt19937 random(777);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::vector<CharacterController> controllers(ControllerCount);
+		std::vector<Vector3> directions(ControllerCount);
+		for( int i = 0; i < ControllerCount; i++ )
+		{
+			controllers[i].Create(radius, { &mesh });
+			// случайная точка над полом уровня
+			float floorDistance = 0.0f;
+			uint32_t floorTriangle = 0;
+			Vector3 spawn;
+			do
+			{
+				spawn = Vector3(bounds.min.x + unit(random) * (bounds.max.x - bounds.min.x), 1.0f, bounds.min.z + unit(random) * (bounds.max.z - bounds.min.z));
+			} while( !mesh.GetBVH().RayCast(Ray(spawn, Vector3(0.0f, -1.0f, 0.0f)), 10.0f, floorDistance, floorTriangle) );
+			controllers[i].position = Vector3(spawn.x, spawn.y - floorDistance + radius.y + 0.05f, spawn.z);
+			const float angle = unit(random) * PI * 2.0f;
+			directions[i] = Vector3(cosf(angle), 0.0f, sinf(angle));
+		}
+
+		constexpr float DeltaTime = 1.0f / 60.0f;
+		const auto begin = std::chrono::steady_clock::now();
+		for( int step = 0; step < StepCount; step++ )
+		{
+			for( int i = 0; i < ControllerCount; i++ )
+				controllers[i].Move(directions[i] * (3.0f * DeltaTime) + Vector3(0.0f, -9.8f * DeltaTime, 0.0f));
+		}
+		const double totalMs = benchmarkElapsedMs(begin);
+
+		int grounded = 0;
+		bool isFinite = true;
+		for( int i = 0; i < ControllerCount; i++ )
+		{
+			grounded += controllers[i].IsGrounded() ? 1 : 0;
+			isFinite = isFinite && std::isfinite(controllers[i].position.x) && std::isfinite(controllers[i].position.y) && std::isfinite(controllers[i].position.z);
+		}
+		consoleCheck(isFinite, "CharacterController map.obj positions finite");
+		consoleOkLog("CharacterController map.obj " + std::to_string(level.size() / 3) + " triangles, 1000 controllers x 100 steps: " + std::to_string(totalMs) + " ms, "
+			+ std::to_string(totalMs * 1000.0 / (ControllerCount * StepCount)) + " us per move, grounded " + std::to_string(grounded));
+	}
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <random>
+void consoleOkLog(const std::string& msg);
+void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
+
+#include "DungeonGrid.h"
+#include "UnitTestGeometry.h" // benchmarkElapsedMs
+
+void RunUnitTestDungeonGrid()
+{
+	consoleOkLog("==> DUNGEON GRID TEST Enable");
+
+	//-------------------------------------------------------------------------
+	// материалы и флаги в чанковом хранилище
+	//-------------------------------------------------------------------------
+	{
+		DungeonGrid grid;
+		consoleCheck(!grid.Create(0, 1, 1), "DungeonGrid invalid size");
+		if( !consoleCheck(grid.Create(37, 3, 21), "DungeonGrid::Create") )
+			return;
+
+		grid.SetCell(16, 2, 15, 7);
+		grid.SetCell(15, 2, 16, 3);
+		consoleCheck(grid.GetCell(16, 2, 15) == 7 && grid.GetCell(15, 2, 16) == 3 && grid.GetCell(15, 2, 15) == 0, "DungeonGrid cells across chunks");
+		consoleCheck(grid.IsSolid(16, 2, 15) && !grid.IsSolid(16, 1, 15) && !grid.IsSolid(-1, 0, 0), "DungeonGrid IsSolid");
+		consoleCheck(grid.GetFlags(16, 2, 15) == CellSolid && grid.GetFlags(37, 0, 0) == CellBlocked, "DungeonGrid GetFlags");
+
+		grid.SetFlags(36, 0, 20, CellOccupied | CellBlocked, true);
+		grid.SetFlags(36, 0, 20, CellSolid, true); // стена только через материал
+		consoleCheck(grid.GetFlags(36, 0, 20) == (CellOccupied | CellBlocked), "DungeonGrid SetFlags");
+		grid.SetFlags(36, 0, 20, CellBlocked, false);
+		consoleCheck(grid.GetFlags(36, 0, 20) == CellOccupied, "DungeonGrid clear flag");
+		grid.SetCell(16, 2, 15, 0);
+		consoleCheck(!grid.IsBlocked(16, 2, 15), "DungeonGrid cleared cell");
+
+		const GridCell cell = DungeonGrid::WorldToCell(Vector3(4.4f, -0.4f, 2.6f));
+		consoleCheck(cell == GridCell{ 4, 0, 3 } && DungeonGrid::WorldToCell(DungeonGrid::CellToWorld(cell)) == cell, "DungeonGrid WorldToCell/CellToWorld");
+		consoleCheck(DungeonGrid::GetDirection(Vector3(0.0f, 0.0f, -1.0f)) == GridDirection::North && DungeonGrid::GetDirection(Vector3(-0.9f, 0.0f, 0.2f)) == GridDirection::West, "DungeonGrid GetDirection");
+	}
+
+	//-------------------------------------------------------------------------
+	// шаги и соседи
+	//-------------------------------------------------------------------------
+	{
+		DungeonGrid grid;
+		grid.Create(8, 1, 8);
+		grid.SetCell(3, 0, 2, 1);
+		grid.SetFlags(4, 0, 3, CellBlocked, true);
+
+		const GridCell start = { 3, 0, 3 };
+		const uint8_t open = grid.GetOpenNeighbours(start);
+		consoleCheck(open == ((1 << (int)GridDirection::South) | (1 << (int)GridDirection::West)), "DungeonGrid GetOpenNeighbours");
+		consoleCheck(grid.GetOpenNeighbours({ 0, 0, 0 }) == ((1 << (int)GridDirection::East) | (1 << (int)GridDirection::South)), "DungeonGrid grid edge blocks");
+
+		GridCell target;
+		consoleCheck(!grid.TryStep(start, GridDirection::North, target), "DungeonGrid step into wall");
+		consoleCheck(grid.TryStep(start, GridDirection::West, target) && target == GridCell{ 2, 0, 3 }, "DungeonGrid step");
+
+		// два актера в одну клетку: второй видит ход первого
+		grid.SetFlags(1, 0, 5, CellOccupied, true);
+		grid.SetFlags(3, 0, 5, CellOccupied, true);
+		GridMove moves[2];
+		moves[0].from = { 1, 0, 5 };
+		moves[0].direction = GridDirection::East;
+		moves[1].from = { 3, 0, 5 };
+		moves[1].direction = GridDirection::West;
+		consoleCheck(grid.ResolveMoves(moves, 2) == 1, "DungeonGrid ResolveMoves count");
+		consoleCheck(moves[0].moved && moves[0].result == GridCell{ 2, 0, 5 } && !moves[1].moved && moves[1].result == moves[1].from, "DungeonGrid ResolveMoves order");
+		consoleCheck(!grid.HasFlags(1, 0, 5, CellOccupied) && grid.HasFlags(2, 0, 5, CellOccupied), "DungeonGrid ResolveMoves occupancy");
+	}
+
+	//-------------------------------------------------------------------------
+	// пакетные ходы актеров на карте 256x256
+	//-------------------------------------------------------------------------
+	{
+		constexpr int Size = 256;
+		constexpr size_t ActorCount = 10000;
+		constexpr int TurnCount = 100;
+		DungeonGrid grid;
+		grid.Create(Size, 1, Size);
+		std::mt19937 random(5);
+		for( int z = 0; z < Size; z++ )
+		{
+			for( int x = 0; x < Size; x++ )
+			{
+				if( random() % 4 == 0 )
+					grid.SetCell(x, 0, z, 1);
+			}
+		}
+
+		std::vector<GridMove> moves(ActorCount);
+		for( GridMove& move : moves )
+		{
+			do
+			{
+				move.from = { (int)(random() % Size), 0, (int)(random() % Size) };
+			} while( grid.IsBlocked(move.from) );
+			grid.SetFlags(move.from.x, 0, move.from.z, CellOccupied, true);
+		}
+
+		size_t movedCount = 0;
+		double totalMs = 0.0;
+		for( int turn = 0; turn < TurnCount; turn++ )
+		{
+			for( GridMove& move : moves )
+				move.direction = (GridDirection)(random() % (int)GridDirection::Count);
+			const auto begin = std::chrono::steady_clock::now();
+			movedCount += grid.ResolveMoves(moves.data(), moves.size());
+			totalMs += benchmarkElapsedMs(begin);
+			for( GridMove& move : moves )
+				move.from = move.result;
+		}
+
+		// каждый актер в своей клетке, ни один не стоит в стене
+		std::vector<uint8_t> occupied((size_t)Size * Size, 0);
+		bool isValid = true;
+		for( const GridMove& move : moves )
+		{
+			uint8_t& cell = occupied[(size_t)move.from.z * Size + move.from.x];
+			isValid = isValid && cell == 0 && !grid.IsSolid(move.from.x, 0, move.from.z) && grid.HasFlags(move.from.x, 0, move.from.z, CellOccupied);
+			cell = 1;
+		}
+		consoleCheck(isValid, "DungeonGrid ResolveMoves keeps actors apart");
+		consoleOkLog("DungeonGrid 10000 actors x 100 turns: " + std::to_string(totalMs) + " ms, " + std::to_string(totalMs * 1000000.0 / (ActorCount * TurnCount)) + " ns per move, moved "
+			+ std::to_string(movedCount));
+	}
+
+	//-------------------------------------------------------------------------
+	// видимость: 100k запросов на карте 256x256
+	//-------------------------------------------------------------------------
+	{
+		constexpr int Size = 256;
+		constexpr size_t MonsterCount = 100000;
+		DungeonGrid grid;
+		grid.Create(Size, 2, Size);
+		std::mt19937 random(9);
+		for( int z = 0; z < Size; z++ )
+		{
+			for( int x = 0; x < Size; x++ )
+			{
+				if( random() % 10 == 0 )
+					grid.SetCell(x, 0, z, 1);
+			}
+		}
+		grid.SetCell(10, 0, 10, 0);
+		grid.SetCell(11, 0, 10, 1);
+		grid.SetCell(12, 0, 10, 0);
+		consoleCheck(!grid.HasLineOfSight(Vector3(10.0f, 0.0f, 10.0f), Vector3(12.0f, 0.0f, 10.0f)), "DungeonGrid wall blocks line of sight");
+		consoleCheck(grid.HasLineOfSight(Vector3(10.0f, 1.0f, 10.0f), Vector3(12.0f, 1.0f, 10.0f)), "DungeonGrid line of sight above wall");
+
+		GridRayHit hit;
+		consoleCheck(grid.Raycast(Ray(Vector3(10.0f, 0.0f, 10.0f), Vector3(1.0f, 0.0f, 0.0f)), 100.0f, hit) && hit.cell[0] == 11 && hit.cell[1] == 0 && hit.cell[2] == 10, "DungeonGrid Raycast");
+
+		// монстры в пределах 32 клеток от игрока
+		const Vector3 player(128.0f, 0.0f, 128.0f);
+		grid.SetCell(128, 0, 128, 0);
+		std::uniform_real_distribution<float> offset(-32.0f, 32.0f);
+		std::vector<Vector3> monsters(MonsterCount);
+		for( Vector3& monster : monsters )
+			monster = player + Vector3(roundf(offset(random)), 0.0f, roundf(offset(random)));
+
+		std::vector<uint8_t> visible(MonsterCount);
+		const auto begin = std::chrono::steady_clock::now();
+		const size_t visibleCount = grid.HasLineOfSight(player, monsters.data(), monsters.size(), visible.data());
+		const double losMs = benchmarkElapsedMs(begin);
+
+		bool isEqual = true;
+		for( size_t i = 0; i < MonsterCount; i += 97 )
+			isEqual = isEqual && (visible[i] != 0) == grid.HasLineOfSight(player, monsters[i]);
+		consoleCheck(isEqual, "DungeonGrid batch line of sight == single");
+		consoleOkLog("DungeonGrid 100000 line of sight queries: " + std::to_string(losMs) + " ms, " + std::to_string(losMs * 1000000.0 / MonsterCount) + " ns per query, visible "
+			+ std::to_string(visibleCount));
+	}
+}
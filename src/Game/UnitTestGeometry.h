@@ -0,0 +1,587 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <random>
+void consoleOkLog(const std::string& msg);
+void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
+
+#include "MicroGeometry.h"
+#include <tiny_obj_loader.h>
+
+inline double benchmarkElapsedMs(std::chrono::steady_clock::time_point begin)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// треугольники OBJ файла без создания GPU ресурсов (по 3 вершины на треугольник)
+inline std::vector<Vector3> loadObjTriangles(const char* fileName)
+{
+	std::vector<Vector3> triangles;
+	tinyobj::ObjReaderConfig readerConfig;
+	readerConfig.triangulate = true;
+	tinyobj::ObjReader reader;
+	if( !reader.ParseFromFile(fileName, readerConfig) )
+		return triangles;
+
+	const auto& attributes = reader.GetAttrib();
+	for( const auto& shape : reader.GetShapes() )
+	{
+		for( const auto& index : shape.mesh.indices )
+		{
+			const size_t i = 3 * (size_t)index.vertex_index;
+			triangles.push_back({ attributes.vertices[i + 0], attributes.vertices[i + 1], attributes.vertices[i + 2] });
+		}
+	}
+	return triangles;
+}
+
+void RunUnitTestGeometry()
+{
+	consoleOkLog("==> GEOMETRY TEST Enable");
+
+	//-------------------------------------------------------------------------
+	// Frustum
+	//-------------------------------------------------------------------------
+	{
+		// камера в начале координат смотрит вдоль +Z
+		const Frustum frustum(Matrix4::Perspective(60.0f * DEG2RAD, 1.0f, 0.1f, 100.0f));
+
+		consoleCheck(frustum.IsInside(Vector3(0.0f, 0.0f, 10.0f)) == INSIDE, "Frustum point inside");
+		consoleCheck(frustum.IsInside(Vector3(0.0f, 0.0f, -10.0f)) == OUTSIDE, "Frustum point behind");
+		consoleCheck(frustum.IsInside(AABB(Vector3(0.0f, 0.0f, 10.0f), 1.0f)) == INSIDE, "Frustum AABB inside");
+		consoleCheck(frustum.IsInside(AABB(Vector3(0.0f, 0.0f, -10.0f), 1.0f)) == OUTSIDE, "Frustum AABB behind");
+		consoleCheck(frustum.IsInside(AABB(Vector3(0.0f, 0.0f, 100.0f), 1.0f)) == INTERSECTS, "Frustum AABB on far plane");
+		consoleCheck(frustum.IsInside(AABB(Vector3(50.0f, 0.0f, 10.0f), 1.0f)) == OUTSIDE, "Frustum AABB right");
+		consoleCheck(frustum.IsInside(Sphere(Vector3(0.0f, 0.0f, 10.0f), 1.0f)) == INSIDE, "Frustum sphere inside");
+		consoleCheck(frustum.IsInside(Sphere(Vector3(0.0f, 0.0f, 0.0f), 1.0f)) == INTERSECTS, "Frustum sphere on near plane");
+		consoleCheck(frustum.IsInside(Sphere(Vector3(0.0f, -50.0f, 10.0f), 1.0f)) == OUTSIDE, "Frustum sphere below");
+
+		// пакетное отсечение должно совпадать со скалярным
+		constexpr size_t BoxCount = 100000;
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> extent(0.25f, 2.5f);
+		AABBArraySoA boxes;
+		boxes.Reserve(BoxCount);
+		for( size_t i = 0; i < BoxCount; i++ )
+		{
+			const Vector3 center(position(random), position(random), position(random));
+			const Vector3 halfSize(extent(random), extent(random), extent(random));
+			boxes.Add({ center - halfSize, center + halfSize });
+		}
+
+		std::vector<uint32_t> visibleScalar;
+		std::vector<uint32_t> visibleBatch;
+		visibleScalar.reserve(BoxCount);
+
+		constexpr int Iterations = 20;
+		auto begin = std::chrono::steady_clock::now();
+		for( int it = 0; it < Iterations; it++ )
+		{
+			visibleScalar.clear();
+			for( size_t i = 0; i < BoxCount; i++ )
+			{
+				if( frustum.IsVisible(boxes.Get(i)) )
+					visibleScalar.push_back((uint32_t)i);
+			}
+		}
+		const double scalarMs = benchmarkElapsedMs(begin) / Iterations;
+
+		begin = std::chrono::steady_clock::now();
+		for( int it = 0; it < Iterations; it++ )
+			frustum.CullAABBs(boxes, visibleBatch);
+		const double batchMs = benchmarkElapsedMs(begin) / Iterations;
+
+		consoleCheck(visibleScalar == visibleBatch, "Frustum::CullAABBs == scalar IsVisible");
+		consoleOkLog("Frustum cull 100k AABB: scalar " + std::to_string(scalarMs) + " ms, batch " + std::to_string(batchMs) + " ms, visible " + std::to_string(visibleBatch.size()));
+	}
+
+	//-------------------------------------------------------------------------
+	// BVH
+	//-------------------------------------------------------------------------
+	{
+		// рельеф 160x160 клеток (51200 треугольников) и случайные наклонные треугольники
+		constexpr int GridSize = 160;
+		std::mt19937 random(4321);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		auto height = [](float x, float z) { return sinf(x * 0.15f) * 3.0f + cosf(z * 0.11f) * 2.0f; };
+		std::vector<Vector3> vertices;
+		for( int z = 0; z < GridSize; z++ )
+		{
+			for( int x = 0; x < GridSize; x++ )
+			{
+				const Vector3 p00((float)x, height((float)x, (float)z), (float)z);
+				const Vector3 p10((float)x + 1, height((float)x + 1, (float)z), (float)z);
+				const Vector3 p01((float)x, height((float)x, (float)z + 1), (float)z + 1);
+				const Vector3 p11((float)x + 1, height((float)x + 1, (float)z + 1), (float)z + 1);
+				vertices.insert(vertices.end(), { p00, p10, p11, p00, p11, p01 });
+			}
+		}
+		for( int i = 0; i < 2000; i++ )
+		{
+			const Vector3 base(unit(random) * GridSize, unit(random) * 6.0f, unit(random) * GridSize);
+			vertices.insert(vertices.end(), { base, base + Vector3(unit(random), 2.0f, 0.0f), base + Vector3(0.0f, unit(random), 1.5f) });
+		}
+		const size_t triangleCount = vertices.size() / 3;
+
+		auto begin = std::chrono::steady_clock::now();
+		BVH bvh;
+		bvh.Build(vertices);
+		const double buildMs = benchmarkElapsedMs(begin);
+		consoleCheck(bvh.IsValid() && bvh.GetTriangleCount() == triangleCount, "BVH build");
+
+		auto triangleMin = [&](size_t t) { return Min(Min(vertices[t * 3], vertices[t * 3 + 1]), vertices[t * 3 + 2]); };
+		auto triangleMax = [&](size_t t) { return Max(Max(vertices[t * 3], vertices[t * 3 + 1]), vertices[t * 3 + 2]); };
+
+		// эллипсоид персонажа, движущийся над рельефом
+		constexpr int QueryCount = 2000;
+		const Vector3 radius(0.5f, 2.0f, 0.5f);
+		std::vector<Vector3> centers(QueryCount), velocities(QueryCount);
+		for( int i = 0; i < QueryCount; i++ )
+		{
+			centers[i] = Vector3(unit(random) * GridSize, unit(random) * 4.0f, unit(random) * GridSize);
+			velocities[i] = Vector3(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f) * 2.0f;
+		}
+
+		std::vector<uint32_t> bruteResult, bvhResult;
+		bool isAABBEqual = true;
+		bool isSweepEqual = true;
+		size_t candidateCount = 0;
+		for( int i = 0; i < QueryCount; i++ )
+		{
+			const AABB box(centers[i] - radius, centers[i] + radius);
+			bruteResult.clear();
+			for( size_t t = 0; t < triangleCount; t++ )
+			{
+				if( box.Overlaps(AABB(triangleMin(t), triangleMax(t))) )
+					bruteResult.push_back((uint32_t)t);
+			}
+			bvh.QueryAABB(box, bvhResult);
+			std::sort(bvhResult.begin(), bvhResult.end());
+			isAABBEqual = isAABBEqual && bruteResult == bvhResult;
+
+			bruteResult.clear();
+			for( size_t t = 0; t < triangleCount; t++ )
+			{
+				if( SegmentAABBIntersect(centers[i], velocities[i], 0.0f, 1.0f, triangleMin(t) - radius, triangleMax(t) + radius) )
+					bruteResult.push_back((uint32_t)t);
+			}
+			bvh.QueryEllipsoidSweep(centers[i], radius, velocities[i], bvhResult);
+			std::sort(bvhResult.begin(), bvhResult.end());
+			isSweepEqual = isSweepEqual && bruteResult == bvhResult;
+			candidateCount += bvhResult.size();
+		}
+		consoleCheck(isAABBEqual, "BVH::QueryAABB == brute force");
+		consoleCheck(isSweepEqual, "BVH::QueryEllipsoidSweep == brute force");
+
+		// лучи сверху вниз и под углом
+		bool isRayEqual = true;
+		for( int i = 0; i < QueryCount; i++ )
+		{
+			const Ray ray(centers[i] + Vector3(0.0f, 10.0f, 0.0f), Vector3(velocities[i].x, -1.0f, velocities[i].z));
+			float bruteDistance = INFINITY;
+			for( size_t t = 0; t < triangleCount; t++ )
+			{
+				float distance;
+				if( RayTriangleIntersect(ray, vertices[t * 3], vertices[t * 3 + 1], vertices[t * 3 + 2], distance) && distance < bruteDistance )
+					bruteDistance = distance;
+			}
+			float bvhDistance = INFINITY;
+			uint32_t triangle = 0;
+			const bool isHit = bvh.RayCast(ray, 1000.0f, bvhDistance, triangle);
+			isRayEqual = isRayEqual && isHit == (bruteDistance != INFINITY) && (!isHit || bvhDistance == bruteDistance);
+		}
+		consoleCheck(isRayEqual, "BVH::RayCast == brute force");
+
+		// производительность: поиск кандидатов для эллипсоида перебором и через BVH
+		begin = std::chrono::steady_clock::now();
+		size_t bruteCount = 0;
+		for( int i = 0; i < QueryCount; i++ )
+		{
+			for( size_t t = 0; t < triangleCount; t++ )
+			{
+				if( SegmentAABBIntersect(centers[i], velocities[i], 0.0f, 1.0f, triangleMin(t) - radius, triangleMax(t) + radius) )
+					bruteCount++;
+			}
+		}
+		const double bruteMs = benchmarkElapsedMs(begin);
+
+		begin = std::chrono::steady_clock::now();
+		size_t bvhCount = 0;
+		for( int i = 0; i < QueryCount; i++ )
+			bvhCount += bvh.QueryEllipsoidSweep(centers[i], radius, velocities[i], bvhResult);
+		const double bvhMs = benchmarkElapsedMs(begin);
+
+		begin = std::chrono::steady_clock::now();
+		size_t rayHits = 0;
+		for( int i = 0; i < QueryCount; i++ )
+		{
+			float distance;
+			uint32_t triangle;
+			rayHits += bvh.RayCast(Ray(centers[i] + Vector3(0.0f, 10.0f, 0.0f), Vector3(velocities[i].x, -1.0f, velocities[i].z)), 1000.0f, distance, triangle) ? 1 : 0;
+		}
+		const double rayMs = benchmarkElapsedMs(begin);
+
+		consoleCheck(bruteCount == bvhCount, "BVH sweep count");
+		consoleOkLog("BVH " + std::to_string(triangleCount) + " triangles, " + std::to_string(bvh.GetNodes().size()) + " nodes, build " + std::to_string(buildMs) + " ms");
+		consoleOkLog("BVH 2000 ellipsoid sweeps: brute " + std::to_string(bruteMs) + " ms, bvh " + std::to_string(bvhMs) + " ms, candidates " + std::to_string(candidateCount) + "; 2000 rays " + std::to_string(rayMs) + " ms, hits " + std::to_string(rayHits));
+	}
+
+	//-------------------------------------------------------------------------
+	// Grid Raycast
+	//-------------------------------------------------------------------------
+	{
+		// случайные твердые клетки 16x4x16, эталон - ближайший вход луча в AABB твердой клетки
+		constexpr int SizeX = 16, SizeY = 4, SizeZ = 16;
+		std::mt19937 random(11);
+		std::vector<uint8_t> cells(SizeX * SizeY * SizeZ);
+		for( uint8_t& cell : cells )
+			cell = random() % 8 == 0 ? 1 : 0;
+		auto isSolid = [&](int x, int y, int z) { return cells[((size_t)z * SizeY + y) * SizeX + x] != 0; };
+		const AABB bounds(Vector3(-0.5f), Vector3((float)SizeX, (float)SizeY, (float)SizeZ) - 0.5f);
+
+		std::uniform_real_distribution<float> coordinate(-3.0f, 18.0f);
+		bool isEqual = true;
+		bool isNormalValid = true;
+		for( int i = 0; i < 2000; i++ )
+		{
+			const Vector3 from(coordinate(random), coordinate(random) * 0.25f, coordinate(random));
+			const Vector3 to(coordinate(random), coordinate(random) * 0.25f, coordinate(random));
+			const Ray ray(from, to - from);
+
+			float referenceDistance = std::numeric_limits<float>::max();
+			for( int z = 0; z < SizeZ; z++ )
+			{
+				for( int y = 0; y < SizeY; y++ )
+				{
+					for( int x = 0; x < SizeX; x++ )
+					{
+						float tMin = 0.0f, tMax = 1.0f;
+						const Vector3 center((float)x, (float)y, (float)z);
+						if( isSolid(x, y, z) && SegmentAABBClip(ray.origin, ray.direction, tMin, tMax, center - 0.5f, center + 0.5f) )
+							referenceDistance = Min(referenceDistance, tMin);
+					}
+				}
+			}
+
+			GridRayHit hit;
+			const bool isHit = GridRaycast(ray, 1.0f, bounds, isSolid, hit);
+			const bool isReferenceHit = referenceDistance <= 1.0f;
+			isEqual = isEqual && isHit == isReferenceHit && (!isHit || (fabsf(hit.distance - referenceDistance) < 1e-4f && isSolid(hit.cell[0], hit.cell[1], hit.cell[2])));
+			isEqual = isEqual && GridLineOfSight(from, to, bounds, isSolid) == !isReferenceHit;
+			// луч входит через грань, обращенную к нему
+			isNormalValid = isNormalValid && (!isHit || hit.distance == 0.0f || DotProduct(hit.normal, ray.direction) < 0.0f);
+		}
+		consoleCheck(isEqual, "GridRaycast == brute force");
+		consoleCheck(isNormalValid, "GridRaycast hit normal");
+
+		GridRayHit hit;
+		cells.assign(cells.size(), 0);
+		cells[((size_t)3 * SizeY + 1) * SizeX + 9] = 1;
+		consoleCheck(GridRaycast(Ray(Vector3(0.0f, 1.0f, 3.0f), Vector3(1.0f, 0.0f, 0.0f)), 100.0f, bounds, isSolid, hit) && hit.cell[0] == 9 && fabsf(hit.distance - 8.5f) < 1e-5f
+			&& hit.normal == Vector3(-1.0f, 0.0f, 0.0f), "GridRaycast axis-aligned ray");
+		consoleCheck(!GridRaycast(Ray(Vector3(0.0f, 1.0f, 3.0f), Vector3(1.0f, 0.0f, 0.0f)), 8.0f, bounds, isSolid, hit), "GridRaycast maxDistance");
+		consoleCheck(!GridRaycast(Ray(Vector3(-10.0f, 1.0f, 3.0f), Vector3(-1.0f, 0.0f, 0.0f)), 1000.0f, bounds, isSolid, hit), "GridRaycast ray away from grid");
+	}
+
+	//-------------------------------------------------------------------------
+	// Dynamic AABB Tree
+	//-------------------------------------------------------------------------
+	{
+		std::mt19937 random(17);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> extent(0.2f, 2.0f);
+		std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+		auto randomAABB = [&](const Vector3& center) { const Vector3 half(extent(random), extent(random), extent(random)); return AABB(center - half, center + half); };
+
+		constexpr uint32_t ProxyCount = 2000;
+		DynamicAABBTree tree;
+		std::vector<uint32_t> proxies;
+		std::vector<AABB> boxes;
+		for( uint32_t i = 0; i < ProxyCount; i++ )
+		{
+			boxes.push_back(randomAABB(Vector3(position(random), position(random), position(random))));
+			proxies.push_back(tree.CreateProxy(boxes.back(), i));
+		}
+		bool isValid = tree.Validate() && tree.GetProxyCount() == ProxyCount;
+
+		// удаление каждого третьего и повторное создание, затем случайные перемещения
+		for( uint32_t i = 0; i < ProxyCount; i += 3 )
+		{
+			tree.DestroyProxy(proxies[i]);
+			proxies[i] = tree.CreateProxy(boxes[i], i);
+		}
+		std::vector<ProxyPair> pairs;
+		tree.UpdatePairs(pairs);
+		for( int frame = 0; frame < 10; frame++ )
+		{
+			for( uint32_t i = 0; i < ProxyCount; i++ )
+			{
+				const Vector3 displacement(step(random), step(random), step(random));
+				boxes[i] = AABB(boxes[i].min + displacement, boxes[i].max + displacement);
+				tree.MoveProxy(proxies[i], boxes[i], displacement);
+			}
+			isValid = isValid && tree.Validate();
+		}
+		isValid = isValid && tree.GetProxyCount() == ProxyCount && tree.GetUserData(proxies[5]) == 5;
+		consoleCheck(isValid, "DynamicAABBTree Validate after create/destroy/move");
+		bool isContained = true;
+		for( uint32_t i = 0; i < ProxyCount; i++ )
+			isContained = isContained && tree.GetFatAABB(proxies[i]).Contains(boxes[i]);
+		consoleCheck(isContained, "DynamicAABBTree fat AABB contains object");
+
+		// запрос == перебор по расширенным AABB
+		std::vector<uint32_t> found;
+		bool isQueryEqual = true;
+		for( int q = 0; q < 100; q++ )
+		{
+			const AABB query = randomAABB(Vector3(position(random), position(random), position(random)));
+			tree.Query(AABB(query.min - 5.0f, query.max + 5.0f), found);
+			std::vector<uint32_t> reference;
+			for( uint32_t i = 0; i < ProxyCount; i++ )
+			{
+				if( tree.GetFatAABB(proxies[i]).Overlaps(AABB(query.min - 5.0f, query.max + 5.0f)) )
+					reference.push_back(proxies[i]);
+			}
+			std::sort(found.begin(), found.end());
+			std::sort(reference.begin(), reference.end());
+			isQueryEqual = isQueryEqual && found == reference;
+		}
+		consoleCheck(isQueryEqual, "DynamicAABBTree Query == brute force");
+
+		auto pairKey = [](const ProxyPair& pair) { return ((uint64_t)pair.proxyA << 32) | pair.proxyB; };
+		std::vector<uint64_t> treePairs;
+		tree.QueryAllPairs(pairs);
+		for( const ProxyPair& pair : pairs )
+			treePairs.push_back(pairKey(pair));
+		std::vector<uint64_t> referencePairs;
+		for( uint32_t i = 0; i < ProxyCount; i++ )
+		{
+			for( uint32_t j = i + 1; j < ProxyCount; j++ )
+			{
+				if( tree.GetFatAABB(proxies[i]).Overlaps(tree.GetFatAABB(proxies[j])) )
+					referencePairs.push_back(pairKey({ std::min(proxies[i], proxies[j]), std::max(proxies[i], proxies[j]) }));
+			}
+		}
+		std::sort(treePairs.begin(), treePairs.end());
+		std::sort(referencePairs.begin(), referencePairs.end());
+		consoleCheck(treePairs == referencePairs, "DynamicAABBTree QueryAllPairs == brute force");
+
+		// UpdatePairs: каждая пара с переставленным прокси ровно один раз
+		tree.UpdatePairs(pairs);
+		const Vector3 jump(50.0f, 0.0f, 0.0f);
+		boxes[7] = AABB(boxes[7].min + jump, boxes[7].max + jump);
+		consoleCheck(tree.MoveProxy(proxies[7], boxes[7], Vector3(0.0f)), "DynamicAABBTree MoveProxy reinserts");
+		tree.UpdatePairs(pairs);
+		std::vector<uint32_t> expected;
+		tree.Query(tree.GetFatAABB(proxies[7]), expected);
+		bool isUpdateEqual = pairs.size() + 1 == expected.size();
+		for( const ProxyPair& pair : pairs )
+			isUpdateEqual = isUpdateEqual && pair.proxyA < pair.proxyB && (pair.proxyA == proxies[7] || pair.proxyB == proxies[7]);
+		consoleCheck(isUpdateEqual, "DynamicAABBTree UpdatePairs moved proxy");
+		consoleCheck(tree.UpdatePairs(pairs) == 0, "DynamicAABBTree UpdatePairs clears move buffer");
+
+		// луч: ближайшее попадание по расширенным AABB == перебор
+		bool isRayEqual = true;
+		for( int r = 0; r < 100; r++ )
+		{
+			const Ray ray(Vector3(position(random), position(random), position(random)), Vector3(step(random), step(random), step(random)));
+			float treeDistance = 500.0f;
+			tree.RayCast(ray, 500.0f, [&](uint32_t proxy, float maxDistance)
+				{
+					float tMin = 0.0f, tMax = maxDistance;
+					const AABB& box = tree.GetFatAABB(proxy);
+					if( !SegmentAABBClip(ray.origin, ray.direction, tMin, tMax, box.min, box.max) ) return maxDistance;
+					treeDistance = Min(treeDistance, tMin);
+					return tMin > 0.0f ? tMin : 0.0f;
+				});
+			float referenceDistance = 500.0f;
+			for( uint32_t i = 0; i < ProxyCount; i++ )
+			{
+				float tMin = 0.0f, tMax = 500.0f;
+				const AABB& box = tree.GetFatAABB(proxies[i]);
+				if( SegmentAABBClip(ray.origin, ray.direction, tMin, tMax, box.min, box.max) )
+					referenceDistance = Min(referenceDistance, tMin);
+			}
+			isRayEqual = isRayEqual && (treeDistance == referenceDistance || referenceDistance == 0.0f);
+		}
+		consoleCheck(isRayEqual, "DynamicAABBTree RayCast == brute force");
+
+		// широкая фаза кадра: 5000 движущихся объектов, MoveProxy + UpdatePairs
+		constexpr uint32_t MoverCount = 5000;
+		constexpr int FrameCount = 100;
+		DynamicAABBTree movers;
+		std::vector<Vector3> centers(MoverCount), velocities(MoverCount);
+		std::vector<uint32_t> moverProxies(MoverCount);
+		const Vector3 half(0.5f);
+		for( uint32_t i = 0; i < MoverCount; i++ )
+		{
+			centers[i] = Vector3(position(random), 0.0f, position(random));
+			velocities[i] = Vector3(step(random), 0.0f, step(random)) * 0.1f; // до 3 м/с по оси при 60 кадрах в секунду
+			moverProxies[i] = movers.CreateProxy(AABB(centers[i] - half, centers[i] + half), i);
+		}
+		movers.UpdatePairs(pairs);
+		size_t reinsertCount = 0;
+		size_t pairCount = 0;
+		const auto begin = std::chrono::steady_clock::now();
+		for( int frame = 0; frame < FrameCount; frame++ )
+		{
+			for( uint32_t i = 0; i < MoverCount; i++ )
+			{
+				centers[i] = centers[i] + velocities[i];
+				reinsertCount += movers.MoveProxy(moverProxies[i], AABB(centers[i] - half, centers[i] + half), velocities[i]) ? 1 : 0;
+			}
+			pairCount += movers.UpdatePairs(pairs);
+		}
+		const double totalMs = benchmarkElapsedMs(begin);
+		consoleCheck(movers.Validate(), "DynamicAABBTree movers Validate");
+		consoleOkLog("DynamicAABBTree " + std::to_string(MoverCount) + " movers x " + std::to_string(FrameCount) + " frames: " + std::to_string(totalMs / FrameCount) + " ms per frame, height "
+			+ std::to_string(movers.GetHeight()) + ", reinserts " + std::to_string(reinsertCount / FrameCount) + " per frame, new pairs " + std::to_string(pairCount / FrameCount) + " per frame");
+	}
+
+	//-------------------------------------------------------------------------
+	// Convex Hull
+	//-------------------------------------------------------------------------
+	{
+		std::mt19937 random(9);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		// углы куба и точки внутри
+		std::vector<Vector3> cube;
+		for( int i = 0; i < 8; i++ )
+			cube.push_back(Vector3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+		for( int i = 0; i < 500; i++ )
+			cube.push_back(Vector3(unit(random), unit(random), unit(random)) * 0.99f);
+		ConvexHull hull;
+		consoleCheck(hull.Build(cube) && hull.vertices.size() == 8 && hull.indices.size() == 36 && hull.planes.size() == 6 && hull.GetError() == 0.0f, "ConvexHull cube");
+		consoleCheck(hull.GetSupport(Vector3(1.0f, -2.0f, 3.0f)) == Vector3(1.0f, -1.0f, 1.0f), "ConvexHull GetSupport");
+		consoleCheck(hull.Contains(Vector3(0.5f)) && !hull.Contains(Vector3(1.1f, 0.0f, 0.0f)), "ConvexHull Contains");
+
+		const std::vector<Vector3> flat = { Vector3(0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(1.0f, 0.0f, 1.0f), Vector3(0.5f, 0.0f, 0.5f) };
+		consoleCheck(!hull.Build(flat) && !hull.IsValid(), "ConvexHull flat points");
+
+		// облако точек: все точки внутри, оболочка выпуклая и замкнутая (V - E + F = 2)
+		std::vector<Vector3> cloud(5000);
+		for( Vector3& point : cloud )
+			point = Vector3(unit(random) * 3.0f, unit(random), unit(random) * 2.0f);
+		bool isHullValid = hull.Build(cloud);
+		const float tolerance = 1e-5f;
+		for( const Vector3& point : cloud )
+			isHullValid = isHullValid && hull.Contains(point, tolerance);
+		for( const Vector3& vertex : hull.vertices )
+			isHullValid = isHullValid && std::find(cloud.begin(), cloud.end(), vertex) != cloud.end();
+		const size_t triangleCount = hull.indices.size() / 3;
+		isHullValid = isHullValid && (int)hull.vertices.size() - (int)(triangleCount * 3 / 2) + (int)triangleCount == 2;
+		consoleCheck(isHullValid, "ConvexHull point cloud (" + std::to_string(hull.vertices.size()) + " vertices)");
+
+		// бюджет вершин: оболочка внутри полной, точки снаружи не дальше GetError
+		bool isBudgetValid = hull.Build(cloud, 16) && hull.vertices.size() <= 16 && hull.GetError() > 0.0f;
+		for( const Vector3& point : cloud )
+			isBudgetValid = isBudgetValid && hull.Contains(point, hull.GetError() + tolerance);
+		consoleCheck(isBudgetValid, "ConvexHull vertex budget, error " + std::to_string(hull.GetError()));
+
+		for( const char* fileName : { "../data/mesh/crate.obj", "../data/mesh/rock.obj" } )
+		{
+			const std::vector<Vector3> triangles = loadObjTriangles(fileName);
+			if( triangles.empty() )
+			{
+				consoleErrorLog(std::string(fileName) + " not found, ConvexHull skipped");
+				continue;
+			}
+			ConvexHull full, simplified;
+			consoleCheck(full.Build(triangles) && simplified.Build(triangles, 24), std::string("ConvexHull ") + fileName);
+			consoleOkLog(std::string("ConvexHull ") + fileName + ": " + std::to_string(triangles.size() / 3) + " triangles -> " + std::to_string(full.planes.size()) + " planes; 24 vertices -> "
+				+ std::to_string(simplified.planes.size()) + " planes, error " + std::to_string(simplified.GetError()));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// Ray Packet
+	//-------------------------------------------------------------------------
+	{
+		// пакет против одного треугольника == скалярный Moller-Trumbore
+		std::mt19937 random(21);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		bool isTriangleEqual = true;
+		for( int i = 0; i < 1000; i++ )
+		{
+			const Vector3 v0(unit(random), unit(random), 2.0f + unit(random));
+			const Vector3 v1(unit(random), unit(random), 2.0f + unit(random));
+			const Vector3 v2(unit(random), unit(random), 2.0f + unit(random));
+			RayPacket packet;
+			for( size_t j = 0; j < RayPacket::MaxSize - 1; j++ ) // последний слот пустой
+				packet.Add(Ray(Vector3(unit(random), unit(random), -1.0f), Vector3(unit(random) * 0.3f, unit(random) * 0.3f, 1.0f)), 100.0f);
+			RayTriangleIntersect(packet, v0, v1, v2, 7);
+			for( size_t j = 0; j < RayPacket::MaxSize - 1; j++ )
+			{
+				float distance = 0.0f;
+				const bool isHit = RayTriangleIntersect(packet.GetRay(j), v0, v1, v2, distance);
+				isTriangleEqual = isTriangleEqual && isHit == packet.IsHit(j) && (!isHit || (packet.triangle[j] == 7 && fabsf(packet.distance[j] - distance) < 1e-5f));
+			}
+			isTriangleEqual = isTriangleEqual && !packet.IsHit(RayPacket::MaxSize - 1);
+		}
+		consoleCheck(isTriangleEqual, "RayPacket triangle == scalar");
+
+		const std::vector<Vector3> level = loadObjTriangles("../data/mesh/map.obj");
+		if( level.empty() )
+		{
+			consoleErrorLog("map.obj not found, RayPacket benchmark skipped");
+			return;
+		}
+		BVH bvh;
+		bvh.Build(level);
+		const AABB bounds = bvh.GetBounds();
+
+		// камера в центре уровня: 512x512 лучей, пакет - 8 соседних пикселей строки
+		constexpr int Resolution = 512;
+		const Vector3 eye = bounds.GetCenter();
+		std::vector<Ray> rays;
+		rays.reserve(Resolution * Resolution);
+		for( int y = 0; y < Resolution; y++ )
+		{
+			for( int x = 0; x < Resolution; x++ )
+			{
+				const float u = ((float)x + 0.5f) / Resolution * 2.0f - 1.0f;
+				const float v = ((float)y + 0.5f) / Resolution * 2.0f - 1.0f;
+				rays.push_back(Ray(eye, Vector3(u, v * 0.75f, -1.0f)));
+			}
+		}
+		constexpr float MaxDistance = 1000.0f;
+
+		std::vector<float> singleDistances(rays.size());
+		std::vector<uint32_t> singleTriangles(rays.size());
+		auto begin = std::chrono::steady_clock::now();
+		for( size_t i = 0; i < rays.size(); i++ )
+		{
+			singleTriangles[i] = RayPacket::NoHit;
+			if( !bvh.RayCast(rays[i], MaxDistance, singleDistances[i], singleTriangles[i]) )
+				singleTriangles[i] = RayPacket::NoHit;
+		}
+		const double singleMs = benchmarkElapsedMs(begin);
+
+		std::vector<RayPacket> packets(rays.size() / RayPacket::MaxSize);
+		for( size_t i = 0; i < rays.size(); i++ )
+			packets[i / RayPacket::MaxSize].Add(rays[i], MaxDistance);
+		begin = std::chrono::steady_clock::now();
+		for( RayPacket& packet : packets )
+			bvh.RayCast(packet);
+		const double packetMs = benchmarkElapsedMs(begin);
+
+		bool isEqual = true;
+		size_t hitCount = 0;
+		for( size_t i = 0; i < rays.size(); i++ )
+		{
+			const RayPacket& packet = packets[i / RayPacket::MaxSize];
+			const size_t j = i % RayPacket::MaxSize;
+			const bool isSingleHit = singleTriangles[i] != RayPacket::NoHit;
+			isEqual = isEqual && packet.IsHit(j) == isSingleHit && (!isSingleHit || fabsf(packet.distance[j] - singleDistances[i]) < 1e-4f);
+			hitCount += isSingleHit ? 1 : 0;
+		}
+		consoleCheck(isEqual, "BVH RayPacket == single rays");
+		const double rayCount = (double)rays.size();
+		consoleOkLog("BVH map.obj " + std::to_string(level.size() / 3) + " triangles, " + std::to_string((int)rayCount) + " primary rays: single " + std::to_string(rayCount / singleMs / 1000.0)
+			+ " Mrays/s, packet " + std::to_string(rayCount / packetMs / 1000.0) + " Mrays/s, hits " + std::to_string(hitCount));
+	}
+}
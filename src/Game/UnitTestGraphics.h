@@ -0,0 +1,320 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+void consoleOkLog(const std::string& msg);
+void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
+
+#include "MicroGraphics.h"
+#include "UnitTestGeometry.h" // benchmarkElapsedMs
+#include <tiny_obj_loader.h>
+
+// прежний хеш Model::loadObjFile (только position и texCoord) - для сравнения в бенчмарке
+struct legacyVertexMeshHash
+{
+	static void combine(size_t& seed, size_t hash)
+	{
+		hash += 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= hash;
+	}
+	size_t operator()(const VertexMesh& vertex) const
+	{
+		std::hash<float> hasher;
+		size_t position = 0;
+		combine(position, hasher(vertex.position.x));
+		combine(position, hasher(vertex.position.y));
+		combine(position, hasher(vertex.position.z));
+		size_t texCoord = 0;
+		combine(texCoord, hasher(vertex.texCoord.x));
+		combine(texCoord, hasher(vertex.texCoord.y));
+		return (position ^ (texCoord << 1)) >> 1;
+	}
+};
+
+// вершины OBJ файла в порядке граней, как их перебирает Model::loadObjFile
+inline bool loadObjFaceVertices(const char* fileName, std::vector<VertexMesh>& outVertices, std::vector<uint32_t>& outMaterials, size_t& outMaterialCount, size_t& outPositionCount)
+{
+	tinyobj::ObjReaderConfig readerConfig;
+	readerConfig.triangulate = true;
+	readerConfig.mtl_search_path = "../data/mesh/";
+	tinyobj::ObjReader reader;
+	if( !reader.ParseFromFile(fileName, readerConfig) )
+		return false;
+
+	const auto& attributes = reader.GetAttrib();
+	outMaterialCount = std::max<size_t>(reader.GetMaterials().size(), 1);
+	outPositionCount = attributes.vertices.size() / 3;
+	for( const auto& shape : reader.GetShapes() )
+	{
+		for( size_t i = 0; i < shape.mesh.indices.size(); i++ )
+		{
+			const tinyobj::index_t& index = shape.mesh.indices[i];
+			VertexMesh vertex;
+			vertex.position = { attributes.vertices[3 * (size_t)index.vertex_index + 0], attributes.vertices[3 * (size_t)index.vertex_index + 1], attributes.vertices[3 * (size_t)index.vertex_index + 2] };
+			if( index.normal_index >= 0 )
+				vertex.normal = { attributes.normals[3 * (size_t)index.normal_index + 0], attributes.normals[3 * (size_t)index.normal_index + 1], attributes.normals[3 * (size_t)index.normal_index + 2] };
+			if( index.texcoord_index >= 0 )
+				vertex.texCoord = { attributes.texcoords[2 * (size_t)index.texcoord_index + 0], attributes.texcoords[2 * (size_t)index.texcoord_index + 1] };
+			vertex.color = { attributes.colors[3 * (size_t)index.vertex_index + 0], attributes.colors[3 * (size_t)index.vertex_index + 1], attributes.colors[3 * (size_t)index.vertex_index + 2] };
+			outVertices.push_back(vertex);
+
+			const int material = shape.mesh.material_ids[i / 3];
+			outMaterials.push_back(material < 0 ? 0u : (uint32_t)material);
+		}
+	}
+	return true;
+}
+
+// сетка width x depth квадов по 2 треугольника в плоскости XZ, вершины по строкам
+inline void makeGridMesh(int width, int depth, std::vector<VertexMesh>& outVertices, std::vector<uint32_t>& outIndices)
+{
+	for( int z = 0; z <= depth; z++ )
+	{
+		for( int x = 0; x <= width; x++ )
+		{
+			VertexMesh vertex;
+			vertex.position = Vector3((float)x, 0.0f, (float)z);
+			vertex.normal = Vector3(0.0f, 1.0f, 0.0f);
+			outVertices.push_back(vertex);
+		}
+	}
+	for( int z = 0; z < depth; z++ )
+	{
+		for( int x = 0; x < width; x++ )
+		{
+			const uint32_t a = (uint32_t)(z * (width + 1) + x);
+			const uint32_t c = a + (uint32_t)width + 1;
+			outIndices.insert(outIndices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+		}
+	}
+}
+
+// треугольники как тройки позиций (порядок вершин внутри треугольника сохраняется), отсортированные
+inline std::vector<std::array<float, 9>> getSortedTriangles(const std::vector<VertexMesh>& vertices, const std::vector<uint32_t>& indices)
+{
+	std::vector<std::array<float, 9>> triangles(indices.size() / 3);
+	for( size_t t = 0; t < triangles.size(); t++ )
+	{
+		for( int k = 0; k < 3; k++ )
+		{
+			const Vector3& position = vertices[indices[t * 3 + k]].position;
+			triangles[t][k * 3 + 0] = position.x;
+			triangles[t][k * 3 + 1] = position.y;
+			triangles[t][k * 3 + 2] = position.z;
+		}
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+void RunUnitTestGraphics()
+{
+	consoleOkLog("==> GRAPHICS TEST Enable");
+
+	//-------------------------------------------------------------------------
+	// VertexMeshIndexMap
+	//-------------------------------------------------------------------------
+	{
+		VertexMeshIndexMap map;
+		std::vector<VertexMesh> group0, group1;
+
+		VertexMesh a;
+		a.position = Vector3(1.0f, 2.0f, 3.0f);
+		a.normal = Vector3(0.0f, 1.0f, 0.0f);
+		VertexMesh negativeZero = a;
+		negativeZero.normal.x = -0.0f;
+		VertexMesh otherNormal = a;
+		otherNormal.normal = Vector3(1.0f, 0.0f, 0.0f);
+
+		const uint32_t ia = map.GetOrAdd(0, a, group0);
+		consoleCheck(ia == 0 && map.GetOrAdd(0, a, group0) == 0 && group0.size() == 1, "VertexMeshIndexMap get existing");
+		consoleCheck(map.GetOrAdd(0, negativeZero, group0) == 0 && VertexMeshIndexMap::Hash(0, a) == VertexMeshIndexMap::Hash(0, negativeZero), "VertexMeshIndexMap -0 == 0");
+		consoleCheck(map.GetOrAdd(0, otherNormal, group0) == 1 && group0.size() == 2, "VertexMeshIndexMap normal is part of key");
+		consoleCheck(map.GetOrAdd(1, a, group1) == 0 && group1.size() == 1 && map.GetSize() == 3, "VertexMeshIndexMap groups");
+
+		// рост таблицы без Reserve: индексы сохраняются
+		map.Clear();
+		group0.clear();
+		bool isGrowValid = map.GetSize() == 0;
+		for( int pass = 0; pass < 2; pass++ )
+		{
+			for( uint32_t i = 0; i < 10000; i++ )
+			{
+				VertexMesh vertex;
+				vertex.position = Vector3((float)(i % 100), 0.0f, (float)(i / 100));
+				isGrowValid = isGrowValid && map.GetOrAdd(0, vertex, group0) == i;
+			}
+		}
+		consoleCheck(isGrowValid && group0.size() == 10000 && map.GetCapacity() >= 20000, "VertexMeshIndexMap grow");
+	}
+
+	//-------------------------------------------------------------------------
+	// Mesh Optimization
+	//-------------------------------------------------------------------------
+	{
+		// полоса 0-1-2, 1-3-2, 2-3-4, 3-5-4: в FIFO из 3 вершин каждая вершина загружается один раз
+		const std::vector<uint32_t> strip = { 0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4 };
+		const VertexCacheStatistics stripStatistics = AnalyzeVertexCache(strip.data(), strip.size(), 6, 3);
+		consoleCheck(stripStatistics.triangles == 4 && stripStatistics.vertices == 6 && stripStatistics.misses == 6
+			&& stripStatistics.GetACMR() == 1.5f && stripStatistics.GetATVR() == 1.0f, "AnalyzeVertexCache strip");
+		// повтор треугольника: в кэше из 3 вершин - попадания, из 2 - каждая вершина вытесняется до повторного использования
+		const std::vector<uint32_t> repeat = { 0, 1, 2, 0, 1, 2 };
+		consoleCheck(AnalyzeVertexCache(repeat.data(), repeat.size(), 3, 3).misses == 3 && AnalyzeVertexCache(repeat.data(), repeat.size(), 3, 2).misses == 6, "AnalyzeVertexCache eviction");
+
+		// перенумерация по первому использованию, неиспользуемые вершины удаляются
+		std::vector<VertexMesh> fetchVertices(10);
+		for( size_t i = 0; i < fetchVertices.size(); i++ )
+			fetchVertices[i].position = Vector3((float)i);
+		std::vector<uint32_t> fetchIndices = { 7, 5, 9, 5, 9, 7 };
+		OptimizeVertexFetch(fetchVertices, fetchIndices);
+		consoleCheck(fetchVertices.size() == 3 && fetchIndices == std::vector<uint32_t>({ 0, 1, 2, 1, 2, 0 })
+			&& fetchVertices[0].position.x == 7.0f && fetchVertices[1].position.x == 5.0f && fetchVertices[2].position.x == 9.0f, "OptimizeVertexFetch");
+
+		// сетка по порядку и с перемешанными треугольниками (с неиспользуемой вершиной)
+		std::mt19937 random(24);
+		for( int pass = 0; pass < 2; pass++ )
+		{
+			std::vector<VertexMesh> vertices;
+			std::vector<uint32_t> indices;
+			makeGridMesh(40, 30, vertices, indices);
+			if( pass == 1 )
+			{
+				std::vector<uint32_t> order(indices.size() / 3);
+				for( uint32_t t = 0; t < order.size(); t++ ) order[t] = t;
+				std::shuffle(order.begin(), order.end(), random);
+				std::vector<uint32_t> shuffled;
+				for( const uint32_t t : order )
+					shuffled.insert(shuffled.end(), { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] });
+				indices = shuffled;
+				vertices.push_back(VertexMesh());
+			}
+
+			const std::vector<std::array<float, 9>> trianglesBefore = getSortedTriangles(vertices, indices);
+			const MeshOptimizationStatistics statistics = OptimizeMesh(vertices, indices);
+
+			bool isIndexValid = true;
+			std::vector<uint8_t> used(vertices.size(), 0);
+			for( const uint32_t index : indices )
+			{
+				isIndexValid = isIndexValid && index < vertices.size();
+				if( index < vertices.size() ) used[index] = 1;
+			}
+			const std::string name = pass == 0 ? "grid" : "shuffled grid";
+			consoleCheck(getSortedTriangles(vertices, indices) == trianglesBefore, "OptimizeMesh keeps triangles, " + name);
+			consoleCheck(isIndexValid && std::find(used.begin(), used.end(), 0) == used.end() && vertices.size() == 41 * 31, "OptimizeMesh indices in range, all vertices used, " + name);
+			consoleCheck(statistics.after.GetACMR() <= statistics.before.GetACMR() && statistics.after.triangles == 40 * 30 * 2, "OptimizeMesh ACMR not worse, " + name);
+			consoleOkLog("OptimizeMesh " + name + ": ACMR " + std::to_string(statistics.before.GetACMR()) + " -> " + std::to_string(statistics.after.GetACMR())
+				+ ", ATVR " + std::to_string(statistics.before.GetATVR()) + " -> " + std::to_string(statistics.after.GetATVR()));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// RadixSort == std::stable_sort
+	//-------------------------------------------------------------------------
+	{
+		std::mt19937_64 random(21);
+		const auto checkSort = [](std::vector<RadixSortEntry> entries) {
+			std::vector<RadixSortEntry> expected = entries;
+			std::stable_sort(expected.begin(), expected.end(), [](const RadixSortEntry& a, const RadixSortEntry& b) { return a.key < b.key; });
+			std::vector<RadixSortEntry> scratch(entries.size());
+			const RadixSortEntry* result = RadixSort(entries.data(), scratch.data(), entries.size());
+			for( size_t i = 0; i < expected.size(); i++ )
+			{
+				if( result[i].key != expected[i].key || result[i].item != expected[i].item )
+					return false;
+			}
+			return true;
+		};
+
+		// случайные ключи, мало различных значений - проверка устойчивости
+		std::vector<RadixSortEntry> entries(5000);
+		for( uint32_t i = 0; i < entries.size(); i++ )
+			entries[i] = { random(), i };
+		consoleCheck(checkSort(entries), "RadixSort random keys");
+		for( uint32_t i = 0; i < entries.size(); i++ )
+			entries[i] = { random() % 37, i };
+		consoleCheck(checkSort(entries), "RadixSort stable on equal keys");
+
+		// старшие байты общие (слой и флаг прозрачности), байт 2 общий в середине ключа - эти проходы пропускаются
+		for( uint32_t i = 0; i < entries.size(); i++ )
+			entries[i] = { 0x0300000000000000ull | (random() & 0x0000FFFFFF00FFFFull) | 0x0000000000AB0000ull, i };
+		consoleCheck(checkSort(entries), "RadixSort shared bytes skipped");
+
+		// все байты общие - ни одного прохода, результат на месте
+		for( uint32_t i = 0; i < entries.size(); i++ )
+			entries[i] = { 0x1234567890ABCDEFull, i };
+		std::vector<RadixSortEntry> scratch(entries.size());
+		consoleCheck(RadixSort(entries.data(), scratch.data(), entries.size()) == entries.data() && checkSort(entries), "RadixSort equal keys");
+		consoleCheck(checkSort({}) && checkSort({ { 5, 0 } }), "RadixSort empty and single");
+	}
+
+	//-------------------------------------------------------------------------
+	// загрузка OBJ: дедупликация вершин std::unordered_map (прежний хеш) против VertexMeshIndexMap
+	//-------------------------------------------------------------------------
+	{
+		for( const char* fileName : { "../data/mesh/eeew.obj", "../data/mesh/untitled.obj" } )
+		{
+			std::vector<VertexMesh> faceVertices;
+			std::vector<uint32_t> faceMaterials;
+			size_t materialCount = 0;
+			size_t positionCount = 0;
+			auto begin = std::chrono::steady_clock::now();
+			if( !loadObjFaceVertices(fileName, faceVertices, faceMaterials, materialCount, positionCount) )
+			{
+				consoleErrorLog(std::string(fileName) + " not found, vertex dedup benchmark skipped");
+				continue;
+			}
+			const double parseMs = benchmarkElapsedMs(begin);
+
+			std::vector<std::vector<VertexMesh>> legacyVertices(materialCount);
+			std::vector<std::vector<uint32_t>> legacyIndices(materialCount);
+			begin = std::chrono::steady_clock::now();
+			{
+				std::vector<std::unordered_map<VertexMesh, uint32_t, legacyVertexMeshHash>> uniqueVertices(materialCount);
+				for( size_t i = 0; i < faceVertices.size(); i++ )
+				{
+					const uint32_t material = faceMaterials[i];
+					const VertexMesh& vertex = faceVertices[i];
+					if( uniqueVertices[material].count(vertex) == 0 )
+					{
+						uniqueVertices[material][vertex] = (uint32_t)legacyVertices[material].size();
+						legacyVertices[material].push_back(vertex);
+					}
+					legacyIndices[material].push_back(uniqueVertices[material][vertex]);
+				}
+			}
+			const double legacyMs = benchmarkElapsedMs(begin);
+
+			std::vector<std::vector<VertexMesh>> vertices(materialCount);
+			std::vector<std::vector<uint32_t>> indices(materialCount);
+			begin = std::chrono::steady_clock::now();
+			{
+				VertexMeshIndexMap uniqueVertices;
+				uniqueVertices.Reserve(positionCount); // как в Model::loadObjFile
+				for( size_t i = 0; i < faceVertices.size(); i++ )
+				{
+					const uint32_t material = faceMaterials[i];
+					indices[material].push_back(uniqueVertices.GetOrAdd(material, faceVertices[i], vertices[material]));
+				}
+			}
+			const double mapMs = benchmarkElapsedMs(begin);
+
+			// тот же результат: вершины в порядке первого появления, одинаковые индексы
+			bool isSame = true;
+			size_t uniqueCount = 0;
+			for( size_t m = 0; m < materialCount; m++ )
+			{
+				isSame = isSame && vertices[m] == legacyVertices[m] && indices[m] == legacyIndices[m];
+				uniqueCount += vertices[m].size();
+			}
+			consoleCheck(isSame, std::string("VertexMeshIndexMap == unordered_map ") + fileName);
+			consoleOkLog(std::string("Vertex dedup ") + fileName + ": " + std::to_string(faceVertices.size()) + " -> " + std::to_string(uniqueCount) + " vertices, parse " + std::to_string(parseMs)
+				+ " ms, unordered_map " + std::to_string(legacyMs) + " ms, VertexMeshIndexMap " + std::to_string(mapMs) + " ms");
+		}
+	}
+}
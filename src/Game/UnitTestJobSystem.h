@@ -0,0 +1,231 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <random>
+void consoleOkLog(const std::string& msg);
+void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
+
+#include "MicroEngine.h"
+#include "UnitTestGeometry.h" // benchmarkElapsedMs
+
+// дерево задач: каждая задача глубины < MaxDepth запускает две дочерние на общем счетчике
+struct JobTreeTest
+{
+	static constexpr uint32_t MaxDepth = 14;
+
+	JobCounter counter;
+	std::atomic<int> leaves = 0;
+
+	static void Node(void* data, uint32_t depth, uint32_t)
+	{
+		JobTreeTest* tree = (JobTreeTest*)data;
+		if( depth == MaxDepth )
+		{
+			tree->leaves.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		Job child;
+		child.function = Node;
+		child.data = tree;
+		child.begin = depth + 1;
+		JobSystem::Run(child, tree->counter);
+		JobSystem::Run(child, tree->counter);
+	}
+};
+
+void RunUnitTestJobSystem()
+{
+	consoleOkLog("==> JOB SYSTEM TEST Enable");
+
+	if( !consoleCheck(JobSystem::Create(), "JobSystem::Create") )
+		return;
+	consoleOkLog("JobSystem threads: " + std::to_string(JobSystem::GetThreadCount()));
+
+	//-------------------------------------------------------------------------
+	// ParallelFor: каждый индекс ровно один раз
+	//-------------------------------------------------------------------------
+	{
+		constexpr uint32_t Count = 1000003;
+		std::vector<uint8_t> visits(Count, 0);
+		std::atomic<uint64_t> sum = 0;
+		JobSystem::ParallelFor(Count, 1000, [&](uint32_t begin, uint32_t end)
+			{
+				uint64_t localSum = 0;
+				for( uint32_t i = begin; i < end; i++ )
+				{
+					visits[i]++;
+					localSum += i;
+				}
+				sum.fetch_add(localSum, std::memory_order_relaxed);
+			});
+
+		bool isOnce = true;
+		for( uint32_t i = 0; i < Count; i++ )
+			isOnce = isOnce && visits[i] == 1;
+		consoleCheck(isOnce, "ParallelFor visits every index once");
+		consoleCheck(sum.load() == (uint64_t)Count * (Count - 1) / 2, "ParallelFor sum");
+	}
+
+	//-------------------------------------------------------------------------
+	// дочерние задачи на счетчике родителя
+	//-------------------------------------------------------------------------
+	{
+		JobTreeTest tree;
+		Job root;
+		root.function = JobTreeTest::Node;
+		root.data = &tree;
+		root.begin = 0;
+
+		const auto begin = std::chrono::steady_clock::now();
+		JobSystem::Run(root, tree.counter);
+		JobSystem::Wait(tree.counter);
+		const double treeMs = benchmarkElapsedMs(begin);
+
+		consoleCheck(tree.leaves.load() == (1 << JobTreeTest::MaxDepth), "Job tree leaves");
+		consoleCheck(tree.counter.value.load() == 0, "Job tree counter");
+		const double jobCount = (double)((2 << JobTreeTest::MaxDepth) - 1);
+		consoleOkLog("Job tree " + std::to_string((int)jobCount) + " jobs: " + std::to_string(treeMs) + " ms, " + std::to_string(jobCount / treeMs / 1000.0) + " Mjobs/s");
+	}
+
+	//-------------------------------------------------------------------------
+	// пропускная способность мелких задач
+	//-------------------------------------------------------------------------
+	{
+		constexpr uint32_t JobCount = 1000000;
+		std::atomic<uint32_t> executed = 0;
+		Job job;
+		job.function = [](void* data, uint32_t, uint32_t) { ((std::atomic<uint32_t>*)data)->fetch_add(1, std::memory_order_relaxed); };
+		job.data = &executed;
+
+		JobCounter counter;
+		const auto begin = std::chrono::steady_clock::now();
+		for( uint32_t i = 0; i < JobCount; i++ )
+			JobSystem::Run(job, counter);
+		JobSystem::Wait(counter);
+		const double runMs = benchmarkElapsedMs(begin);
+
+		consoleCheck(executed.load() == JobCount, "Job stress all executed");
+		consoleOkLog("Job stress 1M jobs: " + std::to_string(runMs) + " ms, " + std::to_string(JobCount / runMs / 1000.0) + " Mjobs/s");
+	}
+
+	//-------------------------------------------------------------------------
+	// ускорение ParallelFor на вычислительной нагрузке
+	//-------------------------------------------------------------------------
+	{
+		constexpr uint32_t Count = 1 << 22;
+		std::vector<float> values(Count);
+		for( uint32_t i = 0; i < Count; i++ )
+			values[i] = (float)(i % 1000) * 0.01f;
+		std::vector<float> serialResult(Count);
+		std::vector<float> parallelResult(Count);
+
+		auto kernel = [&](std::vector<float>& result, uint32_t begin, uint32_t end)
+		{
+			for( uint32_t i = begin; i < end; i++ )
+			{
+				float x = values[i];
+				for( int k = 0; k < 16; k++ )
+					x = std::sqrt(x * x + 1.0f) * 0.5f;
+				result[i] = x;
+			}
+		};
+
+		auto begin = std::chrono::steady_clock::now();
+		kernel(serialResult, 0, Count);
+		const double serialMs = benchmarkElapsedMs(begin);
+
+		begin = std::chrono::steady_clock::now();
+		JobSystem::ParallelFor(Count, 0, [&](uint32_t first, uint32_t last) { kernel(parallelResult, first, last); });
+		const double parallelMs = benchmarkElapsedMs(begin);
+
+		consoleCheck(serialResult == parallelResult, "ParallelFor result == serial");
+		consoleOkLog("ParallelFor 4M elements: serial " + std::to_string(serialMs) + " ms, parallel " + std::to_string(parallelMs) + " ms, speedup " + std::to_string(serialMs / parallelMs));
+	}
+
+	//-------------------------------------------------------------------------
+	// StepCharacters: результат не зависит от числа потоков
+	//-------------------------------------------------------------------------
+	{
+		// пол и столбы 1x1 через 4 м
+		std::vector<Vector3> scene;
+		auto addQuad = [&](const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d, const Vector3& outward)
+		{
+			const bool isFlip = DotProduct(CrossProduct(b - a, c - a), outward) < 0.0f;
+			scene.insert(scene.end(), { a, isFlip ? c : b, isFlip ? b : c, a, isFlip ? d : c, isFlip ? c : d });
+		};
+		addQuad({ -50.0f, 0.0f, -50.0f }, { -50.0f, 0.0f, 50.0f }, { 50.0f, 0.0f, 50.0f }, { 50.0f, 0.0f, -50.0f }, { 0.0f, 1.0f, 0.0f });
+		for( int x = -40; x <= 40; x += 4 )
+		{
+			for( int z = -40; z <= 40; z += 4 )
+			{
+				const Vector3 lo((float)x - 0.5f, -1.0f, (float)z - 0.5f);
+				const Vector3 hi((float)x + 0.5f, 3.0f, (float)z + 0.5f);
+				addQuad({ lo.x, lo.y, lo.z }, { lo.x, hi.y, lo.z }, { lo.x, hi.y, hi.z }, { lo.x, lo.y, hi.z }, { -1.0f, 0.0f, 0.0f });
+				addQuad({ hi.x, lo.y, lo.z }, { hi.x, hi.y, lo.z }, { hi.x, hi.y, hi.z }, { hi.x, lo.y, hi.z }, { 1.0f, 0.0f, 0.0f });
+				addQuad({ lo.x, lo.y, lo.z }, { lo.x, hi.y, lo.z }, { hi.x, hi.y, lo.z }, { hi.x, lo.y, lo.z }, { 0.0f, 0.0f, -1.0f });
+				addQuad({ lo.x, lo.y, hi.z }, { lo.x, hi.y, hi.z }, { hi.x, hi.y, hi.z }, { hi.x, lo.y, hi.z }, { 0.0f, 0.0f, 1.0f });
+			}
+		}
+		CollisionMesh mesh;
+		mesh.Create(scene);
+
+		constexpr size_t CharacterCount = 2000;
+		constexpr int StepCount = 60;
+		constexpr float DeltaTime = 1.0f / 60.0f;
+		auto createCharacters = [&]()
+		{
+			std::mt19937 random(3);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			const Vector3 radius(0.3f, 0.8f, 0.3f);
+			std::vector<CharacterState> characters(CharacterCount);
+			for( CharacterState& character : characters )
+			{
+				character.controller.Create(radius, { &mesh });
+				character.controller.position = Vector3(unit(random) * 80.0f - 40.0f, radius.y + 0.05f, unit(random) * 80.0f - 40.0f);
+				const float angle = unit(random) * PI * 2.0f;
+				character.velocity = Vector3(cosf(angle) * 4.0f, -9.8f, sinf(angle) * 4.0f);
+			}
+			return characters;
+		};
+
+		// эталон - последовательные Move
+		std::vector<CharacterState> reference = createCharacters();
+		auto begin = std::chrono::steady_clock::now();
+		for( int step = 0; step < StepCount; step++ )
+		{
+			for( CharacterState& character : reference )
+				character.controller.Move(character.velocity * DeltaTime);
+		}
+		const double serialMs = benchmarkElapsedMs(begin);
+
+		bool isDeterministic = true;
+		double parallelMs = 0.0;
+		for( const unsigned workerCount : { 1u, 3u, 0u } )
+		{
+			if( !consoleCheck(JobSystem::Create(workerCount), "JobSystem::Create(" + std::to_string(workerCount) + ")") )
+			{
+				isDeterministic = false;
+				continue;
+			}
+			std::vector<CharacterState> characters = createCharacters();
+			begin = std::chrono::steady_clock::now();
+			for( int step = 0; step < StepCount; step++ )
+				StepCharacters(characters, DeltaTime);
+			parallelMs = benchmarkElapsedMs(begin);
+
+			for( size_t i = 0; i < CharacterCount; i++ )
+			{
+				isDeterministic = isDeterministic && characters[i].controller.position == reference[i].controller.position
+					&& characters[i].controller.IsGrounded() == reference[i].controller.IsGrounded();
+			}
+		}
+		consoleCheck(isDeterministic, "StepCharacters == serial Move for 2, 4 and default thread count");
+		consoleOkLog("StepCharacters " + std::to_string(CharacterCount) + " characters x " + std::to_string(StepCount) + " steps, " + std::to_string(JobSystem::GetThreadCount())
+			+ " threads: serial " + std::to_string(serialMs) + " ms, parallel " + std::to_string(parallelMs) + " ms, speedup " + std::to_string(serialMs / parallelMs));
+	}
+
+	JobSystem::Destroy();
+}
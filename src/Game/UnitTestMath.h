@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <chrono>
+#include <random>
 void consoleOkLog(const std::string& msg);
 void consoleErrorLog(const std::string& msg);
+bool consoleCheck(bool condition, const std::string& msg);
 
 #include "MicroMath.h"
 
@@ -35,5 +38,141 @@ void RunUnitTestMath()
 	// Vector4
 	//-------------------------------------------------------------------------
 
+	//-------------------------------------------------------------------------
+	// SIMD Matrix/Quaternion
+	//-------------------------------------------------------------------------
+	{
+		// SIMD-версии должны совпадать со скалярными с точностью до погрешности порядка вычислений
+		constexpr int Count = 10000;
+		constexpr float Epsilon = 1.0e-4f;
+		std::mt19937 random(4321);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		const auto randomMatrix4 = [&]() {
+			Matrix4 m;
+			for( int i = 0; i < 4; i++ )
+				m[i] = Vector4(value(random), value(random), value(random), value(random));
+			for( int i = 0; i < 4; i++ )
+				m[i][i] += 4.0f; // хорошо обусловленная матрица
+			return m;
+		};
+		const auto equalsMatrix4 = [&](const Matrix4& a, const Matrix4& b) {
+			for( int i = 0; i < 4; i++ )
+				for( int j = 0; j < 4; j++ )
+					if( !Equals(a[i][j], b[i][j], Epsilon) ) return false;
+			return true;
+		};
+
+		bool multiplyM4 = true, multiplyM4V4 = true, inverse = true, transformPoint = true, multiplyM3 = true, multiplyQ = true;
+		for( int n = 0; n < Count; n++ )
+		{
+			const Matrix4 a = randomMatrix4();
+			const Matrix4 b = randomMatrix4();
+			const Vector4 v(value(random), value(random), value(random), value(random));
+			const Vector3 p(value(random), value(random), value(random));
+
+			multiplyM4 &= equalsMatrix4(MathSimd::Multiply(a, b), MathScalar::Multiply(a, b));
+			multiplyM4V4 &= Equals(MathSimd::Multiply(a, v), MathScalar::Multiply(a, v), Epsilon);
+			inverse &= equalsMatrix4(MathSimd::Inverse(a), MathScalar::Inverse(a));
+			transformPoint &= Equals(MathSimd::TransformPoint(a, p), MathScalar::TransformPoint(a, p), Epsilon);
+
+			Matrix3 a3, b3;
+			for( int i = 0; i < 3; i++ )
+			{
+				a3[i] = Vector3(value(random), value(random), value(random));
+				b3[i] = Vector3(value(random), value(random), value(random));
+			}
+			const Matrix3 simd3 = MathSimd::Multiply(a3, b3);
+			const Matrix3 scalar3 = MathScalar::Multiply(a3, b3);
+			for( int i = 0; i < 3; i++ )
+				multiplyM3 &= Equals(simd3[i], scalar3[i], Epsilon);
+
+			const Quaternion qa(value(random), value(random), value(random), value(random));
+			const Quaternion qb(value(random), value(random), value(random), value(random));
+			const Quaternion simdQ = MathSimd::Multiply(qa, qb);
+			const Quaternion scalarQ = MathScalar::Multiply(qa, qb);
+			multiplyQ &= Equals(simdQ.w, scalarQ.w, Epsilon) && Equals(simdQ.x, scalarQ.x, Epsilon) && Equals(simdQ.y, scalarQ.y, Epsilon) && Equals(simdQ.z, scalarQ.z, Epsilon);
+		}
+		consoleCheck(multiplyM4, "SIMD Matrix4 * Matrix4");
+		consoleCheck(multiplyM4V4, "SIMD Matrix4 * Vector4");
+		consoleCheck(inverse, "SIMD Matrix4::Inverse");
+		consoleCheck(transformPoint, "SIMD Matrix4::TransformPoint");
+		consoleCheck(multiplyM3, "SIMD Matrix3 * Matrix3");
+		consoleCheck(multiplyQ, "SIMD Quaternion * Quaternion");
+
+		// время
+		constexpr int BenchmarkCount = 1000000;
+		std::vector<Matrix4> matrices(256);
+		for( auto& m : matrices ) m = randomMatrix4();
+		const auto measure = [&](auto&& func) {
+			Matrix4 acc = Matrix4::Identity;
+			const auto begin = std::chrono::steady_clock::now();
+			for( int n = 0; n < BenchmarkCount; n++ )
+				acc = func(acc, matrices[n & 255]);
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+			volatile float sink = acc[0][0]; (void)sink;
+			return ms;
+		};
+		const double scalarMultiply = measure([](const Matrix4& a, const Matrix4& b) { return MathScalar::Multiply(a, b) * 0.25f; });
+		const double simdMultiply = measure([](const Matrix4& a, const Matrix4& b) { return MathSimd::Multiply(a, b) * 0.25f; });
+		const double scalarInverse = measure([](const Matrix4& a, const Matrix4& b) { return MathScalar::Inverse(b) + a * 0.0f; });
+		const double simdInverse = measure([](const Matrix4& a, const Matrix4& b) { return MathSimd::Inverse(b) + a * 0.0f; });
+		consoleOkLog("Matrix4 multiply x" + std::to_string(BenchmarkCount) + ": scalar " + std::to_string(scalarMultiply) + " ms, simd " + std::to_string(simdMultiply) + " ms");
+		consoleOkLog("Matrix4 inverse x" + std::to_string(BenchmarkCount) + ": scalar " + std::to_string(scalarInverse) + " ms, simd " + std::to_string(simdInverse) + " ms");
+
+		// MICROMATH_SIMD_MATRIX переключает только Matrix4 * Vector4, Inverse и TransformPoint
+		const auto measurePoint = [&](auto&& func) {
+			Vector3 acc(1.0f);
+			const auto begin = std::chrono::steady_clock::now();
+			for( int n = 0; n < BenchmarkCount; n++ )
+				acc = func(matrices[n & 255], acc) * 0.25f;
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+			volatile float sink = acc.x; (void)sink;
+			return ms;
+		};
+		const double scalarTransform = measurePoint([](const Matrix4& m, const Vector3& p) { return MathScalar::TransformPoint(m, p); });
+		const double simdTransform = measurePoint([](const Matrix4& m, const Vector3& p) { return MathSimd::TransformPoint(m, p); });
+		consoleOkLog("Matrix4::TransformPoint x" + std::to_string(BenchmarkCount) + ": scalar " + std::to_string(scalarTransform) + " ms, simd " + std::to_string(simdTransform) + " ms");
+	}
+
+	//-------------------------------------------------------------------------
+	// Packing
+	//-------------------------------------------------------------------------
+	{
+		consoleCheck(FloatToHalf(0.0f) == 0x0000 && FloatToHalf(1.0f) == 0x3C00 && FloatToHalf(-2.0f) == 0xC000 && FloatToHalf(65504.0f) == 0x7BFF, "FloatToHalf exact values");
+		consoleCheck(FloatToHalf(1.0e6f) == 0x7C00 && FloatToHalf(-1.0e6f) == 0xFC00 && FloatToHalf(ldexpf(1.0f, -24)) == 0x0001 && FloatToHalf(ldexpf(1.0f, -26)) == 0x0000, "FloatToHalf overflow and denormals");
+		consoleCheck(FloatToHalf(1.0f + ldexpf(1.0f, -11)) == 0x3C00 && FloatToHalf(1.0f + 3.0f * ldexpf(1.0f, -11)) == 0x3C02, "FloatToHalf rounds to nearest even");
+
+		// все half, кроме nan, переживают HalfToFloat -> FloatToHalf без изменений
+		bool halfRoundTrip = true;
+		for( uint32_t bits = 0; bits < 0x10000; bits++ )
+		{
+			if( (bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0 ) continue;
+			halfRoundTrip &= FloatToHalf(HalfToFloat((uint16_t)bits)) == bits;
+		}
+		consoleCheck(halfRoundTrip, "HalfToFloat/FloatToHalf round trip");
+
+		std::mt19937 random(777);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+		float halfError = 0.0f, snormError = 0.0f, unormError = 0.0f;
+		for( int n = 0; n < 100000; n++ )
+		{
+			const float texCoord = value(random) * 64.0f;
+			halfError = Max(halfError, fabsf(HalfToFloat(FloatToHalf(texCoord)) - texCoord) / fabsf(texCoord));
+
+			const Vector3 normal = Vector3(value(random), value(random), value(random)).GetNormalize();
+			const Vector3 unpackedNormal = UnpackSnorm10x3(PackSnorm10x3(normal));
+			for( int i = 0; i < 3; i++ )
+				snormError = Max(snormError, fabsf(unpackedNormal[i] - normal[i]));
 
-}
\ No newline at end of file
+			const Vector4 color(fabsf(value(random)), fabsf(value(random)), fabsf(value(random)), 1.0f);
+			const Vector4 unpackedColor = UnpackUnorm8x4(PackUnorm8x4(color));
+			for( int i = 0; i < 4; i++ )
+				unormError = Max(unormError, fabsf(unpackedColor[i] - color[i]));
+		}
+		consoleCheck(halfError <= ldexpf(1.0f, -11), "half relative error <= 2^-11 (" + std::to_string(halfError) + ")");
+		consoleCheck(snormError <= 1.0f / 1022.0f + 1.0e-6f, "snorm10 error <= 1/1022 (" + std::to_string(snormError) + ")");
+		consoleCheck(unormError <= 1.0f / 510.0f + 1.0e-6f, "unorm8 error <= 1/510 (" + std::to_string(unormError) + ")");
+		consoleCheck(UnpackSnorm10x3(PackSnorm10x3(Vector3(1.0f, -1.0f, 0.0f))) == Vector3(1.0f, -1.0f, 0.0f) && UnpackUnorm8x4(PackUnorm8x4(Vector4(1.0f))) == Vector4(1.0f), "snorm10/unorm8 exact endpoints");
+	}
+}
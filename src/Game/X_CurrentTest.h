@@ -662,8 +662,8 @@ void ExampleFrame()
 	TextureCube::UnBind();
 
 	// render scene 
-	glEnable(GL_DEPTH_TEST);
-	//glEnable(GL_CULL_FACE);
+	SetDepthState({});
+	//SetRasterizerState({ .cullMode = CullMode::Back });
 
 	Lighting.Bind();
 	glBindVertexArray(VAO);
@@ -702,8 +702,8 @@ void ExampleFrame()
 	VertexArrayBuffer::UnBind();
 	ShaderProgram::UnBind();
 
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
+	SetRasterizerState({});
+	SetDepthState({ .depthFunc = CompareFunction::Disabled });
 }
 
 Vector2 GrassTexCoords[6] =
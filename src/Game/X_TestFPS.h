@@ -13,730 +13,10 @@
 
 #define ENABLE_FPS 1
 
-class MeshColliderData
-{
-public:
-	void Init(const Model& model)
-	{
-		triangles = model.GetTriangles();
-	}
-
-	std::vector<Vector3> triangles;
-};
-
-namespace Collisions
-{
-	bool GetLowestRoot(float a, float b, float c, float maxR, float* root)
-	{
-		// Check if a solution exists
-		const float determinant = b * b - 4.0f * a * c;
-		// If determinant is negative it means no solutions.
-		if (determinant < 0.0f) return false;
-
-		// calculate the two roots: (if determinant == 0 then x1==x2 but let’s disregard that slight optimization)
-		const float sqrtD = sqrt(determinant);
-		float r1 = (-b - sqrtD) / (2.0f * a);
-		float r2 = (-b + sqrtD) / (2.0f * a);
-
-		// Sort so x1 <= x2
-		if (r1 > r2)
-		{
-			float temp = r2;
-			r2 = r1;
-			r1 = temp;
-		}
-		// Get lowest root:
-		if (r1 > 0 && r1 < maxR)
-		{
-			*root = r1;
-			return true;
-		}
-		// It is possible that we want x2 - this can happen
-		// if x1 < 0
-		if (r2 > 0 && r2 < maxR)
-		{
-			*root = r2;
-			return true;
-		}
-		// No (valid) solutions
-		return false;
-	}
-}
-
-#define unitsPerMeter 100.0f
-
-#define SLIDE_BIAS 0.008
-#define VERY_CLOSE_DIST 0.001
-#define SLOPE_WALK_ANGLE 0.80
-
-class CollisionPacket
-{
-public:
-	// Information about the move being requested: (in R3)
-	Vector3 R3Velocity;
-	Vector3 R3Position;
-
-	// ellipsoid space
-	Vector3 eRadius; // ellipsoid radius
-	// Information about the move being requested: (in eSpace)
-	Vector3 velocity;
-	Vector3 normalizedVelocity;
-	Vector3 basePoint;
-
-	// original tri points
-	Vector3 a, b, c;
-
-	// Hit information
-	bool foundCollision;
-	float nearestDistance;
-	float t;
-	Vector3 intersectionPoint;
-
-	Plane plane;
-
-	// iteration depth
-	int collisionRecursionDepth;
-};
-
-// Assumes: p1, p2and p3 are given in ellisoid space :
-inline void CheckCollisionsTriangle(CollisionPacket* colPackage, const Vector3& p1, const Vector3& p2, const Vector3& p3)
-{
-	// Make the Plane containing this triangle.
-	const Plane trianglePlane(p1, p2, p3);
-	// Is triangle front-facing to the velocity vector?
-	// only check front-facing triangles
-	if (!trianglePlane.IsFrontFacingTo(colPackage->normalizedVelocity))
-		return;
-
-	// Get interval of Plane intersection:
-	float t0, t1;
-	bool embeddedInPlane = false;
-
-	// Calculate the signed distance from sphere position to triangle Plane
-	const float signedDistToTrianglePlane = trianglePlane.SignedDistanceTo(colPackage->basePoint);
-
-	// cache this as we’re going to use it a few times below:
-	const float normalDotVelocity = DotProduct(trianglePlane.normal, colPackage->velocity);
-	// if sphere is travelling parrallel to the Plane:
-	if (normalDotVelocity == 0.0f)
-	{
-		if (fabsf(signedDistToTrianglePlane) >= 1.0f)
-		{
-			// Sphere is not embedded in Plane.
-			// No collision possible:
-			return;
-		}
-		else
-		{
-			// sphere is embedded in Plane.
-			// It intersects in the whole range [0..1]
-			embeddedInPlane = true;
-			t0 = 0.0f;
-			t1 = 1.0f;
-		}
-	}
-	else
-	{
-		// N dot D is not 0. Calculate intersection interval:
-		t0 = (-1.0f - signedDistToTrianglePlane) / normalDotVelocity;
-		t1 = (+1.0f - signedDistToTrianglePlane) / normalDotVelocity;
-
-		// Swap so t0 < t1
-		if (t0 > t1)
-		{
-			float temp = t1;
-			t1 = t0;
-			t0 = temp;
-		}
-
-		// Check that at least one result is within range:
-		if (t0 > 1.0f || t1 < 0.0f)
-		{
-			// Both t values are outside values [0,1]
-			// No collision possible:
-			return;
-		}
-		// Clamp to [0,1]
-		if (t0 < 0.0f) t0 = 0.0f;
-		if (t1 < 0.0f) t1 = 0.0f;
-		if (t0 > 1.0f) t0 = 1.0f;
-		if (t1 > 1.0f) t1 = 1.0f;
-	}
-
-	// OK, at this point we have two time values t0 and t1 between which the swept sphere intersects with the triangle Plane. If any collision is to occur it must happen within this interval.
-	Vector3 collisionPoint;
-	bool foundCollison = false;
-	float t = 1.0f;
-
-	// First we check for the easy case - collision inside the triangle. If this happens it must be at time t0 as this is when the sphere rests on the front side of the triangle Plane. Note, this can only happen if the sphere is not embedded in the triangle Plane.
-	if (!embeddedInPlane)
-	{
-		const Vector3 PlaneIntersectionPoint = (colPackage->basePoint - trianglePlane.normal) + t0 * colPackage->velocity;
-
-		if (CheckPointInTriangle(p1, p2, p3, PlaneIntersectionPoint))
-		{
-			foundCollison = true;
-			t = t0;
-			collisionPoint = PlaneIntersectionPoint;
-		}
-	}
-	// if we haven’t found a collision already we’ll have to sweep sphere against points and edges of the triangle.
-	// Note: A collision inside the triangle (the check above) will always happen before a vertex or edge collision!
-	// This is why we can skip the swept test if the above gives a collision!
-	if (foundCollison == false)
-	{
-		// some commonly used terms:
-		const Vector3 velocity = colPackage->velocity;
-		const Vector3 base = colPackage->basePoint;
-		const float velocitySquaredLength = DotProduct(velocity, velocity);
-		float a, b, c; // Params for equation
-		float newT;
-
-		// For each vertex or edge a quadratic equation have to be solved. We parameterize this equation as a*t^2 + b*t + c = 0 and below we calculate the parameters a,b and c for each test.
-
-		// Check against points:
-		a = velocitySquaredLength;
-
-		// P1
-		b = 2.0f * (DotProduct(velocity, base - p1));
-		c =DotProduct(p1 - base, p1 - base) - 1.0f;
-		if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-		{
-			t = newT;
-			foundCollison = true;
-			collisionPoint = p1;
-		}
-
-		// P2
-		if (!foundCollison)
-		{
-			b = 2.0f * (DotProduct(velocity, base - p2));
-			c = DotProduct(p2 - base, p2 - base) - 1.0f;
-			if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-			{
-				t = newT;
-				foundCollison = true;
-				collisionPoint = p2;
-			}
-		}
-
-		// P3
-		if (!foundCollison)
-		{
-			b = 2.0f * (DotProduct(velocity, base - p3));
-			c = DotProduct(p3 - base, p3 - base) - 1.0f;
-			if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-			{
-				t = newT;
-				foundCollison = true;
-				collisionPoint = p3;
-			}
-		}
-
-		// Check agains edges:
-
-		// p1 -> p2:
-		Vector3 edge = p2 - p1;
-		Vector3 baseToVertex = p1 - base;
-		float edgeSquaredLength = DotProduct(edge, edge);
-		float edgeDotVelocity = DotProduct(edge, velocity);
-		float edgeDotBaseToVertex = DotProduct(edge, baseToVertex);
-
-		// Calculate parameters for equation
-		a = edgeSquaredLength * -velocitySquaredLength + edgeDotVelocity * edgeDotVelocity;
-		b = edgeSquaredLength * (2.0f * DotProduct(velocity, baseToVertex)) - 2.0f * edgeDotVelocity * edgeDotBaseToVertex;
-		c = edgeSquaredLength * (1.0f - DotProduct(baseToVertex, baseToVertex)) + edgeDotBaseToVertex * edgeDotBaseToVertex;
-
-		// Does the swept sphere collide against infinite edge?
-		if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-		{
-			// Check if intersection is within line segment:
-			float f = (edgeDotVelocity * newT - edgeDotBaseToVertex) / edgeSquaredLength;
-			if (f >= 0.0f && f <= 1.0f)
-			{
-				// intersection took place within segment.
-				t = newT;
-				foundCollison = true;
-				collisionPoint = p1 + f * edge;
-			}
-		}
-
-		// p2 -> p3:
-		edge = p3 - p2;
-		baseToVertex = p2 - base;
-		edgeSquaredLength = DotProduct(edge, edge);
-		edgeDotVelocity = DotProduct(edge, velocity);
-		edgeDotBaseToVertex = DotProduct(edge, baseToVertex);
-
-		// calculate params for equation
-		a = edgeSquaredLength * -velocitySquaredLength + edgeDotVelocity * edgeDotVelocity;
-		b = edgeSquaredLength * (2.0f * DotProduct(velocity, baseToVertex)) - 2.0f * edgeDotVelocity * edgeDotBaseToVertex;
-		c = edgeSquaredLength * (1.0f - DotProduct(baseToVertex, baseToVertex)) + edgeDotBaseToVertex * edgeDotBaseToVertex;
-
-		// do we collide against infinite edge
-		if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-		{
-			// check if intersect is within line segment
-			float f = (edgeDotVelocity * newT - edgeDotBaseToVertex) / edgeSquaredLength;
-			if (f >= 0.0f && f <= 1.0f)
-			{
-				t = newT;
-				foundCollison = true;
-				collisionPoint = p2 + f * edge;
-			}
-		}
-
-		// p3 -> p1:
-		edge = p1 - p3;
-		baseToVertex = p3 - base;
-		edgeSquaredLength = DotProduct(edge, edge);
-		edgeDotVelocity = DotProduct(edge, velocity);
-		edgeDotBaseToVertex = DotProduct(edge, baseToVertex);
-
-		// calculate params for equation
-		a = edgeSquaredLength * -velocitySquaredLength + edgeDotVelocity * edgeDotVelocity;
-		b = edgeSquaredLength * (2.0f * DotProduct(velocity, baseToVertex)) - 2.0f * edgeDotVelocity * edgeDotBaseToVertex;
-		c = edgeSquaredLength * (1.0f - DotProduct(baseToVertex, baseToVertex)) + edgeDotBaseToVertex * edgeDotBaseToVertex;
-
-		// do we collide against infinite edge
-		if (Collisions::GetLowestRoot(a, b, c, t, &newT))
-		{
-			// check if intersect is within line segment
-			float f = (edgeDotVelocity * newT - edgeDotBaseToVertex) / edgeSquaredLength;
-			if (f >= 0.0f && f <= 1.0f)
-			{
-				t = newT;
-				foundCollison = true;
-				collisionPoint = p3 + f * edge;
-			}
-		}
-	}
-	// Set result:
-	if (foundCollison == true)
-	{
-		// distance to collision: ’t’ is time of collision
-		const float distToCollision = t * colPackage->velocity.GetLength();
-		// Does this triangle qualify for the closest hit?
-		// it does if it’s the first hit or the closest
-		if (colPackage->foundCollision == false || distToCollision < colPackage->nearestDistance)
-		{
-			// Collision information nessesary for sliding
-			colPackage->nearestDistance = distToCollision;
-			colPackage->intersectionPoint = collisionPoint;
-			colPackage->foundCollision = true;
-			colPackage->t = t;
-			colPackage->plane = trianglePlane;
-			colPackage->a = p1;
-			colPackage->b = p2;
-			colPackage->c = p3;
-		}
-	}
-}
-
-class CharacterEntity
-{
-public:
-	CharacterEntity(Model* model, Vector3 radius);
-	CharacterEntity(std::vector<Model*> models, Vector3 radius);
-	void Update(float dt);
-	void CheckCollision();
-
-	void CollideAndSlide(const Vector3& gravity);
-
-	Vector3 CollideWithWorld(const Vector3& pos, const Vector3& velocity);
-
-	// new
-	void CollideAndSlide2();
-	void CollideWithWorld2(Vector3& pos, Vector3& velocity);
-	void CheckGrounded();
-	void Update2(float dt);
-
-	Vector3 position, velocity, radius;
-	CollisionPacket collisionPackage;
-	std::vector<Model*> models;
-	std::vector<MeshColliderData> colliders;
-	int grounded;
-};
-
-CharacterEntity::CharacterEntity(Model* model, Vector3 radius)
-{
-	this->radius = radius;
-	position = Vector3(0.0f);
-	velocity = Vector3(0.0f);
-
-	models.push_back(model);
-	colliders.push_back({});
-	colliders[0].Init(*models[0]);
-
-	grounded = 0;
-}
-
-CharacterEntity::CharacterEntity(std::vector<Model*> models, Vector3 radius)
-{
-	this->radius = radius;
-	position = Vector3(0.0f);
-	velocity = Vector3(0.0f);
-
-	this->models = models;
-	for( size_t i = 0; i < this->models.size(); i++ )
-	{
-		colliders.push_back({});
-		colliders[colliders.size()-1].Init(*this->models[i]);
-	}
-	grounded = 0;
-}
-
-void CharacterEntity::CollideAndSlide(const Vector3& gravity)
-{
-#if 1
-	// Do collision detection:
-	collisionPackage.R3Position = position;
-	collisionPackage.R3Velocity = velocity;
-	collisionPackage.eRadius = radius;
-
-	// calculate position and velocity in eSpace
-	Vector3 eSpacePosition = collisionPackage.R3Position / collisionPackage.eRadius;
-	Vector3 Velocity = collisionPackage.R3Velocity / collisionPackage.eRadius;
-	// no gravity
-	Velocity.y = 0.0f;
-
-	// Iterate until we have our final position.
-	collisionPackage.collisionRecursionDepth = 0;
-
-	int g = grounded;
-	Vector3 finalPosition = CollideWithWorld(eSpacePosition, Velocity);
-	grounded = g;
-
-	// Add gravity pull:
-
-	// Set the new R3 position (convert back from eSpace to R3)
-	collisionPackage.R3Position = finalPosition * collisionPackage.eRadius;
-	collisionPackage.R3Velocity = gravity;
-
-	// convert velocity to e-space
-	Velocity = gravity / collisionPackage.eRadius;
-
-	// gravity iteration
-	collisionPackage.collisionRecursionDepth = 0;
-	finalPosition = CollideWithWorld(finalPosition, Velocity);
-
-	// finally set entity position
-	position = finalPosition * collisionPackage.eRadius;
-#else
-	// Do collision detection:
-	collisionPackage.R3Position = position;
-	collisionPackage.R3Velocity = velocity;
-	collisionPackage.eRadius = radius;
-
-	// y velocity in a seperate pass
-	glm::vec3 Gravity = glm::vec3{ 0.0f };
-	Gravity.y = collisionPackage.R3Velocity.y;
-	//collisionPackage.R3Velocity.y = 0.0f;
-
-	// lets get e-spacey?
-	// calculate position and velocity in eSpace
-	glm::vec3 eSpacePosition = collisionPackage.R3Position / collisionPackage.eRadius;
-	glm::vec3 eSpaceVelocity = collisionPackage.R3Velocity / collisionPackage.eRadius;
-
-	// Iterate until we have our final position.
-	collisionPackage.collisionRecursionDepth = 0;
-
-	int g = grounded;
-	glm::vec3 finalPosition = CollideWithWorld(eSpacePosition, velocity);
-	grounded = g;
-
-
-#if 1
-	// Set the new R3 position (convert back from eSpace to R3)
-	collisionPackage.R3Position = finalPosition * collisionPackage.eRadius;
-	collisionPackage.R3Velocity = gravity;
-
-	// convert velocity to e-space
-	eSpaceVelocity = gravity / collisionPackage.eRadius;
-
-	// gravity iteration
-	collisionPackage.collisionRecursionDepth = 0;
-	finalPosition = CollideWithWorld(finalPosition, velocity);
-
-	// finally set entity position
-	position = finalPosition * collisionPackage.eRadius;
-#else
-	// do gravity iteration
-	collisionPackage.R3Velocity = Gravity;
-	eSpaceVelocity = Gravity / collisionPackage.eRadius;
-	/*glm::vec3 finalPosition = */CollideWithWorld(eSpacePosition, velocity);
-
-	// finally set entity position & velocity
-	position = eSpacePosition * collisionPackage.eRadius;
-#endif
-#endif
-}
-
-inline void CharacterEntity::CollideAndSlide2()
-{
-	// Do collision detection:
-	collisionPackage.R3Position = position;
-	collisionPackage.R3Velocity = velocity;
-	collisionPackage.eRadius = radius;
-
-	// y velocity in a seperate pass
-	Vector3 gravity = Vector3{ 0.0f };
-	gravity.y = collisionPackage.R3Velocity.y;
-	collisionPackage.R3Velocity.y = 0.0f;
-
-	// calculate position and velocity in eSpace
-	Vector3 eSpacePosition = collisionPackage.R3Position / collisionPackage.eRadius;
-	Vector3 eVelocity = collisionPackage.R3Velocity / collisionPackage.eRadius;
-
-	// do velocity iteration
-	CollideWithWorld2(eSpacePosition, eVelocity);
-
-	// do gravity iteration
-	collisionPackage.R3Velocity = gravity;
-	eVelocity = collisionPackage.R3Velocity / collisionPackage.eRadius;
-	CollideWithWorld2(eSpacePosition, eVelocity);
-
-	// finally set entity position & velocity
-	position = eSpacePosition * collisionPackage.eRadius;
-}
-
-inline void CharacterEntity::CollideWithWorld2(Vector3& e_position, Vector3& e_velocity)
-{
-	Vector3 dest = e_position + e_velocity;
-	const Vector3 src = e_position;
-
-	Plane first_plane;
-
-	// check for collision
-	Vector3 temp;
-	for (int i = 0; i < 5; i++)
-	{
-		// setup coll packet
-		collisionPackage.velocity = e_velocity;
-		collisionPackage.normalizedVelocity = e_velocity.GetNormalize();
-		collisionPackage.basePoint = e_position;
-		collisionPackage.eRadius = radius;
-		collisionPackage.foundCollision = false;
-		collisionPackage.nearestDistance = FLT_MAX;
-		collisionPackage.t = 0.0f;
-
-		// Check for collision (calls the collision routines)
-	// Application specific!!
-		CheckCollision();
-		CheckGrounded();
-
-		// If no collision we just move along the velocity
-		if (collisionPackage.foundCollision == false)
-		{
-			e_position = dest; // TODO: переделать на возврат
-			return;
-		}
-
-		// point touching tri
-		Vector3 touch_point = e_position + e_velocity * collisionPackage.t;
-
-		float dist = sqrtf(DotProduct(e_velocity, e_velocity)) * collisionPackage.t;
-		float short_dist = Max(dist - 1.0f, 0.0f);
-
-		e_position = e_position + e_velocity.GetNormalize() * short_dist;
-
-		// Determine the sliding Plane
-		Vector3 slidePlaneOrigin = collisionPackage.intersectionPoint; // use intersect point as origin
-		// normal = touch_point - intersect_point
-		// dont use normal from packet.plane.normal!
-		Vector3 slidePlaneNormal = (touch_point - collisionPackage.intersectionPoint).GetNormalize();
-
-		if (i == 0)
-		{
-			float long_radius = 1.0 + VERY_CLOSE_DIST;
-			first_plane = Plane(slidePlaneOrigin, slidePlaneNormal);
-
-			float dist_to_plane = first_plane.SignedDistanceTo(dest) - long_radius;
-
-			dest = dest - first_plane.normal * dist_to_plane;
-			e_velocity = dest - e_position;
-		}
-		else if (i == 1)
-		{
-			Plane second_plane(slidePlaneOrigin, slidePlaneNormal);
-
-			Vector3 crease = CrossProduct(first_plane.normal, second_plane.normal);
-			float dis = DotProduct(dest - e_position, crease);
-			crease = crease.GetNormalize();
-
-			e_velocity = crease * dis;
-			dest = e_position + e_velocity;
-		}
-	}
-
-	e_position = dest;
-}
-
-void CharacterEntity::CheckGrounded()
-{
-	if (!collisionPackage.foundCollision)
-		return;
-
-	Vector3 axis = Vector3{ 0.0f, 1.0f, 0.0f };
-
-	Vector3 a = collisionPackage.a * radius;
-	Vector3 b = collisionPackage.b * radius;
-	Vector3 c = collisionPackage.c * radius;
-
-	Plane plane(a, b, c);
-	float f = DotProduct(plane.normal, axis);
-	if (f >= SLOPE_WALK_ANGLE)
-		grounded = 1;
-}
-
-inline void CharacterEntity::Update2(float dt)
-{
-	const Vector3 xz = Vector3(velocity.x, 0.0f, velocity.z);
-	// prevent sliding while standing still on a slope
-	// change < 0.0f to > 0.0f if inverting y axis
-	if (grounded && fabs(sqrtf(DotProduct(xz, xz))) < 0.1f && velocity.y < 0.0f)
-		velocity.y = 0.0f;
-	else
-		grounded = 0;
-
-	dt = dt / 5.0;
-
-	velocity = velocity * dt;
-	for (int i = 0; i < 5; i++)
-		CollideAndSlide2();
-
-	velocity = position - collisionPackage.R3Position;
-	velocity = velocity * 1.0f / dt;
-}
-
-Vector3 CharacterEntity::CollideWithWorld(const Vector3& pos, const Vector3& vel)
-{
-	// All hard-coded distances in this function is
-	// scaled to fit the setting above..
-	float unitScale = unitsPerMeter / 100.0f;
-	float veryCloseDistance = 0.0000005f * unitScale;
-
-	// do we need to worry?
-	if (collisionPackage.collisionRecursionDepth > 5)
-		return pos;
-
-	// Ok, we need to worry:
-	collisionPackage.velocity = vel;
-	collisionPackage.normalizedVelocity = (vel.GetNormalize());
-	collisionPackage.basePoint = pos;
-	collisionPackage.foundCollision = false;
-	collisionPackage.nearestDistance = FLT_MAX;
-
-	// Check for collision (calls the collision routines)
-	// Application specific!!
-	CheckCollision();
-
-	// If no collision we just move along the velocity
-	if (collisionPackage.foundCollision == false)
-	{
-		return pos + vel;
-	}
-
-	// *** Collision occured ***
-
-	// The original destination point
-	Vector3 destinationPoint = pos + vel;
-	Vector3 newBasePoint = pos;
-	// only update if we are not already very close
-	// and if so we only move very close to intersection..not
-	// to the exact spot.
-	if (collisionPackage.nearestDistance >= veryCloseDistance)
-	{
-		Vector3 v = (float)Min(vel.GetLength(), collisionPackage.nearestDistance - veryCloseDistance) * vel;
-		// TODO: может это вместо выше v.SetLength(collisionPackage->nearestDistance - veryCloseDistance);
-		newBasePoint = collisionPackage.basePoint + v;
-
-		// Adjust polygon intersection point (so sliding
-		// Plane will be unaffected by the fact that we
-		// move slightly less than collision tells us)
-		v = v.GetNormalize();
-		collisionPackage.intersectionPoint -= veryCloseDistance * v;
-	}
-
-	// Determine the sliding Plane
-	Vector3 slidePlaneOrigin = collisionPackage.intersectionPoint;
-	Vector3 slidePlaneNormal = newBasePoint - collisionPackage.intersectionPoint;
-	slidePlaneNormal = slidePlaneNormal.GetNormalize();
-
-	Plane slidingPlane(slidePlaneOrigin, slidePlaneNormal);
-
-	Vector3 newDestinationPoint = destinationPoint - (float)slidingPlane.SignedDistanceTo(destinationPoint) * slidePlaneNormal;
-
-	// Generate the slide vectpr, which will become our new
-	// velocity vector for the next iteration
-	Vector3 newVelocityVector = newDestinationPoint - collisionPackage.intersectionPoint;
-
-	if (collisionPackage.intersectionPoint.y <= pos.y - collisionPackage.eRadius.y + 0.1f && vel.y <= 0.0f)
-	{
-		Vector3 a = collisionPackage.a * radius;
-		Vector3 b = collisionPackage.b * radius;
-		Vector3 c = collisionPackage.c * radius;
-		Plane plane(a, b, c);
-		Vector3 axis = { 0.0f, 1.0f, 0.0f };
-		float f = DotProduct(plane.normal, axis);
-		if (f >= SLOPE_WALK_ANGLE)
-			grounded = 1;
-	}
-
-	// Recurse:
-
-	// dont recurse if the new velocity is very small
-	if (newVelocityVector.GetLength() < veryCloseDistance)
-	{
-		return newBasePoint;
-	}
-
-	collisionPackage.collisionRecursionDepth++;
-
-	return CollideWithWorld(newBasePoint, newVelocityVector);
-}
-
-void CharacterEntity::CheckCollision()
-{
-	// сначала тестим все объекты на попадание в AABB
-	// в выбранных получаем список треугольников, при этом каждый треугольник хранит (или вычисляется) свой размер - для простоты в виде AABB.
-	// теперь проверяем эти треугольники в попадание зоны ААББ объекта-игрока.
-	// и вот с полученными уже обрабатываем коллизии
-	// при этом если меш - примитив (куб, сфера, плоскость) - то вместо проверки на треугольники делать только проверку на объемы
-	// на случай пролета объектов через объект (обычно юзают Continuous Collision Detection) - разбивать движение на итерации с фиксированным расстоянием и циклом каждое проверить - например шаг 0.1, персонаж сдвинулся с 8 до 9, значит не двигать по формуле pos + velocity, где Velocity равно 1. а разделить на десять итераций со сдвигом в 0.1 и в каждую проверять столкновение. Вроде называется Supersampling
-
-	// check collision against triangles
-
-	for( size_t i = 0; i < colliders.size(); i++ )
-	{
-		for( size_t j = 0; j < colliders[i].triangles.size(); j += 3 )
-		{
-			const Vector3 a = colliders[i].triangles[j + 0] / collisionPackage.eRadius;
-			const Vector3 b = colliders[i].triangles[j + 1] / collisionPackage.eRadius;
-			const Vector3 c = colliders[i].triangles[j + 2] / collisionPackage.eRadius;
-
-			CheckCollisionsTriangle(&collisionPackage, a, b, c);
-		}
-	}
-}
-
-void CharacterEntity::Update(float dt)
-{
-	grounded = 0;
-	Vector3 gravity = { 0.0f, this->velocity.y, 0.0f };
-	CollideAndSlide(gravity);
-
-	Vector3 xz = Vector3{ velocity.x, 0.0f, velocity.z };
-
-	// prevent sliding while standing still on a slope change < 0.0f to > 0.0f if inverting y axis
-	if (grounded /* && fabs(glm::length(xz)) < 0.1f && velocity.y < 0.0f*/)
-		velocity.y = 0.0f;
-	//else
-	//	grounded = 0;
-}
-
-
-CharacterEntity* entity;
+CollisionMesh levelCollision;
+CharacterController entity;
+Vector3 entityVelocity;
+bool entityGrounded = false; // держится, пока персонаж стоит на месте (Move без падения опору не находит)
 // size of collision ellipse, experiment with this to change fidelity of detection
 static Vector3 boundingEllipse = { 0.5f, 2.0f, 0.5f };
 
@@ -804,6 +84,25 @@ Model model;
 
 FlyingCamera cam;
 
+// шаг персонажа за кадр: 5 подшагов Move, на месте персонаж не сползает по склону
+void UpdateEntity(float deltaTime)
+{
+	// prevent sliding while standing still on a slope
+	const Vector3 xz = Vector3(entityVelocity.x, 0.0f, entityVelocity.z);
+	if( entityGrounded && xz.GetLength() < 0.1f && entityVelocity.y < 0.0f )
+		entityVelocity.y = 0.0f;
+	else
+		entityGrounded = false;
+
+	constexpr int SubstepCount = 5;
+	const Vector3 displacement = entityVelocity * (deltaTime / SubstepCount);
+	for( int i = 0; i < SubstepCount; i++ )
+	{
+		entity.Move(displacement);
+		entityGrounded = entityGrounded || entity.IsGrounded();
+	}
+}
+
 void ExampleInit()
 {
 	shader.CreateFromMemories(vertexShaderText, fragmentShaderText);
@@ -825,10 +124,11 @@ void ExampleInit()
 	model.Create("../data/mesh/untitled.obj", "../data/mesh/");
 	//model.SetMaterial({ .diffuseTexture = &texture }); // если материала нет
 
-	entity = new CharacterEntity(&model, boundingEllipse);// initialize player infront of model
-	entity->position.x = -62;
-	entity->position.y = 150;
-	entity->position.z = 0;
+	levelCollision.Create(model.GetTriangles());
+	entity.Create(boundingEllipse, { &levelCollision });// initialize player infront of model
+	entity.position.x = -62;
+	entity.position.y = 150;
+	entity.position.z = 0;
 	
 	cam.Look({ -62.0f, 80.0f, 0.0f }, { 0.0f, 0.0f, 0.0f });
 
@@ -838,6 +138,8 @@ void ExampleInit()
 
 void ExampleClose()
 {
+	entity.Destroy();
+	levelCollision.Destroy();
 	texture.Destroy();
 	shader.Destroy();
 	model.Destroy();
@@ -866,23 +168,23 @@ void ExampleFrame()
 		if( IsKeyDown('D') ) PlayerMovement += PlayerRight;
 
 		PlayerMovement *= 30.0f;
-		entity->velocity.x = PlayerMovement.x;
-		//entity->velocity.y = -30.0f;
-		entity->velocity.z = PlayerMovement.z;
+		entityVelocity.x = PlayerMovement.x;
+		//entityVelocity.y = -30.0f;
+		entityVelocity.z = PlayerMovement.z;
 
 		static float impulseSpace = 0.0f;
-		if( IsKeyPressed('Q') && entity->grounded == 1 && impulseSpace <= 0.0f )
+		if( IsKeyPressed('Q') && entityGrounded && impulseSpace <= 0.0f )
 		{
 			impulseSpace = 400;
 		}
 		if( impulseSpace <= 0.0f )
 		{
-			entity->velocity.y = -40.0f;
+			entityVelocity.y = -40.0f;
 		}
 		else
 		{
-			entity->velocity.y = 40.0f;
-			impulseSpace -= entity->velocity.y;
+			entityVelocity.y = 40.0f;
+			impulseSpace -= entityVelocity.y;
 		}
 #else
 		short Keys = 0x0000;
@@ -904,20 +206,20 @@ void ExampleFrame()
 		bool MoveCamera = cam.OnKeys(Keys, 70 * GetDeltaTime(), Movement);
 		if( MoveCamera ) cam.Move(Movement);
 
-		entity->velocity.x = 0.0f;
-		if( IsKeyDown('L') ) entity->velocity.x = 500.0f * GetDeltaTime();
-		if( IsKeyDown('J') ) entity->velocity.x = -500.0f * GetDeltaTime();
+		entityVelocity.x = 0.0f;
+		if( IsKeyDown('L') ) entityVelocity.x = 500.0f * GetDeltaTime();
+		if( IsKeyDown('J') ) entityVelocity.x = -500.0f * GetDeltaTime();
 
-		entity->velocity.y = -980.0f * GetDeltaTime();
+		entityVelocity.y = -980.0f * GetDeltaTime();
 
-		entity->velocity.z = 0.0f;
-		if( IsKeyDown('I') ) entity->velocity.z = 500.0f * GetDeltaTime();
-		if( IsKeyDown('K') ) entity->velocity.z = -500.0f * GetDeltaTime();
+		entityVelocity.z = 0.0f;
+		if( IsKeyDown('I') ) entityVelocity.z = 500.0f * GetDeltaTime();
+		if( IsKeyDown('K') ) entityVelocity.z = -500.0f * GetDeltaTime();
 #endif
 	}
-	entity->Update2(GetDeltaTime());
+	UpdateEntity(GetDeltaTime());
 #if ENABLE_FPS
-	cam.SetPosition(entity->position + Vector3(0.0f, boundingEllipse.y-0.2f, 0.0f));
+	cam.SetPosition(entity.position + Vector3(0.0f, boundingEllipse.y-0.2f, 0.0f));
 #endif
 
 	Matrix4 view = cam.GetViewMatrix();
@@ -936,8 +238,8 @@ void ExampleFrame()
 	DebugDraw::DrawGrid(100);
 
 	DebugDraw::DrawCapsule(
-		{ entity->position.x, entity->position.y - boundingEllipse.y/2.0f, entity->position.z },
-		{ entity->position.x, entity->position.y + boundingEllipse.y / 2.0f, entity->position.z },
+		{ entity.position.x, entity.position.y - boundingEllipse.y/2.0f, entity.position.z },
+		{ entity.position.x, entity.position.y + boundingEllipse.y / 2.0f, entity.position.z },
 		0.5f, RED);
 
 	DebugDraw::Flush(perpective * view);